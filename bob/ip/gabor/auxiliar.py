@@ -1,4 +1,4 @@
-from ._library import Jet
+from ._library import Jet, load_jet_block
 import bob.io.base
 import numpy
 
@@ -12,6 +12,7 @@ def save_jets(jets, hdf5):
   """save_jets(jets, hdf5) -> None
 
   Saves the given list of Gabor jets to the given HDF5 file, which needs to be open for writing.
+  Each Gabor jet is written into its own directory; to write all jets into a single data set, use :py:func:`bob.ip.gabor.save_jet_block`.
 
   **Parameters**:
 
@@ -33,6 +34,8 @@ def load_jets(hdf5):
   """load_jets(hdf5) -> jets
 
   Loads a list of Gabor jets from the given HDF5 file, which needs to be open for reading.
+  Both the directories written by :py:func:`bob.ip.gabor.save_jets`, whose jets might have different lengths, and the single data set written by :py:func:`bob.ip.gabor.save_jet_block` can be read.
+  The single data set is read with :py:func:`bob.ip.gabor.load_jet_block`, which should be used directly when the data of the jets is required as one array.
 
   **Parameters**:
 
@@ -44,8 +47,15 @@ def load_jets(hdf5):
     ``jets`` : [:py:class:`bob.ip.gabor.Jet`]
       The list of Gabor jets read from file
   """
-  count = hdf5.read("NumberOfJets")
   jets = []
+  if hdf5.has_dataset("Jets"):
+    for data in load_jet_block(hdf5):
+      jet = Jet(data.shape[1])
+      jet.jet[:] = data
+      jets.append(jet)
+    return jets
+
+  count = hdf5.read("NumberOfJets")
   for i in range(count):
     old_name = _name(i, 100)
     name = old_name if hdf5.has_group(old_name) else _name(i, count)
@@ -53,4 +63,3 @@ def load_jets(hdf5):
     jets.append(Jet(hdf5))
     hdf5.cd("..")
   return jets
-
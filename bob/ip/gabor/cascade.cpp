@@ -0,0 +1,367 @@
+/**
+ * @date Sat Oct 17 22:52:31 UTC 2026
+ *
+ * @brief Bindings for the cascaded gallery comparison
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.extension/documentation.h>
+
+#include "gil.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto Cascade_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".Cascade",
+  "Compares a probe with a large gallery using a cheap screening stage and an expensive matching stage",
+  "In large galleries, most of the gallery entries are obviously wrong, but computing a disparity-based :py:class:`Similarity` for each of them is expensive. "
+  "The cascade first computes the ``screening`` similarity (by default, ``'ScalarProduct'``, which uses only the absolute values) between the probe and all gallery entries. "
+  "Only the best :py:attr:`fraction` of the gallery entries, and only those with a screening similarity of at least :py:attr:`threshold`, are passed to the ``matching`` stage, e.g., a ``'PhaseDiffPlusCanberra'`` similarity.\n\n"
+  "The cascade keeps track of the number of gallery entries that were evaluated in each stage, see :py:attr:`evaluated` and :py:attr:`pass_rate`."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates a cascade with the given similarity functions",
+    0,
+    true
+  )
+  .add_prototype("matching, [screening], [fraction], [threshold]", "")
+  .add_parameter("matching", ":py:class:`bob.ip.gabor.Similarity`", "The similarity function used in the matching stage")
+  .add_parameter("screening", ":py:class:`bob.ip.gabor.Similarity` or ``None``", "[Default: ``None``] The similarity function used in the screening stage; if ``None``, ``'ScalarProduct'`` is used")
+  .add_parameter("fraction", "float", "[Default: ``0.1``] The fraction of the gallery that is passed to the matching stage, in range ``]0,1]``")
+  .add_parameter("threshold", "float", "[Default: ``-inf``] The minimum screening similarity for a gallery entry to be passed to the matching stage")
+);
+
+static int PyBobIpGaborCascade_init(PyBobIpGaborCascadeObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = Cascade_doc.kwlist();
+
+  PyBobIpGaborSimilarityObject* matching;
+  PyObject* screening = 0;
+  double fraction = 0.1, threshold = -std::numeric_limits<double>::infinity();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|Odd", kwlist, &PyBobIpGaborSimilarity_Type, &matching, &screening, &fraction, &threshold)) return -1;
+
+  boost::shared_ptr<bob::ip::gabor::Similarity> screening_similarity;
+  if (screening && screening != Py_None){
+    if (!PyBobIpGaborSimilarity_Check(screening)){
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `screening' parameter to be of type bob.ip.gabor.Similarity or None", Py_TYPE(self)->tp_name);
+      return -1;
+    }
+    screening_similarity = reinterpret_cast<PyBobIpGaborSimilarityObject*>(screening)->cxx;
+  }
+
+  self->cxx.reset(new bob::ip::gabor::Cascade(matching->cxx, screening_similarity, fraction, threshold));
+  return 0;
+BOB_CATCH_MEMBER("Cascade constructor", -1)
+}
+
+static void PyBobIpGaborCascade_delete(PyBobIpGaborCascadeObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborCascade_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborCascade_Type));
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto matching_doc = bob::extension::VariableDoc(
+  "matching",
+  ":py:class:`bob.ip.gabor.Similarity`",
+  "The similarity function used in the matching stage, read only"
+);
+PyObject* PyBobIpGaborCascade_matching(PyBobIpGaborCascadeObject* self, void*){
+BOB_TRY
+  PyBobIpGaborSimilarityObject* similarity = (PyBobIpGaborSimilarityObject*)PyBobIpGaborSimilarity_Type.tp_alloc(&PyBobIpGaborSimilarity_Type, 0);
+  similarity->cxx = self->cxx->matching();
+  return Py_BuildValue("N", similarity);
+BOB_CATCH_MEMBER("matching", 0)
+}
+
+static auto screening_doc = bob::extension::VariableDoc(
+  "screening",
+  ":py:class:`bob.ip.gabor.Similarity`",
+  "The similarity function used in the screening stage, read only"
+);
+PyObject* PyBobIpGaborCascade_screening(PyBobIpGaborCascadeObject* self, void*){
+BOB_TRY
+  PyBobIpGaborSimilarityObject* similarity = (PyBobIpGaborSimilarityObject*)PyBobIpGaborSimilarity_Type.tp_alloc(&PyBobIpGaborSimilarity_Type, 0);
+  similarity->cxx = self->cxx->screening();
+  return Py_BuildValue("N", similarity);
+BOB_CATCH_MEMBER("screening", 0)
+}
+
+static auto fraction_doc = bob::extension::VariableDoc(
+  "fraction",
+  "float",
+  "The fraction of the gallery that is passed to the matching stage, in range ``]0,1]``"
+);
+PyObject* PyBobIpGaborCascade_getFraction(PyBobIpGaborCascadeObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("d", self->cxx->fraction());
+BOB_CATCH_MEMBER("fraction", 0)
+}
+int PyBobIpGaborCascade_setFraction(PyBobIpGaborCascadeObject* self, PyObject* value, void*){
+BOB_TRY
+  double fraction = PyFloat_AsDouble(value);
+  if (PyErr_Occurred()) return -1;
+  self->cxx->fraction(fraction);
+  return 0;
+BOB_CATCH_MEMBER("fraction", -1)
+}
+
+static auto threshold_doc = bob::extension::VariableDoc(
+  "threshold",
+  "float",
+  "The minimum screening similarity for a gallery entry to be passed to the matching stage"
+);
+PyObject* PyBobIpGaborCascade_getThreshold(PyBobIpGaborCascadeObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("d", self->cxx->threshold());
+BOB_CATCH_MEMBER("threshold", 0)
+}
+int PyBobIpGaborCascade_setThreshold(PyBobIpGaborCascadeObject* self, PyObject* value, void*){
+BOB_TRY
+  double threshold = PyFloat_AsDouble(value);
+  if (PyErr_Occurred()) return -1;
+  self->cxx->threshold(threshold);
+  return 0;
+BOB_CATCH_MEMBER("threshold", -1)
+}
+
+static auto evaluated_doc = bob::extension::VariableDoc(
+  "evaluated",
+  "(int, int)",
+  "The number of gallery entries evaluated in the screening and the matching stage since the last call to :py:meth:`reset_statistics`, read only"
+);
+PyObject* PyBobIpGaborCascade_evaluated(PyBobIpGaborCascadeObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("(ll)", self->cxx->evaluated(bob::ip::gabor::Cascade::SCREENING), self->cxx->evaluated(bob::ip::gabor::Cascade::MATCHING));
+BOB_CATCH_MEMBER("evaluated", 0)
+}
+
+static auto passRate_doc = bob::extension::VariableDoc(
+  "pass_rate",
+  "float",
+  "The rate of the screened gallery entries that were passed to the matching stage since the last call to :py:meth:`reset_statistics`, read only"
+);
+PyObject* PyBobIpGaborCascade_passRate(PyBobIpGaborCascadeObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("d", self->cxx->pass_rate());
+BOB_CATCH_MEMBER("pass_rate", 0)
+}
+
+static PyGetSetDef PyBobIpGaborCascade_getseters[] = {
+  {
+    matching_doc.name(),
+    (getter)PyBobIpGaborCascade_matching,
+    0,
+    matching_doc.doc(),
+    0
+  },
+  {
+    screening_doc.name(),
+    (getter)PyBobIpGaborCascade_screening,
+    0,
+    screening_doc.doc(),
+    0
+  },
+  {
+    fraction_doc.name(),
+    (getter)PyBobIpGaborCascade_getFraction,
+    (setter)PyBobIpGaborCascade_setFraction,
+    fraction_doc.doc(),
+    0
+  },
+  {
+    threshold_doc.name(),
+    (getter)PyBobIpGaborCascade_getThreshold,
+    (setter)PyBobIpGaborCascade_setThreshold,
+    threshold_doc.doc(),
+    0
+  },
+  {
+    evaluated_doc.name(),
+    (getter)PyBobIpGaborCascade_evaluated,
+    0,
+    evaluated_doc.doc(),
+    0
+  },
+  {
+    passRate_doc.name(),
+    (getter)PyBobIpGaborCascade_passRate,
+    0,
+    passRate_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto search_doc = bob::extension::FunctionDoc(
+  "search",
+  "Computes the cascaded similarities between the probe and all entries of the given gallery",
+  "The ``probe`` can either be a single Gabor jet, or a list of Gabor jets (i.e., a graph), and the ``gallery`` is a contiguous array of Gabor jet data, see :py:meth:`Similarity.similarities` for details. "
+  "Gallery entries that do not pass the screening stage get the score ``-inf``, while all other scores are computed with the :py:attr:`matching` similarity.\n\n"
+  ".. note::\n\n  The function :py:func:`__call__` is a synonym for this function.",
+  true
+)
+.add_prototype("probe, gallery, [scores], [number_of_threads]", "scores")
+.add_parameter("probe", ":py:class:`bob.ip.gabor.Jet` or [:py:class:`bob.ip.gabor.Jet`]", "The probe Gabor jet or the list of Gabor jets of the probe graph")
+.add_parameter("gallery", "array_like (float, 3D or 4D)", "The Gabor jets of the gallery, stored contiguously")
+.add_parameter("scores", "array_like (float, 1D)", "If given, the scores will be written to this array, which must be of shape ``(N,)``")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads to use in both stages; ``0`` selects one thread per available core")
+.add_return("scores", "array_like (float, 1D)", "The scores of all gallery entries; identical to the ``scores`` parameter, if given")
+;
+
+static PyObject* PyBobIpGaborCascade_search(PyBobIpGaborCascadeObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = search_doc.kwlist();
+
+  PyObject* probe;
+  PyBlitzArrayObject* gallery = 0,* scores = 0;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO&|O&i", kwlist, &probe, &PyBlitzArray_Converter, &gallery, &PyBlitzArray_OutputConverter, &scores, &threads)) return 0;
+
+  auto gallery_ = make_safe(gallery);
+  auto scores_ = make_xsafe(scores);
+
+  // get the probe jets
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> jets;
+  bool graph = !PyBobIpGaborJet_Check(probe);
+  if (graph){
+    PyObject* iterator = PyObject_GetIter(probe);
+    if (!iterator) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `probe' to be a bob.ip.gabor.Jet or a list of those", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    auto iterator_ = make_safe(iterator);
+    while (PyObject* it = PyIter_Next(iterator)) {
+      auto it_ = make_safe(it);
+      if (!PyBobIpGaborJet_Check(it)){
+        PyErr_Format(PyExc_TypeError, "`%s' requires all elements of the `probe' to be of type bob.ip.gabor.Jet, but element %d isn't", Py_TYPE(self)->tp_name, (int)jets.size());
+        return 0;
+      }
+      jets.push_back(reinterpret_cast<PyBobIpGaborJetObject*>(it)->cxx);
+    }
+  }
+
+  if (gallery->type_num != NPY_FLOAT64 || gallery->ndim != (graph ? 4 : 3)) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `gallery' to be a %dD array of type float", Py_TYPE(self)->tp_name, graph ? 4 : 3);
+    return 0;
+  }
+
+  if (scores){
+    if (scores->type_num != NPY_FLOAT64 || scores->ndim != 1) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `scores' to be a 1D array of type float", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[] = {gallery->shape[0]};
+    scores = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, osize);
+    scores_ = make_safe(scores);
+  }
+
+  // the C++ objects stay alive while the global interpreter lock is released
+  auto cascade = self->cxx;
+  auto& blitz_scores = *PyBlitzArrayCxx_AsBlitz<double,1>(scores);
+  if (graph){
+    auto& blitz_gallery = *PyBlitzArrayCxx_AsBlitz<double,4>(gallery);
+    if (!without_gil([&](){cascade->search(jets, blitz_gallery, blitz_scores, threads);})) return 0;
+  } else {
+    auto jet = reinterpret_cast<PyBobIpGaborJetObject*>(probe)->cxx;
+    auto& blitz_gallery = *PyBlitzArrayCxx_AsBlitz<double,3>(gallery);
+    if (!without_gil([&](){cascade->search(*jet, blitz_gallery, blitz_scores, threads);})) return 0;
+  }
+
+  return PyBlitzArray_AsNumpyArray(scores, 0);
+BOB_CATCH_MEMBER("search", 0)
+}
+
+static auto resetStatistics_doc = bob::extension::FunctionDoc(
+  "reset_statistics",
+  "Resets the number of evaluated gallery entries of all stages",
+  0,
+  true
+)
+.add_prototype("")
+;
+
+static PyObject* PyBobIpGaborCascade_resetStatistics(PyBobIpGaborCascadeObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = resetStatistics_doc.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+
+  self->cxx->reset_statistics();
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("reset_statistics", 0)
+}
+
+
+static PyMethodDef PyBobIpGaborCascade_methods[] = {
+  {
+    search_doc.name(),
+    (PyCFunction)PyBobIpGaborCascade_search,
+    METH_VARARGS|METH_KEYWORDS,
+    search_doc.doc()
+  },
+  {
+    resetStatistics_doc.name(),
+    (PyCFunction)PyBobIpGaborCascade_resetStatistics,
+    METH_VARARGS|METH_KEYWORDS,
+    resetStatistics_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the Cascade type struct; will be initialized later
+PyTypeObject PyBobIpGaborCascade_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpGaborCascade(PyObject* module)
+{
+
+  // initialize the Cascade type struct
+  PyBobIpGaborCascade_Type.tp_name = Cascade_doc.name();
+  PyBobIpGaborCascade_Type.tp_basicsize = sizeof(PyBobIpGaborCascadeObject);
+  PyBobIpGaborCascade_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborCascade_Type.tp_doc = Cascade_doc.doc();
+
+  // set the functions
+  PyBobIpGaborCascade_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborCascade_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborCascade_init);
+  PyBobIpGaborCascade_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborCascade_delete);
+  PyBobIpGaborCascade_Type.tp_methods = PyBobIpGaborCascade_methods;
+  PyBobIpGaborCascade_Type.tp_getset = PyBobIpGaborCascade_getseters;
+  PyBobIpGaborCascade_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobIpGaborCascade_search);
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborCascade_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborCascade_Type);
+  return PyModule_AddObject(module, "Cascade", (PyObject*)&PyBobIpGaborCascade_Type) >= 0;
+}
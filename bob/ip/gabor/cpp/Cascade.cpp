@@ -0,0 +1,90 @@
+/**
+ * @date Sat Oct 17 22:52:31 UTC 2026
+ *
+ * @brief The C++ implementation of the cascaded gallery comparison
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <bob.ip.gabor/Cascade.h>
+
+
+bob::ip::gabor::Cascade::Cascade(boost::shared_ptr<Similarity> matching, boost::shared_ptr<Similarity> screening, double fraction, double threshold)
+:
+  m_matching(matching),
+  m_screening(screening),
+  m_threshold(threshold)
+{
+  if (!m_matching)
+    throw std::runtime_error("The cascade requires a similarity function for the matching stage.");
+  if (!m_screening)
+    m_screening.reset(new Similarity(Similarity::SCALAR_PRODUCT));
+  this->fraction(fraction);
+  reset_statistics();
+}
+
+void bob::ip::gabor::Cascade::fraction(double fraction){
+  if (fraction <= 0. || fraction > 1.)
+    throw std::runtime_error((boost::format("The fraction of gallery entries passed to the matching stage (%g) must be in range ]0,1].") % fraction).str());
+  m_fraction = fraction;
+}
+
+double bob::ip::gabor::Cascade::pass_rate() const{
+  // the entries that passed the screening are exactly those evaluated in the matching stage
+  long screened = m_evaluated[SCREENING];
+  return screened ? (double)m_evaluated[MATCHING] / screened : 0.;
+}
+
+void bob::ip::gabor::Cascade::reset_statistics(){
+  for (int s = 0; s < 2; ++s)
+    m_evaluated[s] = 0;
+}
+
+
+template <typename Probe, int D>
+void bob::ip::gabor::Cascade::run(const Probe& probe, const blitz::Array<double,D>& gallery, blitz::Array<double,1>& scores, int number_of_threads) const{
+  const int size = gallery.extent(0);
+  bob::core::array::assertCZeroBaseContiguous(scores);
+  bob::core::array::assertSameShape(scores, blitz::shape(size));
+
+  // stage 1: screen all gallery entries (which also checks the probe and the gallery)
+  blitz::Array<double,1> screening(size);
+  m_screening->similarities(probe, gallery, screening, number_of_threads);
+
+  // select the best fraction of the entries that are above threshold
+  std::vector<int> candidates;
+  for (int i = 0; i < size; ++i)
+    if (screening(i) >= m_threshold)
+      candidates.push_back(i);
+  const std::size_t keep = std::max<std::size_t>((std::size_t)std::ceil(m_fraction * size), 1);
+  if (candidates.size() > keep){
+    std::nth_element(candidates.begin(), candidates.begin() + keep, candidates.end(), [&screening](int a, int b){return screening(a) > screening(b) || (screening(a) == screening(b) && a < b);});
+    candidates.resize(keep);
+    // keep the gallery order for a linear memory access
+    std::sort(candidates.begin(), candidates.end());
+  }
+
+  // stage 2: compute the matching similarities of the candidates only
+  scores = -std::numeric_limits<double>::infinity();
+  if (!candidates.empty()){
+    blitz::Array<double,1> matching(candidates.size());
+    m_matching->similarities(probe, gallery, candidates, matching, number_of_threads);
+    for (std::size_t c = 0; c < candidates.size(); ++c)
+      scores(candidates[c]) = matching(c);
+  }
+
+  // update statistics
+  m_evaluated[SCREENING] += size;
+  m_evaluated[MATCHING] += candidates.size();
+}
+
+void bob::ip::gabor::Cascade::search(const Jet& probe, const blitz::Array<double,3>& gallery, blitz::Array<double,1>& scores, int number_of_threads) const{
+  run(probe, gallery, scores, number_of_threads);
+}
+
+void bob::ip::gabor::Cascade::search(const std::vector<boost::shared_ptr<Jet>>& probe, const blitz::Array<double,4>& gallery, blitz::Array<double,1>& scores, int number_of_threads) const{
+  run(probe, gallery, scores, number_of_threads);
+}
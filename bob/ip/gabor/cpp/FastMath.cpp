@@ -0,0 +1,22 @@
+/**
+ * @date Sat Oct 17 23:10:45 UTC 2026
+ *
+ * @brief The run-time switch between exact and fast trigonometric functions
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <atomic>
+
+#include <bob.ip.gabor/FastMath.h>
+
+// by default, the exact functions of the standard library are used
+static std::atomic<bool> s_fast_math(false);
+
+bool bob::ip::gabor::fast_math(){
+  return s_fast_math.load(std::memory_order_relaxed);
+}
+
+void bob::ip::gabor::fast_math(bool enable){
+  s_fast_math.store(enable, std::memory_order_relaxed);
+}
@@ -0,0 +1,153 @@
+/**
+ * @date Sat Oct 17 23:26:25 UTC 2026
+ *
+ * @brief The C++ implementation of the fixed-point Gabor jet similarities
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <cmath>
+
+#include <bob.ip.gabor/FixedPointSimilarity.h>
+#include <bob.ip.gabor/Parallel.h>
+
+// the cosines of COSINE_TABLE_SIZE equally spaced angles in [0, 2 pi[, scaled by COSINE_SCALE
+struct CosineTable{
+  CosineTable(){
+    for (int i = 0; i < bob::ip::gabor::FixedPointSimilarity::COSINE_TABLE_SIZE; ++i)
+      values[i] = (int16_t)std::lround(std::cos(2. * M_PI * i / bob::ip::gabor::FixedPointSimilarity::COSINE_TABLE_SIZE) * bob::ip::gabor::FixedPointSimilarity::COSINE_SCALE);
+  }
+  int16_t values[bob::ip::gabor::FixedPointSimilarity::COSINE_TABLE_SIZE];
+};
+static const CosineTable cosine_table;
+
+// the number of phase indices that map to the same cosine table entry
+static const int PHASE_SHIFT = 4;
+static_assert((bob::ip::gabor::FixedPointSimilarity::PHASE_STEPS >> PHASE_SHIFT) == bob::ip::gabor::FixedPointSimilarity::COSINE_TABLE_SIZE, "The cosine table does not fit to the phase quantization");
+
+
+bob::ip::gabor::FixedPointSimilarity::FixedPointSimilarity(Similarity::SimilarityType type)
+:
+  m_type(type)
+{
+  if (m_type != Similarity::SCALAR_PRODUCT && m_type != Similarity::CANBERRA && m_type != Similarity::ABS_PHASE)
+    throw std::runtime_error("The fixed-point similarity is only available for the types ScalarProduct, Canberra and AbsPhase");
+}
+
+bob::ip::gabor::FixedPointSimilarity::FixedPointSimilarity(const std::string& name)
+:
+  FixedPointSimilarity(Similarity::name_to_type(name))
+{
+}
+
+
+// quantizes one Gabor jet stored as (2, length) block
+static void quantize_jet(const double* jet, int length, uint16_t* quantized){
+  for (int j = 0; j < length; ++j){
+    const double magnitude = std::min(std::max(jet[j], 0.), 1.);
+    quantized[j] = (uint16_t)std::lround(magnitude * bob::ip::gabor::FixedPointSimilarity::MAGNITUDE_SCALE);
+    // negative phases wrap around to the upper half of the indices
+    quantized[length + j] = (uint16_t)(std::lround(jet[length + j] * (bob::ip::gabor::FixedPointSimilarity::PHASE_STEPS / (2. * M_PI))) & 0xFFFF);
+  }
+}
+
+void bob::ip::gabor::FixedPointSimilarity::quantize(const Jet& jet, blitz::Array<uint16_t,2>& quantized){
+  bob::core::array::assertCZeroBaseContiguous(jet.jet());
+  bob::core::array::assertCZeroBaseContiguous(quantized);
+  bob::core::array::assertSameShape(quantized, jet.jet());
+  quantize_jet(jet.jet().data(), jet.length(), quantized.data());
+}
+
+void bob::ip::gabor::FixedPointSimilarity::quantize(const blitz::Array<double,3>& jets, blitz::Array<uint16_t,3>& quantized){
+  bob::core::array::assertCZeroBaseContiguous(jets);
+  bob::core::array::assertCZeroBaseContiguous(quantized);
+  bob::core::array::assertSameShape(jets, blitz::shape(jets.extent(0), 2, jets.extent(2)));
+  bob::core::array::assertSameShape(quantized, jets);
+  const int length = jets.extent(2);
+  for (int i = 0; i < jets.extent(0); ++i)
+    quantize_jet(jets.data() + 2 * i * length, length, quantized.data() + 2 * i * length);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  Fixed-point kernels  //////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The kernels accumulate integer sums, which are converted into the score only once.
+// The loops of the scalar product and the absolute phase similarity are free of branches, so that they can be vectorized with integer SIMD instructions.
+
+static double scalar_product(const uint16_t* jet1, const uint16_t* jet2, int length){
+  uint64_t sum = 0;
+#pragma omp simd reduction(+:sum)
+  for (int j = 0; j < length; ++j){
+    sum += (uint32_t)jet1[j] * jet2[j];
+  }
+  return sum / ((double)bob::ip::gabor::FixedPointSimilarity::MAGNITUDE_SCALE * bob::ip::gabor::FixedPointSimilarity::MAGNITUDE_SCALE);
+}
+
+static double canberra(const uint16_t* jet1, const uint16_t* jet2, int length){
+  // 1 - |a - b| / (a + b) = 2 min(a, b) / (a + b), where min(a, b) / (a + b) <= 1/2 is computed with 16 fractional bits
+  uint64_t sum = 0;
+  for (int j = 0; j < length; ++j){
+    const uint32_t minimum = std::min(jet1[j], jet2[j]), total = (uint32_t)jet1[j] + jet2[j];
+    // two vanishing absolute values are identical
+    sum += total ? ((minimum << 16) / total) << 1 : 1u << 16;
+  }
+  return sum / (65536. * length);
+}
+
+static double abs_phase(const uint16_t* jet1, const uint16_t* jet2, int length){
+  const uint16_t* p1 = jet1 + length,* p2 = jet2 + length;
+  const int16_t* table = cosine_table.values;
+  int64_t sum = 0;
+#pragma omp simd reduction(+:sum)
+  for (int j = 0; j < length; ++j){
+    // the phase difference wraps around modulo 2 pi, and it is rounded to the closest table entry
+    const uint32_t difference = (uint16_t)(p1[j] - p2[j]);
+    const int index = ((difference + (1u << (PHASE_SHIFT - 1))) >> PHASE_SHIFT) & (bob::ip::gabor::FixedPointSimilarity::COSINE_TABLE_SIZE - 1);
+    // the product of the absolute values is reduced to 16 fractional bits, so that the product with the cosine fits into 32 bit
+    const int32_t product = ((uint32_t)jet1[j] * jet2[j]) >> 16;
+    sum += product * table[index];
+  }
+  return sum * (65536. / ((double)bob::ip::gabor::FixedPointSimilarity::MAGNITUDE_SCALE * bob::ip::gabor::FixedPointSimilarity::MAGNITUDE_SCALE * bob::ip::gabor::FixedPointSimilarity::COSINE_SCALE));
+}
+
+// computes the scores of count gallery jets with the given kernel
+template <double (*kernel)(const uint16_t*, const uint16_t*, int)>
+static void compute(const uint16_t* probe, const uint16_t* gallery, int count, int length, double* scores){
+  for (int i = 0; i < count; ++i)
+    scores[i] = kernel(probe, gallery + (std::size_t)i * 2 * length, length);
+}
+
+void bob::ip::gabor::FixedPointSimilarity::compute_similarities(const uint16_t* probe, const uint16_t* gallery, int count, int length, double* scores) const{
+  switch (m_type){
+    case Similarity::SCALAR_PRODUCT: compute<scalar_product>(probe, gallery, count, length, scores); return;
+    case Similarity::CANBERRA: compute<canberra>(probe, gallery, count, length, scores); return;
+    case Similarity::ABS_PHASE: compute<abs_phase>(probe, gallery, count, length, scores); return;
+    default: throw std::runtime_error("This should not have happened. The type of the fixed-point similarity is not supported.");
+  }
+}
+
+
+double bob::ip::gabor::FixedPointSimilarity::similarity(const blitz::Array<uint16_t,2>& jet1, const blitz::Array<uint16_t,2>& jet2) const{
+  bob::core::array::assertCZeroBaseContiguous(jet1);
+  bob::core::array::assertCZeroBaseContiguous(jet2);
+  bob::core::array::assertSameShape(jet1, blitz::shape(2, jet1.extent(1)));
+  bob::core::array::assertSameShape(jet2, jet1);
+  double score;
+  compute_similarities(jet1.data(), jet2.data(), 1, jet1.extent(1), &score);
+  return score;
+}
+
+void bob::ip::gabor::FixedPointSimilarity::similarities(const blitz::Array<uint16_t,2>& probe, const blitz::Array<uint16_t,3>& gallery, blitz::Array<double,1>& scores, int number_of_threads) const{
+  bob::core::array::assertCZeroBaseContiguous(probe);
+  bob::core::array::assertCZeroBaseContiguous(gallery);
+  bob::core::array::assertCZeroBaseContiguous(scores);
+  bob::core::array::assertSameShape(probe, blitz::shape(2, probe.extent(1)));
+  bob::core::array::assertSameShape(gallery, blitz::shape(gallery.extent(0), 2, probe.extent(1)));
+  bob::core::array::assertSameShape(scores, blitz::shape(gallery.extent(0)));
+
+  const int length = probe.extent(1);
+  parallel_for(gallery.extent(0), number_of_threads, [&](int begin, int end){
+    compute_similarities(probe.data(), gallery.data() + (std::size_t)begin * 2 * length, end - begin, length, scores.data() + begin);
+  });
+}
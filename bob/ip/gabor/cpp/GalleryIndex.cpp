@@ -0,0 +1,353 @@
+/**
+ * @date Sun Oct 18 00:37:44 UTC 2026
+ *
+ * @brief The C++ implementation of the top-k gallery index
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <bob.ip.gabor/GalleryIndex.h>
+#include <bob.ip.gabor/Parallel.h>
+
+// the order of the search results: higher scores first, lower ids first for equal scores
+static bool better(const bob::ip::gabor::GalleryIndex::Result& a, const bob::ip::gabor::GalleryIndex::Result& b){
+  return a.first > b.first || (a.first == b.first && a.second < b.second);
+}
+
+
+// the mean and the (population) standard deviation of the given scores, where a standard deviation of 0 is replaced by 1
+static bob::ip::gabor::GalleryIndex::Statistics statistics(const double* scores, int count, int stride){
+  double sum = 0., sum_sqr = 0.;
+  for (int i = 0; i < count; ++i){
+    sum += scores[i * stride];
+    sum_sqr += scores[i * stride] * scores[i * stride];
+  }
+  const double mean = sum / count, variance = std::max(sum_sqr / count - mean * mean, 0.);
+  return bob::ip::gabor::GalleryIndex::Statistics(mean, variance > 0. ? std::sqrt(variance) : 1.);
+}
+
+static inline double normalize(double score, const bob::ip::gabor::GalleryIndex::Statistics& statistics){
+  return (score - statistics.first) / statistics.second;
+}
+
+
+bob::ip::gabor::GalleryIndex::GalleryIndex(boost::shared_ptr<Similarity> similarity)
+:
+  m_similarity(similarity),
+  m_nodes(0),
+  m_length(0),
+  m_normalization(NO_NORM),
+  m_cohort_size(0)
+{
+  if (!m_similarity)
+    throw std::runtime_error("The gallery index requires a similarity function.");
+}
+
+bob::ip::gabor::GalleryIndex::GalleryIndex(bob::io::base::HDF5File& file)
+{
+  load(file);
+}
+
+bob::ip::gabor::GalleryIndex::Normalization bob::ip::gabor::GalleryIndex::name_to_normalization(const std::string& name){
+  if (name == "None") return NO_NORM;
+  if (name == "ZNorm") return Z_NORM;
+  if (name == "TNorm") return T_NORM;
+  if (name == "ZTNorm") return ZT_NORM;
+  throw std::runtime_error("The given normalization '" + name + "' is not known; choose one of ('None', 'ZNorm', 'TNorm', 'ZTNorm')");
+}
+
+std::string bob::ip::gabor::GalleryIndex::normalization_to_name(Normalization normalization){
+  switch (normalization){
+    case NO_NORM: return "None";
+    case Z_NORM: return "ZNorm";
+    case T_NORM: return "TNorm";
+    case ZT_NORM: return "ZTNorm";
+  }
+  throw std::runtime_error("The given normalization is not known");
+}
+
+void bob::ip::gabor::GalleryIndex::check(const std::vector<boost::shared_ptr<Jet>>& graph, long id){
+  if (graph.empty())
+    throw std::runtime_error("The graph must contain at least one Gabor jet.");
+
+  // the first graph defines the shape of all graphs, unless the cohort has already defined it
+  if (m_ids.empty() && !m_cohort_size){
+    m_nodes = graph.size();
+    m_length = graph.front()->length();
+  }
+  if ((int)graph.size() != m_nodes)
+    throw std::runtime_error((boost::format("The graph with id %d has %d nodes, but the graphs in the gallery index have %d.") % id % graph.size() % m_nodes).str());
+  for (auto it = graph.begin(); it != graph.end(); ++it){
+    if ((*it)->length() != m_length)
+      throw std::runtime_error((boost::format("The jets of the graph with id %d have length %d, but the jets in the gallery index have length %d.") % id % (*it)->length() % m_length).str());
+  }
+}
+
+void bob::ip::gabor::GalleryIndex::add(long id, const std::vector<boost::shared_ptr<Jet>>& graph, int number_of_threads){
+  if (contains(id))
+    throw std::runtime_error((boost::format("A graph with id %d is already in the gallery index.") % id).str());
+  check(graph, id);
+
+  // copy the graph and compute its Z-norm statistics before touching the index, so that exceptions leave it unchanged
+  std::vector<double> entry;
+  entry.reserve((std::size_t)m_nodes * 2 * m_length);
+  for (auto it = graph.begin(); it != graph.end(); ++it){
+    const blitz::Array<double,2>& jet = (*it)->jet();
+    entry.insert(entry.end(), jet.begin(), jet.end());
+  }
+
+  Statistics z;
+  const bool z_norm = m_normalization & Z_NORM;
+  if (z_norm)
+    compute_z_statistics(entry.data(), 1, &z, number_of_threads);
+
+  // reserve all memory first, so that the containers cannot be modified partially
+  m_data.reserve(m_data.size() + entry.size());
+  m_ids.reserve(m_ids.size() + 1);
+  if (z_norm) m_z_statistics.reserve(m_z_statistics.size() + 1);
+  m_positions[id] = m_ids.size();
+
+  m_data.insert(m_data.end(), entry.begin(), entry.end());
+  if (z_norm) m_z_statistics.push_back(z);
+  m_ids.push_back(id);
+}
+
+bool bob::ip::gabor::GalleryIndex::remove(long id){
+  auto it = m_positions.find(id);
+  if (it == m_positions.end()) return false;
+
+  // move the last graph into the gap
+  const int position = it->second, last = m_ids.size() - 1;
+  const std::size_t entry_size = (std::size_t)m_nodes * 2 * m_length;
+  if (position != last){
+    std::copy(m_data.begin() + last * entry_size, m_data.end(), m_data.begin() + position * entry_size);
+    m_ids[position] = m_ids[last];
+    m_positions[m_ids[position]] = position;
+    if (!m_z_statistics.empty()) m_z_statistics[position] = m_z_statistics[last];
+  }
+  m_positions.erase(it);
+  m_ids.pop_back();
+  m_data.resize(last * entry_size);
+  if (!m_z_statistics.empty()) m_z_statistics.pop_back();
+  return true;
+}
+
+void bob::ip::gabor::GalleryIndex::search(const std::vector<boost::shared_ptr<Jet>>& probe, int k, std::vector<Result>& results, const std::vector<Range>& id_ranges, int number_of_threads) const{
+  if (k < 1)
+    throw std::runtime_error((boost::format("The number of search results (%d) must be positive.") % k).str());
+  results.clear();
+  if (m_ids.empty()) return;
+
+  // collect the positions of all graphs with ids in the given ranges
+  std::vector<int> candidates;
+  candidates.reserve(m_ids.size());
+  for (int i = 0; i < (int)m_ids.size(); ++i){
+    bool selected = id_ranges.empty();
+    for (auto it = id_ranges.begin(); !selected && it != id_ranges.end(); ++it)
+      selected = m_ids[i] >= it->first && m_ids[i] <= it->second;
+    if (selected) candidates.push_back(i);
+  }
+  if (candidates.empty()) return;
+
+  // the stored graphs as a gallery block (which is never modified)
+  const blitz::Array<double,4> gallery(const_cast<double*>(m_data.data()), blitz::shape(m_ids.size(), m_nodes, 2, m_length), blitz::neverDeleteData);
+
+  // the T-norm statistics of the probe are computed only once
+  const bool z_norm = m_normalization & Z_NORM, t_norm = m_normalization & T_NORM;
+  const Statistics t = t_norm ? t_statistics(probe, number_of_threads) : Statistics(0., 1.);
+
+  // each partition keeps the k best results of its candidates in a bounded heap, where the worst result is on top
+  const int partitions = bob::ip::gabor::number_of_threads(candidates.size(), m_similarity->thread_safe() ? number_of_threads : 1);
+  std::vector<std::vector<Result>> heaps(partitions);
+  parallel_for(partitions, partitions, [&](int begin, int end){
+    for (int p = begin; p < end; ++p){
+      const std::vector<int> indices(candidates.begin() + (long)candidates.size() * p / partitions, candidates.begin() + (long)candidates.size() * (p+1) / partitions);
+      blitz::Array<double,1> scores(indices.size());
+      m_similarity->similarities(probe, gallery, indices, scores, 1);
+
+      std::vector<Result>& heap = heaps[p];
+      heap.reserve(std::min<std::size_t>(k, indices.size()));
+      for (std::size_t i = 0; i < indices.size(); ++i){
+        double score = scores(i);
+        if (z_norm) score = normalize(score, m_z_statistics[indices[i]]);
+        if (t_norm) score = normalize(score, t);
+        Result result(score, m_ids[indices[i]]);
+        if ((int)heap.size() < k){
+          heap.push_back(result);
+          std::push_heap(heap.begin(), heap.end(), better);
+        } else if (better(result, heap.front())){
+          std::pop_heap(heap.begin(), heap.end(), better);
+          heap.back() = result;
+          std::push_heap(heap.begin(), heap.end(), better);
+        }
+      }
+    }
+  });
+
+  // merge the results of all partitions
+  for (auto it = heaps.begin(); it != heaps.end(); ++it)
+    results.insert(results.end(), it->begin(), it->end());
+  std::sort(results.begin(), results.end(), better);
+  if ((int)results.size() > k) results.resize(k);
+}
+
+void bob::ip::gabor::GalleryIndex::compute_z_statistics(const double* graphs, int count, Statistics* statistics, int number_of_threads) const{
+  // the cohort graphs are the probes, and the given graphs are the gallery
+  const blitz::Array<double,4> cohort(const_cast<double*>(m_cohort.data()), blitz::shape(m_cohort_size, m_nodes, 2, m_length), blitz::neverDeleteData);
+  const blitz::Array<double,4> gallery(const_cast<double*>(graphs), blitz::shape(count, m_nodes, 2, m_length), blitz::neverDeleteData);
+  blitz::Array<double,2> scores(m_cohort_size, count);
+  m_similarity->similarity_matrix(cohort, gallery, scores, number_of_threads);
+  for (int i = 0; i < count; ++i)
+    statistics[i] = ::statistics(scores.data() + i, m_cohort_size, count);
+}
+
+void bob::ip::gabor::GalleryIndex::set_normalization(Normalization normalization, const blitz::Array<double,4>& cohort, int number_of_threads){
+  if (normalization == NO_NORM){
+    clear_normalization();
+    return;
+  }
+  bob::core::array::assertCZeroBaseContiguous(cohort);
+  if (cohort.extent(0) < 3)
+    throw std::runtime_error((boost::format("The cohort must contain at least 3 graphs, but it contains %d.") % cohort.extent(0)).str());
+  if (!m_ids.empty() && (cohort.extent(1) != m_nodes || cohort.extent(3) != m_length))
+    throw std::runtime_error((boost::format("The cohort graphs have %d nodes with jets of length %d, but the graphs in the gallery index have %d nodes with jets of length %d.") % cohort.extent(1) % cohort.extent(3) % m_nodes % m_length).str());
+  bob::core::array::assertSameShape(cohort, blitz::shape(cohort.extent(0), cohort.extent(1), 2, cohort.extent(3)));
+
+  m_normalization = normalization;
+  m_nodes = cohort.extent(1);
+  m_length = cohort.extent(3);
+  m_cohort_size = cohort.extent(0);
+  m_cohort.assign(cohort.data(), cohort.data() + cohort.numElements());
+
+  // compute the Z-norm statistics of all enrolled graphs at once
+  m_z_statistics.clear();
+  if (m_normalization & Z_NORM){
+    m_z_statistics.resize(m_ids.size());
+    if (!m_ids.empty())
+      compute_z_statistics(m_data.data(), m_ids.size(), m_z_statistics.data(), number_of_threads);
+  }
+
+  // for ZT-norm, compute the Z-norm statistics of each cohort graph with respect to all other cohort graphs
+  m_cohort_statistics.clear();
+  if (m_normalization == ZT_NORM){
+    blitz::Array<double,2> scores(m_cohort_size, m_cohort_size);
+    m_similarity->similarity_matrix(cohort, cohort, scores, number_of_threads);
+    std::vector<double> column(m_cohort_size - 1);
+    m_cohort_statistics.resize(m_cohort_size);
+    for (int c = 0; c < m_cohort_size; ++c){
+      for (int i = 0, j = 0; i < m_cohort_size; ++i)
+        if (i != c) column[j++] = scores(i, c);
+      m_cohort_statistics[c] = ::statistics(column.data(), m_cohort_size - 1, 1);
+    }
+  }
+}
+
+void bob::ip::gabor::GalleryIndex::clear_normalization(){
+  m_normalization = NO_NORM;
+  m_cohort_size = 0;
+  m_cohort.clear();
+  m_z_statistics.clear();
+  m_cohort_statistics.clear();
+}
+
+bob::ip::gabor::GalleryIndex::Statistics bob::ip::gabor::GalleryIndex::z_statistics(long id) const{
+  if (!(m_normalization & Z_NORM))
+    throw std::runtime_error("Z-norm statistics are only available for the Z-norm and ZT-norm normalizations.");
+  auto it = m_positions.find(id);
+  if (it == m_positions.end())
+    throw std::runtime_error((boost::format("The graph with id %d is not in the gallery index.") % id).str());
+  return m_z_statistics[it->second];
+}
+
+bob::ip::gabor::GalleryIndex::Statistics bob::ip::gabor::GalleryIndex::t_statistics(const std::vector<boost::shared_ptr<Jet>>& probe, int number_of_threads) const{
+  if (!(m_normalization & T_NORM))
+    throw std::runtime_error("T-norm statistics are only available for the T-norm and ZT-norm normalizations.");
+  const blitz::Array<double,4> cohort(const_cast<double*>(m_cohort.data()), blitz::shape(m_cohort_size, m_nodes, 2, m_length), blitz::neverDeleteData);
+  blitz::Array<double,1> scores(m_cohort_size);
+  m_similarity->similarities(probe, cohort, scores, number_of_threads);
+  if (m_normalization == ZT_NORM){
+    for (int c = 0; c < m_cohort_size; ++c)
+      scores(c) = normalize(scores(c), m_cohort_statistics[c]);
+  }
+  return ::statistics(scores.data(), m_cohort_size, 1);
+}
+
+// writes the statistics as (N, 2) array of means and standard deviations
+static void write_statistics(bob::io::base::HDF5File& file, const std::string& name, const std::vector<bob::ip::gabor::GalleryIndex::Statistics>& statistics){
+  blitz::Array<double,2> data(statistics.size(), 2);
+  for (int i = 0; i < data.extent(0); ++i){
+    data(i,0) = statistics[i].first;
+    data(i,1) = statistics[i].second;
+  }
+  file.setArray(name, data);
+}
+
+// reads the (N, 2) statistics from file
+static std::vector<bob::ip::gabor::GalleryIndex::Statistics> read_statistics(bob::io::base::HDF5File& file, const std::string& name){
+  blitz::Array<double,2> data(file.readArray<double,2>(name));
+  std::vector<bob::ip::gabor::GalleryIndex::Statistics> statistics(data.extent(0));
+  for (int i = 0; i < data.extent(0); ++i)
+    statistics[i] = bob::ip::gabor::GalleryIndex::Statistics(data(i,0), data(i,1));
+  return statistics;
+}
+
+void bob::ip::gabor::GalleryIndex::save(bob::io::base::HDF5File& file) const{
+  file.createGroup("Similarity");
+  file.cd("Similarity");
+  m_similarity->save(file);
+  file.cd("..");
+
+  file.set("NumberOfNodes", m_nodes);
+  file.set("Length", m_length);
+  if (!m_ids.empty()){
+    blitz::Array<int64_t,1> ids(m_ids.size());
+    std::copy(m_ids.begin(), m_ids.end(), ids.begin());
+    file.setArray("Ids", ids);
+    file.setArray("Graphs", blitz::Array<double,4>(const_cast<double*>(m_data.data()), blitz::shape(m_ids.size(), m_nodes, 2, m_length), blitz::neverDeleteData));
+  }
+
+  file.set("Normalization", normalization_to_name(m_normalization));
+  if (m_normalization != NO_NORM){
+    file.setArray("Cohort", blitz::Array<double,4>(const_cast<double*>(m_cohort.data()), blitz::shape(m_cohort_size, m_nodes, 2, m_length), blitz::neverDeleteData));
+    if (!m_z_statistics.empty())
+      write_statistics(file, "ZStatistics", m_z_statistics);
+    if (!m_cohort_statistics.empty())
+      write_statistics(file, "CohortStatistics", m_cohort_statistics);
+  }
+}
+
+void bob::ip::gabor::GalleryIndex::load(bob::io::base::HDF5File& file){
+  file.cd("Similarity");
+  m_similarity.reset(new Similarity(file));
+  file.cd("..");
+
+  m_nodes = file.read<int>("NumberOfNodes");
+  m_length = file.read<int>("Length");
+  m_ids.clear();
+  m_data.clear();
+  m_positions.clear();
+  if (file.contains("Ids")){
+    blitz::Array<int64_t,1> ids(file.readArray<int64_t,1>("Ids"));
+    blitz::Array<double,4> graphs(file.readArray<double,4>("Graphs"));
+    m_ids.assign(ids.begin(), ids.end());
+    m_data.assign(graphs.data(), graphs.data() + graphs.numElements());
+    for (int i = 0; i < (int)m_ids.size(); ++i)
+      m_positions[m_ids[i]] = i;
+  }
+
+  clear_normalization();
+  m_normalization = name_to_normalization(file.read<std::string>("Normalization"));
+  if (m_normalization != NO_NORM){
+    blitz::Array<double,4> cohort(file.readArray<double,4>("Cohort"));
+    m_cohort_size = cohort.extent(0);
+    m_cohort.assign(cohort.data(), cohort.data() + cohort.numElements());
+    // the statistics are read from file and not recomputed
+    if (m_normalization & Z_NORM && !m_ids.empty())
+      m_z_statistics = read_statistics(file, "ZStatistics");
+    if (m_normalization == ZT_NORM)
+      m_cohort_statistics = read_statistics(file, "CohortStatistics");
+  }
+}
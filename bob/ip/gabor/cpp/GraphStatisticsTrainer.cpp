@@ -0,0 +1,82 @@
+/**
+ * @date Sun Oct 18 00:08:40 UTC 2026
+ *
+ * @brief The C++ implementation of the parallel computation of the Gabor jet statistics of all nodes of a graph
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/GraphStatisticsTrainer.h>
+#include <bob.ip.gabor/Parallel.h>
+#include <bob.core/assert.h>
+
+bob::ip::gabor::GraphStatisticsTrainer::GraphStatisticsTrainer()
+{
+}
+
+void bob::ip::gabor::GraphStatisticsTrainer::check(int nodes, int two, int length){
+  if (two != 2)
+    throw std::runtime_error((boost::format("GraphStatisticsTrainer: the given graphs must be of shape ([N,] number_of_nodes, 2, length), but the jet dimension is %d") % two).str());
+  if (m_builders.empty()){
+    if (!nodes) throw std::runtime_error("GraphStatisticsTrainer: the given graphs do not have any node");
+    m_builders.resize(nodes);
+    for (auto it = m_builders.begin(); it != m_builders.end(); ++it)
+      it->m_length = length;
+  }
+  else if (nodes != numberOfNodes() || length != this->length())
+    throw std::runtime_error((boost::format("GraphStatisticsTrainer: the given graphs have %d nodes with jets of length %d, but the previous graphs have %d nodes with jets of length %d") % nodes % length % numberOfNodes() % this->length()).str());
+}
+
+void bob::ip::gabor::GraphStatisticsTrainer::add(const blitz::Array<double,3>& graph){
+  bob::core::array::assertCZeroBaseContiguous(graph);
+  check(graph.extent(0), graph.extent(1), graph.extent(2));
+  const int length = graph.extent(2);
+  const double* data = graph.data();
+  for (auto it = m_builders.begin(); it != m_builders.end(); ++it, data += 2 * length)
+    it->add(data, data + length);
+}
+
+void bob::ip::gabor::GraphStatisticsTrainer::add(const blitz::Array<double,4>& graphs, int number_of_threads){
+  if (!graphs.extent(0)) return;
+  bob::core::array::assertCZeroBaseContiguous(graphs);
+  check(graphs.extent(1), graphs.extent(2), graphs.extent(3));
+  const int count = graphs.extent(0), nodes = graphs.extent(1), length = graphs.extent(3);
+  const double* data = graphs.data();
+  // each thread adds the jets of its nodes from all graphs, so that each builder is updated by a single thread
+  parallel_for(nodes, number_of_threads, [&](int begin, int end){
+    for (int g = 0; g < count; ++g){
+      const double* graph = data + (long)g * nodes * 2 * length;
+      for (int n = begin; n < end; ++n){
+        const double* jet = graph + (long)n * 2 * length;
+        m_builders[n].add(jet, jet + length);
+      }
+    }
+  });
+}
+
+void bob::ip::gabor::GraphStatisticsTrainer::merge(const GraphStatisticsTrainer& other){
+  if (other.m_builders.empty()) return;
+  if (m_builders.empty()){
+    *this = other;
+    return;
+  }
+  if (other.numberOfNodes() != numberOfNodes())
+    throw std::runtime_error((boost::format("GraphStatisticsTrainer: cannot merge graphs with %d nodes into graphs with %d nodes") % other.numberOfNodes() % numberOfNodes()).str());
+  for (int n = 0; n < numberOfNodes(); ++n)
+    m_builders[n].merge(other.m_builders[n]);
+}
+
+void bob::ip::gabor::GraphStatisticsTrainer::clear(){
+  m_builders.clear();
+}
+
+std::vector<boost::shared_ptr<bob::ip::gabor::JetStatistics>> bob::ip::gabor::GraphStatisticsTrainer::finalize(boost::shared_ptr<bob::ip::gabor::Transform> gwt, int number_of_threads) const{
+  if (m_builders.empty())
+    throw std::runtime_error("GraphStatisticsTrainer: no graph has been added");
+  std::vector<boost::shared_ptr<JetStatistics>> statistics(m_builders.size());
+  parallel_for(m_builders.size(), number_of_threads, [&](int begin, int end){
+    for (int n = begin; n < end; ++n)
+      statistics[n] = m_builders[n].finalize(gwt);
+  });
+  return statistics;
+}
@@ -9,9 +9,24 @@
 
 
 #include <bob.ip.gabor/Jet.h>
+#include <bob.ip.gabor/FastMath.h>
 
 #include <numeric>
 
+// splits the given complex Gabor jet data into absolute values and phases
+static void split(const blitz::Array<std::complex<double>,1>& data, blitz::Array<double,2>& jet){
+  if (bob::ip::gabor::fast_math()){
+    for (int j = 0; j < data.extent(0); ++j){
+      const double real = data(j).real(), imag = data(j).imag();
+      jet(0,j) = std::sqrt(real * real + imag * imag);
+      jet(1,j) = bob::ip::gabor::fast_atan2(imag, real);
+    }
+  } else {
+    jet(0, blitz::Range::all()) = blitz::abs(data);
+    jet(1, blitz::Range::all()) = blitz::arg(data);
+  }
+}
+
 bob::ip::gabor::Jet::Jet(
   int length
 ):
@@ -34,8 +49,7 @@ bob::ip::gabor::Jet::Jet(
   }
 
   blitz::Array<std::complex<double>,1> data = trafo_image(blitz::Range::all(), position[0], position[1]);
-  m_jet(0, blitz::Range::all()) = blitz::abs(data);
-  m_jet(1, blitz::Range::all()) = blitz::arg(data);
+  split(data, m_jet);
 
   if (normalize)
     this->normalize();
@@ -47,8 +61,7 @@ bob::ip::gabor::Jet::Jet(
 ):
   m_jet(2, data.extent(0))
 {
-  m_jet(0, blitz::Range::all()) = blitz::abs(data);
-  m_jet(1, blitz::Range::all()) = blitz::arg(data);
+  split(data, m_jet);
 
   if (normalize)
     this->normalize();
@@ -93,8 +106,7 @@ void bob::ip::gabor::Jet::init(
   bool normalize
 ){
   m_jet.resize(2, data.extent(0));
-  m_jet(0, blitz::Range::all()) = blitz::abs(data);
-  m_jet(1, blitz::Range::all()) = blitz::arg(data);
+  split(data, m_jet);
 
   if (normalize)
     this->normalize();
@@ -123,6 +135,13 @@ bool bob::ip::gabor::Jet::operator == (
 }
 
 const blitz::Array<std::complex<double>,1> bob::ip::gabor::Jet::complex() const {
+  if (fast_math()){
+    blitz::Array<std::complex<double>,1> data(length());
+    for (int j = 0; j < length(); ++j){
+      data(j) = std::complex<double>(m_jet(0,j) * fast_cos(m_jet(1,j)), m_jet(0,j) * fast_sin(m_jet(1,j)));
+    }
+    return data;
+  }
   return blitz::Array<std::complex<double>,1>(blitz::polar(this->abs(), this->phase()));
 }
 
@@ -0,0 +1,56 @@
+/**
+ * @date Sun Oct 18 00:11:58 UTC 2026
+ *
+ * @brief The C++ implementation of reading and writing of lists of Gabor jets
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/JetList.h>
+
+void bob::ip::gabor::save_jets(const blitz::Array<double,3>& jets, bob::io::base::HDF5File& file, size_t compression){
+  if (jets.extent(1) != 2)
+    throw std::runtime_error((boost::format("save_jets: the given jets must be of shape (N, 2, length), but the second dimension is %d") % jets.extent(1)).str());
+  file.setArray("Jets", jets, compression);
+}
+
+void bob::ip::gabor::save_jets(const std::vector<boost::shared_ptr<Jet>>& jets, bob::io::base::HDF5File& file, size_t compression){
+  const int length = jets.empty() ? 0 : jets.front()->length();
+  blitz::Array<double,3> block(jets.size(), 2, length);
+  for (int i = 0; i < (int)jets.size(); ++i){
+    if (jets[i]->length() != length)
+      throw std::runtime_error((boost::format("save_jets: all Gabor jets must have the same length, but jet %d has length %d instead of %d") % i % jets[i]->length() % length).str());
+    block(i, blitz::Range::all(), blitz::Range::all()) = jets[i]->jet();
+  }
+  save_jets(block, file, compression);
+}
+
+// the name of the directory of the given jet in the layout with one directory per jet, where the index is zero-padded to the number of digits of the count
+static std::string jet_name(int index, int count){
+  const std::string format = "Jet_%0" + std::to_string(std::to_string(count).size()) + "d";
+  return (boost::format(format) % (index+1)).str();
+}
+
+std::string bob::ip::gabor::jet_directory(bob::io::base::HDF5File& file, int index, int count){
+  const std::string name = jet_name(index, 100);
+  return file.hasGroup(name) ? name : jet_name(index, count);
+}
+
+blitz::Array<double,3> bob::ip::gabor::load_jets(bob::io::base::HDF5File& file){
+  if (file.contains("Jets"))
+    return file.readArray<double,3>("Jets");
+
+  // one directory per jet, where the number of jets was written as a Python integer
+  const int count = file.read<int64_t>("NumberOfJets");
+  blitz::Array<double,3> block;
+  for (int i = 0; i < count; ++i){
+    file.cd(jet_directory(file, i, count));
+    const blitz::Array<double,2> jet = file.readArray<double,2>("Jet");
+    file.cd("..");
+    if (!i) block.resize(count, 2, jet.extent(1));
+    else if (jet.extent(1) != block.extent(2))
+      throw std::runtime_error((boost::format("load_jets: all Gabor jets must have the same length, but jet %d has length %d instead of %d") % i % jet.extent(1) % block.extent(2)).str());
+    block(i, blitz::Range::all(), blitz::Range::all()) = jet;
+  }
+  return block;
+}
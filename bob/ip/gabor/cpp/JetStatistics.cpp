@@ -8,6 +8,8 @@
 
 
 #include <bob.ip.gabor/JetStatistics.h>
+#include <bob.ip.gabor/FastMath.h>
+#include <bob.ip.gabor/Parallel.h>
 
 static double sqr(const double x){return x*x;}
 
@@ -47,6 +49,19 @@ bob::ip::gabor::JetStatistics::JetStatistics(const std::vector<boost::shared_ptr
     m_varAbs(j) /= jets.size() - 1;
     m_varPhase(j) /= jets.size() - 1;
   }
+  init();
+}
+
+bob::ip::gabor::JetStatistics::JetStatistics(const blitz::Array<double,1>& meanAbs, const blitz::Array<double,1>& varAbs, const blitz::Array<double,1>& meanPhase, const blitz::Array<double,1>& varPhase, boost::shared_ptr<bob::ip::gabor::Transform> gwt)
+: m_meanAbs(meanAbs.copy()),
+  m_meanPhase(meanPhase.copy()),
+  m_varAbs(varAbs.copy()),
+  m_varPhase(varPhase.copy()),
+  m_gwt(gwt)
+{
+  if (varAbs.extent(0) != meanAbs.extent(0) || meanPhase.extent(0) != meanAbs.extent(0) || varPhase.extent(0) != meanAbs.extent(0))
+    throw std::runtime_error("The means and variances of the Gabor jet statistics must have the same length");
+  init();
 }
 
 bob::ip::gabor::JetStatistics::JetStatistics(bob::io::base::HDF5File& hdf5){
@@ -59,6 +74,13 @@ bob::ip::gabor::JetStatistics::JetStatistics(bob::io::base::HDF5File& hdf5){
     m_gwt.reset(new bob::ip::gabor::Transform(hdf5));
     hdf5.cd("..");
   }
+  init();
+}
+
+void bob::ip::gabor::JetStatistics::init(){
+  m_invVarPhase.resize(m_varPhase.extent(0));
+  for (int j = 0; j < m_varPhase.extent(0); ++j)
+    m_invVarPhase[j] = 1. / m_varPhase(j);
 }
 
 bool bob::ip::gabor::JetStatistics::operator == (const JetStatistics& other) const {
@@ -85,37 +107,81 @@ void bob::ip::gabor::JetStatistics::save(bob::io::base::HDF5File& hdf5, bool sav
   }
 }
 
+void bob::ip::gabor::JetStatistics::save(const std::vector<boost::shared_ptr<JetStatistics>>& statistics, bob::io::base::HDF5File& hdf5, bool saveTransform){
+  if (statistics.empty()) throw std::runtime_error("JetStatistics: at least one statistics is required to be saved");
+  const boost::shared_ptr<bob::ip::gabor::Transform>& gwt = statistics.front()->m_gwt;
+  const int length = statistics.front()->m_meanAbs.extent(0);
+  // the means and variances of each statistics are stored in one block
+  blitz::Array<double,3> data(statistics.size(), 4, length);
+  for (int i = 0; i < (int)statistics.size(); ++i){
+    const JetStatistics& s = *statistics[i];
+    if (s.m_meanAbs.extent(0) != length)
+      throw std::runtime_error((boost::format("JetStatistics: the statistics %d have length %d, but the first have length %d") % i % s.m_meanAbs.extent(0) % length).str());
+    if (saveTransform && s.m_gwt != gwt && !(s.m_gwt && gwt && *s.m_gwt == *gwt))
+      throw std::runtime_error((boost::format("JetStatistics: the statistics %d have a different transform than the first statistics") % i).str());
+    data(i, 0, blitz::Range::all()) = s.m_meanAbs;
+    data(i, 1, blitz::Range::all()) = s.m_varAbs;
+    data(i, 2, blitz::Range::all()) = s.m_meanPhase;
+    data(i, 3, blitz::Range::all()) = s.m_varPhase;
+  }
+  hdf5.setArray("Statistics", data);
+  if (saveTransform && gwt){
+    hdf5.createGroup("Transform");
+    hdf5.cd("Transform");
+    gwt->save(hdf5);
+    hdf5.cd("..");
+  }
+}
+
+std::vector<boost::shared_ptr<bob::ip::gabor::JetStatistics>> bob::ip::gabor::JetStatistics::load(bob::io::base::HDF5File& hdf5){
+  blitz::Array<double,3> data = hdf5.readArray<double,3>("Statistics");
+  if (data.extent(1) != 4)
+    throw std::runtime_error((boost::format("JetStatistics: the data set 'Statistics' must be of shape (N, 4, length), but the second dimension is %d") % data.extent(1)).str());
+  boost::shared_ptr<bob::ip::gabor::Transform> gwt;
+  if (hdf5.hasGroup("Transform")){
+    hdf5.cd("Transform");
+    gwt.reset(new bob::ip::gabor::Transform(hdf5));
+    hdf5.cd("..");
+  }
+  std::vector<boost::shared_ptr<JetStatistics>> statistics;
+  statistics.reserve(data.extent(0));
+  const blitz::Range all = blitz::Range::all();
+  for (int i = 0; i < data.extent(0); ++i)
+    statistics.push_back(boost::shared_ptr<JetStatistics>(new JetStatistics(data(i, 0, all), data(i, 1, all), data(i, 2, all), data(i, 3, all), gwt)));
+  return statistics;
+}
+
 blitz::TinyVector<double,2> bob::ip::gabor::JetStatistics::disparity(const boost::shared_ptr<bob::ip::gabor::Jet> jet) const{
   if (!m_gwt) throw std::runtime_error("The Gabor wavelet transform class has not been set jet");
   if (m_gwt->numberOfWavelets() != jet->length())
     throw std::runtime_error((boost::format("The given Gabor jet is of length %d, but the transform has %d wavelets; forgot to set your custom Transform") % jet->length() % m_gwt->numberOfWavelets()).str());
 
-  // compute confidences and phase differences once
-  m_confidences.resize(m_meanAbs.shape());
-  m_phaseDifferences.resize(m_meanPhase.shape());
-  m_confidences = m_meanAbs * jet->abs();
-  m_phaseDifferences = m_meanPhase - jet->phase();
+  // the confidences and phase differences are computed on the fly, so that no scratch memory is required
+  const double* abs = jet->jet().data(),* phase = abs + jet->length();
+  const double* mean_abs = m_meanAbs.data(),* mean_phase = m_meanPhase.data(),* inv_var = m_invVarPhase.data();
 
   double gamma_y_y = 0., gamma_y_x = 0., gamma_x_x = 0., phi_y = 0., phi_x = 0.;
   blitz::TinyVector<double,2> disparity(0., 0.);
-  auto kernels = m_gwt->waveletFrequencies();
+  const auto& kernels = m_gwt->waveletFrequencies();
+  const bool fast = fast_math();
 
   // iterate through the Gabor jet **backwards** (from highest scale to lowest scale)
   for (int j = jet->length()-1, scale = m_gwt->numberOfScales(); scale--;){
     for (int direction = m_gwt->numberOfDirections(); direction--; --j){
       const double kjy = kernels[j][0], kjx = kernels[j][1];
-      const double conf = m_confidences(j), diff = m_phaseDifferences(j), var = m_varPhase(j);
+      const double conf = mean_abs[j] * abs[j] * inv_var[j], diff = mean_phase[j] - phase[j];
       // totalize Gamma matrix
-      gamma_y_y += conf * kjy * kjy / var;
-      gamma_y_x += conf * kjy * kjx / var;
-      gamma_x_x += conf * kjx * kjx / var;
+      gamma_y_y += conf * kjy * kjy;
+      gamma_y_x += conf * kjy * kjx;
+      gamma_x_x += conf * kjx * kjx;
 
       // totalize phi vector
       // estimate the number of cycles that we are off (using the current estimation of the disparity
-      double n = round((diff - disparity[0] * kjy - disparity[1] * kjx) / (2.*M_PI));
+      const double cycles = (diff - disparity[0] * kjy - disparity[1] * kjx) / (2.*M_PI);
+      double n = fast ? round_nearest(cycles) : round(cycles);
       // totalize corrected phi vector elements
-      phi_y += conf * (diff - n * 2. * M_PI) * kjy / var;
-      phi_x += conf * (diff - n * 2. * M_PI) * kjx / var;
+      phi_y += conf * (diff - n * 2. * M_PI) * kjy;
+      phi_x += conf * (diff - n * 2. * M_PI) * kjx;
     }
 
     // re-calculate disparity as d=\Gamma^{-1}\Phi of the (low frequency) wavelet scales that we used up to now
@@ -139,10 +205,12 @@ double bob::ip::gabor::JetStatistics::logLikelihood(const boost::shared_ptr<bob:
     disp[1] -= offset[1] - (int)offset[1];
 
     // .. and the phase part
-    auto kernels = m_gwt->waveletFrequencies();
+    const auto& kernels = m_gwt->waveletFrequencies();
     auto abs = jet->abs(), phase = jet->phase();
+    const bool fast = fast_math();
     for (int j = jet->length(); j--;){
-      q_phase += sqr(adjust_phase(phase(j) + kernels[j][0] * disp[0] + kernels[j][1] * disp[1] - m_meanPhase(j))) / m_varPhase(j) * abs(j) / m_varAbs(j);
+      const double difference = phase(j) + kernels[j][0] * disp[0] + kernels[j][1] * disp[1] - m_meanPhase(j);
+      q_phase += sqr(fast ? wrap_phase(difference) : adjust_phase(difference)) / m_varPhase(j) * abs(j) / m_varAbs(j);
     }
 //    q_phase *= blitz::sum(m_varPhase);
     factor = 2.;
@@ -155,3 +223,239 @@ double bob::ip::gabor::JetStatistics::logLikelihood(const boost::shared_ptr<bob:
 
   return -(q_abs + q_phase)/(factor*jet->length());
 }
+
+
+// The statistics, their inverse variances and the wavelet frequencies, which are computed once for a batch of jets.
+// The computations are identical to the ones of disparity() and logLikelihood(), but they do not divide and do not allocate memory.
+struct bob::ip::gabor::JetStatistics::Model{
+  Model(const JetStatistics& statistics, bool estimate_phase, const blitz::TinyVector<double,2>& offset)
+  : length(statistics.m_meanAbs.extent(0)),
+    estimate_phase(estimate_phase),
+    fast(fast_math()),
+    offset(offset[0] - (int)offset[0], offset[1] - (int)offset[1]),
+    meanAbs(statistics.m_meanAbs.begin(), statistics.m_meanAbs.end()),
+    meanPhase(statistics.m_meanPhase.begin(), statistics.m_meanPhase.end()),
+    invVarAbs(length), weightPhase(length), ky(length), kx(length), yy(length), yx(length), xx(length)
+  {
+    for (int j = 0; j < length; ++j){
+      invVarAbs[j] = 1. / statistics.m_varAbs(j);
+    }
+    if (!estimate_phase) return;
+
+    const auto& gwt = statistics.m_gwt;
+    if (!gwt) throw std::runtime_error("The Gabor wavelet transform class has not been set jet");
+    if (gwt->numberOfWavelets() != length)
+      throw std::runtime_error((boost::format("The statistics are of length %d, but the transform has %d wavelets; forgot to set your custom Transform") % length % gwt->numberOfWavelets()).str());
+    scales = gwt->numberOfScales();
+    directions = gwt->numberOfDirections();
+    const auto& kernels = gwt->waveletFrequencies();
+    for (int j = 0; j < length; ++j){
+      const double invVarPhase = statistics.m_invVarPhase[j];
+      weightPhase[j] = invVarPhase * invVarAbs[j];
+      ky[j] = kernels[j][0] * invVarPhase;
+      kx[j] = kernels[j][1] * invVarPhase;
+      yy[j] = kernels[j][0] * ky[j];
+      yx[j] = kernels[j][0] * kx[j];
+      xx[j] = kernels[j][1] * kx[j];
+      frequencies.push_back(kernels[j]);
+    }
+  }
+
+  // computes the log likelihood of the given jet, using the given workspace of the jet length
+  double logLikelihood(const double* jet, double* confidences) const{
+    const double* abs = jet,* phase = jet + length;
+    double q_abs = 0.;
+    for (int j = 0; j < length; ++j){
+      const double diff = abs[j] - meanAbs[j];
+      q_abs += diff * diff * invVarAbs[j];
+    }
+    if (!estimate_phase)
+      return -q_abs / length;
+
+    // estimate the disparity as in disparity(), from the lowest to the highest frequencies
+    for (int j = 0; j < length; ++j){
+      confidences[j] = meanAbs[j] * abs[j];
+    }
+    double gamma_y_y = 0., gamma_y_x = 0., gamma_x_x = 0., phi_y = 0., phi_x = 0.;
+    double dy = 0., dx = 0.;
+    for (int j = length-1, scale = scales; scale--;){
+      for (int direction = directions; direction--; --j){
+        const double conf = confidences[j], diff = meanPhase[j] - phase[j];
+        gamma_y_y += conf * yy[j];
+        gamma_y_x += conf * yx[j];
+        gamma_x_x += conf * xx[j];
+        const double cycles = (diff - dy * frequencies[j][0] - dx * frequencies[j][1]) / (2.*M_PI);
+        const double n = fast ? round_nearest(cycles) : round(cycles);
+        phi_y += conf * (diff - n * 2. * M_PI) * ky[j];
+        phi_x += conf * (diff - n * 2. * M_PI) * kx[j];
+      }
+      const double gamma_det = gamma_x_x * gamma_y_y - gamma_y_x * gamma_y_x;
+      dy = (gamma_x_x * phi_y - gamma_y_x * phi_x) / gamma_det;
+      dx = (gamma_y_y * phi_x - gamma_y_x * phi_y) / gamma_det;
+    }
+    dy -= offset[0];
+    dx -= offset[1];
+
+    double q_phase = 0.;
+    for (int j = 0; j < length; ++j){
+      const double difference = phase[j] + frequencies[j][0] * dy + frequencies[j][1] * dx - meanPhase[j];
+      const double wrapped = fast ? wrap_phase(difference) : adjust_phase(difference);
+      q_phase += wrapped * wrapped * abs[j] * weightPhase[j];
+    }
+    return -(q_abs + q_phase) / (2. * length);
+  }
+
+  int length, scales = 0, directions = 0;
+  bool estimate_phase, fast;
+  blitz::TinyVector<double,2> offset;
+  std::vector<double> meanAbs, meanPhase, invVarAbs, weightPhase, ky, kx, yy, yx, xx;
+  std::vector<blitz::TinyVector<double,2>> frequencies;
+};
+
+// checks that the jets fit to the statistics and that the scores have the given shape
+template <int N>
+static void check(const blitz::Array<double,3>& jets, int length, const blitz::Array<double,N>& scores, const blitz::TinyVector<int,N>& shape){
+  bob::core::array::assertCZeroBaseContiguous(jets);
+  bob::core::array::assertSameShape(jets, blitz::shape(jets.extent(0), 2, length));
+  bob::core::array::assertCZeroBaseContiguous(scores);
+  bob::core::array::assertSameShape(scores, shape);
+}
+
+void bob::ip::gabor::JetStatistics::logLikelihoods(const blitz::Array<double,3>& jets, blitz::Array<double,1>& scores, bool estimate_phase, const blitz::TinyVector<double,2>& offset, int number_of_threads) const{
+  const Model model(*this, estimate_phase, offset);
+  check(jets, model.length, scores, blitz::shape(jets.extent(0)));
+  const double* data = jets.data();
+  double* result = scores.data();
+  parallel_for(jets.extent(0), number_of_threads, [&](int begin, int end){
+    std::vector<double> workspace(model.length);
+    for (int i = begin; i < end; ++i)
+      result[i] = model.logLikelihood(data + i * 2 * model.length, workspace.data());
+  });
+}
+
+void bob::ip::gabor::JetStatistics::logLikelihoods(const std::vector<boost::shared_ptr<JetStatistics>>& statistics, const blitz::Array<double,3>& jets, blitz::Array<double,2>& scores, bool estimate_phase, const blitz::TinyVector<double,2>& offset, int number_of_threads){
+  if (statistics.empty())
+    throw std::runtime_error("At least one JetStatistics is required to compute log likelihoods");
+  std::vector<Model> models;
+  models.reserve(statistics.size());
+  for (auto it = statistics.begin(); it != statistics.end(); ++it){
+    models.push_back(Model(**it, estimate_phase, offset));
+    if (models.back().length != models.front().length)
+      throw std::runtime_error((boost::format("The JetStatistics have different lengths %d and %d") % models.back().length % models.front().length).str());
+  }
+  check(jets, models.front().length, scores, blitz::shape(statistics.size(), jets.extent(0)));
+
+  // each thread scores its jets with all models, so that each jet is read from memory once
+  const int count = jets.extent(0), length = models.front().length;
+  const double* data = jets.data();
+  double* result = scores.data();
+  parallel_for(count, number_of_threads, [&](int begin, int end){
+    std::vector<double> workspace(length);
+    for (int i = begin; i < end; ++i)
+      for (std::size_t m = 0; m < models.size(); ++m)
+        result[m * count + i] = models[m].logLikelihood(data + i * 2 * length, workspace.data());
+  });
+}
+
+void bob::ip::gabor::JetStatistics::logLikelihoodMap(const blitz::Array<std::complex<double>,3>& trafo_image, const blitz::TinyVector<int,2>& first, const blitz::TinyVector<int,2>& last, blitz::Array<double,2>& scores, bool estimate_phase, bool normalize, int number_of_threads) const{
+  bob::core::array::assertCZeroBaseContiguous(scores);
+  bob::core::array::assertSameShape(scores, blitz::shape(last[0] - first[0] + 1, last[1] - first[1] + 1));
+  // the statistics are not modified, so that they can be referenced without being owned
+  std::vector<boost::shared_ptr<JetStatistics>> statistics(1, boost::shared_ptr<JetStatistics>(const_cast<JetStatistics*>(this), [](JetStatistics*){}));
+  std::vector<blitz::Array<double,2>> maps(1);
+  maps[0].reference(scores);
+  logLikelihoodMaps(statistics, trafo_image, std::vector<blitz::TinyVector<int,2>>(1, first), std::vector<blitz::TinyVector<int,2>>(1, last), maps, estimate_phase, normalize, number_of_threads);
+}
+
+void bob::ip::gabor::JetStatistics::logLikelihoodMaps(const std::vector<boost::shared_ptr<JetStatistics>>& statistics, const blitz::Array<std::complex<double>,3>& trafo_image, const std::vector<blitz::TinyVector<int,2>>& first, const std::vector<blitz::TinyVector<int,2>>& last, std::vector<blitz::Array<double,2>>& scores, bool estimate_phase, bool normalize, int number_of_threads){
+  if (statistics.empty())
+    throw std::runtime_error("At least one JetStatistics is required to compute log likelihood maps");
+  if (first.size() != statistics.size() || last.size() != statistics.size())
+    throw std::runtime_error((boost::format("The number of regions (%d, %d) and the number of JetStatistics (%d) differ") % first.size() % last.size() % statistics.size()).str());
+  bob::core::array::assertCZeroBaseContiguous(trafo_image);
+  const int count = statistics.size(), length = trafo_image.extent(0), height = trafo_image.extent(1), width = trafo_image.extent(2);
+
+  std::vector<Model> models;
+  models.reserve(count);
+  // the bounding box of all regions
+  blitz::TinyVector<int,2> top_left(height, width), bottom_right(-1, -1);
+  for (int m = 0; m < count; ++m){
+    models.push_back(Model(*statistics[m], estimate_phase, blitz::TinyVector<double,2>(0.,0.)));
+    if (models.back().length != length)
+      throw std::runtime_error((boost::format("The transformed image has %d layers, but the statistics are of length %d") % length % models.back().length).str());
+    if (first[m][0] < 0 || first[m][1] < 0 || last[m][0] >= height || last[m][1] >= width || first[m][0] > last[m][0] || first[m][1] > last[m][1])
+      throw std::runtime_error((boost::format("The region [(%d, %d), (%d, %d)] is not inside the transformed image of size (%d, %d)") % first[m][0] % first[m][1] % last[m][0] % last[m][1] % height % width).str());
+    for (int d = 0; d < 2; ++d){
+      top_left[d] = std::min(top_left[d], first[m][d]);
+      bottom_right[d] = std::max(bottom_right[d], last[m][d]);
+    }
+  }
+  // already allocated maps of the correct shape are filled in place
+  scores.resize(count);
+  std::vector<double*> results(count);
+  for (int m = 0; m < count; ++m){
+    const blitz::TinyVector<int,2> shape(last[m][0] - first[m][0] + 1, last[m][1] - first[m][1] + 1);
+    if (scores[m].extent(0) != shape[0] || scores[m].extent(1) != shape[1] || !scores[m].isStorageContiguous())
+      scores[m].resize(shape);
+    results[m] = scores[m].data();
+  }
+
+  const std::complex<double>* image = trafo_image.data();
+  const bool fast = fast_math();
+  parallel_for(bottom_right[0] - top_left[0] + 1, number_of_threads, [&](int begin, int end){
+    std::vector<double> jets, workspace(length);
+    for (int y = top_left[0] + begin; y < top_left[0] + end; ++y){
+      // the columns of all regions that contain this row
+      int left = width, right = -1;
+      for (int m = 0; m < count; ++m){
+        if (first[m][0] <= y && y <= last[m][0]){
+          left = std::min(left, first[m][1]);
+          right = std::max(right, last[m][1]);
+        }
+      }
+      if (right < left) continue;
+
+      // extract the jets of these columns once, layer by layer, so that the transformed image is read sequentially
+      const int columns = right - left + 1;
+      jets.resize(columns * 2 * length);
+      for (int j = 0; j < length; ++j){
+        const std::complex<double>* layer = image + ((long)j * height + y) * width + left;
+        double* abs = jets.data() + j,* phase = abs + length;
+        if (fast){
+          for (int c = 0; c < columns; ++c){
+            const double real = layer[c].real(), imag = layer[c].imag();
+            abs[c * 2 * length] = std::sqrt(real * real + imag * imag);
+            phase[c * 2 * length] = fast_atan2(imag, real);
+          }
+        } else {
+          for (int c = 0; c < columns; ++c){
+            abs[c * 2 * length] = std::abs(layer[c]);
+            phase[c * 2 * length] = std::arg(layer[c]);
+          }
+        }
+      }
+      if (normalize){
+        for (int c = 0; c < columns; ++c){
+          // same as Jet::normalize
+          double* jet = jets.data() + c * 2 * length;
+          double norm = 0.;
+          for (int j = 0; j < length; ++j) norm += jet[j] * jet[j];
+          if (std::abs(norm - 1.) > 1e-8){
+            const double factor = sqrt(norm);
+            for (int j = 0; j < length; ++j) jet[j] /= factor;
+          }
+        }
+      }
+
+      // score the jets with all statistics, whose regions contain them
+      for (int m = 0; m < count; ++m){
+        if (y < first[m][0] || y > last[m][0]) continue;
+        const int columns_m = last[m][1] - first[m][1] + 1;
+        double* result = results[m] + (y - first[m][0]) * columns_m;
+        const double* jet = jets.data() + (first[m][1] - left) * 2 * length;
+        for (int c = 0; c < columns_m; ++c, jet += 2 * length)
+          result[c] = models[m].logLikelihood(jet, workspace.data());
+      }
+    }
+  });
+}
@@ -0,0 +1,214 @@
+/**
+ * @date Sat Oct 17 23:46:00 UTC 2026
+ *
+ * @brief The C++ implementation of the incremental computation of Gabor jet statistics
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/JetStatisticsBuilder.h>
+#include <bob.ip.gabor/FastMath.h>
+#include <bob.core/assert.h>
+
+static double sqr(const double x){return x*x;}
+
+const int bob::ip::gabor::JetStatisticsBuilder::PHASE_MOMENTS;
+
+bob::ip::gabor::JetStatisticsBuilder::JetStatisticsBuilder()
+: m_count(0),
+  m_length(0)
+{
+}
+
+bob::ip::gabor::JetStatisticsBuilder::JetStatisticsBuilder(bob::io::base::HDF5File& hdf5)
+: m_count(hdf5.read<int64_t>("Count")),
+  m_length(hdf5.read<int>("Length"))
+{
+  if (!m_count) return;
+  auto read = [&hdf5, this](const char* name, std::vector<double>& values){
+    blitz::Array<double,1> data = hdf5.readArray<double,1>(name);
+    if (data.extent(0) != m_length)
+      throw std::runtime_error((boost::format("JetStatisticsBuilder: the data set '%s' has %d elements, but %d are expected") % name % data.extent(0) % m_length).str());
+    values.assign(data.begin(), data.end());
+  };
+  read("MeanAbs", m_meanAbs);
+  read("M2Abs", m_m2Abs);
+  read("SumReal", m_sumReal);
+  read("SumImag", m_sumImag);
+  read("ReferencePhase", m_reference);
+  read("MeanPhaseDifference", m_meanDifference);
+  read("M2PhaseDifference", m_m2Difference);
+  read("MinPhaseDifference", m_minDifference);
+  read("MaxPhaseDifference", m_maxDifference);
+  blitz::Array<std::complex<double>,2> moments = hdf5.readArray<std::complex<double>,2>("PhaseMoments");
+  if (moments.extent(0) != m_length || moments.extent(1) != PHASE_MOMENTS)
+    throw std::runtime_error((boost::format("JetStatisticsBuilder: the data set 'PhaseMoments' has shape (%d, %d), but (%d, %d) is expected") % moments.extent(0) % moments.extent(1) % m_length % PHASE_MOMENTS).str());
+  m_moments.assign(moments.begin(), moments.end());
+}
+
+void bob::ip::gabor::JetStatisticsBuilder::add(const double* abs, const double* phase){
+  if (!m_count){
+    // the first jet defines the length and the reference phases
+    m_meanAbs.assign(m_length, 0.);
+    m_m2Abs.assign(m_length, 0.);
+    m_sumReal.assign(m_length, 0.);
+    m_sumImag.assign(m_length, 0.);
+    m_reference.assign(phase, phase + m_length);
+    m_meanDifference.assign(m_length, 0.);
+    m_m2Difference.assign(m_length, 0.);
+    m_minDifference.assign(m_length, 0.);
+    m_maxDifference.assign(m_length, 0.);
+    m_moments.assign(m_length * PHASE_MOMENTS, 0.);
+  }
+  const double weight = 1. / ++m_count;
+  const bool fast = fast_math();
+  double* mean_abs = m_meanAbs.data(),* m2_abs = m_m2Abs.data(),* real = m_sumReal.data(),* imag = m_sumImag.data();
+  double* mean_diff = m_meanDifference.data(),* m2_diff = m_m2Difference.data(),* min_diff = m_minDifference.data(),* max_diff = m_maxDifference.data();
+  const double* reference = m_reference.data();
+  for (int j = 0; j < m_length; ++j){
+    const double delta = abs[j] - mean_abs[j];
+    mean_abs[j] += delta * weight;
+    m2_abs[j] += delta * (abs[j] - mean_abs[j]);
+
+    const double c = fast ? fast_cos(phase[j]) : std::cos(phase[j]), s = fast ? fast_sin(phase[j]) : std::sin(phase[j]);
+    real[j] += abs[j] * c;
+    imag[j] += abs[j] * s;
+
+    const double difference = fast ? wrap_phase(phase[j] - reference[j]) : JetStatistics::adjust_phase(phase[j] - reference[j]);
+    const double delta_diff = difference - mean_diff[j];
+    mean_diff[j] += delta_diff * weight;
+    m2_diff[j] += delta_diff * (difference - mean_diff[j]);
+    min_diff[j] = std::min(min_diff[j], difference);
+    max_diff[j] = std::max(max_diff[j], difference);
+
+    // the powers of exp(i*phase) are computed by complex multiplication, written out to avoid the special value handling of std::complex
+    double* moments = reinterpret_cast<double*>(m_moments.data() + j * PHASE_MOMENTS);
+    double power_c = c, power_s = s;
+    for (int k = 0; k < PHASE_MOMENTS; ++k){
+      moments[2*k] += power_c;
+      moments[2*k+1] += power_s;
+      const double next_c = power_c * c - power_s * s;
+      power_s = power_c * s + power_s * c;
+      power_c = next_c;
+    }
+  }
+}
+
+void bob::ip::gabor::JetStatisticsBuilder::add(const Jet& jet){
+  if (!m_count) m_length = jet.length();
+  else if (jet.length() != m_length)
+    throw std::runtime_error((boost::format("JetStatisticsBuilder: the given Gabor jet has length %d, but the previous jets have length %d") % jet.length() % m_length).str());
+  const double* data = jet.jet().data();
+  add(data, data + m_length);
+}
+
+void bob::ip::gabor::JetStatisticsBuilder::add(const blitz::Array<double,3>& jets){
+  if (!jets.extent(0)) return;
+  if (jets.extent(1) != 2)
+    throw std::runtime_error((boost::format("JetStatisticsBuilder: the given jets must be of shape (N, 2, length), but the second dimension is %d") % jets.extent(1)).str());
+  if (!m_count) m_length = jets.extent(2);
+  else if (jets.extent(2) != m_length)
+    throw std::runtime_error((boost::format("JetStatisticsBuilder: the given Gabor jets have length %d, but the previous jets have length %d") % jets.extent(2) % m_length).str());
+
+  bob::core::array::assertCZeroBaseContiguous(jets);
+  const double* data = jets.data();
+  for (int i = 0; i < jets.extent(0); ++i, data += 2 * m_length)
+    add(data, data + m_length);
+}
+
+void bob::ip::gabor::JetStatisticsBuilder::merge(const JetStatisticsBuilder& other){
+  if (!other.m_count) return;
+  if (!m_count){
+    *this = other;
+    return;
+  }
+  if (other.m_length != m_length)
+    throw std::runtime_error((boost::format("JetStatisticsBuilder: cannot merge statistics of Gabor jets with length %d into statistics of length %d") % other.m_length % m_length).str());
+
+  // combine the means and the sums of squared deviations of both parts (Chan et al.)
+  const double count = m_count + other.m_count, factor = (double)m_count * other.m_count / count, weight = other.m_count / count;
+  const bool fast = fast_math();
+  for (int j = 0; j < m_length; ++j){
+    const double delta = other.m_meanAbs[j] - m_meanAbs[j];
+    m_meanAbs[j] += delta * weight;
+    m_m2Abs[j] += other.m_m2Abs[j] + delta * delta * factor;
+
+    m_sumReal[j] += other.m_sumReal[j];
+    m_sumImag[j] += other.m_sumImag[j];
+
+    // the phase differences of the other part are shifted to our reference phases
+    const double shift = fast ? wrap_phase(other.m_reference[j] - m_reference[j]) : JetStatistics::adjust_phase(other.m_reference[j] - m_reference[j]);
+    const double delta_diff = other.m_meanDifference[j] + shift - m_meanDifference[j];
+    m_meanDifference[j] += delta_diff * weight;
+    m_m2Difference[j] += other.m_m2Difference[j] + delta_diff * delta_diff * factor;
+    m_minDifference[j] = std::min(m_minDifference[j], other.m_minDifference[j] + shift);
+    m_maxDifference[j] = std::max(m_maxDifference[j], other.m_maxDifference[j] + shift);
+  }
+  for (std::size_t i = 0; i < m_moments.size(); ++i)
+    m_moments[i] += other.m_moments[i];
+  m_count += other.m_count;
+}
+
+void bob::ip::gabor::JetStatisticsBuilder::clear(){
+  m_count = 0;
+  m_length = 0;
+  m_meanAbs.clear();
+  m_m2Abs.clear();
+  m_sumReal.clear();
+  m_sumImag.clear();
+  m_reference.clear();
+  m_meanDifference.clear();
+  m_m2Difference.clear();
+  m_minDifference.clear();
+  m_maxDifference.clear();
+  m_moments.clear();
+}
+
+boost::shared_ptr<bob::ip::gabor::JetStatistics> bob::ip::gabor::JetStatisticsBuilder::finalize(boost::shared_ptr<bob::ip::gabor::Transform> gwt) const{
+  if (m_count < 2)
+    throw std::runtime_error((boost::format("JetStatisticsBuilder: at least two Gabor jets are required to compute statistics, but %d have been added") % m_count).str());
+
+  blitz::Array<double,1> mean_abs(m_length), var_abs(m_length), mean_phase(m_length), var_phase(m_length);
+  const bool fast = fast_math();
+  for (int j = 0; j < m_length; ++j){
+    mean_abs(j) = m_meanAbs[j];
+    var_abs(j) = m_m2Abs[j] / (m_count - 1);
+    mean_phase(j) = fast ? fast_atan2(m_sumImag[j], m_sumReal[j]) : std::atan2(m_sumImag[j], m_sumReal[j]);
+
+    const double shift = mean_phase(j) - m_reference[j];
+    const double offset = fast ? wrap_phase(shift) : JetStatistics::adjust_phase(shift);
+    if (m_minDifference[j] - offset >= -M_PI && m_maxDifference[j] - offset <= M_PI){
+      // all differences to the mean phase are within pi, so that wrapping them around the mean phase does not change them:
+      // their squares are the squared differences to the mean difference, plus the squared offset of the mean phase
+      var_phase(j) = (m_m2Difference[j] + m_count * sqr(m_meanDifference[j] - offset)) / (m_count - 1);
+    } else {
+      // the truncated Fourier series adjust_phase(x)^2 = pi^2/3 + sum_k 4 (-1)^k cos(k x) / k^2, evaluated at x = phase - mean_phase for all jets at once
+      const std::complex<double> rotation = std::polar(1., -mean_phase(j));
+      std::complex<double> power = rotation;
+      double sum = m_count * M_PI * M_PI / 3.;
+      for (int k = 1; k <= PHASE_MOMENTS; ++k, power *= rotation)
+        sum += (k % 2 ? -4. : 4.) / (k * k) * (power * m_moments[j * PHASE_MOMENTS + k - 1]).real();
+      var_phase(j) = std::max(sum, 0.) / (m_count - 1);
+    }
+  }
+  return boost::shared_ptr<JetStatistics>(new JetStatistics(mean_abs, var_abs, mean_phase, var_phase, gwt));
+}
+
+void bob::ip::gabor::JetStatisticsBuilder::save(bob::io::base::HDF5File& hdf5) const{
+  hdf5.set("Count", (int64_t)m_count);
+  hdf5.set("Length", m_length);
+  if (!m_count) return;
+  auto write = [&hdf5](const char* name, const std::vector<double>& values){
+    hdf5.setArray(name, blitz::Array<double,1>(const_cast<double*>(values.data()), blitz::shape(values.size()), blitz::neverDeleteData));
+  };
+  write("MeanAbs", m_meanAbs);
+  write("M2Abs", m_m2Abs);
+  write("SumReal", m_sumReal);
+  write("SumImag", m_sumImag);
+  write("ReferencePhase", m_reference);
+  write("MeanPhaseDifference", m_meanDifference);
+  write("M2PhaseDifference", m_m2Difference);
+  write("MinPhaseDifference", m_minDifference);
+  write("MaxPhaseDifference", m_maxDifference);
+  hdf5.setArray("PhaseMoments", blitz::Array<std::complex<double>,2>(const_cast<std::complex<double>*>(m_moments.data()), blitz::shape(m_length, PHASE_MOMENTS), blitz::neverDeleteData));
+}
@@ -0,0 +1,225 @@
+/**
+ * @date Sun Oct 18 00:28:40 UTC 2026
+ *
+ * @brief The C++ implementation of the batch-wise reading of lists of Gabor jets
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <hdf5.h>
+
+#include <bob.ip.gabor/JetStream.h>
+
+// Reads batches of jets from the file. The data set "Jets" is accessed through the HDF5 C API, so that each batch is read with a single H5Dread of a hyperslab;
+// the directories with one jet each are read through bob::io::base::HDF5File.
+struct bob::ip::gabor::JetStream::Reader{
+  Reader(const JetStream& stream)
+  : stream(stream),
+    file(-1),
+    data(-1),
+    space(-1)
+  {
+    if (!stream.m_single_data_set){
+      hdf5.reset(new bob::io::base::HDF5File(stream.m_filename, 'r'));
+      return;
+    }
+    file = H5Fopen(stream.m_filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file >= 0) data = H5Dopen2(file, "/Jets", H5P_DEFAULT);
+    if (data >= 0) space = H5Dget_space(data);
+    if (space < 0){
+      close();
+      throw std::runtime_error((boost::format("JetStream: could not open the data set 'Jets' of file '%s'") % stream.m_filename).str());
+    }
+    // data sets that are written with compression have an additional, expandable first dimension of size 1
+    rank = H5Sget_simple_extent_ndims(space);
+    if (rank != 3 && rank != 4){
+      close();
+      throw std::runtime_error((boost::format("JetStream: the data set 'Jets' of file '%s' has %d dimensions") % stream.m_filename % rank).str());
+    }
+  }
+
+  ~Reader(){close();}
+
+  void close(){
+    if (space >= 0) H5Sclose(space);
+    if (data >= 0) H5Dclose(data);
+    if (file >= 0) H5Fclose(file);
+    space = data = file = -1;
+  }
+
+  // reads the jets starting at the given index into the given batch
+  void read(int first, blitz::Array<double,3>& batch){
+    const int count = batch.extent(0), length = stream.m_length;
+    if (stream.m_single_data_set){
+      const int offset = rank - 3;
+      hsize_t start[4] = {0, 0, 0, 0}, shape[4] = {1, 1, 1, 1};
+      start[offset] = first;
+      shape[offset] = count;
+      shape[offset + 1] = 2;
+      shape[offset + 2] = length;
+      hid_t memory = H5Screate_simple(rank, shape, 0);
+      herr_t status = memory < 0 ? -1 : H5Sselect_hyperslab(space, H5S_SELECT_SET, start, 0, shape, 0);
+      if (status >= 0) status = H5Dread(data, H5T_NATIVE_DOUBLE, memory, space, H5P_DEFAULT, batch.data());
+      if (memory >= 0) H5Sclose(memory);
+      if (status < 0)
+        throw std::runtime_error((boost::format("JetStream: could not read the jets %d to %d of file '%s'") % first % (first + count - 1) % stream.m_filename).str());
+      return;
+    }
+
+    for (int i = 0; i < count; ++i){
+      hdf5->cd(jet_directory(*hdf5, first + i, stream.m_size));
+      blitz::Array<double,2> jet = hdf5->readArray<double,2>("Jet");
+      hdf5->cd("..");
+      if (jet.extent(0) != 2 || jet.extent(1) != length)
+        throw std::runtime_error((boost::format("JetStream: all Gabor jets must have the same length, but jet %d of file '%s' has length %d instead of %d") % (first + i) % stream.m_filename % jet.extent(1) % length).str());
+      batch(i, blitz::Range::all(), blitz::Range::all()) = jet;
+    }
+  }
+
+  const JetStream& stream;
+  boost::shared_ptr<bob::io::base::HDF5File> hdf5;
+  hid_t file, data, space;
+  int rank;
+};
+
+bob::ip::gabor::JetStream::JetStream(const std::string& filename, int batch_size, int read_ahead)
+: m_filename(filename),
+  m_batch_size(batch_size),
+  m_read_ahead(read_ahead),
+  m_length(0),
+  m_position(0),
+  m_stopped(true),
+  m_finished(false)
+{
+  if (batch_size < 1)
+    throw std::runtime_error((boost::format("JetStream: the batch size must be positive, but it is %d") % batch_size).str());
+  if (read_ahead < 1)
+    throw std::runtime_error((boost::format("JetStream: at least one batch must be read ahead, but %d are requested") % read_ahead).str());
+
+  // a background thread may only access files when the HDF5 library is thread-safe
+  hbool_t thread_safe = 0;
+  m_background = H5is_library_threadsafe(&thread_safe) >= 0 && thread_safe;
+
+  // read the number and the length of the jets; the file is closed before it is opened for reading the batches
+  {
+    bob::io::base::HDF5File file(filename, 'r');
+    m_single_data_set = file.contains("Jets");
+    if (m_single_data_set){
+      const bob::io::base::HDF5Shape shape = file.describe("Jets")[0].type.shape();
+      if (shape.n() != 3 || shape[1] != 2)
+        throw std::runtime_error((boost::format("JetStream: the data set 'Jets' in file '%s' must be of shape (N, 2, length)") % filename).str());
+      m_size = shape[0];
+      m_length = shape[2];
+    } else {
+      m_size = file.read<int64_t>("NumberOfJets");
+      if (m_size){
+        file.cd(jet_directory(file, 0, m_size));
+        m_length = file.readArray<double,2>("Jet").extent(1);
+        file.cd("..");
+      }
+    }
+  }
+
+  start();
+}
+
+bob::ip::gabor::JetStream::~JetStream(){
+  stop();
+}
+
+void bob::ip::gabor::JetStream::start(){
+  m_batches.clear();
+  m_position = 0;
+  m_stopped = false;
+  m_finished = false;
+  m_error = std::exception_ptr();
+  if (m_background)
+    m_reader = std::thread(&JetStream::read, this);
+  else
+    m_synchronous.reset(new Reader(*this));
+}
+
+void bob::ip::gabor::JetStream::stop(){
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopped = true;
+  }
+  m_changed.notify_all();
+  if (m_reader.joinable()) m_reader.join();
+  m_synchronous.reset();
+}
+
+void bob::ip::gabor::JetStream::reset(){
+  stop();
+  start();
+}
+
+// The reference counts of blitz arrays are not thread-safe; hence, the batches are handed over between the threads only while the mutex is locked.
+void bob::ip::gabor::JetStream::read(){
+  try {
+    Reader reader(*this);
+    for (int first = 0; first < m_size; first += m_batch_size){
+      {
+        // wait until the batch fits into the read-ahead buffer
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_changed.wait(lock, [this](){return m_stopped || (int)m_batches.size() < m_read_ahead;});
+        if (m_stopped) return;
+      }
+
+      blitz::Array<double,3> batch(std::min(m_batch_size, m_size - first), 2, m_length);
+      reader.read(first, batch);
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_batches.push_back(batch);
+      batch.reference(blitz::Array<double,3>());
+      m_changed.notify_all();
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_error = std::current_exception();
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_finished = true;
+  m_changed.notify_all();
+}
+
+bool bob::ip::gabor::JetStream::next(blitz::Array<double,3>& batch){
+  if (!m_background){
+    if (m_position >= m_size) return false;
+    // the previous batch might still be in use, so a new one is allocated
+    batch.reference(blitz::Array<double,3>(std::min(m_batch_size, m_size - m_position), 2, m_length));
+    m_synchronous->read(m_position, batch);
+    m_position += batch.extent(0);
+    return true;
+  }
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_changed.wait(lock, [this](){return m_finished || !m_batches.empty();});
+  if (m_batches.empty()){
+    // all batches that were read before an error are returned first
+    if (m_error) std::rethrow_exception(m_error);
+    return false;
+  }
+  batch.reference(m_batches.front());
+  m_batches.pop_front();
+  m_position += batch.extent(0);
+  m_changed.notify_all();
+  return true;
+}
+
+void bob::ip::gabor::JetStream::similarities(const Similarity& similarity, const std::vector<boost::shared_ptr<Jet>>& probes, blitz::Array<double,2>& scores, int number_of_threads){
+  bob::core::array::assertSameShape(scores, blitz::shape(probes.size(), m_size));
+
+  reset();
+  blitz::Array<double,3> batch;
+  blitz::Array<double,1> batch_scores;
+  while (next(batch)){
+    // with a background thread, the next batch is read while the scores of this batch are computed
+    const int first = m_position - batch.extent(0);
+    batch_scores.resize(batch.extent(0));
+    for (int p = 0; p < (int)probes.size(); ++p){
+      similarity.similarities(*probes[p], batch, batch_scores, number_of_threads);
+      scores(p, blitz::Range(first, m_position - 1)) = batch_scores;
+    }
+  }
+}
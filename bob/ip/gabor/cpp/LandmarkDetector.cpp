@@ -0,0 +1,83 @@
+/**
+ * @date Sun Oct 18 00:02:42 UTC 2026
+ *
+ * @brief The C++ implementation of the localization of several landmarks
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <bob.ip.gabor/LandmarkDetector.h>
+
+bob::ip::gabor::LandmarkDetector::LandmarkDetector(boost::shared_ptr<Transform> gwt, const std::vector<boost::shared_ptr<JetStatistics>>& statistics)
+: m_gwt(gwt)
+{
+  if (!m_gwt) throw std::runtime_error("LandmarkDetector: the Gabor wavelet transform class must be given");
+  if (statistics.empty()) throw std::runtime_error("LandmarkDetector: at least one landmark is required");
+  for (auto it = statistics.begin(); it != statistics.end(); ++it){
+    if ((*it)->meanAbs().extent(0) != m_gwt->numberOfWavelets())
+      throw std::runtime_error((boost::format("LandmarkDetector: the statistics of landmark %d are of length %d, but the transform has %d wavelets") % (it - statistics.begin()) % (*it)->meanAbs().extent(0) % m_gwt->numberOfWavelets()).str());
+    m_statistics.push_back(boost::shared_ptr<JetStatistics>(new JetStatistics(**it)));
+    m_statistics.back()->gwt(m_gwt);
+  }
+}
+
+bob::ip::gabor::LandmarkDetector::LandmarkDetector(bob::io::base::HDF5File& hdf5){
+  hdf5.cd("Transform");
+  m_gwt.reset(new Transform(hdf5));
+  hdf5.cd("..");
+  const int count = hdf5.read<int>("NumberOfLandmarks");
+  for (int i = 0; i < count; ++i){
+    hdf5.cd((boost::format("Landmark%d") % i).str());
+    m_statistics.push_back(boost::shared_ptr<JetStatistics>(new JetStatistics(hdf5)));
+    m_statistics.back()->gwt(m_gwt);
+    hdf5.cd("..");
+  }
+}
+
+void bob::ip::gabor::LandmarkDetector::save(bob::io::base::HDF5File& hdf5) const{
+  hdf5.createGroup("Transform");
+  hdf5.cd("Transform");
+  m_gwt->save(hdf5);
+  hdf5.cd("..");
+  hdf5.set("NumberOfLandmarks", (int)m_statistics.size());
+  for (std::size_t i = 0; i < m_statistics.size(); ++i){
+    const std::string group = (boost::format("Landmark%d") % i).str();
+    hdf5.createGroup(group);
+    hdf5.cd(group);
+    // the transform is stored only once
+    m_statistics[i]->save(hdf5, false);
+    hdf5.cd("..");
+  }
+}
+
+void bob::ip::gabor::LandmarkDetector::detect(const blitz::Array<std::complex<double>,3>& trafo_image, const std::vector<blitz::TinyVector<int,2>>& first, const std::vector<blitz::TinyVector<int,2>>& last, blitz::Array<double,2>& positions, blitz::Array<double,1>& scores, bool estimate_phase, int number_of_threads) const{
+  const int count = m_statistics.size();
+  bob::core::array::assertSameShape(positions, blitz::shape(count, 2));
+  bob::core::array::assertSameShape(scores, blitz::shape(count));
+
+  // compute the log likelihood maps of all landmarks, sharing the extracted Gabor jets
+  std::vector<blitz::Array<double,2>> maps;
+  JetStatistics::logLikelihoodMaps(m_statistics, trafo_image, first, last, maps, estimate_phase, true, number_of_threads);
+
+  Jet jet(m_gwt->numberOfWavelets());
+  boost::shared_ptr<Jet> jet_ptr(&jet, [](Jet*){});
+  for (int i = 0; i < count; ++i){
+    // the first position with the highest score
+    const blitz::Array<double,2>& map = maps[i];
+    blitz::TinyVector<int,2> best(0, 0);
+    for (int y = 0; y < map.extent(0); ++y)
+      for (int x = 0; x < map.extent(1); ++x)
+        if (map(y,x) > map(best[0], best[1]))
+          best = blitz::TinyVector<int,2>(y, x);
+    scores(i) = map(best[0], best[1]);
+
+    // refine the position with the disparity of the jet, which points to the estimated landmark position
+    best[0] += first[i][0];
+    best[1] += first[i][1];
+    jet.extract(trafo_image, best, true);
+    const blitz::TinyVector<double,2> disparity = m_statistics[i]->disparity(jet_ptr);
+    const bool valid = std::abs(disparity[0]) < 1. && std::abs(disparity[1]) < 1.;
+    positions(i, 0) = best[0] + (valid ? disparity[0] : 0.);
+    positions(i, 1) = best[1] + (valid ? disparity[1] : 0.);
+  }
+}
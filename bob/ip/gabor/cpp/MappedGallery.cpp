@@ -0,0 +1,174 @@
+/**
+ * @date Sun Oct 18 00:19:09 UTC 2026
+ *
+ * @brief The C++ implementation of the memory-mapped binary gallery
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <bob.ip.gabor/MappedGallery.h>
+#include <bob.ip.gabor/FixedPointSimilarity.h>
+
+// the first multiple of the alignment that is not smaller than the given offset
+static uint64_t align(uint64_t offset){
+  const uint64_t alignment = bob::ip::gabor::gallery_file::ALIGNMENT;
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+// writes the given values, followed by zeros up to the given offset
+static void write_block(std::ofstream& file, const void* data, uint64_t bytes, uint64_t next_offset){
+  file.write(static_cast<const char*>(data), bytes);
+  const std::vector<char> padding(next_offset - (uint64_t)file.tellp(), 0);
+  file.write(padding.data(), padding.size());
+}
+
+void bob::ip::gabor::MappedGallery::write(const std::string& filename, const blitz::Array<double,4>& graphs, const std::vector<int64_t>& ids, const std::vector<blitz::TinyVector<int,2>>& nodes, bool quantize){
+  bob::core::array::assertCZeroBaseContiguous(graphs);
+  const int64_t count = graphs.extent(0);
+  const int number_of_nodes = graphs.extent(1), length = graphs.extent(3);
+  if (graphs.extent(2) != 2)
+    throw std::runtime_error((boost::format("MappedGallery: the graphs must be of shape (N, nodes, 2, length), but the third dimension is %d") % graphs.extent(2)).str());
+  if (!ids.empty() && (int64_t)ids.size() != count)
+    throw std::runtime_error((boost::format("MappedGallery: %d ids are given for %d graphs") % ids.size() % count).str());
+  if (!nodes.empty() && (int)nodes.size() != number_of_nodes)
+    throw std::runtime_error((boost::format("MappedGallery: %d node positions are given for graphs with %d nodes") % nodes.size() % number_of_nodes).str());
+
+  std::vector<int64_t> all_ids(ids);
+  for (int64_t i = ids.size(); i < count; ++i)
+    all_ids.push_back(i);
+  std::vector<int32_t> positions;
+  for (auto it = nodes.begin(); it != nodes.end(); ++it){
+    positions.push_back((*it)[0]);
+    positions.push_back((*it)[1]);
+  }
+  const uint64_t values = count * number_of_nodes * 2 * length;
+
+  // compute the layout of the file
+  gallery_file::Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, gallery_file::MAGIC, sizeof(header.magic));
+  header.byte_order = gallery_file::BYTE_ORDER_MARK;
+  header.version = gallery_file::VERSION;
+  header.header_size = sizeof(header);
+  header.count = count;
+  header.number_of_nodes = number_of_nodes;
+  header.length = length;
+  uint64_t offset = header.ids_offset = align(sizeof(header));
+  offset += count * sizeof(int64_t);
+  if (!nodes.empty()){
+    offset = header.nodes_offset = align(offset);
+    offset += positions.size() * sizeof(int32_t);
+  }
+  offset = header.jets_offset = align(offset);
+  offset += values * sizeof(double);
+  if (quantize){
+    offset = header.quantized_offset = align(offset);
+    offset += values * sizeof(uint16_t);
+  }
+  header.file_size = offset;
+
+  std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+  if (!file)
+    throw std::runtime_error((boost::format("MappedGallery: could not open '%s' for writing") % filename).str());
+  write_block(file, &header, sizeof(header), header.ids_offset);
+  write_block(file, all_ids.data(), count * sizeof(int64_t), nodes.empty() ? header.jets_offset : header.nodes_offset);
+  if (!nodes.empty())
+    write_block(file, positions.data(), positions.size() * sizeof(int32_t), header.jets_offset);
+  write_block(file, graphs.data(), values * sizeof(double), quantize ? header.quantized_offset : header.file_size);
+  if (quantize){
+    const blitz::Array<double,3> jets(const_cast<double*>(graphs.data()), blitz::shape(count * number_of_nodes, 2, length), blitz::neverDeleteData);
+    blitz::Array<uint16_t,3> quantized(count * number_of_nodes, 2, length);
+    FixedPointSimilarity::quantize(jets, quantized);
+    write_block(file, quantized.data(), values * sizeof(uint16_t), header.file_size);
+  }
+  file.close();
+  if (!file)
+    throw std::runtime_error((boost::format("MappedGallery: could not write '%s'") % filename).str());
+}
+
+bob::ip::gabor::MappedGallery::MappedGallery(const std::string& filename)
+: m_filename(filename),
+  m_data(MAP_FAILED),
+  m_size(0),
+  m_header(0)
+{
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error((boost::format("MappedGallery: could not open '%s': %s") % filename % std::strerror(errno)).str());
+  struct stat status;
+  if (fstat(fd, &status) < 0){
+    const int error = errno;
+    close(fd);
+    throw std::runtime_error((boost::format("MappedGallery: could not read the size of '%s': %s") % filename % std::strerror(error)).str());
+  }
+  m_size = status.st_size;
+  if (m_size < sizeof(gallery_file::Header)){
+    close(fd);
+    throw std::runtime_error((boost::format("MappedGallery: the file '%s' is too small to be a gallery file") % filename).str());
+  }
+  m_data = mmap(0, m_size, PROT_READ, MAP_SHARED, fd, 0);
+  const int error = errno;
+  // the mapping stays valid after closing the file
+  close(fd);
+  if (m_data == MAP_FAILED)
+    throw std::runtime_error((boost::format("MappedGallery: could not map '%s' into memory: %s") % filename % std::strerror(error)).str());
+
+  // check the header; the destructor is not called when the constructor throws, so the file is unmapped here
+  m_header = static_cast<const gallery_file::Header*>(m_data);
+  const gallery_file::Header& header = *m_header;
+  const uint64_t values = (uint64_t)header.count * header.number_of_nodes * 2 * header.length;
+  auto fits = [&](uint64_t offset, uint64_t bytes){
+    return offset % gallery_file::ALIGNMENT == 0 && offset >= header.header_size && offset <= m_size && bytes <= m_size - offset;
+  };
+  std::string problem;
+  if (std::memcmp(header.magic, gallery_file::MAGIC, sizeof(header.magic)))
+    problem = "it is not a gallery file";
+  else if (header.byte_order != gallery_file::BYTE_ORDER_MARK)
+    problem = "it was written on a machine with a different byte order";
+  else if (header.version < 1 || header.version > gallery_file::VERSION)
+    problem = (boost::format("its version %d is not supported; the latest supported version is %d") % header.version % gallery_file::VERSION).str();
+  else if (header.header_size < sizeof(gallery_file::Header) || header.file_size != m_size)
+    problem = "its size does not match the header";
+  else if (header.count < 0 || header.number_of_nodes <= 0 || header.length <= 0)
+    problem = "the shape of the graphs is invalid";
+  else if (!fits(header.ids_offset, header.count * sizeof(int64_t)) ||
+           (header.nodes_offset && !fits(header.nodes_offset, header.number_of_nodes * 2 * sizeof(int32_t))) ||
+           !fits(header.jets_offset, values * sizeof(double)) ||
+           (header.quantized_offset && !fits(header.quantized_offset, values * sizeof(uint16_t))))
+    problem = "its blocks do not fit into the file";
+  if (!problem.empty()){
+    munmap(m_data, m_size);
+    throw std::runtime_error((boost::format("MappedGallery: the file '%s' cannot be used, since %s") % filename % problem).str());
+  }
+
+  // create the views into the mapped memory
+  const char* data = static_cast<const char*>(m_data);
+  m_ids.reference(blitz::Array<int64_t,1>((int64_t*)(data + header.ids_offset), blitz::shape(header.count), blitz::neverDeleteData));
+  if (header.nodes_offset){
+    const int32_t* positions = (const int32_t*)(data + header.nodes_offset);
+    for (int n = 0; n < header.number_of_nodes; ++n)
+      m_nodes.push_back(blitz::TinyVector<int,2>(positions[2*n], positions[2*n+1]));
+  }
+  double* jets = (double*)(data + header.jets_offset);
+  m_graphs.reference(blitz::Array<double,4>(jets, blitz::shape(header.count, header.number_of_nodes, 2, header.length), blitz::neverDeleteData));
+  m_jets.reference(blitz::Array<double,3>(jets, blitz::shape(header.count * header.number_of_nodes, 2, header.length), blitz::neverDeleteData));
+  if (header.quantized_offset)
+    m_quantized.reference(blitz::Array<uint16_t,3>((uint16_t*)(data + header.quantized_offset), blitz::shape(header.count * header.number_of_nodes, 2, header.length), blitz::neverDeleteData));
+}
+
+bob::ip::gabor::MappedGallery::~MappedGallery(){
+  munmap(m_data, m_size);
+}
+
+void bob::ip::gabor::MappedGallery::similarities(const Similarity& similarity, const std::vector<boost::shared_ptr<Jet>>& probe, blitz::Array<double,1>& scores, int number_of_threads) const{
+  similarity.similarities(probe, m_graphs, scores, number_of_threads);
+}
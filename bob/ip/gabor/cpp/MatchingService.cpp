@@ -0,0 +1,369 @@
+/**
+ * @date Sat Oct 17 23:41:12 UTC 2026
+ *
+ * @brief The C++ implementation of the matching server and client
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <bob.ip.gabor/MatchingService.h>
+#include <bob.ip.gabor/Parallel.h>
+
+// limits of the requests, which protect the server against corrupted messages
+static const long MAX_PROBE_SIZE = 1 << 24;
+static const int MAX_RANGES = 1 << 20;
+
+// fills the address of the Unix domain socket at the given path
+static sockaddr_un address(const std::string& path){
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path))
+    throw std::runtime_error((boost::format("The socket path '%s' is too long; at most %d characters are supported.") % path % (sizeof(address.sun_path) - 1)).str());
+  std::strcpy(address.sun_path, path.c_str());
+  return address;
+}
+
+// reads exactly size bytes; returns false if the connection is closed or broken
+static bool read_all(int socket, void* data, std::size_t size){
+  char* buffer = static_cast<char*>(data);
+  while (size){
+    ssize_t count = ::recv(socket, buffer, size, 0);
+    if (count < 0 && errno == EINTR) continue;
+    if (count <= 0) return false;
+    buffer += count;
+    size -= count;
+  }
+  return true;
+}
+
+// writes exactly size bytes; returns false if the connection is closed or broken
+static bool write_all(int socket, const void* data, std::size_t size){
+  const char* buffer = static_cast<const char*>(data);
+  while (size){
+    // do not raise SIGPIPE when the other side has closed the connection
+    ssize_t count = ::send(socket, buffer, size, MSG_NOSIGNAL);
+    if (count < 0 && errno == EINTR) continue;
+    if (count <= 0) return false;
+    buffer += count;
+    size -= count;
+  }
+  return true;
+}
+
+// appends the bytes of the given values to the message
+template <typename T>
+static void append(std::vector<char>& message, const T* values, std::size_t count = 1){
+  const char* data = reinterpret_cast<const char*>(values);
+  message.insert(message.end(), data, data + count * sizeof(T));
+}
+
+template <typename T>
+static void append_value(std::vector<char>& message, T value){
+  append(message, &value);
+}
+
+// the beginning of an error response with the given message
+static std::vector<char> error_response(const std::string& error){
+  std::vector<char> response;
+  response.reserve(3 * sizeof(int32_t) + error.size());
+  append_value(response, bob::ip::gabor::protocol::MAGIC);
+  append_value<int32_t>(response, 1);
+  append_value<int32_t>(response, error.size());
+  append(response, error.data(), error.size());
+  return response;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  Server  ///////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bob::ip::gabor::MatchingServer::MatchingServer(boost::shared_ptr<GalleryIndex> index, const std::string& socket_path, int number_of_threads)
+:
+  m_index(index),
+  m_socket_path(socket_path),
+  m_number_of_threads(number_of_threads),
+  m_stopped(false),
+  m_handlers(0)
+{
+  if (!m_index)
+    throw std::runtime_error("The matching server requires a gallery index.");
+  sockaddr_un addr = address(m_socket_path);
+
+  m_socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (m_socket < 0)
+    throw std::runtime_error((boost::format("Could not create the socket: %s") % std::strerror(errno)).str());
+  // replace sockets of previous servers, but never any other file
+  struct stat status;
+  if (::lstat(m_socket_path.c_str(), &status) == 0){
+    if (!S_ISSOCK(status.st_mode)){
+      ::close(m_socket);
+      throw std::runtime_error((boost::format("The path '%s' exists and is not a socket.") % m_socket_path).str());
+    }
+    ::unlink(m_socket_path.c_str());
+  }
+  if (::bind(m_socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(m_socket, SOMAXCONN) < 0 || ::lstat(m_socket_path.c_str(), &status) < 0){
+    int error = errno;
+    ::close(m_socket);
+    throw std::runtime_error((boost::format("Could not listen on the socket '%s': %s") % m_socket_path % std::strerror(error)).str());
+  }
+  m_socket_device = status.st_dev;
+  m_socket_inode = status.st_ino;
+}
+
+bob::ip::gabor::MatchingServer::~MatchingServer(){
+  stop();
+  ::close(m_socket);
+  // remove the socket file only if it was not replaced by another server
+  struct stat status;
+  if (::lstat(m_socket_path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode) && status.st_dev == m_socket_device && status.st_ino == m_socket_inode)
+    ::unlink(m_socket_path.c_str());
+}
+
+void bob::ip::gabor::MatchingServer::serve(){
+  while (!m_stopped){
+    int connection = ::accept(m_socket, 0, 0);
+    if (connection < 0){
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      // the socket was shut down in stop(), or it is broken
+      int error = errno;
+      if (m_stopped) break;
+      stop();
+      throw std::runtime_error((boost::format("Could not accept connections on the socket '%s': %s") % m_socket_path % std::strerror(error)).str());
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stopped){
+      ::close(connection);
+      break;
+    }
+    m_connections.insert(connection);
+    ++m_handlers;
+    std::thread([this, connection](){
+      try {
+        handle(connection);
+      } catch (...){
+        // the connection is closed when its request cannot be handled
+      }
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_connections.erase(connection);
+      ::close(connection);
+      if (!--m_handlers)
+        m_finished.notify_all();
+    }).detach();
+  }
+  stop();
+}
+
+void bob::ip::gabor::MatchingServer::stop(){
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (!m_stopped.exchange(true)){
+    // wake up accept() and all handlers, which are waiting for requests
+    ::shutdown(m_socket, SHUT_RDWR);
+    for (auto it = m_connections.begin(); it != m_connections.end(); ++it)
+      ::shutdown(*it, SHUT_RDWR);
+  }
+  m_finished.wait(lock, [this](){return m_handlers == 0;});
+}
+
+void bob::ip::gabor::MatchingServer::handle(int connection){
+  uint32_t header[2];
+  while (read_all(connection, header, sizeof(header))){
+    if (header[0] != protocol::MAGIC){
+      // the connection is out of sync and cannot be recovered
+      auto response = error_response("The request does not start with the magic number of the matching protocol.");
+      write_all(connection, response.data(), response.size());
+      return;
+    }
+
+    std::vector<char> response;
+    if (header[1] == protocol::INFO){
+      append_value(response, protocol::MAGIC);
+      append_value<int32_t>(response, 0);
+      append_value<int64_t>(response, m_index->size());
+      append_value<int32_t>(response, m_index->numberOfNodes());
+      append_value<int32_t>(response, m_index->length());
+    } else if (header[1] == protocol::SEARCH){
+      int32_t parameters[4];
+      if (!read_all(connection, parameters, sizeof(parameters))) return;
+      const int k = parameters[0], nodes = parameters[1], length = parameters[2], range_count = parameters[3];
+      if (nodes <= 0 || length <= 0 || (long)nodes * length > MAX_PROBE_SIZE || range_count < 0 || range_count > MAX_RANGES){
+        response = error_response((boost::format("The search request with %d nodes, jets of length %d and %d id ranges is invalid.") % nodes % length % range_count).str());
+        write_all(connection, response.data(), response.size());
+        return;
+      }
+
+      std::vector<int64_t> ranges(2 * range_count);
+      std::vector<GalleryIndex::Range> id_ranges(range_count);
+      std::vector<boost::shared_ptr<Jet>> probe(nodes);
+      if (!read_all(connection, ranges.data(), ranges.size() * sizeof(int64_t))) return;
+      for (int r = 0; r < range_count; ++r)
+        id_ranges[r] = std::make_pair((long)ranges[2*r], (long)ranges[2*r+1]);
+      for (int n = 0; n < nodes; ++n){
+        probe[n].reset(new Jet(length));
+        if (!read_all(connection, probe[n]->jet().data(), 2 * length * sizeof(double))) return;
+      }
+
+      try {
+        std::vector<GalleryIndex::Result> results;
+        m_index->search(probe, k, results, id_ranges, m_number_of_threads);
+        append_value(response, protocol::MAGIC);
+        append_value<int32_t>(response, 0);
+        append_value<int32_t>(response, results.size());
+        for (auto it = results.begin(); it != results.end(); ++it){
+          append_value<double>(response, it->first);
+          append_value<int64_t>(response, it->second);
+        }
+      } catch (std::exception& e){
+        response = error_response(e.what());
+      }
+    } else {
+      response = error_response((boost::format("The command %d is not part of the matching protocol.") % header[1]).str());
+    }
+
+    if (!write_all(connection, response.data(), response.size())) return;
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  Client  ///////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// reads the beginning of the response and throws the error message of the server, if any
+static void read_status(int socket, const std::string& path){
+  uint32_t magic;
+  int32_t status;
+  if (!read_all(socket, &magic, sizeof(magic)) || !read_all(socket, &status, sizeof(status)))
+    throw std::runtime_error((boost::format("The connection to the matching server at '%s' was closed.") % path).str());
+  if (magic != bob::ip::gabor::protocol::MAGIC)
+    throw std::runtime_error((boost::format("The response of the matching server at '%s' does not start with the magic number of the matching protocol.") % path).str());
+  if (status){
+    int32_t length;
+    std::string error;
+    if (read_all(socket, &length, sizeof(length)) && length > 0){
+      error.resize(length);
+      if (!read_all(socket, &error[0], length)) error.clear();
+    }
+    throw std::runtime_error((boost::format("The matching server at '%s' reported an error: %s") % path % error).str());
+  }
+}
+
+// throws an exception that the request could not be sent
+static void request_failed(const std::string& path){
+  throw std::runtime_error((boost::format("Could not send the request to the matching server at '%s': %s") % path % std::strerror(errno)).str());
+}
+
+bob::ip::gabor::MatchingClient::Connection::Connection(const std::string& path)
+:
+  path(path)
+{
+  sockaddr_un addr = address(path);
+  socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (socket < 0 || ::connect(socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0){
+    int error = errno;
+    if (socket >= 0) ::close(socket);
+    throw std::runtime_error((boost::format("Could not connect to the matching server at '%s': %s") % path % std::strerror(error)).str());
+  }
+}
+
+bob::ip::gabor::MatchingClient::Connection::~Connection(){
+  ::close(socket);
+}
+
+bob::ip::gabor::MatchingClient::MatchingClient(const std::vector<std::string>& socket_paths){
+  if (socket_paths.empty())
+    throw std::runtime_error("The matching client requires at least one server.");
+  // the connections of the previous servers are closed by their destructors when a later connection fails
+  for (auto it = socket_paths.begin(); it != socket_paths.end(); ++it)
+    m_connections.push_back(boost::shared_ptr<Connection>(new Connection(*it)));
+}
+
+void bob::ip::gabor::MatchingClient::search(const std::vector<boost::shared_ptr<Jet>>& probe, int k, std::vector<GalleryIndex::Result>& results, const std::vector<GalleryIndex::Range>& id_ranges){
+  if (probe.empty())
+    throw std::runtime_error("The probe graph must contain at least one Gabor jet.");
+  const int nodes = probe.size(), length = probe.front()->length();
+
+  // the request is the same for all servers
+  std::vector<char> request;
+  append_value(request, protocol::MAGIC);
+  append_value<uint32_t>(request, protocol::SEARCH);
+  append_value<int32_t>(request, k);
+  append_value<int32_t>(request, nodes);
+  append_value<int32_t>(request, length);
+  append_value<int32_t>(request, id_ranges.size());
+  for (auto it = id_ranges.begin(); it != id_ranges.end(); ++it){
+    append_value<int64_t>(request, it->first);
+    append_value<int64_t>(request, it->second);
+  }
+  for (auto it = probe.begin(); it != probe.end(); ++it){
+    if ((*it)->length() != length)
+      throw std::runtime_error("All Gabor jets of the probe graph must have the same length.");
+    bob::core::array::assertCZeroBaseContiguous((*it)->jet());
+    append(request, (*it)->jet().data(), 2 * length);
+  }
+
+  // query all servers in parallel
+  std::vector<std::vector<GalleryIndex::Result>> shard_results(m_connections.size());
+  parallel_for(m_connections.size(), m_connections.size(), [&](int begin, int end){
+    for (int s = begin; s < end; ++s){
+      Connection& connection = *m_connections[s];
+      std::lock_guard<std::mutex> lock(connection.mutex);
+      if (!write_all(connection.socket, request.data(), request.size()))
+        request_failed(connection.path);
+      read_status(connection.socket, connection.path);
+      int32_t count;
+      if (!read_all(connection.socket, &count, sizeof(count)) || count < 0)
+        throw std::runtime_error((boost::format("The connection to the matching server at '%s' was closed.") % connection.path).str());
+      for (int32_t r = 0; r < count; ++r){
+        double score;
+        int64_t id;
+        if (!read_all(connection.socket, &score, sizeof(score)) || !read_all(connection.socket, &id, sizeof(id)))
+          throw std::runtime_error((boost::format("The connection to the matching server at '%s' was closed.") % connection.path).str());
+        shard_results[s].push_back(std::make_pair(score, (long)id));
+      }
+    }
+  });
+
+  // merge the results in the same order as GalleryIndex::search
+  results.clear();
+  for (auto it = shard_results.begin(); it != shard_results.end(); ++it)
+    results.insert(results.end(), it->begin(), it->end());
+  std::sort(results.begin(), results.end(), [](const GalleryIndex::Result& a, const GalleryIndex::Result& b){return a.first > b.first || (a.first == b.first && a.second < b.second);});
+  if ((int)results.size() > k)
+    results.resize(std::max(k, 0));
+}
+
+long bob::ip::gabor::MatchingClient::size(){
+  std::vector<long> sizes(m_connections.size());
+  parallel_for(m_connections.size(), m_connections.size(), [&](int begin, int end){
+    for (int s = begin; s < end; ++s){
+      Connection& connection = *m_connections[s];
+      std::lock_guard<std::mutex> lock(connection.mutex);
+      const uint32_t request[] = {protocol::MAGIC, protocol::INFO};
+      if (!write_all(connection.socket, request, sizeof(request)))
+        request_failed(connection.path);
+      read_status(connection.socket, connection.path);
+      int64_t size;
+      int32_t shape[2];
+      if (!read_all(connection.socket, &size, sizeof(size)) || !read_all(connection.socket, shape, sizeof(shape)))
+        throw std::runtime_error((boost::format("The connection to the matching server at '%s' was closed.") % connection.path).str());
+      sizes[s] = size;
+    }
+  });
+  long total = 0;
+  for (auto it = sizes.begin(); it != sizes.end(); ++it)
+    total += *it;
+  return total;
+}
@@ -0,0 +1,317 @@
+/**
+ * @date Sat Oct 17 23:02:54 UTC 2026
+ *
+ * @brief The C++ implementation of the product quantization index
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <cmath>
+
+#include <bob.ip.gabor/QuantizedIndex.h>
+#include <bob.ip.gabor/Parallel.h>
+
+// the order of the approximate search results: smaller distances first, lower indices first for equal distances
+static bool closer(const bob::ip::gabor::QuantizedIndex::Result& a, const bob::ip::gabor::QuantizedIndex::Result& b){
+  return a.first < b.first || (a.first == b.first && a.second < b.second);
+}
+
+// the order of the re-ranked search results: higher similarities first, lower indices first for equal similarities
+static bool better(const bob::ip::gabor::QuantizedIndex::Result& a, const bob::ip::gabor::QuantizedIndex::Result& b){
+  return a.first > b.first || (a.first == b.first && a.second < b.second);
+}
+
+static double squared_distance(const double* a, const double* b, int length){
+  double sum = 0.;
+  #pragma omp simd reduction(+:sum)
+  for (int j = 0; j < length; ++j){
+    sum += (a[j] - b[j]) * (a[j] - b[j]);
+  }
+  return sum;
+}
+
+// returns the index of the centroid that is closest to the given vector
+static int nearest(const double* vector, const double* centroids, int count, int length){
+  int best = 0;
+  double best_distance = squared_distance(vector, centroids, length);
+  for (int c = 1; c < count; ++c){
+    double distance = squared_distance(vector, centroids + c * length, length);
+    if (distance < best_distance){
+      best_distance = distance;
+      best = c;
+    }
+  }
+  return best;
+}
+
+
+bob::ip::gabor::QuantizedIndex::QuantizedIndex(int number_of_subspaces, int number_of_centroids, Space space)
+:
+  m_space(space),
+  m_subspaces(number_of_subspaces),
+  m_number_of_centroids(number_of_centroids),
+  m_length(0)
+{
+  if (number_of_subspaces < 1)
+    throw std::runtime_error((boost::format("The number of sub-vectors (%d) must be positive.") % number_of_subspaces).str());
+  if (number_of_centroids < 1 || number_of_centroids > 256)
+    throw std::runtime_error((boost::format("The number of centroids (%d) must be in range [1, 256].") % number_of_centroids).str());
+}
+
+bob::ip::gabor::QuantizedIndex::QuantizedIndex(bob::io::base::HDF5File& file){
+  load(file);
+}
+
+bob::ip::gabor::QuantizedIndex::Space bob::ip::gabor::QuantizedIndex::name_to_space(const std::string& name){
+  if (name == "Absolute") return ABSOLUTE;
+  if (name == "Cartesian") return CARTESIAN;
+  throw std::runtime_error("The given space '" + name + "' is not known; choose one of ('Absolute', 'Cartesian')");
+}
+
+std::string bob::ip::gabor::QuantizedIndex::space_to_name(Space space){
+  switch (space){
+    case ABSOLUTE: return "Absolute";
+    case CARTESIAN: return "Cartesian";
+  }
+  throw std::runtime_error((boost::format("The given space %d is not known") % space).str());
+}
+
+void bob::ip::gabor::QuantizedIndex::check(int length) const{
+  if (!m_length)
+    throw std::runtime_error("The quantized index has not been trained yet.");
+  if (length != m_length)
+    throw std::runtime_error((boost::format("The given Gabor jets have length %d, but the quantized index was trained with jets of length %d.") % length % m_length).str());
+}
+
+void bob::ip::gabor::QuantizedIndex::vectorize(const double* jet, double* vector) const{
+  const double* abs = jet,* phase = jet + m_length;
+  switch (m_space){
+    case ABSOLUTE:
+      std::copy(abs, abs + m_length, vector);
+      break;
+    case CARTESIAN:
+      // interleave real and imaginary parts, so that each sub-vector contains complete Gabor jet entries
+      for (int j = 0; j < m_length; ++j){
+        vector[2*j] = abs[j] * std::cos(phase[j]);
+        vector[2*j+1] = abs[j] * std::sin(phase[j]);
+      }
+      break;
+  }
+}
+
+blitz::Array<uint8_t,2> bob::ip::gabor::QuantizedIndex::codes() const{
+  blitz::Array<uint8_t,2> codes(size(), m_subspaces);
+  std::copy(m_codes.begin(), m_codes.end(), codes.data());
+  return codes;
+}
+
+
+void bob::ip::gabor::QuantizedIndex::train(const blitz::Array<double,3>& jets, int iterations, unsigned seed, int number_of_threads){
+  bob::core::array::assertCZeroBaseContiguous(jets);
+  const int count = jets.extent(0), length = jets.extent(2);
+  bob::core::array::assertSameShape(jets, blitz::shape(count, 2, length));
+  if (count < m_number_of_centroids)
+    throw std::runtime_error((boost::format("At least %d training jets are required, but only %d are given.") % m_number_of_centroids % count).str());
+  const int dimension = m_space == CARTESIAN ? 2 * length : length;
+  if (dimension % m_subspaces)
+    throw std::runtime_error((boost::format("The dimension of the jet vectors (%d) cannot be split into %d sub-vectors of equal length.") % dimension % m_subspaces).str());
+
+  m_length = length;
+  m_codes.clear();
+  const int sub = dimension / m_subspaces, C = m_number_of_centroids;
+
+  // convert all training jets into vectors
+  std::vector<double> vectors((std::size_t)count * dimension);
+  for (int n = 0; n < count; ++n)
+    vectorize(jets.data() + (std::size_t)n * 2 * length, &vectors[(std::size_t)n * dimension]);
+
+  // train the codebooks of all sub-vectors independently with k-means
+  m_centroids.resize(m_subspaces, C, sub);
+  parallel_for(m_subspaces, number_of_threads, [&](int begin, int end){
+    for (int m = begin; m < end; ++m){
+      // collect the training data of this sub-vector
+      std::vector<double> data((std::size_t)count * sub);
+      for (int n = 0; n < count; ++n)
+        std::copy(&vectors[(std::size_t)n * dimension + m * sub], &vectors[(std::size_t)n * dimension + (m+1) * sub], &data[(std::size_t)n * sub]);
+
+      // initialize the centroids with distinct random training vectors; the generator depends on the sub-vector only, so that the result is independent of the number of threads
+      std::mt19937 generator(seed + m);
+      std::vector<int> order(count);
+      std::iota(order.begin(), order.end(), 0);
+      std::vector<double> centroids((std::size_t)C * sub);
+      for (int c = 0; c < C; ++c){
+        std::swap(order[c], order[c + generator() % (count - c)]);
+        std::copy(&data[(std::size_t)order[c] * sub], &data[(std::size_t)(order[c]+1) * sub], &centroids[(std::size_t)c * sub]);
+      }
+
+      std::vector<int> assignment(count, -1), counts(C);
+      std::vector<double> sums((std::size_t)C * sub);
+      for (int i = 0; i < iterations; ++i){
+        // assign each vector to its closest centroid
+        bool changed = false;
+        for (int n = 0; n < count; ++n){
+          int c = nearest(&data[(std::size_t)n * sub], centroids.data(), C, sub);
+          changed = changed || c != assignment[n];
+          assignment[n] = c;
+        }
+        if (!changed) break;
+
+        // move the centroids to the means of their vectors; empty clusters keep their centroid
+        std::fill(sums.begin(), sums.end(), 0.);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (int n = 0; n < count; ++n){
+          const int c = assignment[n];
+          ++counts[c];
+          for (int j = 0; j < sub; ++j)
+            sums[(std::size_t)c * sub + j] += data[(std::size_t)n * sub + j];
+        }
+        for (int c = 0; c < C; ++c)
+          if (counts[c])
+            for (int j = 0; j < sub; ++j)
+              centroids[(std::size_t)c * sub + j] = sums[(std::size_t)c * sub + j] / counts[c];
+      }
+
+      std::copy(centroids.begin(), centroids.end(), &m_centroids(m, 0, 0));
+    }
+  });
+}
+
+void bob::ip::gabor::QuantizedIndex::add(const blitz::Array<double,3>& jets, int number_of_threads){
+  bob::core::array::assertCZeroBaseContiguous(jets);
+  check(jets.extent(2));
+  bob::core::array::assertSameShape(jets, blitz::shape(jets.extent(0), 2, m_length));
+
+  const int count = jets.extent(0), dimension = m_centroids.extent(2) * m_subspaces, sub = m_centroids.extent(2);
+  const std::size_t offset = m_codes.size();
+  m_codes.resize(offset + (std::size_t)count * m_subspaces);
+  parallel_for(count, number_of_threads, [&](int begin, int end){
+    std::vector<double> vector(dimension);
+    for (int n = begin; n < end; ++n){
+      vectorize(jets.data() + (std::size_t)n * 2 * m_length, vector.data());
+      uint8_t* code = m_codes.data() + offset + (std::size_t)n * m_subspaces;
+      for (int m = 0; m < m_subspaces; ++m)
+        code[m] = nearest(&vector[m * sub], &m_centroids(m, 0, 0), m_number_of_centroids, sub);
+    }
+  });
+}
+
+
+void bob::ip::gabor::QuantizedIndex::distance_table(const Jet& probe, blitz::Array<double,2>& table) const{
+  check(probe.length());
+  bob::core::array::assertCZeroBaseContiguous(probe.jet());
+  bob::core::array::assertCZeroBaseContiguous(table);
+  bob::core::array::assertSameShape(table, blitz::shape(m_subspaces, m_number_of_centroids));
+
+  const int sub = m_centroids.extent(2);
+  std::vector<double> vector(sub * m_subspaces);
+  vectorize(probe.jet().data(), vector.data());
+  for (int m = 0; m < m_subspaces; ++m)
+    for (int c = 0; c < m_number_of_centroids; ++c)
+      table(m, c) = squared_distance(&vector[m * sub], &m_centroids(m, c, 0), sub);
+}
+
+void bob::ip::gabor::QuantizedIndex::search(const Jet& probe, int k, std::vector<Result>& results, int number_of_threads) const{
+  if (k < 1)
+    throw std::runtime_error((boost::format("The number of search results (%d) must be positive.") % k).str());
+  blitz::Array<double,2> table(m_subspaces, m_number_of_centroids);
+  distance_table(probe, table);
+  results.clear();
+
+  // each partition keeps the k closest jets in a bounded heap, where the farthest jet is on top
+  const int count = size(), C = m_number_of_centroids, M = m_subspaces;
+  const int partitions = bob::ip::gabor::number_of_threads(count, number_of_threads);
+  std::vector<std::vector<Result>> heaps(partitions);
+  parallel_for(partitions, partitions, [&](int first, int last){
+    for (int p = first; p < last; ++p){
+      const int begin = (long)count * p / partitions, end = (long)count * (p+1) / partitions;
+      std::vector<Result>& heap = heaps[p];
+      heap.reserve(std::min(k, end - begin));
+      const uint8_t* code = m_codes.data() + (std::size_t)begin * M;
+      for (int n = begin; n < end; ++n, code += M){
+        double distance = 0.;
+        for (int m = 0; m < M; ++m)
+          distance += table.data()[m * C + code[m]];
+        Result result(distance, n);
+        if ((int)heap.size() < k){
+          heap.push_back(result);
+          std::push_heap(heap.begin(), heap.end(), closer);
+        } else if (closer(result, heap.front())){
+          std::pop_heap(heap.begin(), heap.end(), closer);
+          heap.back() = result;
+          std::push_heap(heap.begin(), heap.end(), closer);
+        }
+      }
+    }
+  });
+
+  // merge the results of all partitions
+  for (auto it = heaps.begin(); it != heaps.end(); ++it)
+    results.insert(results.end(), it->begin(), it->end());
+  std::sort(results.begin(), results.end(), closer);
+  if ((int)results.size() > k) results.resize(k);
+}
+
+void bob::ip::gabor::QuantizedIndex::search(const Jet& probe, const blitz::Array<double,3>& gallery, const Similarity& similarity, int k, int candidates, std::vector<Result>& results, int number_of_threads) const{
+  check(gallery.extent(2));
+  bob::core::array::assertSameShape(gallery, blitz::shape(size(), 2, m_length));
+
+  // select the candidates with the approximate search
+  std::vector<Result> approximate;
+  search(probe, std::max(k, candidates), approximate, number_of_threads);
+  std::vector<int> indices(approximate.size());
+  for (std::size_t i = 0; i < approximate.size(); ++i)
+    indices[i] = approximate[i].second;
+
+  // re-rank them with the exact similarity
+  blitz::Array<double,1> scores(indices.size());
+  similarity.similarities(probe, gallery, indices, scores, number_of_threads);
+  results.resize(indices.size());
+  for (std::size_t i = 0; i < indices.size(); ++i)
+    results[i] = Result(scores(i), indices[i]);
+  std::sort(results.begin(), results.end(), better);
+  if ((int)results.size() > k) results.resize(k);
+}
+
+
+void bob::ip::gabor::QuantizedIndex::save(bob::io::base::HDF5File& file) const{
+  file.set("Space", space_to_name(m_space));
+  file.set("NumberOfSubspaces", m_subspaces);
+  file.set("NumberOfCentroids", m_number_of_centroids);
+  file.set("Length", m_length);
+  if (m_length){
+    file.setArray("Centroids", m_centroids);
+    if (size()) file.setArray("Codes", codes());
+  }
+}
+
+void bob::ip::gabor::QuantizedIndex::load(bob::io::base::HDF5File& file){
+  m_space = name_to_space(file.read<std::string>("Space"));
+  m_subspaces = file.read<int>("NumberOfSubspaces");
+  m_number_of_centroids = file.read<int>("NumberOfCentroids");
+  m_length = file.read<int>("Length");
+  m_codes.clear();
+  if (m_subspaces < 1 || m_number_of_centroids < 1 || m_number_of_centroids > 256 || m_length < 0)
+    throw std::runtime_error((boost::format("QuantizedIndex: the stored configuration with %d sub-vectors, %d centroids and jet length %d is invalid") % m_subspaces % m_number_of_centroids % m_length).str());
+  if (m_length){
+    const int dimension = m_space == CARTESIAN ? 2 * m_length : m_length;
+    if (dimension % m_subspaces)
+      throw std::runtime_error((boost::format("QuantizedIndex: the dimension of the jet vectors (%d) cannot be split into %d sub-vectors of equal length") % dimension % m_subspaces).str());
+    m_centroids.reference(file.readArray<double,3>("Centroids"));
+    if (m_centroids.extent(0) != m_subspaces || m_centroids.extent(1) != m_number_of_centroids || m_centroids.extent(2) != dimension / m_subspaces)
+      throw std::runtime_error((boost::format("QuantizedIndex: the data set 'Centroids' has shape (%d, %d, %d), but (%d, %d, %d) is expected") % m_centroids.extent(0) % m_centroids.extent(1) % m_centroids.extent(2) % m_subspaces % m_number_of_centroids % (dimension / m_subspaces)).str());
+    if (file.contains("Codes")){
+      blitz::Array<uint8_t,2> codes(file.readArray<uint8_t,2>("Codes"));
+      if (codes.extent(1) != m_subspaces)
+        throw std::runtime_error((boost::format("QuantizedIndex: the data set 'Codes' has %d columns, but %d are expected") % codes.extent(1) % m_subspaces).str());
+      for (auto it = codes.begin(); it != codes.end(); ++it)
+        if (*it >= m_number_of_centroids)
+          throw std::runtime_error((boost::format("QuantizedIndex: the data set 'Codes' contains the centroid index %d, but only %d centroids are stored") % (int)*it % m_number_of_centroids).str());
+      m_codes.assign(codes.data(), codes.data() + codes.numElements());
+    }
+  } else {
+    m_centroids.resize(0, 0, 0);
+  }
+}
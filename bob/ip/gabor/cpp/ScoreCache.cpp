@@ -0,0 +1,241 @@
+/**
+ * @date Sat Oct 17 23:35:10 UTC 2026
+ *
+ * @brief The C++ implementation of the cache of similarity scores
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#include <cstring>
+
+#include <bob.ip.gabor/ScoreCache.h>
+#include <bob.ip.gabor/FastMath.h>
+#include <bob.ip.gabor/Parallel.h>
+
+static const uint64_t MULTIPLIER = 0x9E3779B97F4A7C15ull;
+
+// continues the hash with the given 64 bit word
+static inline uint64_t mix(uint64_t state, uint64_t word){
+  state = (state ^ word) * MULTIPLIER;
+  return state ^ (state >> 29);
+}
+
+// continues the hash with the bit patterns of the given values
+static uint64_t mix(uint64_t state, const double* data, std::size_t size){
+  for (std::size_t i = 0; i < size; ++i){
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    state = mix(state, word);
+  }
+  return state;
+}
+
+// starts the hash of a Gabor graph with the given number of nodes, i.e., Gabor jets of the given length
+static uint64_t begin_hash(uint64_t seed, int nodes, int length){
+  return mix(mix(seed, (uint64_t)nodes), (uint64_t)length);
+}
+
+// distributes the bits of the final hash
+static uint64_t finalize(uint64_t state){
+  state = (state ^ (state >> 30)) * 0xBF58476D1CE4E5B9ull;
+  state = (state ^ (state >> 27)) * 0x94D049BB133111EBull;
+  return state ^ (state >> 31);
+}
+
+static uint64_t hash(uint64_t seed, const bob::ip::gabor::Jet& jet){
+  bob::core::array::assertCZeroBaseContiguous(jet.jet());
+  return finalize(mix(begin_hash(seed, 1, jet.length()), jet.jet().data(), 2 * jet.length()));
+}
+
+static uint64_t hash(uint64_t seed, const std::vector<boost::shared_ptr<bob::ip::gabor::Jet>>& graph){
+  if (graph.empty())
+    throw std::runtime_error("The score cache requires graphs with at least one node.");
+  uint64_t state = begin_hash(seed, graph.size(), graph.front()->length());
+  for (auto it = graph.begin(); it != graph.end(); ++it){
+    bob::core::array::assertCZeroBaseContiguous((*it)->jet());
+    state = mix(state, (*it)->jet().data(), 2 * (*it)->length());
+  }
+  return finalize(state);
+}
+
+
+bob::ip::gabor::ScoreCache::ScoreCache(boost::shared_ptr<Similarity> similarity, std::size_t capacity)
+:
+  m_similarity(similarity),
+  m_capacity(capacity)
+{
+  if (!m_similarity)
+    throw std::runtime_error("The score cache requires a similarity function.");
+  if (!m_capacity)
+    throw std::runtime_error("The capacity of the score cache must be positive.");
+
+  // the scores depend on the similarity function and, for disparity based similarities, on the wavelet frequencies
+  const std::string& type = m_similarity->type();
+  uint64_t state = mix(0, (uint64_t)type.size());
+  for (auto it = type.begin(); it != type.end(); ++it)
+    state = mix(state, (uint64_t)(unsigned char)*it);
+  if (m_similarity->transform()){
+    const auto& frequencies = m_similarity->transform()->waveletFrequencies();
+    for (auto it = frequencies.begin(); it != frequencies.end(); ++it){
+      const double frequency[] = {(*it)[0], (*it)[1]};
+      state = mix(state, frequency, 2);
+    }
+  }
+  m_configuration = state;
+  reset_statistics();
+}
+
+uint64_t bob::ip::gabor::ScoreCache::seed() const{
+  // the fast math mode changes the scores slightly
+  return fast_math() ? mix(m_configuration, 1) : m_configuration;
+}
+
+std::size_t bob::ip::gabor::ScoreCache::size() const{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_entries.size();
+}
+
+double bob::ip::gabor::ScoreCache::hit_rate() const{
+  long hits = m_hits, total = hits + m_misses;
+  return total ? (double)hits / total : 0.;
+}
+
+void bob::ip::gabor::ScoreCache::clear(){
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_index.clear();
+  m_entries.clear();
+}
+
+void bob::ip::gabor::ScoreCache::reset_statistics(){
+  m_hits = 0;
+  m_misses = 0;
+}
+
+
+// Both functions require m_mutex to be locked
+bool bob::ip::gabor::ScoreCache::lookup(const Key& key, double& score){
+  auto it = m_index.find(key);
+  if (it == m_index.end())
+    return false;
+  // move the entry to the front
+  m_entries.splice(m_entries.begin(), m_entries, it->second);
+  score = it->second->second;
+  return true;
+}
+
+void bob::ip::gabor::ScoreCache::insert(const Key& key, double score){
+  // the same score might have been computed concurrently
+  auto it = m_index.find(key);
+  if (it != m_index.end()){
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    it->second->second = score;
+    return;
+  }
+  m_entries.push_front(std::make_pair(key, score));
+  m_index[key] = m_entries.begin();
+  while (m_entries.size() > m_capacity){
+    m_index.erase(m_entries.back().first);
+    m_entries.pop_back();
+  }
+}
+
+
+double bob::ip::gabor::ScoreCache::similarity(const Jet& jet1, const Jet& jet2){
+  const uint64_t seed = this->seed();
+  const Key key = {hash(seed, jet1), hash(seed, jet2)};
+  double score;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (lookup(key, score)){
+      ++m_hits;
+      return score;
+    }
+  }
+
+  // compute the score outside of the lock, so that other threads are not blocked
+  blitz::TinyVector<double,2> disparity;
+  score = m_similarity->similarity(jet1, jet2, disparity);
+  ++m_misses;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  insert(key, score);
+  return score;
+}
+
+double bob::ip::gabor::ScoreCache::similarity(const std::vector<boost::shared_ptr<Jet>>& graph1, const std::vector<boost::shared_ptr<Jet>>& graph2){
+  if (graph1.size() != graph2.size())
+    throw std::runtime_error((boost::format("The number of nodes of the graphs (%d and %d) differ.") % graph1.size() % graph2.size()).str());
+  const uint64_t seed = this->seed();
+  const Key key = {hash(seed, graph1), hash(seed, graph2)};
+  double score;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (lookup(key, score)){
+      ++m_hits;
+      return score;
+    }
+  }
+
+  blitz::TinyVector<double,2> disparity;
+  score = 0.;
+  for (std::size_t n = 0; n < graph1.size(); ++n)
+    score += m_similarity->similarity(*graph1[n], *graph2[n], disparity);
+  score /= graph1.size();
+  ++m_misses;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  insert(key, score);
+  return score;
+}
+
+
+template <typename Probe, int D>
+void bob::ip::gabor::ScoreCache::run(const Probe& probe, const blitz::Array<double,D>& gallery, blitz::Array<double,1>& scores, int number_of_threads){
+  bob::core::array::assertCZeroBaseContiguous(gallery);
+  bob::core::array::assertCZeroBaseContiguous(scores);
+  const int size = gallery.extent(0);
+  bob::core::array::assertSameShape(scores, blitz::shape(size));
+
+  // hash all gallery entries in parallel
+  const int nodes = D == 4 ? gallery.extent(1) : 1, length = gallery.extent(D-1);
+  const std::size_t stride = (std::size_t)nodes * 2 * length;
+  const uint64_t seed = this->seed(), probe_hash = hash(seed, probe);
+  std::vector<Key> keys(size);
+  parallel_for(size, number_of_threads, [&](int begin, int end){
+    for (int i = begin; i < end; ++i){
+      keys[i].probe = probe_hash;
+      keys[i].gallery = finalize(mix(begin_hash(seed, nodes, length), gallery.data() + i * stride, stride));
+    }
+  });
+
+  // look up all scores at once
+  std::vector<int> misses;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int i = 0; i < size; ++i)
+      if (!lookup(keys[i], scores(i)))
+        misses.push_back(i);
+  }
+  m_hits += size - misses.size();
+  if (misses.empty())
+    return;
+
+  // compute the missing scores (which also checks the probe and the gallery)
+  blitz::Array<double,1> computed(misses.size());
+  m_similarity->similarities(probe, gallery, misses, computed, number_of_threads);
+  m_misses += misses.size();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (std::size_t m = 0; m < misses.size(); ++m){
+    scores(misses[m]) = computed(m);
+    insert(keys[misses[m]], computed(m));
+  }
+}
+
+void bob::ip::gabor::ScoreCache::similarities(const Jet& probe, const blitz::Array<double,3>& gallery, blitz::Array<double,1>& scores, int number_of_threads){
+  run(probe, gallery, scores, number_of_threads);
+}
+
+void bob::ip::gabor::ScoreCache::similarities(const std::vector<boost::shared_ptr<Jet>>& probe, const blitz::Array<double,4>& gallery, blitz::Array<double,1>& scores, int number_of_threads){
+  run(probe, gallery, scores, number_of_threads);
+}
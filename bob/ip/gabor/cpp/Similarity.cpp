@@ -7,7 +7,13 @@
  * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
  */
 
+#include <limits>
+#include <mutex>
+#include <type_traits>
+
 #include <bob.ip.gabor/Similarity.h>
+#include <bob.ip.gabor/Parallel.h>
+#include <bob.ip.gabor/FastMath.h>
 
 
 static const std::map<bob::ip::gabor::Similarity::SimilarityType, std::string> type_map = {
@@ -19,32 +25,62 @@ static const std::map<bob::ip::gabor::Similarity::SimilarityType, std::string> t
   {bob::ip::gabor::Similarity::PHASE_DIFF_PLUS_CANBERRA, "PhaseDiffPlusCanberra"}
 };
 
+// the user-defined similarity functions, which are registered by name, together with their thread-safety
+static std::map<std::string, std::pair<bob::ip::gabor::Similarity::Function, bool>> function_map;
+static std::mutex function_mutex;
+
 const std::string& bob::ip::gabor::Similarity::type_to_name(bob::ip::gabor::Similarity::SimilarityType type){
-  return type_map.find(type)->second;
+  auto it = type_map.find(type);
+  if (it == type_map.end())
+    throw std::runtime_error((boost::format("The similarity function type %d has no unique name; user-defined similarity functions are identified by their registered name.") % type).str());
+  return it->second;
 }
 
 bob::ip::gabor::Similarity::SimilarityType bob::ip::gabor::Similarity::name_to_type(const std::string& type){
   for (auto it = type_map.begin(); it != type_map.end(); ++it)
     if (it->second == type)
       return it->first;
+  std::lock_guard<std::mutex> lock(function_mutex);
+  if (function_map.count(type))
+    return CUSTOM;
   throw std::runtime_error("The given similarity name '" + type + "' does not name an appropriate similarity function type.");
 }
 
+void bob::ip::gabor::Similarity::register_function(const std::string& name, const Function& function, bool thread_safe){
+  for (auto it = type_map.begin(); it != type_map.end(); ++it)
+    if (it->second == name)
+      throw std::runtime_error("The similarity function name '" + name + "' is reserved for a built-in similarity function.");
+  if (!function)
+    throw std::runtime_error("The similarity function registered as '" + name + "' is empty.");
+  std::lock_guard<std::mutex> lock(function_mutex);
+  function_map[name] = std::make_pair(function, thread_safe);
+}
+
 bob::ip::gabor::Similarity::Similarity(SimilarityType type, boost::shared_ptr<Transform> gwt)
 :
   m_type(type),
   m_gwt(gwt),
   m_disparity(std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN())
 {
-  // initialize, when required
-  if (m_type >= DISPARITY){
-    if (!m_gwt)
-      throw std::runtime_error("The given similarity function type '" + type_to_name(m_type) + "' required to specify the Gabor wavelet transform!");
-    init();
-  }
+  if (m_type == CUSTOM)
+    throw std::runtime_error("User-defined similarity functions need to be created by their registered name.");
+  m_name = type_to_name(m_type);
+  init();
+}
+
+bob::ip::gabor::Similarity::Similarity(const std::string& name, boost::shared_ptr<Transform> gwt)
+:
+  m_type(name_to_type(name)),
+  m_name(name),
+  m_gwt(gwt),
+  m_disparity(std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN())
+{
+  init();
 }
 
 bob::ip::gabor::Similarity::Similarity(bob::io::base::HDF5File& file)
+:
+  m_disparity(std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN())
 {
   // load configuration from file
   load(file);
@@ -52,89 +88,510 @@ bob::ip::gabor::Similarity::Similarity(bob::io::base::HDF5File& file)
 
 static double sqr(double x){return x*x;}
 
+static double adjustPhase(double phase){
+  return phase - (2.*M_PI)*round(phase / (2.*M_PI));
+}
+
+// the cosine of the standard library, or its fast approximation
+template <bool fast>
+static inline double cosine(double x){
+  return fast ? bob::ip::gabor::fast_cos(x) : cos(x);
+}
+
+void bob::ip::gabor::Similarity::check(const Jet& jet) const{
+  bob::core::array::assertCZeroBaseContiguous(jet.jet());
+  check(jet.length());
+}
+
+void bob::ip::gabor::Similarity::check(int length) const{
+  if (m_type >= DISPARITY && length != m_gwt->numberOfWavelets()){
+    throw std::runtime_error((boost::format("The size of the Gabor jet (%d) and the number of wavelets in the Gabor wavelet transform (%d) differ!") % length % m_gwt->numberOfWavelets()).str());
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  Similarity kernels  ///////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// All kernels operate on Gabor jets stored as contiguous (2, length) blocks, i.e., length absolute values followed by length phases.
+// The loops are free of branches, so that they can be vectorized by the compiler.
+
+static double scalar_product(const double* jet1, const double* jet2, int length){
+  // normalized scalar product (we assume normalized Gabor jets here!)
+  double sim = 0.;
+#pragma omp simd reduction(+:sim)
+  for (int j = 0; j < length; ++j){
+    sim += jet1[j] * jet2[j];
+  }
+  return sim;
+}
+
+static double canberra(const double* jet1, const double* jet2, int length){
+  // sum of Canberra similarities of the absolute values
+  double sim = 0.;
+#pragma omp simd reduction(+:sim)
+  for (int j = 0; j < length; ++j){
+    sim += 1. - std::abs(jet1[j] - jet2[j]) / (jet1[j] + jet2[j]);
+  }
+  return sim;
+}
+
+// the same sum with half of the divisions, which are the bottleneck of the loop above:
+// the terms j and j+h are combined into x1/y1 + x2/y2 = (x1*y2 + x2*y1) / (y1*y2), which deviates from the exact sum only by rounding.
+// When the products y1*y2 leave the range of normalized doubles, e.g., for magnitudes close to zero, the exact sum is computed instead.
+static double canberra_pairwise(const double* jet1, const double* jet2, int length){
+  const int half = length / 2;
+  const double* a1 = jet1 + half,* a2 = jet2 + half;
+  double sim = 0., min_product = std::numeric_limits<double>::max(), max_product = 0.;
+#pragma omp simd reduction(+:sim) reduction(min:min_product) reduction(max:max_product)
+  for (int j = 0; j < half; ++j){
+    const double x1 = std::abs(jet1[j] - jet2[j]), y1 = jet1[j] + jet2[j], x2 = std::abs(a1[j] - a2[j]), y2 = a1[j] + a2[j];
+    const double product = y1 * y2;
+    sim += 2. - (x1 * y2 + x2 * y1) / product;
+    min_product = std::min(min_product, product);
+    max_product = std::max(max_product, product);
+  }
+  // x1*y2 + x2*y1 is at most 2*y1*y2, which must not overflow either
+  if (min_product < std::numeric_limits<double>::min() || !(max_product <= 0.5 * std::numeric_limits<double>::max()))
+    return canberra(jet1, jet2, length);
+  // the remaining term of odd lengths
+  if (length % 2)
+    sim += canberra(jet1 + length - 1, jet2 + length - 1, 1);
+  return sim;
+}
+
+template <bool fast>
+static double abs_phase(const double* jet1, const double* jet2, int length){
+  // similarity with absolute values and cosine of phase differences
+  const double* p1 = jet1 + length,* p2 = jet2 + length;
+  double sim = 0.;
+#pragma omp simd reduction(+:sim)
+  for (int j = 0; j < length; ++j){
+    sim += jet1[j] * jet2[j] * cosine<fast>(p1[j] - p2[j]);
+  }
+  return sim;
+}
+
+// sum of the cosines of the disparity corrected phase differences, which are weighted by the confidences, if desired
+template <bool weighted, bool fast>
+static double disparity_terms(const double* kx, const double* ky, const double* confidences, const double* phase_differences, const blitz::TinyVector<double,2>& disparity, int length){
+  const double dx = disparity[1], dy = disparity[0];
+  double sim = 0.;
+#pragma omp simd reduction(+:sim)
+  for (int j = 0; j < length; ++j){
+    sim += (weighted ? confidences[j] : 1.) * cosine<fast>(phase_differences[j] - dy * ky[j] - dx * kx[j]);
+  }
+  return sim;
+}
+
+template <bool weighted>
+static double disparity_terms(const double* kx, const double* ky, const double* confidences, const double* phase_differences, const blitz::TinyVector<double,2>& disparity, int length, bool fast){
+  return fast ? disparity_terms<weighted, true>(kx, ky, confidences, phase_differences, disparity, length) : disparity_terms<weighted, false>(kx, ky, confidences, phase_differences, disparity, length);
+}
+
+
+// The kernels of all similarity types as function objects, which are selected once per Similarity object (for single comparisons) or per batch.
+// All kernels share the same call signature: kernel(jet1, jet2, length, workspace, disparity).
+// Since the type is resolved at compile time, the batch loops are instantiated once per kernel and do not contain any switches.
+// Kernels that compute cosines query the fast math mode when they are created, i.e., once per single comparison or per batch.
+struct bob::ip::gabor::Similarity::Kernels{
+
+  struct ScalarProduct{
+    explicit ScalarProduct(const Similarity&){}
+    double operator()(const double* jet1, const double* jet2, int length, Workspace&, blitz::TinyVector<double,2>&) const {return scalar_product(jet1, jet2, length);}
+  };
+
+  struct Canberra{
+    explicit Canberra(const Similarity&) {}
+    double operator()(const double* jet1, const double* jet2, int length, Workspace&, blitz::TinyVector<double,2>&) const {return canberra_pairwise(jet1, jet2, length) / length;}
+  };
+
+  struct AbsPhase{
+    explicit AbsPhase(const Similarity&) : fast(fast_math()) {}
+    double operator()(const double* jet1, const double* jet2, int length, Workspace&, blitz::TinyVector<double,2>&) const {return fast ? abs_phase<true>(jet1, jet2, length) : abs_phase<false>(jet1, jet2, length);}
+    const bool fast;
+  };
+
+  struct Custom{
+    explicit Custom(const Similarity& similarity) : function(similarity.m_function) {}
+    double operator()(const double* jet1, const double* jet2, int length, Workspace&, blitz::TinyVector<double,2>&) const {return function(jet1, jet2, length);}
+    const Function& function;
+  };
+
+  // the disparity based similarities, which first estimate the disparity; the workspace needs to have the given length
+  template <SimilarityType TYPE>
+  struct Disparity{
+    explicit Disparity(const Similarity& similarity) : similarity(similarity), kx(similarity.m_kx.data()), ky(similarity.m_ky.data()), fast(fast_math()) {}
+    double operator()(const double* jet1, const double* jet2, int length, Workspace& workspace, blitz::TinyVector<double,2>& disparity) const {
+      double* confidences = workspace.confidences.data(),* phase_differences = workspace.phase_differences.data();
+      similarity.compute_confidences(jet1, jet2, length, confidences, phase_differences);
+      similarity.compute_disparity(confidences, phase_differences, disparity);
+
+      // compute the similarity using the estimated disparity
+      if (TYPE == DISPARITY)
+        return disparity_terms<true>(kx, ky, confidences, phase_differences, disparity, length, fast);
+      if (TYPE == PHASE_DIFF)
+        return disparity_terms<false>(kx, ky, confidences, phase_differences, disparity, length, fast) / length;
+      // PHASE_DIFF_PLUS_CANBERRA: add disparity and Canberra terms
+      return (disparity_terms<false>(kx, ky, confidences, phase_differences, disparity, length, fast) + canberra_pairwise(jet1, jet2, length)) / (2. * length);
+    }
+    const Similarity& similarity;
+    const double* kx,* ky;
+    const bool fast;
+  };
+
+  // calls action(kernel) with the kernel of the type of the given similarity
+  template <class Action>
+  static void dispatch(const Similarity& similarity, Action& action){
+    switch (similarity.m_type){
+      case CUSTOM: action(Custom(similarity)); return;
+      case SCALAR_PRODUCT: action(ScalarProduct(similarity)); return;
+      case CANBERRA: action(Canberra(similarity)); return;
+      case ABS_PHASE: action(AbsPhase(similarity)); return;
+      case DISPARITY: action(Disparity<DISPARITY>(similarity)); return;
+      case PHASE_DIFF: action(Disparity<PHASE_DIFF>(similarity)); return;
+      case PHASE_DIFF_PLUS_CANBERRA: action(Disparity<PHASE_DIFF_PLUS_CANBERRA>(similarity)); return;
+    }
+    // this should never happen
+    throw std::runtime_error("This should not have happened. Please assure that newly generated Gabor jet similarity functions are actually implemented!");
+  }
+
+  // estimates the disparities and confidences on the grid of the given size, where the Gabor jets are provided by the given images
+  template <class Image>
+  static void disparity_field(const Similarity& similarity, const Image& image1, const Image& image2, const blitz::TinyVector<int,2>& first, const blitz::TinyVector<int,2>& step, double* disparities, double* confidences, int height, int width, int number_of_threads);
+
+  // evaluates the given kernel type for the given similarity; a pointer to the instance of the current type is stored in m_kernel
+  template <class Kernel>
+  static double evaluate(const Similarity& similarity, const double* jet1, const double* jet2, int length, Workspace& workspace, blitz::TinyVector<double,2>& disparity){
+    return Kernel(similarity)(jet1, jet2, length, workspace, disparity);
+  }
+
+  // selects the kernel for single comparisons
+  struct Select{
+    template <class Kernel> void operator()(const Kernel&){kernel = &evaluate<Kernel>;}
+    KernelFunction kernel;
+  };
+
+  // the 1:N comparison of a probe with a contiguous gallery
+  struct Similarities{
+    template <class Kernel> void operator()(const Kernel& kernel) const;
+    const Similarity& similarity;
+    const std::vector<const double*>& probe;
+    int length;
+    const double* gallery;
+    const int* indices;
+    int count;
+    double* scores;
+    int number_of_threads;
+  };
+
+  // the N:M comparison of contiguous probes and gallery
+  struct SimilarityMatrix{
+    template <class Kernel> void operator()(const Kernel& kernel) const;
+    const Similarity& similarity;
+    const double* probes;
+    int probe_size;
+    const double* gallery;
+    int gallery_size;
+    int nodes;
+    int length;
+    double* scores;
+    int number_of_threads;
+  };
+};
+
+
 void bob::ip::gabor::Similarity::init(){
-  m_confidences.resize(m_gwt->numberOfWavelets());
-  m_confidences = 0.;
-  m_phase_differences.resize(m_gwt->numberOfWavelets());
-  m_phase_differences = 0.;
+  m_thread_safe = true;
+  if (m_type == CUSTOM){
+    std::lock_guard<std::mutex> lock(function_mutex);
+    const auto& entry = function_map.at(m_name);
+    m_function = entry.first;
+    m_thread_safe = entry.second;
+  }
+
+  if (m_type >= DISPARITY){
+    if (!m_gwt)
+      throw std::runtime_error("The given similarity function type '" + m_name + "' required to specify the Gabor wavelet transform!");
+
+    m_workspace.resize(m_gwt->numberOfWavelets());
+
+    // copy wavelet frequencies for faster access
+    const std::vector<blitz::TinyVector<double,2> >& kernels = m_gwt->waveletFrequencies();
+    m_kx.resize(kernels.size());
+    m_ky.resize(kernels.size());
+    for (std::size_t j = 0; j < kernels.size(); ++j){
+      m_kx[j] = kernels[j][1];
+      m_ky[j] = kernels[j][0];
+    }
+  }
+
+  // select the kernel once
+  Kernels::Select select;
+  Kernels::dispatch(*this, select);
+  m_kernel = select.kernel;
+}
+
+
+double bob::ip::gabor::Similarity::compute_similarity(const double* jet1, const double* jet2, int length, Workspace& workspace, blitz::TinyVector<double,2>& disparity) const{
+  return m_kernel(*this, jet1, jet2, length, workspace, disparity);
 }
 
 double bob::ip::gabor::Similarity::similarity(const Jet& jet1, const Jet& jet2) const{
-  // compute the disparity, if required
+  // the last disparity is only updated by similarity functions that estimate a disparity
   if (m_type < DISPARITY){
-    switch (m_type){
-      case SCALAR_PRODUCT:
-        // normalized scalar product (we assume normalized Gabor jets here!)
-        return blitz::dot(jet1.abs(), jet2.abs());
-      case CANBERRA:{
-        // Canberra similarity
-        double sim = 0.;
-        const auto& a1 = jet1.abs(),& a2 = jet2.abs();
-        int size = jet1.length();
-        for (int j = 0; j < size; ++j){
-          sim += 1. - std::abs(a1(j) - a2(j)) / (a1(j) + a2(j));
-        }
-        return sim / size;
-      }
-      case ABS_PHASE:{
-        // similarity with absloute values and cosine of phase differences
-        double sim = 0.;
-        const auto& a1 = jet1.abs(),& a2 = jet2.abs();
-        const auto& p1 = jet1.phase(),& p2 = jet2.phase();
-        int size = jet1.length();
-        for (int j = 0; j < size; ++j){
-          sim += a1(j) * a2(j) * cos(p1(j) - p2(j));
-        }
-        return sim;
+    blitz::TinyVector<double,2> disparity;
+    return similarity(jet1, jet2, disparity, m_workspace);
+  }
+  return similarity(jet1, jet2, m_disparity, m_workspace);
+}
+
+double bob::ip::gabor::Similarity::similarity(const Jet& jet1, const Jet& jet2, blitz::TinyVector<double,2>& disparity, Workspace& workspace) const{
+  check(jet1);
+  check(jet2);
+  bob::core::array::assertSameShape(jet1.jet(),jet2.jet());
+
+  if (m_type < DISPARITY){
+    disparity = std::numeric_limits<double>::quiet_NaN();
+  } else {
+    workspace.resize(jet1.length());
+  }
+  return compute_similarity(jet1.jet().data(), jet2.jet().data(), jet1.length(), workspace, disparity);
+}
+
+double bob::ip::gabor::Similarity::similarity(const Jet& jet1, const Jet& jet2, blitz::TinyVector<double,2>& disparity) const{
+  static thread_local Workspace workspace;
+  return similarity(jet1, jet2, disparity, workspace);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  Batch similarities  ///////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <class Kernel>
+void bob::ip::gabor::Similarity::Kernels::Similarities::operator()(const Kernel& kernel) const{
+  const int nodes = probe.size(), stride = 2 * length;
+  const std::size_t entry_size = (std::size_t)nodes * stride;
+  parallel_for(count, number_of_threads, [&](int begin, int end){
+    // each thread uses its own memory for the disparity computation
+    Workspace workspace(similarity.m_type >= DISPARITY ? length : 0);
+    blitz::TinyVector<double,2> disparity;
+    for (int i = begin; i < end; ++i){
+      const double* entry = gallery + (indices ? indices[i] : i) * entry_size;
+      double sum = 0.;
+      for (int n = 0; n < nodes; ++n, entry += stride){
+        sum += kernel(probe[n], entry, length, workspace, disparity);
       }
-      default:
-        throw std::runtime_error("This should not have happened. Please assure that newly generated Gabor jet similarity functions are actually implemented!");
+      scores[i] = sum / nodes;
     }
+  });
+}
 
-  } else {
-    // here only the disparity-related functions should be computed
-    // compute disparity
-    disparity(jet1, jet2);
+void bob::ip::gabor::Similarity::compute_similarities(const std::vector<const double*>& probe, int length, const double* gallery, const int* indices, int count, double* scores, int number_of_threads) const{
+  Kernels::Similarities action = {*this, probe, length, gallery, indices, count, scores, m_thread_safe ? number_of_threads : 1};
+  Kernels::dispatch(*this, action);
+}
+
+std::vector<const double*> bob::ip::gabor::Similarity::check(const Jet& probe, const blitz::Array<double,3>& gallery) const{
+  check(probe);
+  bob::core::array::assertCZeroBaseContiguous(gallery);
+  bob::core::array::assertSameShape(gallery, blitz::shape(gallery.extent(0), 2, probe.length()));
+  return std::vector<const double*>(1, probe.jet().data());
+}
+
+std::vector<const double*> bob::ip::gabor::Similarity::check(const std::vector<boost::shared_ptr<Jet>>& probe, const blitz::Array<double,4>& gallery) const{
+  if (probe.empty()){
+    throw std::runtime_error("The probe graph must contain at least one Gabor jet.");
+  }
+  std::vector<const double*> probe_data;
+  for (auto it = probe.begin(); it != probe.end(); ++it){
+    check(**it);
+    bob::core::array::assertSameShape((*it)->jet(), probe.front()->jet());
+    probe_data.push_back((*it)->jet().data());
+  }
+  bob::core::array::assertCZeroBaseContiguous(gallery);
+  bob::core::array::assertSameShape(gallery, blitz::shape(gallery.extent(0), probe.size(), 2, probe.front()->length()));
+  return probe_data;
+}
+
+// checks that the given indices are valid gallery indices and that the scores fit to them
+static void check_indices(const std::vector<int>& indices, int gallery_size, const blitz::Array<double,1>& scores){
+  bob::core::array::assertCZeroBaseContiguous(scores);
+  bob::core::array::assertSameShape(scores, blitz::shape(indices.size()));
+  for (auto it = indices.begin(); it != indices.end(); ++it)
+    if (*it < 0 || *it >= gallery_size)
+      throw std::runtime_error((boost::format("The gallery index %d is out of range [0, %d[.") % *it % gallery_size).str());
+}
+
+void bob::ip::gabor::Similarity::similarities(const Jet& probe, const blitz::Array<double,3>& gallery, blitz::Array<double,1>& scores, int number_of_threads) const{
+  auto probe_data = check(probe, gallery);
+  bob::core::array::assertCZeroBaseContiguous(scores);
+  bob::core::array::assertSameShape(scores, blitz::shape(gallery.extent(0)));
+
+  compute_similarities(probe_data, probe.length(), gallery.data(), 0, gallery.extent(0), scores.data(), number_of_threads);
+}
+
+void bob::ip::gabor::Similarity::similarities(const std::vector<boost::shared_ptr<Jet>>& probe, const blitz::Array<double,4>& gallery, blitz::Array<double,1>& scores, int number_of_threads) const{
+  auto probe_data = check(probe, gallery);
+  bob::core::array::assertCZeroBaseContiguous(scores);
+  bob::core::array::assertSameShape(scores, blitz::shape(gallery.extent(0)));
+
+  compute_similarities(probe_data, probe.front()->length(), gallery.data(), 0, gallery.extent(0), scores.data(), number_of_threads);
+}
+
+void bob::ip::gabor::Similarity::similarities(const Jet& probe, const blitz::Array<double,3>& gallery, const std::vector<int>& indices, blitz::Array<double,1>& scores, int number_of_threads) const{
+  auto probe_data = check(probe, gallery);
+  check_indices(indices, gallery.extent(0), scores);
+
+  compute_similarities(probe_data, probe.length(), gallery.data(), indices.data(), indices.size(), scores.data(), number_of_threads);
+}
+
+void bob::ip::gabor::Similarity::similarities(const std::vector<boost::shared_ptr<Jet>>& probe, const blitz::Array<double,4>& gallery, const std::vector<int>& indices, blitz::Array<double,1>& scores, int number_of_threads) const{
+  auto probe_data = check(probe, gallery);
+  check_indices(indices, gallery.extent(0), scores);
+
+  compute_similarities(probe_data, probe.front()->length(), gallery.data(), indices.data(), indices.size(), scores.data(), number_of_threads);
+}
 
-    const std::vector<blitz::TinyVector<double,2> >& kernels = m_gwt->waveletFrequencies();
 
-    switch (m_type){
-      case DISPARITY:{
-        // compute the similarity using the estimated disparity
-        double sum = 0.;
-        for (int j = 0; j < m_confidences.extent(0); ++j){
-          sum += m_confidences(j) * cos(m_phase_differences(j) - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////  Similarity matrices  //////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The number of bytes of probe and gallery data that should be processed together, so that they stay in the cache
+static const std::size_t TILE_BYTES = 1 << 18;
+// The number of probes and gallery entries that the scalar product kernel computes at once
+static const int BLOCK = 4;
+
+// Copies the absolute values of BLOCK gallery entries into one interleaved panel, i.e., panel[(n*length + j)*BLOCK + b] = gallery[b][n][0][j]
+// Entries beyond gallery_end are replaced by the last entry, so that the kernel does not need to handle borders.
+static void pack_panel(const double* gallery, int first, int gallery_end, int nodes, int length, double* panel){
+  const std::size_t stride = (std::size_t)nodes * 2 * length;
+  for (int b = 0; b < BLOCK; ++b){
+    const double* entry = gallery + std::min(first + b, gallery_end - 1) * stride;
+    for (int n = 0; n < nodes; ++n, entry += 2 * length){
+      double* target = panel + (std::size_t)n * length * BLOCK + b;
+      for (int j = 0; j < length; ++j){
+        target[j * BLOCK] = entry[j];
+      }
+    }
+  }
+}
+
+// Computes the scalar products of BLOCK probes with the BLOCK gallery entries stored in the panel, similar to the micro-kernel of a matrix multiplication
+static void scalar_product_block(const double* const* probes, const double* panel, int nodes, int length, double result[BLOCK][BLOCK]){
+  for (int p = 0; p < BLOCK; ++p)
+    for (int b = 0; b < BLOCK; ++b)
+      result[p][b] = 0.;
+  for (int n = 0; n < nodes; ++n){
+    const std::size_t offset = (std::size_t)n * 2 * length;
+    const double* column = panel + (std::size_t)n * length * BLOCK;
+    for (int j = 0; j < length; ++j, column += BLOCK){
+      for (int p = 0; p < BLOCK; ++p){
+        const double a = probes[p][offset + j];
+        // this loop over the interleaved gallery entries is vectorized
+        for (int b = 0; b < BLOCK; ++b){
+          result[p][b] += a * column[b];
         }
-        return sum;
-      } // DISPARITY
-
-      case PHASE_DIFF:{
-        // compute the similarity using the estimated disparity
-        double sum = 0.;
-        for (int j = 0; j < m_phase_differences.extent(0); ++j){
-          sum += cos(m_phase_differences(j) - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
+      }
+    }
+  }
+}
+
+template <class Kernel>
+void bob::ip::gabor::Similarity::Kernels::SimilarityMatrix::operator()(const Kernel& kernel) const{
+  // the scalar product is computed as a blocked matrix multiplication
+  const bool packed = std::is_same<Kernel, ScalarProduct>::value;
+  // when probes and gallery are identical, the similarity matrix is symmetric
+  const bool symmetric = probes == gallery && probe_size == gallery_size;
+  const std::size_t stride = (std::size_t)nodes * 2 * length;
+
+  // split probes and gallery into tiles that fit into the cache together
+  const int tile = std::max<int>((TILE_BYTES / (2 * stride * sizeof(double))) / BLOCK * BLOCK, BLOCK);
+  const int probe_tiles = (probe_size + tile - 1) / tile, gallery_tiles = (gallery_size + tile - 1) / tile;
+  std::vector<std::pair<int,int>> tiles;
+  for (int p = 0; p < probe_tiles; ++p)
+    for (int g = symmetric ? p : 0; g < gallery_tiles; ++g)
+      tiles.push_back(std::make_pair(p, g));
+
+  parallel_for(tiles.size(), number_of_threads, [&](int begin, int end){
+    // each thread uses its own memory
+    Workspace workspace(similarity.m_type >= DISPARITY ? length : 0);
+    std::vector<double> panels(packed ? (std::size_t)tile * nodes * length : 0);
+    blitz::TinyVector<double,2> disparity;
+
+    for (int t = begin; t < end; ++t){
+      const int probe_begin = tiles[t].first * tile, probe_end = std::min(probe_begin + tile, probe_size);
+      const int gallery_begin = tiles[t].second * tile, gallery_end = std::min(gallery_begin + tile, gallery_size);
+      const bool diagonal = symmetric && tiles[t].first == tiles[t].second;
+
+      if (packed){
+        // pack the absolute values of the gallery tile once
+        for (int g = gallery_begin; g < gallery_end; g += BLOCK)
+          pack_panel(gallery, g, gallery_end, nodes, length, &panels[(std::size_t)(g - gallery_begin) * nodes * length]);
+
+        double result[BLOCK][BLOCK];
+        const double* block[BLOCK];
+        for (int p = probe_begin; p < probe_end; p += BLOCK){
+          // probes beyond the border are replaced by the last probe
+          for (int b = 0; b < BLOCK; ++b)
+            block[b] = probes + std::min(p + b, probe_end - 1) * stride;
+          for (int g = gallery_begin; g < gallery_end; g += BLOCK){
+            scalar_product_block(block, &panels[(std::size_t)(g - gallery_begin) * nodes * length], nodes, length, result);
+            for (int i = p; i < std::min(p + BLOCK, probe_end); ++i){
+              for (int j = g; j < std::min(g + BLOCK, gallery_end); ++j){
+                scores[(std::size_t)i * gallery_size + j] = result[i-p][j-g] / nodes;
+                if (symmetric) scores[(std::size_t)j * gallery_size + i] = result[i-p][j-g] / nodes;
+              }
+            }
+          }
         }
-        return sum / jet1.length();
-      } // PHASE_DIFF
-
-      case PHASE_DIFF_PLUS_CANBERRA:{
-        // compute the similarity using the estimated disparity
-        double sum = 0.;
-        const auto& a1 = jet1.abs(),& a2 = jet2.abs();
-        for (int j = 0; j < m_phase_differences.extent(0); ++j){
-          // add disparity term
-          sum += cos(m_phase_differences(j) - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
-          // add Canberra term
-          sum += 1. - std::abs(a1(j) - a2(j)) / (a1(j) + a2(j));
+      } else {
+        for (int i = probe_begin; i < probe_end; ++i){
+          for (int j = diagonal ? i : gallery_begin; j < gallery_end; ++j){
+            const double* probe = probes + i * stride,* entry = gallery + j * stride;
+            double sum = 0.;
+            for (int n = 0; n < nodes; ++n, probe += 2 * length, entry += 2 * length){
+              sum += kernel(probe, entry, length, workspace, disparity);
+            }
+            scores[(std::size_t)i * gallery_size + j] = sum / nodes;
+            if (symmetric) scores[(std::size_t)j * gallery_size + i] = sum / nodes;
+          }
         }
-        return sum / (2. * jet1.length());
       }
-
-      default:
-        // this should never happen
-        throw std::runtime_error("This should not have happened. Please check the implementation of the similarity() functions.");
     }
+  });
+}
+
+void bob::ip::gabor::Similarity::compute_similarity_matrix(const double* probes, int probe_size, const double* gallery, int gallery_size, int nodes, int length, double* scores, int number_of_threads) const{
+  Kernels::SimilarityMatrix action = {*this, probes, probe_size, gallery, gallery_size, nodes, length, scores, m_thread_safe ? number_of_threads : 1};
+  Kernels::dispatch(*this, action);
+}
+
+void bob::ip::gabor::Similarity::similarity_matrix(const blitz::Array<double,3>& probes, const blitz::Array<double,3>& gallery, blitz::Array<double,2>& scores, int number_of_threads) const{
+  bob::core::array::assertCZeroBaseContiguous(probes);
+  bob::core::array::assertCZeroBaseContiguous(gallery);
+  bob::core::array::assertCZeroBaseContiguous(scores);
+  bob::core::array::assertSameShape(probes, blitz::shape(probes.extent(0), 2, probes.extent(2)));
+  bob::core::array::assertSameShape(gallery, blitz::shape(gallery.extent(0), 2, probes.extent(2)));
+  bob::core::array::assertSameShape(scores, blitz::shape(probes.extent(0), gallery.extent(0)));
+  check(probes.extent(2));
+
+  compute_similarity_matrix(probes.data(), probes.extent(0), gallery.data(), gallery.extent(0), 1, probes.extent(2), scores.data(), number_of_threads);
+}
+
+void bob::ip::gabor::Similarity::similarity_matrix(const blitz::Array<double,4>& probes, const blitz::Array<double,4>& gallery, blitz::Array<double,2>& scores, int number_of_threads) const{
+  bob::core::array::assertCZeroBaseContiguous(probes);
+  bob::core::array::assertCZeroBaseContiguous(gallery);
+  bob::core::array::assertCZeroBaseContiguous(scores);
+  if (probes.extent(1) == 0){
+    throw std::runtime_error("The probe graphs must contain at least one Gabor jet.");
   }
+  bob::core::array::assertSameShape(probes, blitz::shape(probes.extent(0), probes.extent(1), 2, probes.extent(3)));
+  bob::core::array::assertSameShape(gallery, blitz::shape(gallery.extent(0), probes.extent(1), 2, probes.extent(3)));
+  bob::core::array::assertSameShape(scores, blitz::shape(probes.extent(0), gallery.extent(0)));
+  check(probes.extent(3));
+
+  compute_similarity_matrix(probes.data(), probes.extent(0), gallery.data(), gallery.extent(0), probes.extent(1), probes.extent(3), scores.data(), number_of_threads);
 }
 
 
@@ -142,74 +599,88 @@ double bob::ip::gabor::Similarity::similarity(const Jet& jet1, const Jet& jet2)
 ////////////////  Disparity estimation  /////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 blitz::TinyVector<double,2> bob::ip::gabor::Similarity::disparity(const Jet& jet1, const Jet& jet2) const{
+  m_disparity = disparity(jet1, jet2, m_workspace);
+  return m_disparity;
+}
+
+blitz::TinyVector<double,2> bob::ip::gabor::Similarity::disparity(const Jet& jet1, const Jet& jet2, Workspace& workspace) const{
+  if (m_type < DISPARITY){
+    throw std::runtime_error("The disparity computation is not supported for similarity type " + type());
+  }
 
   // Here, only the disparity based similarity functions are executed
-  bob::core::array::assertCZeroBaseContiguous(jet1.jet());
-  bob::core::array::assertCZeroBaseContiguous(jet2.jet());
+  check(jet1);
+  check(jet2);
   bob::core::array::assertSameShape(jet1.jet(),jet2.jet());
 
   // compute confidence vectors
-  compute_confidences(jet1, jet2);
+  workspace.resize(jet1.length());
+  compute_confidences(jet1.jet().data(), jet2.jet().data(), jet1.length(), workspace.confidences.data(), workspace.phase_differences.data());
 
   // now, compute the disparity
-  compute_disparity();
+  blitz::TinyVector<double,2> disparity;
+  compute_disparity(workspace.confidences.data(), workspace.phase_differences.data(), disparity);
 
   // return the disparity
-  return m_disparity;
+  return disparity;
 }
 
-static double adjustPhase(double phase){
-  return phase - (2.*M_PI)*round(phase / (2.*M_PI));
+void bob::ip::gabor::Similarity::shift_phase(const Jet& jet, const Jet& reference, Jet& shifted) const{
+  m_disparity = shift_phase(jet, reference, shifted, m_workspace);
 }
 
-void bob::ip::gabor::Similarity::shift_phase(const Jet& jet, const Jet& reference, Jet& shifted) const{
+blitz::TinyVector<double,2> bob::ip::gabor::Similarity::shift_phase(const Jet& jet, const Jet& reference, Jet& shifted, Workspace& workspace) const{
   bob::core::array::assertSameShape(jet.jet(),reference.jet());
   bob::core::array::assertSameShape(jet.jet(),shifted.jet());
 
   // compute disparity between jet and reference jet
-  disparity(jet, reference);
+  const blitz::TinyVector<double,2> disparity = this->disparity(jet, reference, workspace);
 
   // compute phase shift for each jet entry based on disparity vector
-  const std::vector<blitz::TinyVector<double,2>>& kernels = m_gwt->waveletFrequencies();
   auto& data = shifted.jet();
   // copy data from original jet
   data = jet.jet();
   // shift phases according to the computed disparity
-  for (int j = 0; j < m_phase_differences.extent(0); ++j){
-    data(1,j) = adjustPhase(data(1,j) - m_disparity[0] * kernels[j][0] - m_disparity[1] * kernels[j][1]);
+  const bool fast = fast_math();
+  for (int j = 0; j < jet.length(); ++j){
+    const double phase = data(1,j) - disparity[0] * m_ky[j] - disparity[1] * m_kx[j];
+    data(1,j) = fast ? wrap_phase(phase) : adjustPhase(phase);
   }
+  return disparity;
 }
 
-void bob::ip::gabor::Similarity::compute_confidences(const Jet& jet1, const Jet& jet2) const{
-  if (m_type < DISPARITY){
-    throw std::runtime_error("The disparity computation is not supported for similarity type " + type());
-  }
-  if (jet1.length() != m_confidences.extent(0)){
-    throw std::runtime_error((boost::format("The size of the Gabor jet (%d) and the number of wavelets in the Gabor wavelet transform (%d) differ!") % jet1.length() % m_confidences.extent(0)).str());
-  }
+void bob::ip::gabor::Similarity::compute_confidences(const double* jet1, const double* jet2, int length, double* confidences, double* phase_differences) const{
   // first, fill confidence and phase difference vectors
-  const auto& a1 = jet1.abs(),& a2 = jet2.abs(),& p1 = jet1.phase(),& p2 = jet2.phase();
-  for (int j = 0; j < m_confidences.extent(0); ++j){
-    m_confidences(j) = a1(j) * a2(j);
-    m_phase_differences(j) = adjustPhase(p1(j) - p2(j));
+  const double* p1 = jet1 + length,* p2 = jet2 + length;
+  if (fast_math()){
+#pragma omp simd
+    for (int j = 0; j < length; ++j){
+      confidences[j] = jet1[j] * jet2[j];
+      phase_differences[j] = wrap_phase(p1[j] - p2[j]);
+    }
+  } else {
+    for (int j = 0; j < length; ++j){
+      confidences[j] = jet1[j] * jet2[j];
+      phase_differences[j] = adjustPhase(p1[j] - p2[j]);
+    }
   }
 }
 
-void bob::ip::gabor::Similarity::compute_disparity() const{
+void bob::ip::gabor::Similarity::compute_disparity(const double* confidences, const double* phase_differences, blitz::TinyVector<double,2>& disparity) const{
   // approximate the disparity from the phase differences
   double gamma_x_x = 0., gamma_x_y = 0., gamma_y_y = 0., phi_x = 0., phi_y = 0.;
   // initialize the disparity with 0
-  m_disparity = 0.;
+  disparity = 0.;
+  const bool fast = fast_math();
 
-  const std::vector<blitz::TinyVector<double,2> >& kernels = m_gwt->waveletFrequencies();
   // iterate backwards through the vector to start with the lowest frequency wavelets
-  for (int j = m_confidences.extent(0)-1, level = m_gwt->numberOfScales()-1; level >= 0; --level){
+  for (int j = m_gwt->numberOfWavelets()-1, level = m_gwt->numberOfScales()-1; level >= 0; --level){
     for (int direction = m_gwt->numberOfDirections()-1; direction >= 0; --direction, --j){
       double
-          kjx = kernels[j][1],
-          kjy = kernels[j][0],
-          conf = m_confidences(j),
-          diff = m_phase_differences(j);
+          kjx = m_kx[j],
+          kjy = m_ky[j],
+          conf = confidences[j],
+          diff = phase_differences[j];
 
       // totalize gamma matrix
       gamma_x_x += kjx * kjx * conf;
@@ -218,7 +689,8 @@ void bob::ip::gabor::Similarity::compute_disparity() const{
 
       // totalize phi vector
       // estimate the number of cycles that we are off
-      double nL = round((diff - m_disparity[1] * kjx - m_disparity[0] * kjy) / (2.*M_PI));
+      const double cycles = (diff - disparity[1] * kjx - disparity[0] * kjy) / (2.*M_PI);
+      double nL = fast ? round_nearest(cycles) : round(cycles);
       // totalize corrected phi vector elements
       phi_x += (diff - nL * 2. * M_PI) * conf * kjx;
       phi_y += (diff - nL * 2. * M_PI) * conf * kjy;
@@ -226,15 +698,283 @@ void bob::ip::gabor::Similarity::compute_disparity() const{
 
     // re-calculate disparity as d=\Gamma^{-1}\Phi of the (low frequency) wavelet scales that we used up to now
     double gamma_det = gamma_x_x * gamma_y_y - sqr(gamma_x_y);
-    m_disparity[1] = (gamma_y_y * phi_x - gamma_x_y * phi_y) / gamma_det;
-    m_disparity[0] = (gamma_x_x * phi_y - gamma_x_y * phi_x) / gamma_det;
+    disparity[1] = (gamma_y_y * phi_x - gamma_x_y * phi_y) / gamma_det;
+    disparity[0] = (gamma_x_x * phi_y - gamma_x_y * phi_x) / gamma_det;
   } // for level
 }
 
 
+// The number of jet pairs that are processed at once by the batch disparity estimation
+static const int DISPARITY_GROUP = 8;
+
+// the sums of the confidence weighted cosines of the disparity corrected phase differences of a group of jet pairs, which are stored in structure-of-arrays layout
+template <bool fast>
+static void group_disparity_terms(const double* kx, const double* ky, const double* confidences, const double* phase_differences, const double* disparity_x, const double* disparity_y, int length, double* sums){
+  const int G = DISPARITY_GROUP;
+  for (int j = 0; j < length; ++j){
+    const double* conf = confidences + j*G,* diff = phase_differences + j*G;
+#pragma omp simd
+    for (int p = 0; p < G; ++p){
+      sums[p] += conf[p] * cosine<fast>(diff[p] - disparity_x[p] * kx[j] - disparity_y[p] * ky[j]);
+    }
+  }
+}
+
+void bob::ip::gabor::Similarity::compute_disparities(const double* const* jets1, const double* const* jets2, int pairs, Workspace& workspace, double* disparities, double* similarities) const{
+  const int length = m_kx.size(), G = DISPARITY_GROUP;
+  // confidences and phase differences are stored in structure-of-arrays layout, i.e., confidences[j*G + p] for wavelet j of pair p
+  workspace.resize(length * G);
+  double* confidences = workspace.confidences.data(),* phase_differences = workspace.phase_differences.data();
+  double norms1[G] = {0.}, norms2[G] = {0.};
+  // the phases are wrapped and the cycles are rounded exactly as in compute_confidences and compute_disparity
+  const bool fast = fast_math();
+  for (int p = 0; p < G; ++p){
+    if (p < pairs){
+      const double* jet1 = jets1[p],* jet2 = jets2[p];
+      for (int j = 0; j < length; ++j){
+        confidences[j*G + p] = jet1[j] * jet2[j];
+        const double diff = jet1[length + j] - jet2[length + j];
+        phase_differences[j*G + p] = fast ? wrap_phase(diff) : adjustPhase(diff);
+        norms1[p] += jet1[j] * jet1[j];
+        norms2[p] += jet2[j] * jet2[j];
+      }
+    } else {
+      // unused pairs get a well-defined (zero) disparity
+      for (int j = 0; j < length; ++j){
+        confidences[j*G + p] = 1.;
+        phase_differences[j*G + p] = 0.;
+      }
+    }
+  }
+
+  // the same scale-wise estimation as in compute_disparity, but vectorized over the pairs
+  double gamma_x_x[G] = {0.}, gamma_x_y[G] = {0.}, gamma_y_y[G] = {0.}, phi_x[G] = {0.}, phi_y[G] = {0.}, disparity_x[G] = {0.}, disparity_y[G] = {0.};
+  for (int j = length-1, level = m_gwt->numberOfScales()-1; level >= 0; --level){
+    for (int direction = m_gwt->numberOfDirections()-1; direction >= 0; --direction, --j){
+      const double kjx = m_kx[j], kjy = m_ky[j];
+      const double* conf = confidences + j*G,* diff = phase_differences + j*G;
+#pragma omp simd
+      for (int p = 0; p < G; ++p){
+        gamma_x_x[p] += kjx * kjx * conf[p];
+        gamma_x_y[p] += kjx * kjy * conf[p];
+        gamma_y_y[p] += kjy * kjy * conf[p];
+
+        const double cycles = (diff[p] - disparity_x[p] * kjx - disparity_y[p] * kjy) / (2.*M_PI);
+        double nL = fast ? round_nearest(cycles) : round(cycles);
+        phi_x[p] += (diff[p] - nL * 2. * M_PI) * conf[p] * kjx;
+        phi_y[p] += (diff[p] - nL * 2. * M_PI) * conf[p] * kjy;
+      }
+    }
+
+#pragma omp simd
+    for (int p = 0; p < G; ++p){
+      double gamma_det = gamma_x_x[p] * gamma_y_y[p] - gamma_x_y[p] * gamma_x_y[p];
+      disparity_x[p] = (gamma_y_y[p] * phi_x[p] - gamma_x_y[p] * phi_y[p]) / gamma_det;
+      disparity_y[p] = (gamma_x_x[p] * phi_y[p] - gamma_x_y[p] * phi_x[p]) / gamma_det;
+    }
+  }
+
+  for (int p = 0; p < pairs; ++p){
+    disparities[2*p] = disparity_y[p];
+    disparities[2*p+1] = disparity_x[p];
+  }
+
+  if (similarities){
+    // the DISPARITY similarity of the normalized Gabor jets
+    double sums[G] = {0.};
+    if (fast)
+      group_disparity_terms<true>(m_kx.data(), m_ky.data(), confidences, phase_differences, disparity_x, disparity_y, length, sums);
+    else
+      group_disparity_terms<false>(m_kx.data(), m_ky.data(), confidences, phase_differences, disparity_x, disparity_y, length, sums);
+    for (int p = 0; p < pairs; ++p){
+      const double norm = std::sqrt(norms1[p] * norms2[p]);
+      similarities[p] = norm > 0. ? sums[p] / norm : 0.;
+    }
+  }
+}
+
+void bob::ip::gabor::Similarity::disparities(const blitz::Array<double,3>& jets1, const blitz::Array<double,3>& jets2, blitz::Array<double,2>& disparities, int number_of_threads) const{
+  if (m_type < DISPARITY){
+    throw std::runtime_error("The disparity computation is not supported for similarity type " + type());
+  }
+  bob::core::array::assertCZeroBaseContiguous(jets1);
+  bob::core::array::assertCZeroBaseContiguous(jets2);
+  bob::core::array::assertCZeroBaseContiguous(disparities);
+  bob::core::array::assertSameShape(jets1, blitz::shape(jets1.extent(0), 2, m_gwt->numberOfWavelets()));
+  bob::core::array::assertSameShape(jets2, jets1);
+  bob::core::array::assertSameShape(disparities, blitz::shape(jets1.extent(0), 2));
+
+  const int pairs = jets1.extent(0), groups = (pairs + DISPARITY_GROUP - 1) / DISPARITY_GROUP, stride = 2 * jets1.extent(2);
+  const double* data1 = jets1.data(),* data2 = jets2.data();
+  double* result = disparities.data();
+  parallel_for(groups, number_of_threads, [&](int begin, int end){
+    Workspace workspace;
+    const double* group1[DISPARITY_GROUP],* group2[DISPARITY_GROUP];
+    for (int g = begin; g < end; ++g){
+      const int first = g * DISPARITY_GROUP, count = std::min(DISPARITY_GROUP, pairs - first);
+      for (int p = 0; p < count; ++p){
+        group1[p] = data1 + (std::size_t)(first + p) * stride;
+        group2[p] = data2 + (std::size_t)(first + p) * stride;
+      }
+      compute_disparities(group1, group2, count, workspace, result + 2 * first);
+    }
+  });
+}
+
+
+// shifts the phases of the jet by the given disparity and writes the result to shifted, which might be identical to jet
+template <bool fast>
+static void shift_jet(const double* jet, const double* kx, const double* ky, const double* disparity, int length, double* shifted){
+  const double dy = disparity[0], dx = disparity[1];
+#pragma omp simd
+  for (int j = 0; j < length; ++j){
+    shifted[j] = jet[j];
+    const double phase = jet[length + j] - dy * ky[j] - dx * kx[j];
+    shifted[length + j] = fast ? bob::ip::gabor::wrap_phase(phase) : adjustPhase(phase);
+  }
+}
+
+void bob::ip::gabor::Similarity::compute_shift_phases(const double* jets, const double* references, int reference_stride, int count, double* shifted, double* disparities, int number_of_threads) const{
+  const int length = m_kx.size(), stride = 2 * length, groups = (count + DISPARITY_GROUP - 1) / DISPARITY_GROUP;
+  const bool fast = fast_math();
+  parallel_for(groups, number_of_threads, [&](int begin, int end){
+    Workspace workspace;
+    const double* group1[DISPARITY_GROUP],* group2[DISPARITY_GROUP];
+    for (int g = begin; g < end; ++g){
+      const int first = g * DISPARITY_GROUP, pairs = std::min(DISPARITY_GROUP, count - first);
+      for (int p = 0; p < pairs; ++p){
+        group1[p] = jets + (std::size_t)(first + p) * stride;
+        group2[p] = references + (std::size_t)(first + p) * reference_stride;
+      }
+      // all disparities of the group are estimated before any of the jets is shifted, so that the jets can be shifted in place
+      compute_disparities(group1, group2, pairs, workspace, disparities + 2 * first);
+      for (int p = 0; p < pairs; ++p){
+        double* target = shifted + (std::size_t)(first + p) * stride;
+        if (fast)
+          shift_jet<true>(group1[p], m_kx.data(), m_ky.data(), disparities + 2 * (first + p), length, target);
+        else
+          shift_jet<false>(group1[p], m_kx.data(), m_ky.data(), disparities + 2 * (first + p), length, target);
+      }
+    }
+  });
+}
+
+void bob::ip::gabor::Similarity::check_shift(const blitz::Array<double,3>& jets, const blitz::Array<double,3>& shifted, const blitz::Array<double,2>& disparities) const{
+  if (m_type < DISPARITY){
+    throw std::runtime_error("The phase shift is not supported for similarity type " + type());
+  }
+  bob::core::array::assertCZeroBaseContiguous(jets);
+  bob::core::array::assertCZeroBaseContiguous(shifted);
+  bob::core::array::assertCZeroBaseContiguous(disparities);
+  bob::core::array::assertSameShape(jets, blitz::shape(jets.extent(0), 2, m_gwt->numberOfWavelets()));
+  bob::core::array::assertSameShape(shifted, jets);
+  bob::core::array::assertSameShape(disparities, blitz::shape(jets.extent(0), 2));
+}
+
+void bob::ip::gabor::Similarity::shift_phases(const blitz::Array<double,3>& jets, const blitz::Array<double,3>& references, blitz::Array<double,3>& shifted, blitz::Array<double,2>& disparities, int number_of_threads) const{
+  check_shift(jets, shifted, disparities);
+  bob::core::array::assertCZeroBaseContiguous(references);
+  bob::core::array::assertSameShape(references, jets);
+  compute_shift_phases(jets.data(), references.data(), 2 * jets.extent(2), jets.extent(0), shifted.data(), disparities.data(), number_of_threads);
+}
+
+void bob::ip::gabor::Similarity::shift_phases(const blitz::Array<double,3>& jets, const Jet& reference, blitz::Array<double,3>& shifted, blitz::Array<double,2>& disparities, int number_of_threads) const{
+  check_shift(jets, shifted, disparities);
+  check(reference);
+  // the common reference is used for all jets
+  compute_shift_phases(jets.data(), reference.jet().data(), 0, jets.extent(0), shifted.data(), disparities.data(), number_of_threads);
+}
+
+// Provides the Gabor jets of a trafo image of shape (length, height, width), which are converted into absolute values and phases in the given buffer
+struct TrafoImageJets{
+  TrafoImageJets(const blitz::Array<std::complex<double>,3>& image) : image(image), length(image.extent(0)), fast(bob::ip::gabor::fast_math()) {}
+  const double* operator()(int y, int x, double* buffer) const {
+    if (fast){
+      for (int j = 0; j < length; ++j){
+        const double real = image(j, y, x).real(), imag = image(j, y, x).imag();
+        buffer[j] = std::sqrt(real * real + imag * imag);
+        buffer[length + j] = bob::ip::gabor::fast_atan2(imag, real);
+      }
+    } else {
+      for (int j = 0; j < length; ++j){
+        buffer[j] = std::abs(image(j, y, x));
+        buffer[length + j] = std::arg(image(j, y, x));
+      }
+    }
+    return buffer;
+  }
+  const blitz::Array<std::complex<double>,3>& image;
+  const int length;
+  const bool fast;
+};
+
+// Provides the Gabor jets of a jet image of shape (height, width, 2, length) without copying them
+struct JetImageJets{
+  JetImageJets(const blitz::Array<double,4>& image) : data(image.data()), width(image.extent(1)), stride(2 * image.extent(3)) {}
+  const double* operator()(int y, int x, double*) const {
+    return data + ((std::size_t)y * width + x) * stride;
+  }
+  const double* data;
+  const int width, stride;
+};
+
+template <class Image>
+void bob::ip::gabor::Similarity::Kernels::disparity_field(const Similarity& similarity, const Image& image1, const Image& image2, const blitz::TinyVector<int,2>& first, const blitz::TinyVector<int,2>& step, double* disparities, double* confidences, int height, int width, int number_of_threads){
+  const int size = height * width, groups = (size + DISPARITY_GROUP - 1) / DISPARITY_GROUP, length = similarity.m_kx.size();
+  parallel_for(groups, number_of_threads, [&](int begin, int end){
+    Workspace workspace;
+    std::vector<double> buffer(4 * DISPARITY_GROUP * length);
+    const double* group1[DISPARITY_GROUP],* group2[DISPARITY_GROUP];
+    for (int g = begin; g < end; ++g){
+      // the grid positions are enumerated in row-major order
+      const int index = g * DISPARITY_GROUP, count = std::min(DISPARITY_GROUP, size - index);
+      for (int p = 0; p < count; ++p){
+        const int y = first[0] + (index + p) / width * step[0], x = first[1] + (index + p) % width * step[1];
+        group1[p] = image1(y, x, &buffer[2 * p * length]);
+        group2[p] = image2(y, x, &buffer[2 * (DISPARITY_GROUP + p) * length]);
+      }
+      similarity.compute_disparities(group1, group2, count, workspace, disparities + 2 * index, confidences + index);
+    }
+  });
+}
+
+void bob::ip::gabor::Similarity::check_grid(int height, int width, const blitz::TinyVector<int,2>& first, const blitz::TinyVector<int,2>& step, const blitz::Array<double,3>& disparities, const blitz::Array<double,2>& confidences) const{
+  if (m_type < DISPARITY){
+    throw std::runtime_error("The disparity computation is not supported for similarity type " + type());
+  }
+  bob::core::array::assertCZeroBaseContiguous(disparities);
+  bob::core::array::assertCZeroBaseContiguous(confidences);
+  bob::core::array::assertSameShape(disparities, blitz::shape(confidences.extent(0), confidences.extent(1), 2));
+  if (step[0] < 1 || step[1] < 1){
+    throw std::runtime_error((boost::format("The step (%d, %d) of the disparity grid must be positive") % step[0] % step[1]).str());
+  }
+  const int last_y = first[0] + (confidences.extent(0) - 1) * step[0], last_x = first[1] + (confidences.extent(1) - 1) * step[1];
+  if (confidences.size() && (first[0] < 0 || first[1] < 0 || last_y >= height || last_x >= width)){
+    throw std::runtime_error((boost::format("The disparity grid from (%d, %d) to (%d, %d) is out of range [0, %d[, [0, %d[") % first[0] % first[1] % last_y % last_x % height % width).str());
+  }
+}
+
+void bob::ip::gabor::Similarity::disparity_field(const blitz::Array<std::complex<double>,3>& image1, const blitz::Array<std::complex<double>,3>& image2, const blitz::TinyVector<int,2>& first, const blitz::TinyVector<int,2>& step, blitz::Array<double,3>& disparities, blitz::Array<double,2>& confidences, int number_of_threads) const{
+  bob::core::array::assertSameShape(image2, image1);
+  check(image1.extent(0));
+  check_grid(image1.extent(1), image1.extent(2), first, step, disparities, confidences);
+  Kernels::disparity_field(*this, TrafoImageJets(image1), TrafoImageJets(image2), first, step, disparities.data(), confidences.data(), confidences.extent(0), confidences.extent(1), number_of_threads);
+}
+
+void bob::ip::gabor::Similarity::disparity_field(const blitz::Array<double,4>& image1, const blitz::Array<double,4>& image2, const blitz::TinyVector<int,2>& first, const blitz::TinyVector<int,2>& step, blitz::Array<double,3>& disparities, blitz::Array<double,2>& confidences, int number_of_threads) const{
+  bob::core::array::assertCZeroBaseContiguous(image1);
+  bob::core::array::assertCZeroBaseContiguous(image2);
+  bob::core::array::assertSameShape(image1, blitz::shape(image1.extent(0), image1.extent(1), 2, image1.extent(3)));
+  bob::core::array::assertSameShape(image2, image1);
+  check(image1.extent(3));
+  check_grid(image1.extent(0), image1.extent(1), first, step, disparities, confidences);
+  Kernels::disparity_field(*this, JetImageJets(image1), JetImageJets(image2), first, step, disparities.data(), confidences.data(), confidences.extent(0), confidences.extent(1), number_of_threads);
+}
+
+
 void bob::ip::gabor::Similarity::save(bob::io::base::HDF5File& file) const{
 
-  file.set("Type", type_to_name(m_type));
+  file.set("Type", m_name);
   if (m_type >= DISPARITY){
     file.createGroup("Transform");
     file.cd("Transform");
@@ -246,14 +986,15 @@ void bob::ip::gabor::Similarity::save(bob::io::base::HDF5File& file) const{
 
 void bob::ip::gabor::Similarity::load(bob::io::base::HDF5File& file){
   // read value
-  m_type = name_to_type(file.read<std::string>("Type"));
+  m_name = file.read<std::string>("Type");
+  m_type = name_to_type(m_name);
 
   if (m_type >= DISPARITY){
     file.cd("Transform");
     m_gwt.reset(new Transform(file));
     file.cd("..");
-
-    init();
   }
+
+  init();
 }
 
@@ -0,0 +1,285 @@
+/**
+ * @date Sat Oct 17 23:26:25 UTC 2026
+ *
+ * @brief Bindings for the fixed-point Gabor jet similarities
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.extension/documentation.h>
+
+#include "gil.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto FixedPointSimilarity_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".FixedPointSimilarity",
+  "Computes Gabor jet similarities on quantized Gabor jets using integer arithmetic only",
+  "On devices without fast floating point units, the similarity functions of :py:class:`bob.ip.gabor.Similarity` are slow. "
+  "This class works on quantized Gabor jets (see :py:meth:`quantize`), which are stored as ``uint16`` arrays of shape ``(2, length)``. "
+  "The first row contains the absolute values in fixed-point format with 16 fractional bits, where the absolute values are clipped to ``[0, 1]`` -- hence, the Gabor jets need to be normalized. "
+  "The second row contains the phases as indices of :math:`2^{16}` equally spaced angles in :math:`[0, 2\\pi[`, so that differences of phases wrap around automatically.\n\n"
+  "All sums are computed in integer arithmetic, where the cosines of the phase differences are taken from a table with 4096 entries. "
+  "Only the final score is converted to floating point, and it deviates from the score of :py:class:`bob.ip.gabor.Similarity` by less than ``1e-3``.\n\n"
+  "Only the similarity functions ``'ScalarProduct'``, ``'Canberra'`` and ``'AbsPhase'`` are available, since the disparity based functions require floating point disparity estimation. "
+  "In contrast to the floating point version, the Canberra similarity of two vanishing absolute values is ``1``."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates a fixed-point similarity function of the given type",
+    0,
+    true
+  )
+  .add_prototype("type", "")
+  .add_parameter("type", "str", "The type of the similarity function; possible values are ``'ScalarProduct'``, ``'Canberra'`` and ``'AbsPhase'``")
+);
+
+static int PyBobIpGaborFixedPointSimilarity_init(PyBobIpGaborFixedPointSimilarityObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = FixedPointSimilarity_doc.kwlist();
+
+  const char* name;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", kwlist, &name)) return -1;
+  self->cxx.reset(new bob::ip::gabor::FixedPointSimilarity(name));
+  return 0;
+BOB_CATCH_MEMBER("FixedPointSimilarity constructor", -1)
+}
+
+static void PyBobIpGaborFixedPointSimilarity_delete(PyBobIpGaborFixedPointSimilarityObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborFixedPointSimilarity_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborFixedPointSimilarity_Type));
+}
+
+// checks that the given array is a quantized jet (or a 3D array of quantized jets); returns false on error
+static bool check_quantized(PyBobIpGaborFixedPointSimilarityObject* self, PyBlitzArrayObject* jets, int ndim, const char* name){
+  if (jets->type_num != NPY_UINT16 || jets->ndim != ndim) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `%s' to be a %dD array of type uint16", Py_TYPE(self)->tp_name, name, ndim);
+    return false;
+  }
+  return true;
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto type_doc = bob::extension::VariableDoc(
+  "type",
+  "str",
+  "The type of the similarity function, read only"
+);
+PyObject* PyBobIpGaborFixedPointSimilarity_type(PyBobIpGaborFixedPointSimilarityObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("s", self->cxx->name().c_str());
+BOB_CATCH_MEMBER("type", 0)
+}
+
+static PyGetSetDef PyBobIpGaborFixedPointSimilarity_getseters[] = {
+  {
+    type_doc.name(),
+    (getter)PyBobIpGaborFixedPointSimilarity_type,
+    0,
+    type_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto quantize_doc = bob::extension::FunctionDoc(
+  "quantize",
+  "Quantizes the given Gabor jet or the given Gabor jets",
+  "The absolute values are clipped to ``[0, 1]`` and rounded to multiples of :math:`1/65535`, and the phases are rounded to multiples of :math:`2\\pi/65536`. "
+  "The quantization does not depend on the :py:attr:`type`.",
+  true
+)
+.add_prototype("jet", "quantized")
+.add_prototype("jets", "quantized")
+.add_parameter("jet", ":py:class:`bob.ip.gabor.Jet`", "The (normalized) Gabor jet to quantize")
+.add_parameter("jets", "array_like (float, 3D)", "The (normalized) Gabor jets of shape ``(N, 2, length)`` to quantize")
+.add_return("quantized", "array_like (uint16, 2D or 3D)", "The quantized Gabor jet(s), of shape ``(2, length)`` or ``(N, 2, length)``")
+;
+
+static PyObject* PyBobIpGaborFixedPointSimilarity_quantize(PyBobIpGaborFixedPointSimilarityObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist1 = quantize_doc.kwlist(0);
+  char** kwlist2 = quantize_doc.kwlist(1);
+
+  // two ways to call
+  PyObject* k = Py_BuildValue("s", kwlist1[0]);
+  auto k_ = make_safe(k);
+  if (
+    (kwargs && PyDict_Contains(kwargs, k)) ||
+    (args && PyTuple_Size(args) == 1 && PyBobIpGaborJet_Check(PyTuple_GetItem(args, 0)))
+  ){
+    PyBobIpGaborJetObject* jet;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist1, &PyBobIpGaborJet_Type, &jet)) return 0;
+
+    blitz::Array<uint16_t,2> quantized(2, jet->cxx->length());
+    bob::ip::gabor::FixedPointSimilarity::quantize(*jet->cxx, quantized);
+    return PyBlitzArrayCxx_AsNumpy(quantized);
+  }
+
+  PyBlitzArrayObject* jets;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist2, &PyBlitzArray_Converter, &jets)) return 0;
+
+  auto jets_ = make_safe(jets);
+  if (jets->type_num != NPY_FLOAT64 || jets->ndim != 3) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `jets' to be a 3D array of type float", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+
+  blitz::Array<uint16_t,3> quantized(jets->shape[0], jets->shape[1], jets->shape[2]);
+  bob::ip::gabor::FixedPointSimilarity::quantize(*PyBlitzArrayCxx_AsBlitz<double,3>(jets), quantized);
+  return PyBlitzArrayCxx_AsNumpy(quantized);
+BOB_CATCH_MEMBER("quantize", 0)
+}
+
+static auto similarity_doc = bob::extension::FunctionDoc(
+  "similarity",
+  "Computes the similarity between the given quantized Gabor jets",
+  ".. note::\n\n  The function :py:func:`__call__` is a synonym for this function.",
+  true
+)
+.add_prototype("jet1, jet2", "sim")
+.add_parameter("jet1", "array_like (uint16, 2D)", "The first quantized Gabor jet of shape ``(2, length)``")
+.add_parameter("jet2", "array_like (uint16, 2D)", "The second quantized Gabor jet of the same shape")
+.add_return("sim", "float", "The similarity between the two quantized Gabor jets")
+;
+
+static PyObject* PyBobIpGaborFixedPointSimilarity_similarity(PyBobIpGaborFixedPointSimilarityObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = similarity_doc.kwlist();
+
+  PyBlitzArrayObject* jet1,* jet2;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&", kwlist, &PyBlitzArray_Converter, &jet1, &PyBlitzArray_Converter, &jet2)) return 0;
+
+  auto jet1_ = make_safe(jet1), jet2_ = make_safe(jet2);
+  if (!check_quantized(self, jet1, 2, "jet1") || !check_quantized(self, jet2, 2, "jet2")) return 0;
+
+  double sim = self->cxx->similarity(*PyBlitzArrayCxx_AsBlitz<uint16_t,2>(jet1), *PyBlitzArrayCxx_AsBlitz<uint16_t,2>(jet2));
+  return Py_BuildValue("d", sim);
+BOB_CATCH_MEMBER("similarity", 0)
+}
+
+static auto similarities_doc = bob::extension::FunctionDoc(
+  "similarities",
+  "Computes the similarities between the given quantized probe jet and all quantized jets of the gallery",
+  0,
+  true
+)
+.add_prototype("probe, gallery, [scores], [number_of_threads]", "scores")
+.add_parameter("probe", "array_like (uint16, 2D)", "The quantized probe jet of shape ``(2, length)``")
+.add_parameter("gallery", "array_like (uint16, 3D)", "The quantized gallery jets, stored contiguously in shape ``(N, 2, length)``")
+.add_parameter("scores", "array_like (float, 1D)", "[Default: ``None``] If given, the scores will be written into this array of shape ``(N,)``")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads, over which the gallery is distributed; ``0`` selects one thread per available core")
+.add_return("scores", "array_like (float, 1D)", "The similarities between the probe and all gallery jets")
+;
+
+static PyObject* PyBobIpGaborFixedPointSimilarity_similarities(PyBobIpGaborFixedPointSimilarityObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = similarities_doc.kwlist();
+
+  PyBlitzArrayObject* probe,* gallery,* scores = 0;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|O&i", kwlist, &PyBlitzArray_Converter, &probe, &PyBlitzArray_Converter, &gallery, &PyBlitzArray_OutputConverter, &scores, &threads)) return 0;
+
+  auto probe_ = make_safe(probe), gallery_ = make_safe(gallery);
+  auto scores_ = make_xsafe(scores);
+  if (!check_quantized(self, probe, 2, "probe") || !check_quantized(self, gallery, 3, "gallery")) return 0;
+
+  if (scores){
+    if (scores->type_num != NPY_FLOAT64 || scores->ndim != 1) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `scores' to be a 1D array of type float", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[] = {gallery->shape[0]};
+    scores = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, osize);
+    scores_ = make_safe(scores);
+  }
+
+  // the C++ objects stay alive while the global interpreter lock is released
+  auto similarity = self->cxx;
+  auto& blitz_probe = *PyBlitzArrayCxx_AsBlitz<uint16_t,2>(probe);
+  auto& blitz_gallery = *PyBlitzArrayCxx_AsBlitz<uint16_t,3>(gallery);
+  auto& blitz_scores = *PyBlitzArrayCxx_AsBlitz<double,1>(scores);
+  if (!without_gil([&](){similarity->similarities(blitz_probe, blitz_gallery, blitz_scores, threads);})) return 0;
+  return PyBlitzArray_AsNumpyArray(scores, 0);
+BOB_CATCH_MEMBER("similarities", 0)
+}
+
+
+static PyMethodDef PyBobIpGaborFixedPointSimilarity_methods[] = {
+  {
+    quantize_doc.name(),
+    (PyCFunction)PyBobIpGaborFixedPointSimilarity_quantize,
+    METH_VARARGS|METH_KEYWORDS,
+    quantize_doc.doc()
+  },
+  {
+    similarity_doc.name(),
+    (PyCFunction)PyBobIpGaborFixedPointSimilarity_similarity,
+    METH_VARARGS|METH_KEYWORDS,
+    similarity_doc.doc()
+  },
+  {
+    similarities_doc.name(),
+    (PyCFunction)PyBobIpGaborFixedPointSimilarity_similarities,
+    METH_VARARGS|METH_KEYWORDS,
+    similarities_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the FixedPointSimilarity type struct; will be initialized later
+PyTypeObject PyBobIpGaborFixedPointSimilarity_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+bool init_BobIpGaborFixedPointSimilarity(PyObject* module)
+{
+
+  // initialize the FixedPointSimilarity type struct
+  PyBobIpGaborFixedPointSimilarity_Type.tp_name = FixedPointSimilarity_doc.name();
+  PyBobIpGaborFixedPointSimilarity_Type.tp_basicsize = sizeof(PyBobIpGaborFixedPointSimilarityObject);
+  PyBobIpGaborFixedPointSimilarity_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborFixedPointSimilarity_Type.tp_doc = FixedPointSimilarity_doc.doc();
+
+  // set the functions
+  PyBobIpGaborFixedPointSimilarity_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborFixedPointSimilarity_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborFixedPointSimilarity_init);
+  PyBobIpGaborFixedPointSimilarity_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborFixedPointSimilarity_delete);
+  PyBobIpGaborFixedPointSimilarity_Type.tp_methods = PyBobIpGaborFixedPointSimilarity_methods;
+  PyBobIpGaborFixedPointSimilarity_Type.tp_getset = PyBobIpGaborFixedPointSimilarity_getseters;
+  PyBobIpGaborFixedPointSimilarity_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobIpGaborFixedPointSimilarity_similarity);
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborFixedPointSimilarity_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborFixedPointSimilarity_Type);
+  return PyModule_AddObject(module, "FixedPointSimilarity", (PyObject*)&PyBobIpGaborFixedPointSimilarity_Type) >= 0;
+}
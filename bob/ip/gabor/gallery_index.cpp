@@ -0,0 +1,573 @@
+/**
+ * @date Sun Oct 18 00:37:44 UTC 2026
+ *
+ * @brief Bindings for the top-k gallery index
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.io.base/api.h>
+#include <bob.extension/documentation.h>
+
+#include "gil.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto GalleryIndex_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".GalleryIndex",
+  "Stores enrolled Gabor graphs and returns the most similar ones for a probe graph",
+  "Each enrolled graph is a list of :py:class:`bob.ip.gabor.Jet`'s, which is stored under an integral id, e.g., the id of the client or of the enrollment file. "
+  "All graphs need to have the same number of nodes and jets of the same length, which is defined by the first graph that is added. "
+  "Graphs can be added and removed at any time.\n\n"
+  "The :py:meth:`search` returns only the ``k`` best results, sorted by descending score. "
+  "The scores are the average similarities of corresponding nodes, computed with the given :py:class:`bob.ip.gabor.Similarity`. "
+  "The gallery is split into one partition per thread, and each partition keeps only the ``k`` best results, so the scores of the whole gallery are never sorted.\n\n"
+  "Optionally, the scores can be normalized with respect to a cohort of graphs, see :py:meth:`set_normalization`. "
+  "The statistics of the cohort scores of the enrolled graphs are computed when the graphs are enrolled, and they are stored together with the graphs in :py:meth:`save`, so that only the T-norm statistics of the probe need to be computed in :py:meth:`search`."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates an empty gallery index, or loads a gallery index from file",
+    0,
+    true
+  )
+  .add_prototype("similarity", "")
+  .add_prototype("hdf5", "")
+  .add_parameter("similarity", ":py:class:`bob.ip.gabor.Similarity`", "The similarity function used to compute the scores")
+  .add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading to load the gallery index from")
+);
+
+static int PyBobIpGaborGalleryIndex_init(PyBobIpGaborGalleryIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist1 = GalleryIndex_doc.kwlist(1);
+  char** kwlist2 = GalleryIndex_doc.kwlist(0);
+
+  // two ways to call
+  PyObject* k = Py_BuildValue("s", kwlist1[0]);
+  auto k_ = make_safe(k);
+  if (
+    (kwargs && PyDict_Contains(kwargs, k)) ||
+    (args && PyTuple_Size(args) == 1 && PyBobIoHDF5File_Check(PyTuple_GetItem(args, 0)))
+  ){
+    PyBobIoHDF5FileObject* hdf5;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist1, &PyBobIoHDF5File_Converter, &hdf5)) return -1;
+
+    auto hdf5_ = make_safe(hdf5);
+    self->cxx.reset(new bob::ip::gabor::GalleryIndex(*hdf5->f));
+  } else {
+    PyBobIpGaborSimilarityObject* similarity;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist2, &PyBobIpGaborSimilarity_Type, &similarity)) return -1;
+    self->cxx.reset(new bob::ip::gabor::GalleryIndex(similarity->cxx));
+  }
+  return 0;
+BOB_CATCH_MEMBER("GalleryIndex constructor", -1)
+}
+
+static void PyBobIpGaborGalleryIndex_delete(PyBobIpGaborGalleryIndexObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborGalleryIndex_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborGalleryIndex_Type));
+}
+
+static Py_ssize_t PyBobIpGaborGalleryIndex_len(PyBobIpGaborGalleryIndexObject* self) {
+  return self->cxx->size();
+}
+
+static int PyBobIpGaborGalleryIndex_contains(PyBobIpGaborGalleryIndexObject* self, PyObject* value) {
+  long id = PyLong_AsLong(value);
+  if (PyErr_Occurred()) return -1;
+  return self->cxx->contains(id);
+}
+
+// extracts the Gabor jets of a graph from the given iterable; returns false on error
+static bool get_graph(PyBobIpGaborGalleryIndexObject* self, PyObject* graph, const char* name, std::vector<boost::shared_ptr<bob::ip::gabor::Jet>>& jets){
+  PyObject* iterator = PyObject_GetIter(graph);
+  if (!iterator) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `%s' to be a list of bob.ip.gabor.Jet", Py_TYPE(self)->tp_name, name);
+    return false;
+  }
+  auto iterator_ = make_safe(iterator);
+  while (PyObject* it = PyIter_Next(iterator)) {
+    auto it_ = make_safe(it);
+    if (!PyBobIpGaborJet_Check(it)){
+      PyErr_Format(PyExc_TypeError, "`%s' requires all elements of the `%s' to be of type bob.ip.gabor.Jet, but element %d isn't", Py_TYPE(self)->tp_name, name, (int)jets.size());
+      return false;
+    }
+    jets.push_back(reinterpret_cast<PyBobIpGaborJetObject*>(it)->cxx);
+  }
+  return !PyErr_Occurred();
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto similarity_doc = bob::extension::VariableDoc(
+  "similarity",
+  ":py:class:`bob.ip.gabor.Similarity`",
+  "The similarity function used to compute the scores, read only"
+);
+PyObject* PyBobIpGaborGalleryIndex_similarity(PyBobIpGaborGalleryIndexObject* self, void*){
+BOB_TRY
+  PyBobIpGaborSimilarityObject* similarity = (PyBobIpGaborSimilarityObject*)PyBobIpGaborSimilarity_Type.tp_alloc(&PyBobIpGaborSimilarity_Type, 0);
+  similarity->cxx = self->cxx->similarity();
+  return Py_BuildValue("N", similarity);
+BOB_CATCH_MEMBER("similarity", 0)
+}
+
+static auto ids_doc = bob::extension::VariableDoc(
+  "ids",
+  "[int]",
+  "The ids of all graphs in the index, in the internal storage order, read only"
+);
+PyObject* PyBobIpGaborGalleryIndex_ids(PyBobIpGaborGalleryIndexObject* self, void*){
+BOB_TRY
+  const std::vector<long>& ids = self->cxx->ids();
+  PyObject* list = PyList_New(ids.size());
+  if (!list) return 0;
+  for (Py_ssize_t i = 0; i < (Py_ssize_t)ids.size(); ++i)
+    PyList_SET_ITEM(list, i, Py_BuildValue("l", ids[i]));
+  return list;
+BOB_CATCH_MEMBER("ids", 0)
+}
+
+static auto normalization_doc = bob::extension::VariableDoc(
+  "normalization",
+  "str",
+  "The score normalization applied in :py:meth:`search`, i.e., one of ``'None'``, ``'ZNorm'``, ``'TNorm'`` or ``'ZTNorm'``; read only, see :py:meth:`set_normalization`"
+);
+PyObject* PyBobIpGaborGalleryIndex_normalization(PyBobIpGaborGalleryIndexObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("s", bob::ip::gabor::GalleryIndex::normalization_to_name(self->cxx->normalization()).c_str());
+BOB_CATCH_MEMBER("normalization", 0)
+}
+
+static auto cohort_size_doc = bob::extension::VariableDoc(
+  "cohort_size",
+  "int",
+  "The number of cohort graphs used for the score normalization, read only"
+);
+PyObject* PyBobIpGaborGalleryIndex_cohort_size(PyBobIpGaborGalleryIndexObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->cohort_size());
+BOB_CATCH_MEMBER("cohort_size", 0)
+}
+
+static PyGetSetDef PyBobIpGaborGalleryIndex_getseters[] = {
+  {
+    similarity_doc.name(),
+    (getter)PyBobIpGaborGalleryIndex_similarity,
+    0,
+    similarity_doc.doc(),
+    0
+  },
+  {
+    ids_doc.name(),
+    (getter)PyBobIpGaborGalleryIndex_ids,
+    0,
+    ids_doc.doc(),
+    0
+  },
+  {
+    normalization_doc.name(),
+    (getter)PyBobIpGaborGalleryIndex_normalization,
+    0,
+    normalization_doc.doc(),
+    0
+  },
+  {
+    cohort_size_doc.name(),
+    (getter)PyBobIpGaborGalleryIndex_cohort_size,
+    0,
+    cohort_size_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto add_doc = bob::extension::FunctionDoc(
+  "add",
+  "Adds the given graph to the index",
+  "The ``id`` must not be in the index yet. "
+  "The graph must have the same number of nodes and the same jet length as the graphs that are already in the index. "
+  "For the ``'ZNorm'`` and ``'ZTNorm'`` normalizations, the statistics of the scores of the cohort graphs to the new graph are computed and stored.",
+  true
+)
+.add_prototype("id, graph, [number_of_threads]")
+.add_parameter("id", "int", "The id under which the graph is stored")
+.add_parameter("graph", "[:py:class:`bob.ip.gabor.Jet`]", "The Gabor jets of the enrolled graph; the jet data is copied into the index")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads used to compute the cohort statistics; ``0`` selects one thread per available core")
+;
+
+static PyObject* PyBobIpGaborGalleryIndex_add(PyBobIpGaborGalleryIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = add_doc.kwlist();
+
+  long id;
+  PyObject* graph;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "lO|i", kwlist, &id, &graph, &threads)) return 0;
+
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> jets;
+  if (!get_graph(self, graph, "graph", jets)) return 0;
+
+  self->cxx->add(id, jets, threads);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("add", 0)
+}
+
+static auto remove_doc = bob::extension::FunctionDoc(
+  "remove",
+  "Removes the graph with the given id from the index",
+  0,
+  true
+)
+.add_prototype("id", "removed")
+.add_parameter("id", "int", "The id of the graph to remove")
+.add_return("removed", "bool", "``True`` if the graph was removed, ``False`` if no graph with the given ``id`` was in the index")
+;
+
+static PyObject* PyBobIpGaborGalleryIndex_remove(PyBobIpGaborGalleryIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = remove_doc.kwlist();
+
+  long id;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "l", kwlist, &id)) return 0;
+
+  if (self->cxx->remove(id)) Py_RETURN_TRUE;
+  Py_RETURN_FALSE;
+BOB_CATCH_MEMBER("remove", 0)
+}
+
+static auto search_doc = bob::extension::FunctionDoc(
+  "search",
+  "Returns the ``k`` graphs in the index that are most similar to the given probe graph",
+  "The results are sorted by descending score; results with identical scores are sorted by ascending id. "
+  "When ``id_ranges`` are given, only graphs with an id inside any of the ranges are compared with the probe, all other graphs are skipped. "
+  "The ranges are inclusive, i.e., ``(10, 20)`` selects the ids 10 to 20. "
+  "If a :py:attr:`normalization` is set, the normalized scores are used to select and sort the results.\n\n"
+  ".. note::\n\n  The function :py:func:`__call__` is a synonym for this function.",
+  true
+)
+.add_prototype("probe, k, [id_ranges], [number_of_threads]", "results")
+.add_parameter("probe", "[:py:class:`bob.ip.gabor.Jet`]", "The Gabor jets of the probe graph")
+.add_parameter("k", "int", "The maximum number of results to return")
+.add_parameter("id_ranges", "[(int, int)] or ``None``", "[Default: ``None``] If given, only graphs with ids in these inclusive ranges are considered")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads (i.e., gallery partitions) to use; ``0`` selects one thread per available core")
+.add_return("results", "[(int, float)]", "The ids and scores of the (up to) ``k`` most similar graphs")
+;
+
+static PyObject* PyBobIpGaborGalleryIndex_search(PyBobIpGaborGalleryIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = search_doc.kwlist();
+
+  PyObject* probe,* ranges = 0;
+  int k, threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "Oi|Oi", kwlist, &probe, &k, &ranges, &threads)) return 0;
+
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> jets;
+  if (!get_graph(self, probe, "probe", jets)) return 0;
+
+  std::vector<bob::ip::gabor::GalleryIndex::Range> id_ranges;
+  if (ranges && ranges != Py_None){
+    PyObject* iterator = PyObject_GetIter(ranges);
+    if (!iterator) return 0;
+    auto iterator_ = make_safe(iterator);
+    while (PyObject* it = PyIter_Next(iterator)) {
+      auto it_ = make_safe(it);
+      long first, last;
+      if (!PyArg_ParseTuple(it, "ll", &first, &last)){
+        PyErr_Format(PyExc_TypeError, "`%s' requires all elements of the `id_ranges' to be tuples of two integers, but element %d isn't", Py_TYPE(self)->tp_name, (int)id_ranges.size());
+        return 0;
+      }
+      id_ranges.push_back(std::make_pair(first, last));
+    }
+    if (PyErr_Occurred()) return 0;
+  }
+
+  std::vector<bob::ip::gabor::GalleryIndex::Result> results;
+  // the C++ objects stay alive while the global interpreter lock is released
+  auto index = self->cxx;
+  if (!without_gil([&](){index->search(jets, k, results, id_ranges, threads);})) return 0;
+
+  PyObject* list = PyList_New(results.size());
+  if (!list) return 0;
+  for (Py_ssize_t i = 0; i < (Py_ssize_t)results.size(); ++i)
+    PyList_SET_ITEM(list, i, Py_BuildValue("(ld)", results[i].second, results[i].first));
+  return list;
+BOB_CATCH_MEMBER("search", 0)
+}
+
+
+static auto set_normalization_doc = bob::extension::FunctionDoc(
+  "set_normalization",
+  "Sets the score normalization and the cohort graphs",
+  "The score normalization is applied to the scores in :py:meth:`search`, where :math:`s` is the score between probe and enrolled graph:\n\n"
+  "* ``'ZNorm'``: :math:`(s - \\mu_z) / \\sigma_z`, where :math:`\\mu_z` and :math:`\\sigma_z` are the mean and the standard deviation of the scores between all cohort graphs (as probes) and the enrolled graph. "
+  "These statistics are computed here for all graphs that are already in the index, and in :py:meth:`add` for all graphs enrolled later.\n"
+  "* ``'TNorm'``: :math:`(s - \\mu_t) / \\sigma_t`, where :math:`\\mu_t` and :math:`\\sigma_t` are the mean and the standard deviation of the scores between the probe and all cohort graphs. "
+  "These statistics are computed once per :py:meth:`search`.\n"
+  "* ``'ZTNorm'``: T-norm of the Z-normalized scores, where the T-norm statistics are computed from Z-normalized cohort scores; the Z-norm statistics of the cohort graphs are computed here among each other.\n"
+  "* ``'None'``: no normalization; the cohort is removed.\n\n"
+  "Standard deviations of 0 are replaced by 1.",
+  true
+)
+.add_prototype("normalization, cohort, [number_of_threads]")
+.add_parameter("normalization", "str", "The score normalization, one of ``'None'``, ``'ZNorm'``, ``'TNorm'`` or ``'ZTNorm'``")
+.add_parameter("cohort", "array_like (float, 4D)", "The Gabor jets of at least three cohort graphs, as an array of shape ``(C, nodes, 2, number_of_wavelets)``; ignored for ``'None'``")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads used to compute the cohort statistics; ``0`` selects one thread per available core")
+;
+
+static PyObject* PyBobIpGaborGalleryIndex_set_normalization(PyBobIpGaborGalleryIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = set_normalization_doc.kwlist();
+
+  const char* normalization;
+  PyBlitzArrayObject* cohort;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sO&|i", kwlist, &normalization, &PyBlitzArray_Converter, &cohort, &threads)) return 0;
+
+  auto cohort_ = make_safe(cohort);
+  if (cohort->type_num != NPY_FLOAT64 || cohort->ndim != 4) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `cohort' to be a 4D array of type float", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+
+  self->cxx->set_normalization(bob::ip::gabor::GalleryIndex::name_to_normalization(normalization), *PyBlitzArrayCxx_AsBlitz<double,4>(cohort), threads);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("set_normalization", 0)
+}
+
+static auto clear_normalization_doc = bob::extension::FunctionDoc(
+  "clear_normalization",
+  "Removes the score normalization and the cohort",
+  0,
+  true
+)
+.add_prototype("")
+;
+
+static PyObject* PyBobIpGaborGalleryIndex_clear_normalization(PyBobIpGaborGalleryIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = clear_normalization_doc.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+
+  self->cxx->clear_normalization();
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("clear_normalization", 0)
+}
+
+static auto z_statistics_doc = bob::extension::FunctionDoc(
+  "z_statistics",
+  "Returns the stored Z-norm statistics of the enrolled graph with the given id",
+  "The statistics are only available for the ``'ZNorm'`` and ``'ZTNorm'`` normalizations.",
+  true
+)
+.add_prototype("id", "mean, std")
+.add_parameter("id", "int", "The id of the enrolled graph")
+.add_return("mean", "float", "The mean of the scores between the cohort graphs and the enrolled graph")
+.add_return("std", "float", "The standard deviation of these scores")
+;
+
+static PyObject* PyBobIpGaborGalleryIndex_z_statistics(PyBobIpGaborGalleryIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = z_statistics_doc.kwlist();
+
+  long id;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "l", kwlist, &id)) return 0;
+
+  auto statistics = self->cxx->z_statistics(id);
+  return Py_BuildValue("(dd)", statistics.first, statistics.second);
+BOB_CATCH_MEMBER("z_statistics", 0)
+}
+
+static auto t_statistics_doc = bob::extension::FunctionDoc(
+  "t_statistics",
+  "Computes the T-norm statistics of the given probe graph",
+  "The statistics are only available for the ``'TNorm'`` and ``'ZTNorm'`` normalizations; for ``'ZTNorm'``, the Z-normalized cohort scores are used.",
+  true
+)
+.add_prototype("probe, [number_of_threads]", "mean, std")
+.add_parameter("probe", "[:py:class:`bob.ip.gabor.Jet`]", "The Gabor jets of the probe graph")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads to use; ``0`` selects one thread per available core")
+.add_return("mean", "float", "The mean of the scores between the probe graph and the cohort graphs")
+.add_return("std", "float", "The standard deviation of these scores")
+;
+
+static PyObject* PyBobIpGaborGalleryIndex_t_statistics(PyBobIpGaborGalleryIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = t_statistics_doc.kwlist();
+
+  PyObject* probe;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|i", kwlist, &probe, &threads)) return 0;
+
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> jets;
+  if (!get_graph(self, probe, "probe", jets)) return 0;
+
+  auto statistics = self->cxx->t_statistics(jets, threads);
+  return Py_BuildValue("(dd)", statistics.first, statistics.second);
+BOB_CATCH_MEMBER("t_statistics", 0)
+}
+
+static auto load_doc = bob::extension::FunctionDoc(
+  "load",
+  "Loads the gallery index from the given HDF5 file",
+  "The stored cohort statistics are read from file and not recomputed.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file opened for reading")
+;
+
+static PyObject* PyBobIpGaborGalleryIndex_load(PyBobIpGaborGalleryIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = load_doc.kwlist();
+  PyBobIoHDF5FileObject* file;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &file)) return 0;
+
+  auto file_ = make_safe(file);
+  self->cxx->load(*file->f);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("load", 0)
+}
+
+static auto save_doc = bob::extension::FunctionDoc(
+  "save",
+  "Saves the similarity function, the enrolled graphs, the cohort and the cohort statistics to the given HDF5 file",
+  0,
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing")
+;
+
+static PyObject* PyBobIpGaborGalleryIndex_save(PyBobIpGaborGalleryIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = save_doc.kwlist();
+  PyBobIoHDF5FileObject* file;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &file)) return 0;
+
+  auto file_ = make_safe(file);
+  self->cxx->save(*file->f);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("save", 0)
+}
+
+
+static PyMethodDef PyBobIpGaborGalleryIndex_methods[] = {
+  {
+    add_doc.name(),
+    (PyCFunction)PyBobIpGaborGalleryIndex_add,
+    METH_VARARGS|METH_KEYWORDS,
+    add_doc.doc()
+  },
+  {
+    remove_doc.name(),
+    (PyCFunction)PyBobIpGaborGalleryIndex_remove,
+    METH_VARARGS|METH_KEYWORDS,
+    remove_doc.doc()
+  },
+  {
+    search_doc.name(),
+    (PyCFunction)PyBobIpGaborGalleryIndex_search,
+    METH_VARARGS|METH_KEYWORDS,
+    search_doc.doc()
+  },
+  {
+    set_normalization_doc.name(),
+    (PyCFunction)PyBobIpGaborGalleryIndex_set_normalization,
+    METH_VARARGS|METH_KEYWORDS,
+    set_normalization_doc.doc()
+  },
+  {
+    clear_normalization_doc.name(),
+    (PyCFunction)PyBobIpGaborGalleryIndex_clear_normalization,
+    METH_VARARGS|METH_KEYWORDS,
+    clear_normalization_doc.doc()
+  },
+  {
+    z_statistics_doc.name(),
+    (PyCFunction)PyBobIpGaborGalleryIndex_z_statistics,
+    METH_VARARGS|METH_KEYWORDS,
+    z_statistics_doc.doc()
+  },
+  {
+    t_statistics_doc.name(),
+    (PyCFunction)PyBobIpGaborGalleryIndex_t_statistics,
+    METH_VARARGS|METH_KEYWORDS,
+    t_statistics_doc.doc()
+  },
+  {
+    load_doc.name(),
+    (PyCFunction)PyBobIpGaborGalleryIndex_load,
+    METH_VARARGS|METH_KEYWORDS,
+    load_doc.doc()
+  },
+  {
+    save_doc.name(),
+    (PyCFunction)PyBobIpGaborGalleryIndex_save,
+    METH_VARARGS|METH_KEYWORDS,
+    save_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the GalleryIndex type struct; will be initialized later
+PyTypeObject PyBobIpGaborGalleryIndex_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+static PySequenceMethods PyBobIpGaborGalleryIndex_sequence = {
+  (lenfunc)PyBobIpGaborGalleryIndex_len,
+  0, 0, 0, 0, 0, 0,
+  (objobjproc)PyBobIpGaborGalleryIndex_contains
+};
+
+bool init_BobIpGaborGalleryIndex(PyObject* module)
+{
+
+  // initialize the GalleryIndex type struct
+  PyBobIpGaborGalleryIndex_Type.tp_name = GalleryIndex_doc.name();
+  PyBobIpGaborGalleryIndex_Type.tp_basicsize = sizeof(PyBobIpGaborGalleryIndexObject);
+  PyBobIpGaborGalleryIndex_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborGalleryIndex_Type.tp_doc = GalleryIndex_doc.doc();
+
+  // set the functions
+  PyBobIpGaborGalleryIndex_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborGalleryIndex_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborGalleryIndex_init);
+  PyBobIpGaborGalleryIndex_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborGalleryIndex_delete);
+  PyBobIpGaborGalleryIndex_Type.tp_methods = PyBobIpGaborGalleryIndex_methods;
+  PyBobIpGaborGalleryIndex_Type.tp_getset = PyBobIpGaborGalleryIndex_getseters;
+  PyBobIpGaborGalleryIndex_Type.tp_as_sequence = &PyBobIpGaborGalleryIndex_sequence;
+  PyBobIpGaborGalleryIndex_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobIpGaborGalleryIndex_search);
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborGalleryIndex_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborGalleryIndex_Type);
+  return PyModule_AddObject(module, "GalleryIndex", (PyObject*)&PyBobIpGaborGalleryIndex_Type) >= 0;
+}
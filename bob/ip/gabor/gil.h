@@ -0,0 +1,40 @@
+/**
+ * @date Sun Oct 18 00:38:51 UTC 2026
+ *
+ * @brief Helpers for the Python bindings to run C++ code without holding the global interpreter lock
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_GIL_H
+#define BOB_IP_GABOR_GIL_H
+
+#include <Python.h>
+#include <exception>
+#include <string>
+
+// runs the given function without holding the global interpreter lock, so that other Python threads can run meanwhile; returns false and sets a RuntimeError if the function throws
+// The function must not access any Python object
+template <typename Function>
+static bool without_gil(Function function){
+  bool failed = false;
+  std::string error;
+  Py_BEGIN_ALLOW_THREADS
+  try {
+    function();
+  } catch (std::exception& e) {
+    failed = true;
+    error = e.what();
+  } catch (...) {
+    failed = true;
+    error = "unknown exception";
+  }
+  Py_END_ALLOW_THREADS
+  if (failed){
+    PyErr_SetString(PyExc_RuntimeError, error.c_str());
+    return false;
+  }
+  return true;
+}
+
+#endif // BOB_IP_GABOR_GIL_H
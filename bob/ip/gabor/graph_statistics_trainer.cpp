@@ -0,0 +1,344 @@
+/**
+ * @date Sun Oct 18 00:08:40 UTC 2026
+ *
+ * @brief Bindings for the parallel computation of the Gabor jet statistics of all nodes of a graph
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.extension/documentation.h>
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto GraphStatisticsTrainer_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".GraphStatisticsTrainer",
+  "Computes the :py:class:`JetStatistics` of all nodes of a graph in a single pass over the training graphs",
+  "The Gabor jets of each node of the training graphs are accumulated with a :py:class:`JetStatisticsBuilder`, so that the training graphs can be :py:meth:`add`\\ed in batches and do not need to be in memory at the same time; the statistics of each node are identical to the ones of a :py:class:`JetStatisticsBuilder` that is trained with the jets of the node. "
+  "The nodes are distributed over several threads, where each thread updates the statistics of its nodes only.\n\n"
+  "The resulting statistics can be written to a single data set with :py:func:`save_statistics`."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates an empty trainer",
+    "The number of nodes and the length of the Gabor jets are defined by the first added graph.",
+    true
+  )
+  .add_prototype("", "")
+);
+
+static int PyBobIpGaborGraphStatisticsTrainer_init(PyBobIpGaborGraphStatisticsTrainerObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = GraphStatisticsTrainer_doc.kwlist(0);
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return -1;
+
+  self->cxx.reset(new bob::ip::gabor::GraphStatisticsTrainer());
+  return 0;
+BOB_CATCH_MEMBER("GraphStatisticsTrainer constructor", -1)
+}
+
+static void PyBobIpGaborGraphStatisticsTrainer_delete(PyBobIpGaborGraphStatisticsTrainerObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborGraphStatisticsTrainer_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborGraphStatisticsTrainer_Type));
+}
+
+static Py_ssize_t PyBobIpGaborGraphStatisticsTrainer_len(PyBobIpGaborGraphStatisticsTrainerObject* self) {
+  return self->cxx->count();
+}
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto count_doc = bob::extension::VariableDoc(
+  "count",
+  "int",
+  "The number of graphs that were added, read only",
+  "This is identical to the ``len`` of the trainer."
+);
+PyObject* PyBobIpGaborGraphStatisticsTrainer_count(PyBobIpGaborGraphStatisticsTrainerObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("l", self->cxx->count());
+BOB_CATCH_MEMBER("count", 0)
+}
+
+static auto numberOfNodes_doc = bob::extension::VariableDoc(
+  "number_of_nodes",
+  "int",
+  "The number of nodes of the graphs, which is defined by the first added graph; ``0`` if no graph has been added, read only"
+);
+PyObject* PyBobIpGaborGraphStatisticsTrainer_numberOfNodes(PyBobIpGaborGraphStatisticsTrainerObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->numberOfNodes());
+BOB_CATCH_MEMBER("number_of_nodes", 0)
+}
+
+static auto length_doc = bob::extension::VariableDoc(
+  "length",
+  "int",
+  "The length of the Gabor jets, which is defined by the first added graph; ``0`` if no graph has been added, read only"
+);
+PyObject* PyBobIpGaborGraphStatisticsTrainer_length(PyBobIpGaborGraphStatisticsTrainerObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->length());
+BOB_CATCH_MEMBER("length", 0)
+}
+
+static PyGetSetDef PyBobIpGaborGraphStatisticsTrainer_getseters[] = {
+  {
+    count_doc.name(),
+    (getter)PyBobIpGaborGraphStatisticsTrainer_count,
+    0,
+    count_doc.doc(),
+    0
+  },
+  {
+    numberOfNodes_doc.name(),
+    (getter)PyBobIpGaborGraphStatisticsTrainer_numberOfNodes,
+    0,
+    numberOfNodes_doc.doc(),
+    0
+  },
+  {
+    length_doc.name(),
+    (getter)PyBobIpGaborGraphStatisticsTrainer_length,
+    0,
+    length_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto add_doc = bob::extension::FunctionDoc(
+  "add",
+  "Adds the Gabor jets of the given graphs to the statistics of their nodes",
+  "The graphs can be given as a list of :py:class:`Jet`\\s, e.g., the result of :py:meth:`Graph.extract`, which is a single graph, as an array of shape ``(number_of_nodes, 2, length)``, which is a single graph, or as an array of shape ``(N, number_of_nodes, 2, length)``, which are ``N`` graphs. "
+  "All graphs must have the same number of nodes and the same jet length.",
+  true
+)
+.add_prototype("graphs, [number_of_threads]")
+.add_parameter("graphs", "[:py:class:`bob.ip.gabor.Jet`] or array_like (3D or 4D, float)", "The Gabor jets of the graphs to add")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads, over which the nodes are distributed; ``0`` selects one thread per available core")
+;
+
+static PyObject* PyBobIpGaborGraphStatisticsTrainer_add(PyBobIpGaborGraphStatisticsTrainerObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = add_doc.kwlist();
+
+  PyObject* graphs;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|i", kwlist, &graphs, &threads)) return 0;
+
+  if (PyBlitzArray_Check(graphs) || PyArray_Check(graphs)){
+    PyBlitzArrayObject* data;
+    if (!PyBlitzArray_Converter(graphs, &data)) return 0;
+    auto data_ = make_safe(data);
+    if (data->type_num != NPY_FLOAT64 || (data->ndim != 3 && data->ndim != 4)) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `graphs' to be a 3D or 4D array of type float", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    if (data->ndim == 3)
+      self->cxx->add(*PyBlitzArrayCxx_AsBlitz<double,3>(data));
+    else
+      self->cxx->add(*PyBlitzArrayCxx_AsBlitz<double,4>(data), threads);
+    Py_RETURN_NONE;
+  }
+
+  // a list of jets is a single graph
+  PyObject* iterator = PyObject_GetIter(graphs);
+  if (!iterator) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `graphs' to be a list of bob.ip.gabor.Jet, or a 3D or 4D array", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  auto iterator_ = make_safe(iterator);
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> jets;
+  while (PyObject* it = PyIter_Next(iterator)) {
+    auto it_ = make_safe(it);
+    if (!PyBobIpGaborJet_Check(it)){
+      PyErr_Format(PyExc_TypeError, "`%s' requires all elements of the `graphs' to be of type bob.ip.gabor.Jet, but element %d isn't", Py_TYPE(self)->tp_name, (int)jets.size());
+      return 0;
+    }
+    jets.push_back(reinterpret_cast<PyBobIpGaborJetObject*>(it)->cxx);
+  }
+  if (PyErr_Occurred()) return 0;
+  if (jets.empty()) Py_RETURN_NONE;
+
+  const int length = jets.front()->length();
+  blitz::Array<double,3> graph(jets.size(), 2, length);
+  for (int n = 0; n < (int)jets.size(); ++n){
+    if (jets[n]->length() != length){
+      PyErr_Format(PyExc_RuntimeError, "`%s' requires all jets of the graph to have the same length, but jet %d has length %d instead of %d", Py_TYPE(self)->tp_name, n, jets[n]->length(), length);
+      return 0;
+    }
+    graph(n, blitz::Range::all(), blitz::Range::all()) = jets[n]->jet();
+  }
+  self->cxx->add(graph);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("add", 0)
+}
+
+static auto merge_doc = bob::extension::FunctionDoc(
+  "merge",
+  "Adds all graphs that were added to the other trainer",
+  "The result is the same as if all graphs of the ``other`` trainer were added to this trainer.",
+  true
+)
+.add_prototype("other")
+.add_parameter("other", ":py:class:`bob.ip.gabor.GraphStatisticsTrainer`", "The trainer of another part of the training set")
+;
+
+static PyObject* PyBobIpGaborGraphStatisticsTrainer_merge(PyBobIpGaborGraphStatisticsTrainerObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = merge_doc.kwlist();
+
+  PyBobIpGaborGraphStatisticsTrainerObject* other;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist, &PyBobIpGaborGraphStatisticsTrainer_Type, &other)) return 0;
+
+  self->cxx->merge(*other->cxx);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("merge", 0)
+}
+
+static auto finalize_doc = bob::extension::FunctionDoc(
+  "finalize",
+  "Computes the statistics of all nodes",
+  "At least two graphs must have been added. "
+  "The trainer is not modified, so that more graphs can be added afterward.",
+  true
+)
+.add_prototype("[gwt], [number_of_threads]", "statistics")
+.add_parameter("gwt", ":py:class:`bob.ip.gabor.Transform` or ``None``", "[Default: ``None``] The Gabor wavelet family with which the Gabor jets were extracted")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads, over which the nodes are distributed; ``0`` selects one thread per available core")
+.add_return("statistics", "[:py:class:`bob.ip.gabor.JetStatistics`]", "The statistics of all nodes")
+;
+
+static PyObject* PyBobIpGaborGraphStatisticsTrainer_finalize(PyBobIpGaborGraphStatisticsTrainerObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = finalize_doc.kwlist();
+
+  PyObject* gwt = 0;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|Oi", kwlist, &gwt, &threads)) return 0;
+
+  boost::shared_ptr<bob::ip::gabor::Transform> transform;
+  if (gwt && gwt != Py_None){
+    if (!PyBobIpGaborTransform_Check(gwt)){
+      PyErr_Format(PyExc_TypeError, "The given 'gwt' object is not of type bob.ip.gabor.Transform");
+      return 0;
+    }
+    transform = reinterpret_cast<PyBobIpGaborTransformObject*>(gwt)->cxx;
+  }
+
+  auto statistics = self->cxx->finalize(transform, threads);
+  PyObject* list = PyList_New(statistics.size());
+  if (!list) return 0;
+  auto list_ = make_safe(list);
+  for (std::size_t i = 0; i < statistics.size(); ++i){
+    PyBobIpGaborJetStatisticsObject* s = (PyBobIpGaborJetStatisticsObject*)PyBobIpGaborJetStatistics_Type.tp_alloc(&PyBobIpGaborJetStatistics_Type, 0);
+    s->cxx = statistics[i];
+    PyList_SET_ITEM(list, i, (PyObject*)s);
+  }
+  return Py_BuildValue("O", list);
+BOB_CATCH_MEMBER("finalize", 0)
+}
+
+static auto clear_doc = bob::extension::FunctionDoc(
+  "clear",
+  "Removes all graphs from the statistics",
+  "Afterward, the number of nodes and the jet length are defined by the next added graph.",
+  true
+)
+.add_prototype("")
+;
+
+static PyObject* PyBobIpGaborGraphStatisticsTrainer_clear(PyBobIpGaborGraphStatisticsTrainerObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = clear_doc.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+
+  self->cxx->clear();
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("clear", 0)
+}
+
+static PyMethodDef PyBobIpGaborGraphStatisticsTrainer_methods[] = {
+  {
+    add_doc.name(),
+    (PyCFunction)PyBobIpGaborGraphStatisticsTrainer_add,
+    METH_VARARGS|METH_KEYWORDS,
+    add_doc.doc()
+  },
+  {
+    merge_doc.name(),
+    (PyCFunction)PyBobIpGaborGraphStatisticsTrainer_merge,
+    METH_VARARGS|METH_KEYWORDS,
+    merge_doc.doc()
+  },
+  {
+    finalize_doc.name(),
+    (PyCFunction)PyBobIpGaborGraphStatisticsTrainer_finalize,
+    METH_VARARGS|METH_KEYWORDS,
+    finalize_doc.doc()
+  },
+  {
+    clear_doc.name(),
+    (PyCFunction)PyBobIpGaborGraphStatisticsTrainer_clear,
+    METH_VARARGS|METH_KEYWORDS,
+    clear_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the GraphStatisticsTrainer type struct; will be initialized later
+PyTypeObject PyBobIpGaborGraphStatisticsTrainer_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+static PySequenceMethods PyBobIpGaborGraphStatisticsTrainer_sequence = {
+  (lenfunc)PyBobIpGaborGraphStatisticsTrainer_len
+};
+
+bool init_BobIpGaborGraphStatisticsTrainer(PyObject* module)
+{
+
+  // initialize the GraphStatisticsTrainer type struct
+  PyBobIpGaborGraphStatisticsTrainer_Type.tp_name = GraphStatisticsTrainer_doc.name();
+  PyBobIpGaborGraphStatisticsTrainer_Type.tp_basicsize = sizeof(PyBobIpGaborGraphStatisticsTrainerObject);
+  PyBobIpGaborGraphStatisticsTrainer_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborGraphStatisticsTrainer_Type.tp_doc = GraphStatisticsTrainer_doc.doc();
+
+  // set the functions
+  PyBobIpGaborGraphStatisticsTrainer_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborGraphStatisticsTrainer_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborGraphStatisticsTrainer_init);
+  PyBobIpGaborGraphStatisticsTrainer_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborGraphStatisticsTrainer_delete);
+  PyBobIpGaborGraphStatisticsTrainer_Type.tp_methods = PyBobIpGaborGraphStatisticsTrainer_methods;
+  PyBobIpGaborGraphStatisticsTrainer_Type.tp_getset = PyBobIpGaborGraphStatisticsTrainer_getseters;
+  PyBobIpGaborGraphStatisticsTrainer_Type.tp_as_sequence = &PyBobIpGaborGraphStatisticsTrainer_sequence;
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborGraphStatisticsTrainer_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborGraphStatisticsTrainer_Type);
+  return PyModule_AddObject(module, "GraphStatisticsTrainer", (PyObject*)&PyBobIpGaborGraphStatisticsTrainer_Type) >= 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @date Sat Oct 17 22:52:31 UTC 2026
+ *
+ * @brief Cascaded comparison of a probe with a large gallery
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_CASCADE_H
+#define BOB_IP_GABOR_CASCADE_H
+
+#include <atomic>
+#include <limits>
+
+#include <bob.ip.gabor/Similarity.h>
+
+namespace bob {
+  namespace ip {
+    namespace gabor{
+      //! \brief Class to compare a probe with a large gallery in two stages.
+      //! In the first stage, a cheap screening similarity is computed for all gallery entries.
+      //! Only the best fraction of the gallery entries (and only those with a screening score of at least the threshold) are passed to the second stage, where the expensive matching similarity is computed.
+      class Cascade{
+        public:
+          //! The stages of the cascade
+          typedef enum {
+            SCREENING = 0,
+            MATCHING = 1
+          } Stage;
+
+          //! \brief Creates a cascade with the given matching similarity, e.g., of type PHASE_DIFF_PLUS_CANBERRA
+          //! When no screening similarity is given, the SCALAR_PRODUCT of the absolute values is used
+          Cascade(boost::shared_ptr<Similarity> matching, boost::shared_ptr<Similarity> screening = boost::shared_ptr<Similarity>(), double fraction = 0.1, double threshold = -std::numeric_limits<double>::infinity());
+
+          //! \brief Computes the scores between the probe and all gallery entries, which are stored as contiguous (N, 2, probe.length()) block
+          //! Gallery entries that do not pass the screening get the score -infinity
+          void search(const Jet& probe, const blitz::Array<double,3>& gallery, blitz::Array<double,1>& scores, int number_of_threads = 1) const;
+
+          //! \brief Computes the average scores between the nodes of the probe graph and all graphs in the gallery, which are stored as contiguous (N, probe.size(), 2, probe[0]->length()) block
+          //! Gallery entries that do not pass the screening get the score -infinity
+          void search(const std::vector<boost::shared_ptr<Jet>>& probe, const blitz::Array<double,4>& gallery, blitz::Array<double,1>& scores, int number_of_threads = 1) const;
+
+          //! the similarity function used in the screening stage
+          boost::shared_ptr<Similarity> screening() const {return m_screening;}
+          //! the similarity function used in the matching stage
+          boost::shared_ptr<Similarity> matching() const {return m_matching;}
+
+          //! the fraction of the gallery that is passed to the matching stage
+          double fraction() const {return m_fraction;}
+          void fraction(double fraction);
+          //! the minimum screening score for a gallery entry to be passed to the matching stage
+          double threshold() const {return m_threshold;}
+          void threshold(double threshold) {m_threshold = threshold;}
+
+          //! the number of gallery entries that were evaluated in the given stage since the last reset of the statistics
+          long evaluated(Stage stage) const {return m_evaluated[stage];}
+          //! the rate of the screened gallery entries that were passed to the matching stage since the last reset of the statistics
+          double pass_rate() const;
+          //! resets the statistics of all stages
+          void reset_statistics();
+
+        private:
+          // runs both stages of the cascade for the given probe jet or graph
+          template <typename Probe, int D>
+          void run(const Probe& probe, const blitz::Array<double,D>& gallery, blitz::Array<double,1>& scores, int number_of_threads) const;
+
+          boost::shared_ptr<Similarity> m_matching;
+          boost::shared_ptr<Similarity> m_screening;
+          double m_fraction;
+          double m_threshold;
+
+          // the statistics are updated by concurrent searches
+          mutable std::atomic<long> m_evaluated[2];
+
+      }; // class Cascade
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+
+#endif // BOB_IP_GABOR_CASCADE_H
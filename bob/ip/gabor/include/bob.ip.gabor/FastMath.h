@@ -0,0 +1,105 @@
+/**
+ * @date Sat Oct 17 23:10:45 UTC 2026
+ *
+ * @brief Vectorizable approximations of the trigonometric functions used for Gabor jets
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_FAST_MATH_H
+#define BOB_IP_GABOR_FAST_MATH_H
+
+#include <cmath>
+#include <algorithm>
+
+namespace bob {
+
+  namespace ip {
+
+    namespace gabor{
+
+      //! \brief Returns true if the fast approximations of the trigonometric functions are used instead of the ones from the standard library.
+      bool fast_math();
+
+      //! \brief Enables or disables the fast approximations of the trigonometric functions for all subsequent computations.
+      //! Computations that are running in other threads while the mode is switched might use either mode.
+      void fast_math(bool enable);
+
+      // All functions below are free of library calls, and the trigonometric functions are free of branches, so that loops calling them can be vectorized by the compiler.
+      // The polynomials are near-minimax approximations (interpolations in the Chebyshev nodes), which were fitted for the given reduced ranges.
+
+      //! \brief Rounds to the nearest integer, where exact halves are rounded to the nearest even number; valid for |x| < 2^51.
+      inline double round_nearest(double x){
+        const double magic = 6755399441055744.; // 1.5 * 2^52
+        return (x + magic) - magic;
+      }
+
+      //! \brief Shifts the given phase into the range [-pi, pi]
+      inline double wrap_phase(double phase){
+        return phase - (2.*M_PI) * round_nearest(phase * (0.5/M_PI));
+      }
+
+      namespace detail{
+        // reduces x to r in [-pi/4, pi/4] with x = r + q*pi/2, and returns cos(q*pi/2) and sin(q*pi/2); valid for |x| < 10^6
+        inline double reduce_quarter(double x, double& cos_q, double& sin_q){
+          const double q = round_nearest(x * (2./M_PI));
+          // q = 2h + e with e in {-1, 0, 1}, so that cos(q*pi/2) = (1-e^2) * (-1)^h and sin(q*pi/2) = e * (-1)^h
+          const double h = round_nearest(q * 0.5), e = q - 2. * h, p = h - 2. * round_nearest(h * 0.5);
+          const double sign = 1. - 2. * p * p;
+          cos_q = (1. - e * e) * sign;
+          sin_q = e * sign;
+          // pi/2 is split into three parts, where the products with q are exact (Cody-Waite reduction)
+          return ((x - q * 1.57079632673412561417e+00) - q * 6.07710050630396597660e-11) - q * 2.02226624879595063154e-21;
+        }
+
+        // sin(r) for r in [-pi/4, pi/4]; maximum absolute error 4e-15
+        inline double sin_quarter(double r){
+          const double u = r * r;
+          return r * (0.9999999999999957 + u * (-0.16666666666616609 + u * (0.008333333323874799 + u * (-0.0001984126329805653 + u * (2.75552719613084e-06 + u * -2.4756568460907584e-08)))));
+        }
+
+        // cos(r) for r in [-pi/4, pi/4]; maximum absolute error 6e-14
+        inline double cos_quarter(double r){
+          const double u = r * r;
+          return 0.9999999999999444 + u * (-0.4999999999935103 + u * (0.041666666543903295 + u * (-0.0013888880393487565 + u * (2.4798928713104045e-05 + u * -2.71734276337709e-07))));
+        }
+      }
+
+      //! \brief Approximates cos(x) with a maximum absolute error of 1e-13 for |x| < 10^6
+      inline double fast_cos(double x){
+        double cos_q, sin_q;
+        const double r = detail::reduce_quarter(x, cos_q, sin_q);
+        return detail::cos_quarter(r) * cos_q - detail::sin_quarter(r) * sin_q;
+      }
+
+      //! \brief Approximates sin(x) with a maximum absolute error of 1e-13 for |x| < 10^6
+      inline double fast_sin(double x){
+        double cos_q, sin_q;
+        const double r = detail::reduce_quarter(x, cos_q, sin_q);
+        return detail::sin_quarter(r) * cos_q + detail::cos_quarter(r) * sin_q;
+      }
+
+      //! \brief Approximates atan2(y, x) with a maximum absolute error of 2e-14 for all finite x and y
+      //! As std::atan2, the result is in range [-pi, pi], and the sign of zeros is taken into account.
+      inline double fast_atan2(double y, double x){
+        const double ax = std::abs(x), ay = std::abs(y);
+        const double large = std::max(ax, ay), small = std::min(ax, ay);
+        // the ratio in [0, 1] is reduced to [-tan(pi/8), tan(pi/8)] using atan(a) = pi/4 + atan((a-1)/(a+1))
+        const double a = small / (large > 0. ? large : 1.);
+        const bool reduce = a > 0.41421356237309503;
+        const double t = reduce ? (a - 1.) / (a + 1.) : a, u = t * t;
+        double angle = t * (0.9999999999999734 + u * (-0.3333333333080466 + u * (0.1999999960506827 + u * (-0.14285690432000073 + u * (0.11110385227419418 + u * (-0.09078394244122868 + u * (0.07563717896806983 + u * (-0.058745548630196605 + u * 0.0306631270128583))))))));
+        angle = reduce ? angle + M_PI/4. : angle;
+        // undo the reduction of the octant and the quadrant
+        angle = ay > ax ? M_PI/2. - angle : angle;
+        angle = std::signbit(x) ? M_PI - angle : angle;
+        return std::copysign(angle, y);
+      }
+
+    } // namespace gabor
+
+  } // namespace ip
+
+} // namespace bob
+
+#endif // BOB_IP_GABOR_FAST_MATH_H
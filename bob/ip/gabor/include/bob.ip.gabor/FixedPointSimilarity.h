@@ -0,0 +1,70 @@
+/**
+ * @date Sat Oct 17 23:26:25 UTC 2026
+ *
+ * @brief Gabor jet similarities computed with integer arithmetic on quantized Gabor jets
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_FIXED_POINT_SIMILARITY_H
+#define BOB_IP_GABOR_FIXED_POINT_SIMILARITY_H
+
+#include <stdint.h>
+
+#include <bob.ip.gabor/Similarity.h>
+
+namespace bob {
+  namespace ip {
+    namespace gabor{
+      //! \brief Computes Gabor jet similarities with integer arithmetic only, for devices without good floating point throughput.
+      //! The Gabor jets are quantized into (2, length) blocks of 16 bit integers, i.e., the absolute values in fixed-point format with 16 fractional bits, and the phases as indices of 2^16 equally spaced angles.
+      //! Cosines of phase differences are looked up in a table, and only the final score is converted to floating point.
+      //! The supported similarity types are SCALAR_PRODUCT, CANBERRA and ABS_PHASE; as for the Similarity class, the Gabor jets are expected to be normalized.
+      class FixedPointSimilarity{
+        public:
+          //! the scale of the quantized absolute values, which are clipped to [0, 1]
+          static const int MAGNITUDE_SCALE = 65535;
+          //! the number of phase indices, which cover [0, 2 pi[
+          static const int PHASE_STEPS = 65536;
+          //! the number of entries in the cosine table
+          static const int COSINE_TABLE_SIZE = 4096;
+          //! the scale of the cosine table entries
+          static const int COSINE_SCALE = 16384;
+
+          //! \brief Creates a fixed-point similarity of the given type, which must be SCALAR_PRODUCT, CANBERRA or ABS_PHASE
+          FixedPointSimilarity(Similarity::SimilarityType type);
+
+          //! \brief Creates a fixed-point similarity with the given name, i.e., "ScalarProduct", "Canberra" or "AbsPhase"
+          FixedPointSimilarity(const std::string& name);
+
+          //! \brief Quantizes the given Gabor jet into the quantized jet of shape (2, length)
+          static void quantize(const Jet& jet, blitz::Array<uint16_t,2>& quantized);
+
+          //! \brief Quantizes all Gabor jets of shape (N, 2, length) into the quantized jets of the same shape
+          static void quantize(const blitz::Array<double,3>& jets, blitz::Array<uint16_t,3>& quantized);
+
+          //! \brief Computes the similarity between the two quantized Gabor jets of shape (2, length)
+          double similarity(const blitz::Array<uint16_t,2>& jet1, const blitz::Array<uint16_t,2>& jet2) const;
+
+          //! \brief Computes the similarities between the quantized probe jet and all quantized jets in the gallery of shape (N, 2, length)
+          //! The scores must be of shape (N); the gallery is distributed over the given number of threads (<= 0 for all cores)
+          void similarities(const blitz::Array<uint16_t,2>& probe, const blitz::Array<uint16_t,3>& gallery, blitz::Array<double,1>& scores, int number_of_threads = 1) const;
+
+          //! the type of the similarity function
+          Similarity::SimilarityType type() const {return m_type;}
+          //! the name of the type of the similarity function
+          const std::string& name() const {return Similarity::type_to_name(m_type);}
+
+        private:
+          // computes the scores of count contiguous gallery jets using the kernel of the current type
+          void compute_similarities(const uint16_t* probe, const uint16_t* gallery, int count, int length, double* scores) const;
+
+          Similarity::SimilarityType m_type;
+
+      }; // class FixedPointSimilarity
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+
+#endif // BOB_IP_GABOR_FIXED_POINT_SIMILARITY_H
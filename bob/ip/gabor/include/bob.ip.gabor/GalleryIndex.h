@@ -0,0 +1,132 @@
+/**
+ * @date Sun Oct 18 00:37:44 UTC 2026
+ *
+ * @brief Index of enrolled Gabor graphs for top-k identification
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_GALLERY_INDEX_H
+#define BOB_IP_GABOR_GALLERY_INDEX_H
+
+#include <unordered_map>
+#include <utility>
+
+#include <bob.ip.gabor/Similarity.h>
+
+namespace bob {
+  namespace ip {
+    namespace gabor{
+      //! \brief Stores enrolled Gabor graphs under integral ids and returns the k most similar graphs for a given probe graph.
+      //! All graphs in the index need to have the same number of nodes and the same number of Gabor wavelets per jet, which is fixed by the first added graph (or by the cohort).
+      //! Optionally, the scores are normalized with the statistics of the scores to a cohort of graphs (Z-norm, T-norm or ZT-norm).
+      class GalleryIndex{
+        public:
+          //! The score normalization that is applied in search
+          typedef enum {
+            NO_NORM = 0,
+            Z_NORM = 1,
+            T_NORM = 2,
+            ZT_NORM = 3
+          } Normalization;
+
+          //! a search result, i.e., the score and the id of a gallery graph
+          typedef std::pair<double, long> Result;
+          //! an inclusive range [first, second] of ids
+          typedef std::pair<long, long> Range;
+          //! the mean and the standard deviation of scores to the cohort
+          typedef std::pair<double, double> Statistics;
+
+          //! \brief Creates an empty index that computes scores with the given similarity function
+          GalleryIndex(boost::shared_ptr<Similarity> similarity);
+
+          //! \brief Reads the index, including the similarity function and the score normalization, from file
+          GalleryIndex(bob::io::base::HDF5File& file);
+
+          //! \brief Adds the given graph under the given id, which must not be in the index yet
+          //! For Z-norm and ZT-norm, the statistics of the scores of the cohort graphs to the new graph are computed using the given number of threads
+          void add(long id, const std::vector<boost::shared_ptr<Jet>>& graph, int number_of_threads = 1);
+
+          //! \brief Removes the graph with the given id from the index; returns false if the id is not in the index
+          bool remove(long id);
+
+          //! \brief Returns true if a graph with the given id is in the index
+          bool contains(long id) const {return m_positions.count(id) > 0;}
+
+          //! \brief Computes the k best results for the given probe graph, sorted by descending score (and ascending id for equal scores)
+          //! When id ranges are given, only graphs with an id in any of the (inclusive) ranges are considered
+          //! The scores are normalized inside the search loop, using the stored Z-norm statistics and the T-norm statistics of the probe, which are computed once per search
+          void search(const std::vector<boost::shared_ptr<Jet>>& probe, int k, std::vector<Result>& results, const std::vector<Range>& id_ranges = std::vector<Range>(), int number_of_threads = 1) const;
+
+          //! \brief Sets the score normalization and the cohort graphs of shape (C, nodes, 2, length), which must contain at least three graphs.
+          //! For Z-norm, the statistics of the scores of all cohort graphs (used as probes) to each enrolled graph are computed and stored, for all graphs in the index now, and in add later on.
+          //! For T-norm, the statistics of the scores of each probe graph to all cohort graphs are computed in search.
+          //! For ZT-norm, the scores are Z-normalized first, and the T-norm statistics are computed from Z-normalized cohort scores, for which the Z-norm statistics of the cohort graphs are computed among each other.
+          void set_normalization(Normalization normalization, const blitz::Array<double,4>& cohort, int number_of_threads = 1);
+
+          //! \brief Removes the score normalization and the cohort
+          void clear_normalization();
+
+          //! \brief Returns the stored Z-norm statistics of the graph with the given id; only available for Z-norm and ZT-norm
+          Statistics z_statistics(long id) const;
+
+          //! \brief Computes the T-norm statistics of the given probe graph; only available for T-norm and ZT-norm
+          Statistics t_statistics(const std::vector<boost::shared_ptr<Jet>>& probe, int number_of_threads = 1) const;
+
+          //! \brief Saves the similarity function, the graphs, the cohort and the stored cohort statistics to file
+          void save(bob::io::base::HDF5File& file) const;
+
+          //! \brief Loads the index from file
+          void load(bob::io::base::HDF5File& file);
+
+          //! the number of graphs in the index
+          int size() const {return m_ids.size();}
+          //! the number of nodes of the graphs, which is defined by the first added graph or by the cohort; 0 if undefined
+          int numberOfNodes() const {return m_nodes;}
+          //! the length of the Gabor jets of the graphs, which is defined by the first added graph or by the cohort; 0 if undefined
+          int length() const {return m_length;}
+          //! the ids of the graphs in the index
+          const std::vector<long>& ids() const {return m_ids;}
+          //! the similarity function used to compute the scores
+          boost::shared_ptr<Similarity> similarity() const {return m_similarity;}
+          //! the score normalization applied in search
+          Normalization normalization() const {return m_normalization;}
+          //! the number of cohort graphs
+          int cohort_size() const {return m_cohort_size;}
+
+          //! converts between the normalization and its name, i.e., "None", "ZNorm", "TNorm" or "ZTNorm"
+          static Normalization name_to_normalization(const std::string& name);
+          static std::string normalization_to_name(Normalization normalization);
+
+        private:
+          // checks that the given graph fits into the index, and defines the shape of the index if it is empty
+          void check(const std::vector<boost::shared_ptr<Jet>>& graph, long id);
+          // computes the statistics of the cohort scores to the contiguous block of count graphs
+          void compute_z_statistics(const double* graphs, int count, Statistics* statistics, int number_of_threads) const;
+
+          boost::shared_ptr<Similarity> m_similarity;
+
+          // the shape of each graph, i.e., (nodes, 2, length)
+          int m_nodes;
+          int m_length;
+
+          // the graph data, stored contiguously in the same order as the ids
+          std::vector<double> m_data;
+          std::vector<long> m_ids;
+          std::unordered_map<long, int> m_positions;
+
+          // the score normalization and the contiguous cohort graphs
+          Normalization m_normalization;
+          int m_cohort_size;
+          std::vector<double> m_cohort;
+          // the Z-norm statistics of the stored graphs (in the same order as the ids) and of the cohort graphs (for ZT-norm only)
+          std::vector<Statistics> m_z_statistics;
+          std::vector<Statistics> m_cohort_statistics;
+
+      }; // class GalleryIndex
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+
+#endif // BOB_IP_GABOR_GALLERY_INDEX_H
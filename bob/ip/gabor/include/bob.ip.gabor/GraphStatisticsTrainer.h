@@ -0,0 +1,55 @@
+/**
+ * @date Sun Oct 18 00:08:40 UTC 2026
+ *
+ * @brief Parallel computation of the Gabor jet statistics of all nodes of a graph
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_GRAPH_STATISTICS_TRAINER_H
+#define BOB_IP_GABOR_GRAPH_STATISTICS_TRAINER_H
+
+#include <bob.ip.gabor/JetStatisticsBuilder.h>
+
+namespace bob { namespace ip { namespace gabor {
+
+//! \brief Computes the JetStatistics of all nodes of a graph in a single pass over the training graphs.
+//! The jets of each node are accumulated by a JetStatisticsBuilder, and the nodes are distributed over several threads, so that no locking is required.
+class GraphStatisticsTrainer {
+  public:
+    //! \brief Creates an empty trainer; the number of nodes and the jet length are defined by the first added graph
+    GraphStatisticsTrainer();
+
+    //! \brief Adds the jets of one graph of shape (number_of_nodes, 2, length)
+    void add(const blitz::Array<double,3>& graph);
+
+    //! \brief Adds the given graphs of shape (N, number_of_nodes, 2, length); the nodes are distributed over the given number of threads
+    void add(const blitz::Array<double,4>& graphs, int number_of_threads = 1);
+
+    //! \brief Adds all graphs that were added to the other trainer
+    void merge(const GraphStatisticsTrainer& other);
+
+    //! \brief Removes all graphs
+    void clear();
+
+    //! \brief Computes the statistics of all nodes; at least two graphs are required
+    std::vector<boost::shared_ptr<JetStatistics>> finalize(boost::shared_ptr<bob::ip::gabor::Transform> gwt = boost::shared_ptr<bob::ip::gabor::Transform>(), int number_of_threads = 1) const;
+
+    //! the number of added graphs
+    long count() const {return m_builders.empty() ? 0 : m_builders.front().count();}
+    //! the number of nodes; 0 if no graph has been added yet
+    int numberOfNodes() const {return m_builders.size();}
+    //! the length of the jets; 0 if no graph has been added yet
+    int length() const {return m_builders.empty() ? 0 : m_builders.front().length();}
+
+  private:
+    // checks the shape of the given graphs, and creates the builders for the first graph
+    void check(int nodes, int two, int length);
+
+    // one builder per node
+    std::vector<JetStatisticsBuilder> m_builders;
+};
+
+} } } // namespaces
+
+#endif // BOB_IP_GABOR_GRAPH_STATISTICS_TRAINER_H
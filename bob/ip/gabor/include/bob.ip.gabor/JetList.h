@@ -0,0 +1,41 @@
+/**
+ * @date Sun Oct 18 00:11:58 UTC 2026
+ *
+ * @brief Reading and writing of lists of Gabor jets as contiguous blocks
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_JET_LIST_H
+#define BOB_IP_GABOR_JET_LIST_H
+
+#include <bob.ip.gabor/Jet.h>
+
+namespace bob {
+
+  namespace ip {
+
+    namespace gabor{
+
+      //! \brief Writes the given jets of shape (N, 2, length) into the single data set "Jets" of the current directory.
+      //! A compression level between 1 and 9 writes the data set compressed, where the HDF5 chunks are selected by bob::io::base::HDF5File.
+      void save_jets(const blitz::Array<double,3>& jets, bob::io::base::HDF5File& file, size_t compression = 0);
+
+      //! \brief Writes the given jets, which must all have the same length, into the single data set "Jets" of the current directory
+      void save_jets(const std::vector<boost::shared_ptr<Jet>>& jets, bob::io::base::HDF5File& file, size_t compression = 0);
+
+      //! \brief Reads a list of jets into a block of shape (N, 2, length).
+      //! Both the single data set written by save_jets and the layout with one directory per jet (Jet_1, Jet_2, ...) written by bob.ip.gabor.save_jets in Python are supported.
+      blitz::Array<double,3> load_jets(bob::io::base::HDF5File& file);
+
+      //! \brief Returns the name of the directory of the jet with the given index in the layout with one directory per jet, where the file contains count jets.
+      //! The index is zero-padded to the number of digits of count; older files, which always used three digits, are detected.
+      std::string jet_directory(bob::io::base::HDF5File& file, int index, int count);
+
+    } // namespace gabor
+
+  } // namespace ip
+
+} // namespace bob
+
+#endif // BOB_IP_GABOR_JET_LIST_H
@@ -20,6 +20,8 @@ class JetStatistics {
   public:
     JetStatistics(const std::vector<boost::shared_ptr<bob::ip::gabor::Jet>>& jets, boost::shared_ptr<bob::ip::gabor::Transform> gwt = boost::shared_ptr<bob::ip::gabor::Transform>());
     JetStatistics(bob::io::base::HDF5File& hdf5);
+    // creates the statistics from the given means and variances, e.g., computed by the JetStatisticsBuilder
+    JetStatistics(const blitz::Array<double,1>& meanAbs, const blitz::Array<double,1>& varAbs, const blitz::Array<double,1>& meanPhase, const blitz::Array<double,1>& varPhase, boost::shared_ptr<bob::ip::gabor::Transform> gwt = boost::shared_ptr<bob::ip::gabor::Transform>());
 
     //! Equality operator
     bool operator==(const JetStatistics& other) const;
@@ -42,12 +44,30 @@ class JetStatistics {
     // saves this configuration to file
     void save(bob::io::base::HDF5File& hdf5, bool saveTransform = true) const;
 
+    // saves the given statistics, e.g., of all nodes of a graph, into a single data set of shape (N, 4, length), and their common transform once
+    static void save(const std::vector<boost::shared_ptr<JetStatistics>>& statistics, bob::io::base::HDF5File& hdf5, bool saveTransform = true);
+    // loads the statistics that were written by the static save function
+    static std::vector<boost::shared_ptr<JetStatistics>> load(bob::io::base::HDF5File& hdf5);
+
     // computes the estimated disparity of the given jet towards the mean and variance given in these statistics
+    // this function and the log likelihood functions do not modify the statistics, so that they can be called concurrently
     blitz::TinyVector<double, 2> disparity(const boost::shared_ptr<bob::ip::gabor::Jet> jet) const;
 
     // computes the log likelihood that the given jet fits to these statistics; always negative
     double logLikelihood(const boost::shared_ptr<bob::ip::gabor::Jet> jet, bool estimate_phase = true, const blitz::TinyVector<double,2>& offset=blitz::TinyVector<double,2>(0.,0.)) const;
 
+    // computes the log likelihoods of all given jets of shape (N, 2, length) at once, distributed over the given number of threads
+    void logLikelihoods(const blitz::Array<double,3>& jets, blitz::Array<double,1>& scores, bool estimate_phase = true, const blitz::TinyVector<double,2>& offset=blitz::TinyVector<double,2>(0.,0.), int number_of_threads = 1) const;
+
+    // computes the log likelihoods of all given jets of shape (N, 2, length) for all given statistics, into scores of shape (M, N)
+    static void logLikelihoods(const std::vector<boost::shared_ptr<JetStatistics>>& statistics, const blitz::Array<double,3>& jets, blitz::Array<double,2>& scores, bool estimate_phase = true, const blitz::TinyVector<double,2>& offset=blitz::TinyVector<double,2>(0.,0.), int number_of_threads = 1);
+
+    // computes the log likelihoods of the jets at all positions in the region [first, last] (inclusive) of the given Gabor wavelet transformed image, into scores of shape (last - first + 1); the rows of the region are distributed over the given number of threads
+    void logLikelihoodMap(const blitz::Array<std::complex<double>,3>& trafo_image, const blitz::TinyVector<int,2>& first, const blitz::TinyVector<int,2>& last, blitz::Array<double,2>& scores, bool estimate_phase = true, bool normalize = true, int number_of_threads = 1) const;
+
+    // computes the log likelihood maps of all given statistics in their regions [first[i], last[i]], where the jets are extracted only once for positions that are inside several regions; the scores are resized to the shapes of the regions
+    static void logLikelihoodMaps(const std::vector<boost::shared_ptr<JetStatistics>>& statistics, const blitz::Array<std::complex<double>,3>& trafo_image, const std::vector<blitz::TinyVector<int,2>>& first, const std::vector<blitz::TinyVector<int,2>>& last, std::vector<blitz::Array<double,2>>& scores, bool estimate_phase = true, bool normalize = true, int number_of_threads = 1);
+
   protected:
     // means and variances of absolute and phase values of the jets
     blitz::Array<double,1> m_meanAbs, m_meanPhase, m_varAbs, m_varPhase;
@@ -55,8 +75,14 @@ class JetStatistics {
     boost::shared_ptr<bob::ip::gabor::Transform> m_gwt;
 
   private:
-    // cached sotrage to speed up computation
-    mutable blitz::Array<double,1> m_confidences, m_phaseDifferences;
+    // the statistics and wavelet frequencies in the form used by the batch computations
+    struct Model;
+
+    // computes the inverse phase variances
+    void init();
+
+    // the inverse phase variances, which are used in the disparity estimation
+    std::vector<double> m_invVarPhase;
 };
 
 } } } // namespaces
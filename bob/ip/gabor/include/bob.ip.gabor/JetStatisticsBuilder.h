@@ -0,0 +1,82 @@
+/**
+ * @date Sat Oct 17 23:46:00 UTC 2026
+ *
+ * @brief Incremental computation of Gabor jet statistics
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_JET_STATISTICS_BUILDER_H
+#define BOB_IP_GABOR_JET_STATISTICS_BUILDER_H
+
+#include <bob.ip.gabor/JetStatistics.h>
+#include <complex>
+
+namespace bob { namespace ip { namespace gabor {
+
+//! \brief Computes the same statistics as the JetStatistics constructor in a single pass over the training jets.
+//! Jets can be added one at a time or in batches, and builders of disjoint parts of the training set (e.g., from different threads or machines) can be merged.
+//! The mean and the variance of the absolute values are updated with Welford's algorithm.
+//! The mean phase is the phase of the sum of the complex jet values, as in the average Jet.
+//! The phase variance of the JetStatistics constructor wraps each phase difference around the mean phase, which is known only after the last jet.
+//! Hence, the builder accumulates the phase differences to the phases of the first jet with Welford's algorithm, together with their range, and shifts them to the mean phase when finalizing.
+//! When all phases of a coefficient lie within pi of its mean phase, which the range proves, the phase variance is identical to the one of the constructor (up to rounding).
+//! Otherwise, the phase variance is computed from the first PHASE_MOMENTS trigonometric moments of the phases, i.e., from the truncated Fourier series of the squared wrapped difference;
+//! this differs from the constructor by less than 4 / PHASE_MOMENTS * count / (count-1), and by about 1% of the variance for phases that are spread over the whole circle.
+//! The memory of the builder does not depend on the number of added jets.
+class JetStatisticsBuilder {
+  public:
+    //! the number of trigonometric moments of the phases that are accumulated
+    static const int PHASE_MOMENTS = 16;
+
+    //! \brief Creates an empty builder; the jet length is defined by the first added jet
+    JetStatisticsBuilder();
+
+    //! \brief Reads a (partial) builder from file
+    JetStatisticsBuilder(bob::io::base::HDF5File& hdf5);
+
+    //! \brief Adds the given jet
+    void add(const Jet& jet);
+
+    //! \brief Adds the given jets of shape (N, 2, length)
+    void add(const blitz::Array<double,3>& jets);
+
+    //! \brief Adds all jets that were added to the other builder
+    void merge(const JetStatisticsBuilder& other);
+
+    //! \brief Removes all jets
+    void clear();
+
+    //! \brief Computes the statistics of all added jets; at least two jets are required
+    boost::shared_ptr<JetStatistics> finalize(boost::shared_ptr<bob::ip::gabor::Transform> gwt = boost::shared_ptr<bob::ip::gabor::Transform>()) const;
+
+    //! \brief Saves the current state of the builder, so that it can be merged elsewhere
+    void save(bob::io::base::HDF5File& hdf5) const;
+
+    //! the number of added jets
+    long count() const {return m_count;}
+    //! the length of the jets; 0 if no jet has been added yet
+    int length() const {return m_length;}
+
+  private:
+    friend class GraphStatisticsTrainer;
+
+    // adds the jet with the given absolute values and phases
+    void add(const double* abs, const double* phase);
+
+    long m_count;
+    int m_length;
+
+    // the Welford mean and sum of squared deviations of the absolute values
+    std::vector<double> m_meanAbs, m_m2Abs;
+    // the sum of the complex values
+    std::vector<double> m_sumReal, m_sumImag;
+    // the phases of the first jet, and the Welford mean, the sum of squared deviations and the range of the phase differences to them
+    std::vector<double> m_reference, m_meanDifference, m_m2Difference, m_minDifference, m_maxDifference;
+    // the sums of exp(i*k*phase) for k = 1, ..., PHASE_MOMENTS, stored as (length, PHASE_MOMENTS) block
+    std::vector<std::complex<double>> m_moments;
+};
+
+} } } // namespaces
+
+#endif // BOB_IP_GABOR_JET_STATISTICS_BUILDER_H
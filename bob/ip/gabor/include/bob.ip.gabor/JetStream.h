@@ -0,0 +1,102 @@
+/**
+ * @date Sun Oct 18 00:28:40 UTC 2026
+ *
+ * @brief Reads lists of Gabor jets that do not fit into memory in batches, which are read ahead in a background thread
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_JET_STREAM_H
+#define BOB_IP_GABOR_JET_STREAM_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include <bob.ip.gabor/JetList.h>
+#include <bob.ip.gabor/Similarity.h>
+
+namespace bob {
+  namespace ip {
+    namespace gabor{
+      //! \brief Reads the Gabor jets of an HDF5 file in batches of contiguous jets, so that the memory does not depend on the number of jets in the file.
+      //! Both layouts that are read by load_jets are supported; each batch of the data set "Jets" is read with a single hyperslab selection.
+      //! While the batches are processed, the next batches are read by a background thread.
+      //! This requires an HDF5 library that is built thread-safe, since other threads might access HDF5 files at the same time;
+      //! otherwise, each batch is read in the thread that calls next(), and nothing is read ahead.
+      class JetStream{
+        public:
+          //! \brief Opens the given file and starts reading; at most read_ahead batches of batch_size jets are kept in memory in addition to the batch returned by next()
+          JetStream(const std::string& filename, int batch_size = 1024, int read_ahead = 2);
+
+          //! \brief Stops the background thread
+          ~JetStream();
+
+          //! \brief Returns the next batch of shape (n, 2, length), where n is batch_size for all batches but the last; returns false when all jets have been read.
+          //! Errors of the background thread are thrown here
+          bool next(blitz::Array<double,3>& batch);
+
+          //! \brief Starts reading again from the first jet
+          void reset();
+
+          //! \brief Reads all jets from the first one and computes the similarities between all probes and all jets in the file, which are written into scores of shape (probes, size()).
+          //! Each batch is distributed over the given number of threads, while the next batch is read
+          void similarities(const Similarity& similarity, const std::vector<boost::shared_ptr<Jet>>& probes, blitz::Array<double,2>& scores, int number_of_threads = 1);
+
+          //! the name of the file
+          const std::string& filename() const {return m_filename;}
+          //! the number of jets in the file
+          int size() const {return m_size;}
+          //! the length of the jets
+          int length() const {return m_length;}
+          //! the number of jets per batch
+          int batchSize() const {return m_batch_size;}
+          //! the maximum number of batches that are read ahead
+          int readAhead() const {return m_read_ahead;}
+          //! the index of the first jet of the next batch
+          int position() const {return m_position;}
+          //! true if the batches are read ahead by a background thread, i.e., if the HDF5 library is thread-safe
+          bool background() const {return m_background;}
+
+        private:
+          // reads batches from the opened file, see JetStream.cpp
+          struct Reader;
+
+          // starts reading at the first jet, or stops the background thread
+          void start();
+          void stop();
+
+          // the function of the background thread
+          void read();
+
+          std::string m_filename;
+          int m_batch_size;
+          int m_read_ahead;
+          // true for the data set "Jets", false for one directory per jet
+          bool m_single_data_set;
+          int m_size;
+          int m_length;
+          int m_position;
+          bool m_background;
+
+          // the reader used by next() when no background thread is used
+          boost::shared_ptr<Reader> m_synchronous;
+
+          // the batches that are read, but not returned by next() yet
+          std::thread m_reader;
+          std::mutex m_mutex;
+          std::condition_variable m_changed;
+          std::deque<blitz::Array<double,3>> m_batches;
+          bool m_stopped;
+          bool m_finished;
+          std::exception_ptr m_error;
+
+      }; // class JetStream
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+
+#endif // BOB_IP_GABOR_JET_STREAM_H
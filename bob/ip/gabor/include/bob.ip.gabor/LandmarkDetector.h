@@ -0,0 +1,65 @@
+/**
+ * @date Sun Oct 18 00:02:42 UTC 2026
+ *
+ * @brief Localization of several landmarks with Gabor jet statistics
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_LANDMARK_DETECTOR_H
+#define BOB_IP_GABOR_LANDMARK_DETECTOR_H
+
+#include <bob.ip.gabor/JetStatistics.h>
+
+namespace bob {
+  namespace ip {
+    namespace gabor{
+      //! \brief Localizes several landmarks, e.g., facial landmarks, each of which is modeled by JetStatistics that share the same Transform.
+      //! The image is transformed once, and the log likelihood maps of all landmarks are computed in one pass over their search regions, where each Gabor jet is extracted only once.
+      //! The best position of each landmark is refined to sub-pixel precision using the disparity of the Gabor jet at this position.
+      class LandmarkDetector{
+        public:
+          //! \brief Creates a detector for the landmarks with the given statistics, which must have the length of the given transform.
+          //! The statistics are copied, and the transform of the copies is set to the given one
+          LandmarkDetector(boost::shared_ptr<Transform> gwt, const std::vector<boost::shared_ptr<JetStatistics>>& statistics);
+
+          //! \brief Reads the transform and the statistics of all landmarks from file
+          LandmarkDetector(bob::io::base::HDF5File& hdf5);
+
+          //! \brief Localizes all landmarks in the given transformed image, each inside its inclusive search region [first[i], last[i]].
+          //! The positions of shape (number_of_landmarks, 2) are the best positions, refined by the disparity when it is less than one pixel;
+          //! the scores of shape (number_of_landmarks) are the log likelihoods of the jets at the best integral positions.
+          //! This function does not modify the detector, so that it can be called concurrently.
+          void detect(const blitz::Array<std::complex<double>,3>& trafo_image, const std::vector<blitz::TinyVector<int,2>>& first, const std::vector<blitz::TinyVector<int,2>>& last, blitz::Array<double,2>& positions, blitz::Array<double,1>& scores, bool estimate_phase = true, int number_of_threads = 1) const;
+
+          //! \brief Transforms the given image and localizes all landmarks in it.
+          //! The transformed image is kept for the next call, so this function is not thread-safe
+          template <typename T>
+          void detect(const blitz::Array<T,2>& image, const std::vector<blitz::TinyVector<int,2>>& first, const std::vector<blitz::TinyVector<int,2>>& last, blitz::Array<double,2>& positions, blitz::Array<double,1>& scores, bool estimate_phase = true, int number_of_threads = 1){
+            m_trafo_image.resize(m_gwt->numberOfWavelets(), image.extent(0), image.extent(1));
+            m_gwt->transform(image, m_trafo_image);
+            detect(m_trafo_image, first, last, positions, scores, estimate_phase, number_of_threads);
+          }
+
+          //! \brief Saves the transform and the statistics of all landmarks to file
+          void save(bob::io::base::HDF5File& hdf5) const;
+
+          //! the number of landmarks
+          int numberOfLandmarks() const {return m_statistics.size();}
+          //! the transform, which is shared by all statistics
+          boost::shared_ptr<Transform> gwt() const {return m_gwt;}
+          //! the statistics of all landmarks
+          const std::vector<boost::shared_ptr<JetStatistics>>& statistics() const {return m_statistics;}
+
+        private:
+          boost::shared_ptr<Transform> m_gwt;
+          std::vector<boost::shared_ptr<JetStatistics>> m_statistics;
+
+          // the transformed image of the last call to detect(image, ...)
+          blitz::Array<std::complex<double>,3> m_trafo_image;
+      }; // class LandmarkDetector
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+#endif // BOB_IP_GABOR_LANDMARK_DETECTOR_H
@@ -0,0 +1,112 @@
+/**
+ * @date Sun Oct 18 00:19:09 UTC 2026
+ *
+ * @brief Memory-mapped binary gallery of enrolled Gabor graphs
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_MAPPED_GALLERY_H
+#define BOB_IP_GABOR_MAPPED_GALLERY_H
+
+#include <stdint.h>
+
+#include <bob.ip.gabor/Similarity.h>
+
+namespace bob {
+  namespace ip {
+    namespace gabor{
+      //! \brief The binary file format of the MappedGallery.
+      //! All values are stored in the native byte order of the machine that wrote the file, which is checked with the BYTE_ORDER_MARK.
+      //! The file starts with the Header, which is followed by the blocks at the offsets given in the header; each block starts at a multiple of ALIGNMENT bytes:
+      //! - ids: count int64 values
+      //! - nodes: number_of_nodes pairs of int32 (y, x) node positions, which are optional
+      //! - jets: the graphs as count * number_of_nodes * 2 * length float64 values
+      //! - quantized: the graphs quantized by FixedPointSimilarity::quantize as count * number_of_nodes * 2 * length uint16 values, which are optional
+      //! Optional blocks have offset 0.
+      namespace gallery_file{
+        static const char MAGIC[8] = {'B', 'I', 'P', 'G', 'G', 'A', 'L', '\0'};
+        static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+        static const uint32_t VERSION = 1;
+        static const uint64_t ALIGNMENT = 64;
+
+        struct Header{
+          char magic[8];
+          uint32_t byte_order;
+          uint32_t version;
+          uint64_t header_size;
+          int64_t count;
+          int32_t number_of_nodes;
+          int32_t length;
+          uint64_t ids_offset;
+          uint64_t nodes_offset;
+          uint64_t jets_offset;
+          uint64_t quantized_offset;
+          uint64_t file_size;
+        };
+      }
+
+      //! \brief Provides the enrolled graphs of a gallery file, which is mapped into memory read-only.
+      //! Opening the file does not read or convert any data; the arrays returned by this class point into the mapped file and can directly be passed to the similarity functions.
+      //! Several processes that open the same file share the pages in the page cache.
+      class MappedGallery{
+        public:
+          //! \brief Writes the given graphs of shape (N, nodes, 2, length) with the given ids (by default 0, ..., N-1) and node positions (optional) to the given file.
+          //! When quantize is true, the graphs are also stored in the format of the FixedPointSimilarity
+          static void write(const std::string& filename, const blitz::Array<double,4>& graphs, const std::vector<int64_t>& ids = std::vector<int64_t>(), const std::vector<blitz::TinyVector<int,2>>& nodes = std::vector<blitz::TinyVector<int,2>>(), bool quantize = false);
+
+          //! \brief Maps the given gallery file into memory, after checking its header
+          MappedGallery(const std::string& filename);
+
+          //! \brief Unmaps the file; all arrays returned by this class become invalid
+          ~MappedGallery();
+
+          //! \brief Computes the similarities between the given probe graph and all graphs of the gallery, directly on the mapped data
+          void similarities(const Similarity& similarity, const std::vector<boost::shared_ptr<Jet>>& probe, blitz::Array<double,1>& scores, int number_of_threads = 1) const;
+
+          //! the name of the mapped file
+          const std::string& filename() const {return m_filename;}
+          //! the version of the file format
+          int version() const {return m_header->version;}
+          //! the number of graphs
+          int size() const {return m_header->count;}
+          //! the number of nodes of each graph
+          int numberOfNodes() const {return m_header->number_of_nodes;}
+          //! the length of the Gabor jets
+          int length() const {return m_header->length;}
+          //! the ids of the graphs
+          const blitz::Array<int64_t,1>& ids() const {return m_ids;}
+          //! the node positions of the graphs; empty if they were not stored
+          const std::vector<blitz::TinyVector<int,2>>& nodes() const {return m_nodes;}
+          //! the graphs of shape (size(), numberOfNodes(), 2, length()), which must not be modified
+          const blitz::Array<double,4>& graphs() const {return m_graphs;}
+          //! the Gabor jets of all graphs of shape (size() * numberOfNodes(), 2, length()), which must not be modified
+          const blitz::Array<double,3>& jets() const {return m_jets;}
+          //! true if the quantized graphs are stored
+          bool hasQuantized() const {return m_header->quantized_offset != 0;}
+          //! the quantized Gabor jets of all graphs of shape (size() * numberOfNodes(), 2, length()); empty if they were not stored
+          const blitz::Array<uint16_t,3>& quantized() const {return m_quantized;}
+
+        private:
+          // no copies of the mapping
+          MappedGallery(const MappedGallery&);
+          MappedGallery& operator=(const MappedGallery&);
+
+          std::string m_filename;
+          void* m_data;
+          std::size_t m_size;
+          const gallery_file::Header* m_header;
+
+          // views into the mapped memory
+          blitz::Array<int64_t,1> m_ids;
+          std::vector<blitz::TinyVector<int,2>> m_nodes;
+          blitz::Array<double,4> m_graphs;
+          blitz::Array<double,3> m_jets;
+          blitz::Array<uint16_t,3> m_quantized;
+
+      }; // class MappedGallery
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+#endif // BOB_IP_GABOR_MAPPED_GALLERY_H
@@ -0,0 +1,121 @@
+/**
+ * @date Sat Oct 17 23:41:12 UTC 2026
+ *
+ * @brief A matching server that answers queries on a gallery shard over a Unix domain socket, and a client that merges the results of several servers
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_MATCHING_SERVICE_H
+#define BOB_IP_GABOR_MATCHING_SERVICE_H
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+
+#include <bob.ip.gabor/GalleryIndex.h>
+
+namespace bob {
+  namespace ip {
+    namespace gabor{
+      //! \brief The binary protocol between the MatchingServer and the MatchingClient.
+      //! All values are stored in the native byte order, since both sides run on the same machine.
+      //! Each request starts with the MAGIC number and the command:
+      //! - SEARCH: int32 k, int32 nodes, int32 length, int32 number of id ranges, the id ranges as pairs of int64, and the probe graph as nodes * 2 * length float64 values
+      //! - INFO: no further data
+      //! Each response starts with the MAGIC number and an int32 status:
+      //! - on error (status != 0): int32 length of the message, followed by the message
+      //! - SEARCH: int32 number of results, followed by the results as pairs of float64 score and int64 id
+      //! - INFO: int64 number of graphs, int32 nodes, int32 length
+      namespace protocol{
+        static const uint32_t MAGIC = 0x4D425447; // "GTBM"
+        typedef enum {
+          SEARCH = 1,
+          INFO = 2
+        } Command;
+      }
+
+      //! \brief Answers search queries on a GalleryIndex, which usually contains one shard of a large gallery, over a Unix domain socket.
+      //! Several clients can be connected at the same time, and each connection is handled in its own thread.
+      class MatchingServer{
+        public:
+          //! \brief Binds the Unix domain socket at the given path, which replaces an existing socket (but no other file); clients can connect as soon as the server is constructed
+          //! Each search is distributed over the given number of threads
+          MatchingServer(boost::shared_ptr<GalleryIndex> index, const std::string& socket_path, int number_of_threads = 1);
+
+          //! \brief Stops the server and removes the socket, unless it was replaced by another server meanwhile
+          ~MatchingServer();
+
+          //! \brief Accepts connections and answers their queries until stop() is called; can be called only once
+          void serve();
+
+          //! \brief Stops serve(), closes all connections and waits until their threads have finished
+          //! This function can be called from any thread
+          void stop();
+
+          //! the gallery index that is searched
+          boost::shared_ptr<GalleryIndex> index() const {return m_index;}
+          //! the path of the Unix domain socket
+          const std::string& socket_path() const {return m_socket_path;}
+
+        private:
+          // answers all queries of the given connection until it is closed
+          void handle(int connection);
+
+          boost::shared_ptr<GalleryIndex> m_index;
+          std::string m_socket_path;
+          int m_number_of_threads;
+          int m_socket;
+          // identifies the socket file that was created by this server
+          dev_t m_socket_device;
+          ino_t m_socket_inode;
+          std::atomic<bool> m_stopped;
+
+          // the open connections, which are closed in stop()
+          std::mutex m_mutex;
+          std::condition_variable m_finished;
+          std::set<int> m_connections;
+          int m_handlers;
+
+      }; // class MatchingServer
+
+
+      //! \brief Sends search queries to several MatchingServer's, e.g., one per gallery shard, and merges their results.
+      //! The servers are queried in parallel; the client can be used by several threads at the same time.
+      class MatchingClient{
+        public:
+          //! \brief Connects to the servers at the given socket paths; the connections are closed when the client is destroyed
+          MatchingClient(const std::vector<std::string>& socket_paths);
+
+          //! \brief Computes the k best results of all servers for the given probe graph, sorted by descending score (and ascending id for equal scores)
+          //! When id ranges are given, only graphs with an id in any of the (inclusive) ranges are considered
+          void search(const std::vector<boost::shared_ptr<Jet>>& probe, int k, std::vector<GalleryIndex::Result>& results, const std::vector<GalleryIndex::Range>& id_ranges = std::vector<GalleryIndex::Range>());
+
+          //! \brief Returns the total number of graphs of all servers
+          long size();
+
+          //! the number of servers
+          int numberOfShards() const {return m_connections.size();}
+
+        private:
+          // a connection to one server, which is used by one thread at a time
+          struct Connection{
+            Connection(const std::string& path);
+            ~Connection();
+            std::string path;
+            int socket;
+            std::mutex mutex;
+          };
+
+          std::vector<boost::shared_ptr<Connection>> m_connections;
+
+      }; // class MatchingClient
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+
+#endif // BOB_IP_GABOR_MATCHING_SERVICE_H
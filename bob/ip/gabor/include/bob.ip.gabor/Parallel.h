@@ -0,0 +1,68 @@
+/**
+ * @date Sat Oct 17 22:37:09 UTC 2026
+ *
+ * @brief Helper functions to distribute batch computations over several threads
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+
+#ifndef BOB_IP_GABOR_PARALLEL_H
+#define BOB_IP_GABOR_PARALLEL_H
+
+#include <thread>
+#include <vector>
+#include <exception>
+#include <algorithm>
+
+namespace bob {
+
+  namespace ip {
+
+    namespace gabor{
+
+      //! \brief Returns the number of threads that should be used for a batch of the given size.
+      //! A number_of_threads <= 0 selects one thread per available core.
+      inline int number_of_threads(int size, int number_of_threads){
+        if (number_of_threads <= 0)
+          number_of_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+        return std::max(std::min(number_of_threads, size), 1);
+      }
+
+      //! \brief Splits the range [0, size[ into contiguous chunks and calls function(begin, end) for each of them in a separate thread.
+      //! Exceptions thrown in any of the threads are re-thrown in the calling thread.
+      template <typename Function>
+      void parallel_for(int size, int threads, Function function){
+        threads = number_of_threads(size, threads);
+        if (threads == 1){
+          // avoid the overhead of thread creation
+          if (size > 0) function(0, size);
+          return;
+        }
+
+        std::vector<std::thread> pool;
+        std::vector<std::exception_ptr> errors(threads);
+        pool.reserve(threads);
+        for (int t = 0; t < threads; ++t){
+          int begin = (int)((long)size * t / threads), end = (int)((long)size * (t+1) / threads);
+          pool.push_back(std::thread([&function, &errors, t, begin, end](){
+            try {
+              function(begin, end);
+            } catch (...){
+              errors[t] = std::current_exception();
+            }
+          }));
+        }
+        for (auto it = pool.begin(); it != pool.end(); ++it)
+          it->join();
+        for (auto it = errors.begin(); it != errors.end(); ++it)
+          if (*it) std::rethrow_exception(*it);
+      }
+
+    } // namespace gabor
+
+  } // namespace ip
+
+} // namespace bob
+
+#endif // BOB_IP_GABOR_PARALLEL_H
@@ -0,0 +1,107 @@
+/**
+ * @date Sat Oct 17 23:02:54 UTC 2026
+ *
+ * @brief Approximate nearest neighbor search of Gabor jets using product quantization
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_QUANTIZED_INDEX_H
+#define BOB_IP_GABOR_QUANTIZED_INDEX_H
+
+#include <stdint.h>
+#include <utility>
+
+#include <bob.ip.gabor/Similarity.h>
+
+namespace bob {
+  namespace ip {
+    namespace gabor{
+      //! \brief Stores Gabor jets as product quantization codes and finds the approximate nearest neighbors of a probe jet.
+      //! Each jet is converted into a vector (either the absolute values, or the interleaved real and imaginary parts), which is split into equally sized sub-vectors.
+      //! Each sub-vector is quantized with its own codebook, which is trained with k-means, so that each jet is stored in only one byte per sub-vector.
+      //! The distance between a probe and all stored jets is approximated using a lookup table of the distances between the probe sub-vectors and all centroids.
+      class QuantizedIndex{
+        public:
+          //! The space in which the jets are quantized
+          typedef enum {
+            ABSOLUTE = 0,
+            CARTESIAN = 1
+          } Space;
+
+          //! a search result, i.e., the (approximate squared) distance or the similarity, and the index of the stored jet
+          typedef std::pair<double, int> Result;
+
+          //! \brief Creates an untrained index with the given number of sub-vectors and centroids per sub-vector (at most 256)
+          QuantizedIndex(int number_of_subspaces = 8, int number_of_centroids = 256, Space space = ABSOLUTE);
+
+          //! \brief Reads the index from file
+          QuantizedIndex(bob::io::base::HDF5File& file);
+
+          //! \brief Trains the codebooks with k-means on the given training jets of shape (N, 2, length); removes all stored jets
+          void train(const blitz::Array<double,3>& jets, int iterations = 20, unsigned seed = 0, int number_of_threads = 1);
+
+          //! \brief Encodes the given jets of shape (N, 2, length) and appends them to the index; the first added jet has index 0
+          void add(const blitz::Array<double,3>& jets, int number_of_threads = 1);
+
+          //! \brief Removes all stored jets, but keeps the codebooks
+          void clear() {m_codes.clear();}
+
+          //! \brief Computes the table of squared distances between the sub-vectors of the probe and all centroids, of shape (number_of_subspaces, number_of_centroids)
+          void distance_table(const Jet& probe, blitz::Array<double,2>& table) const;
+
+          //! \brief Returns the k stored jets with the smallest approximate squared distances to the probe, sorted by ascending distance
+          void search(const Jet& probe, int k, std::vector<Result>& results, int number_of_threads = 1) const;
+
+          //! \brief Selects the given number of candidates with the approximate search and re-ranks them with the exact similarity to the jets in the gallery of shape (size(), 2, length).
+          //! Returns the k jets with the highest similarities, sorted by descending similarity; more candidates increase recall, but require more exact similarity computations
+          void search(const Jet& probe, const blitz::Array<double,3>& gallery, const Similarity& similarity, int k, int candidates, std::vector<Result>& results, int number_of_threads = 1) const;
+
+          //! \brief Saves the codebooks and the codes to file
+          void save(bob::io::base::HDF5File& file) const;
+
+          //! \brief Loads the codebooks and the codes from file
+          void load(bob::io::base::HDF5File& file);
+
+          //! the space, in which the jets are quantized
+          Space space() const {return m_space;}
+          //! the number of sub-vectors
+          int numberOfSubspaces() const {return m_subspaces;}
+          //! the number of centroids per sub-vector
+          int numberOfCentroids() const {return m_number_of_centroids;}
+          //! the length of the jets, which is defined during training; 0 for untrained indices
+          int length() const {return m_length;}
+          //! the number of stored jets
+          int size() const {return m_codes.size() / m_subspaces;}
+          //! the trained centroids, of shape (number_of_subspaces, number_of_centroids, sub-vector length)
+          const blitz::Array<double,3>& centroids() const {return m_centroids;}
+          //! the codes of all stored jets, of shape (size(), number_of_subspaces)
+          blitz::Array<uint8_t,2> codes() const;
+
+          //! converts between the space and its name, i.e., "Absolute" or "Cartesian"
+          static Space name_to_space(const std::string& name);
+          static std::string space_to_name(Space space);
+
+        private:
+          // checks that the index is trained and that the jets fit to it
+          void check(int length) const;
+
+          // converts the given jet data into the quantization vector
+          void vectorize(const double* jet, double* vector) const;
+
+          Space m_space;
+          int m_subspaces;
+          int m_number_of_centroids;
+          int m_length;
+
+          // the codebooks and the codes of the stored jets
+          blitz::Array<double,3> m_centroids;
+          std::vector<uint8_t> m_codes;
+
+      }; // class QuantizedIndex
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+
+#endif // BOB_IP_GABOR_QUANTIZED_INDEX_H
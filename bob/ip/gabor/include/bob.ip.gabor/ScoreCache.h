@@ -0,0 +1,105 @@
+/**
+ * @date Sat Oct 17 23:35:10 UTC 2026
+ *
+ * @brief A bounded cache of the similarity scores of repeatedly compared Gabor jets and graphs
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#ifndef BOB_IP_GABOR_SCORE_CACHE_H
+#define BOB_IP_GABOR_SCORE_CACHE_H
+
+#include <stdint.h>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include <bob.ip.gabor/Similarity.h>
+
+namespace bob {
+  namespace ip {
+    namespace gabor{
+      //! \brief Caches the scores of a similarity function for pairs of Gabor jets or graphs, so that repeated comparisons become lookups.
+      //! The pairs are identified by 64 bit hashes of the contents of both sides, which are seeded with the configuration of the similarity function (the type, the wavelet frequencies and the fast math mode).
+      //! When the capacity is exceeded, the least recently used scores are removed.
+      //! All functions can be called concurrently from several threads.
+      class ScoreCache{
+        public:
+          //! \brief Creates an empty cache for the given similarity function, which stores at most capacity scores
+          ScoreCache(boost::shared_ptr<Similarity> similarity, std::size_t capacity = 100000);
+
+          //! \brief Returns the (cached) similarity between the two Gabor jets
+          double similarity(const Jet& jet1, const Jet& jet2);
+
+          //! \brief Returns the (cached) average similarity between the corresponding nodes of the two graphs
+          double similarity(const std::vector<boost::shared_ptr<Jet>>& graph1, const std::vector<boost::shared_ptr<Jet>>& graph2);
+
+          //! \brief Computes the similarities between the probe jet and all jets of the gallery of shape (N, 2, length)
+          //! Only the scores that are not cached are computed, using the given number of threads (<= 0 for all cores)
+          void similarities(const Jet& probe, const blitz::Array<double,3>& gallery, blitz::Array<double,1>& scores, int number_of_threads = 1);
+
+          //! \brief Computes the average similarities between the probe graph and all graphs of the gallery of shape (N, nodes, 2, length)
+          void similarities(const std::vector<boost::shared_ptr<Jet>>& probe, const blitz::Array<double,4>& gallery, blitz::Array<double,1>& scores, int number_of_threads = 1);
+
+          //! \brief Removes all cached scores, but keeps the statistics
+          void clear();
+
+          //! \brief Resets the number of hits and misses
+          void reset_statistics();
+
+          //! the similarity function, of which the scores are cached
+          boost::shared_ptr<Similarity> similarity() const {return m_similarity;}
+          //! the maximum number of cached scores
+          std::size_t capacity() const {return m_capacity;}
+          //! the current number of cached scores
+          std::size_t size() const;
+          //! the number of scores that were found in the cache since the last reset of the statistics
+          long hits() const {return m_hits;}
+          //! the number of scores that needed to be computed since the last reset of the statistics
+          long misses() const {return m_misses;}
+          //! the rate of scores that were found in the cache since the last reset of the statistics
+          double hit_rate() const;
+
+        private:
+          // the hashes of both sides of a comparison
+          struct Key{
+            uint64_t probe, gallery;
+            bool operator==(const Key& other) const {return probe == other.probe && gallery == other.gallery;}
+          };
+          struct KeyHash{
+            std::size_t operator()(const Key& key) const {return key.probe ^ (key.gallery * 0x9E3779B97F4A7C15ull);}
+          };
+          // the scores, sorted from the most to the least recently used one
+          typedef std::list<std::pair<Key, double>> Entries;
+
+          // returns the seed of the hashes for the current configuration of the similarity function
+          uint64_t seed() const;
+          // looks up or computes the scores of all gallery entries
+          template <typename Probe, int D>
+          void run(const Probe& probe, const blitz::Array<double,D>& gallery, blitz::Array<double,1>& scores, int number_of_threads);
+          // looks up the score of the given key and marks it as recently used; returns false if the score is not cached
+          bool lookup(const Key& key, double& score);
+          // inserts the given score and removes the least recently used scores beyond the capacity
+          void insert(const Key& key, double score);
+
+          boost::shared_ptr<Similarity> m_similarity;
+          std::size_t m_capacity;
+          // the hash of the type and the wavelet frequencies of the similarity function
+          uint64_t m_configuration;
+
+          Entries m_entries;
+          std::unordered_map<Key, Entries::iterator, KeyHash> m_index;
+          mutable std::mutex m_mutex;
+
+          // the statistics are updated by concurrent comparisons
+          std::atomic<long> m_hits;
+          std::atomic<long> m_misses;
+
+      }; // class ScoreCache
+    } // namespace gabor
+  } // namespace ip
+} // namespace bob
+
+
+#endif // BOB_IP_GABOR_SCORE_CACHE_H
@@ -11,6 +11,9 @@
 #ifndef BOB_IP_GABOR_SIMILARITY_H
 #define BOB_IP_GABOR_SIMILARITY_H
 
+#include <vector>
+#include <functional>
+
 #include <bob.io.base/HDF5File.h>
 #include <bob.sp/FFT2D.h>
 #include <bob.core/cast.h>
@@ -28,6 +31,7 @@ namespace bob {
           //! The first functions are based on absolute values of Gabor jets,
           //! while the latter also use the Gabor phases
           typedef enum {
+            CUSTOM = 0, // a user-defined similarity function, see register_function
             SCALAR_PRODUCT = 1,
             CANBERRA = 3,
             ABS_PHASE = 8,
@@ -40,18 +44,86 @@ namespace bob {
 
           static SimilarityType name_to_type(const std::string& type);
 
+          //! \brief A user-defined similarity function, which compares two Gabor jets stored as contiguous (2, length) blocks of absolute values and phases.
+          //! The function must be thread-safe, when it should be used in batch computations with several threads.
+          typedef std::function<double(const double* jet1, const double* jet2, int length)> Function;
+
+          //! \brief Registers a user-defined similarity function under the given name, so that Similarity objects of type CUSTOM can be created with this name.
+          //! The names of the built-in similarity functions cannot be overwritten.
+          //! Functions that are not thread_safe are always evaluated in the calling thread, ignoring the requested number of threads.
+          static void register_function(const std::string& name, const Function& function, bool thread_safe = true);
+
+          //! \brief Scratch memory used during the disparity estimation.
+          //! A workspace can be re-used for any number of calls, but it must not be shared between threads.
+          struct Workspace{
+            Workspace(int length = 0) : confidences(length), phase_differences(length) {}
+            void resize(int length) {confidences.resize(length); phase_differences.resize(length);}
+            std::vector<double> confidences;
+            std::vector<double> phase_differences;
+          };
+
           //! Constructor for the Gabor jet similarity
           Similarity(SimilarityType type, boost::shared_ptr<Transform> gwt = boost::shared_ptr<Transform>());
 
+          //! Constructor for the Gabor jet similarity of the given name, which might be a built-in or a registered user-defined similarity function
+          Similarity(const std::string& name, boost::shared_ptr<Transform> gwt = boost::shared_ptr<Transform>());
+
           //! \brief reads the parameters of this Gabor jet similarity from file
           Similarity(bob::io::base::HDF5File& file);
 
-          //! The similarity between two Gabor jets, including absolute values and phases
+          //! \brief The similarity between two Gabor jets, including absolute values and phases
+          //! For disparity-based types, the estimated disparity is stored and can be obtained via disparity(); hence, this function is not thread-safe
           double similarity(const Jet& jet1, const Jet& jet2) const;
 
-          //! returns the disparity vector estimated from the given jets
+          //! \brief Thread-safe version of the similarity between two Gabor jets, which returns the estimated disparity (NaN for types that do not estimate disparities)
+          //! The given workspace is used for temporary data
+          double similarity(const Jet& jet1, const Jet& jet2, blitz::TinyVector<double,2>& disparity, Workspace& workspace) const;
+
+          //! Thread-safe version of the similarity between two Gabor jets, which uses a thread-local workspace
+          double similarity(const Jet& jet1, const Jet& jet2, blitz::TinyVector<double,2>& disparity) const;
+
+          //! \brief computes the similarities between the probe jet and all jets of the gallery block, which is of shape (N, 2, length)
+          //! The scores must be of shape (N); the gallery is distributed over the given number of threads (<= 0 for all cores)
+          void similarities(const Jet& probe, const blitz::Array<double,3>& gallery, blitz::Array<double,1>& scores, int number_of_threads = 1) const;
+
+          //! \brief computes the average similarities between the probe graph and all graphs of the gallery block, which is of shape (N, nodes, 2, length)
+          //! The scores must be of shape (N); the gallery is distributed over the given number of threads (<= 0 for all cores)
+          void similarities(const std::vector<boost::shared_ptr<Jet>>& probe, const blitz::Array<double,4>& gallery, blitz::Array<double,1>& scores, int number_of_threads = 1) const;
+
+          //! \brief computes the similarities between the probe jet and the selected jets of the gallery block, i.e., scores(i) = similarity(probe, gallery(indices[i]))
+          //! The scores must be of shape (indices.size())
+          void similarities(const Jet& probe, const blitz::Array<double,3>& gallery, const std::vector<int>& indices, blitz::Array<double,1>& scores, int number_of_threads = 1) const;
+
+          //! \brief computes the average similarities between the probe graph and the selected graphs of the gallery block
+          //! The scores must be of shape (indices.size())
+          void similarities(const std::vector<boost::shared_ptr<Jet>>& probe, const blitz::Array<double,4>& gallery, const std::vector<int>& indices, blitz::Array<double,1>& scores, int number_of_threads = 1) const;
+
+          //! \brief computes the similarities between all probe jets of shape (N, 2, length) and all gallery jets of shape (M, 2, length) and writes them into scores of shape (N, M)
+          //! When probes and gallery are the same array, only half of the similarities are computed
+          void similarity_matrix(const blitz::Array<double,3>& probes, const blitz::Array<double,3>& gallery, blitz::Array<double,2>& scores, int number_of_threads = 1) const;
+
+          //! \brief computes the average similarities between all probe graphs of shape (N, nodes, 2, length) and all gallery graphs of shape (M, nodes, 2, length) and writes them into scores of shape (N, M)
+          //! When probes and gallery are the same array, only half of the similarities are computed
+          void similarity_matrix(const blitz::Array<double,4>& probes, const blitz::Array<double,4>& gallery, blitz::Array<double,2>& scores, int number_of_threads = 1) const;
+
+          //! returns the disparity vector estimated from the given jets, and stores it for later reference
           blitz::TinyVector<double,2> disparity(const Jet& jet1, const Jet& jet2) const;
 
+          //! thread-safe version of the disparity estimation using the given workspace
+          blitz::TinyVector<double,2> disparity(const Jet& jet1, const Jet& jet2, Workspace& workspace) const;
+
+          //! \brief Estimates the disparities between all pairs of Gabor jets, which are stored as contiguous (N, 2, length) blocks, and writes them into the (N, 2) disparities array
+          //! The pairs are processed in small groups that are vectorized, and the groups are distributed over the given number of threads
+          void disparities(const blitz::Array<double,3>& jets1, const blitz::Array<double,3>& jets2, blitz::Array<double,2>& disparities, int number_of_threads = 1) const;
+
+          //! \brief Estimates the disparities between two trafo images of shape (length, height, width) at the grid positions first + (y * step[0], x * step[1])
+          //! The disparities of shape (Y, X, 2) and the confidences of shape (Y, X) define the size of the grid; the confidences are the DISPARITY similarities of the normalized Gabor jets at the estimated disparities.
+          //! The grid positions are processed in vectorized groups, which are distributed over the given number of threads
+          void disparity_field(const blitz::Array<std::complex<double>,3>& image1, const blitz::Array<std::complex<double>,3>& image2, const blitz::TinyVector<int,2>& first, const blitz::TinyVector<int,2>& step, blitz::Array<double,3>& disparities, blitz::Array<double,2>& confidences, int number_of_threads = 1) const;
+
+          //! \brief Estimates the disparities between two jet images of shape (height, width, 2, length), which contain the Gabor jets of all pixels, at the grid positions first + (y * step[0], x * step[1])
+          void disparity_field(const blitz::Array<double,4>& image1, const blitz::Array<double,4>& image2, const blitz::TinyVector<int,2>& first, const blitz::TinyVector<int,2>& step, blitz::Array<double,3>& disparities, blitz::Array<double,2>& confidences, int number_of_threads = 1) const;
+
           //! returns the disparity vector estimated during the last call of similarity; only valid for disparity types
           blitz::TinyVector<double,2> disparity() const {return m_disparity;}
 
@@ -61,32 +133,80 @@ namespace bob {
           //! shifts the phases from jet towards the reference and stored the result in shifted
           void shift_phase(const Jet& jet, const Jet& reference, Jet& shifted) const;
 
+          //! thread-safe version of shift_phase using the given workspace; returns the disparity used to shift the phases
+          blitz::TinyVector<double,2> shift_phase(const Jet& jet, const Jet& reference, Jet& shifted, Workspace& workspace) const;
+
+          //! \brief Shifts the phases of all jets of shape (N, 2, length) towards the corresponding references of the same shape, and writes the shifted jets and the used disparities of shape (N, 2)
+          //! The disparities are estimated in vectorized groups, which are distributed over the given number of threads; shifted might be the same array as jets
+          void shift_phases(const blitz::Array<double,3>& jets, const blitz::Array<double,3>& references, blitz::Array<double,3>& shifted, blitz::Array<double,2>& disparities, int number_of_threads = 1) const;
+
+          //! \brief Shifts the phases of all jets of shape (N, 2, length) towards one common reference jet
+          void shift_phases(const blitz::Array<double,3>& jets, const Jet& reference, blitz::Array<double,3>& shifted, blitz::Array<double,2>& disparities, int number_of_threads = 1) const;
+
           //! \brief saves the parameters of this Gabor jet similarity to file
           void save(bob::io::base::HDF5File& file) const;
 
           //! \brief reads the parameters of this Gabor jet similarity from file
           void load(bob::io::base::HDF5File& file);
 
-          const std::string& type () const {return type_to_name(m_type);}
+          const std::string& type () const {return m_name;}
+
+          //! returns false for user-defined similarity functions that were not registered as thread-safe
+          bool thread_safe() const {return m_thread_safe;}
 
         private:
+          // the similarity kernels and the batch computations using them, see Similarity.cpp
+          struct Kernels;
+          // the signature of the kernel that is used for single comparisons
+          typedef double (*KernelFunction)(const Similarity& similarity, const double* jet1, const double* jet2, int length, Workspace& workspace, blitz::TinyVector<double,2>& disparity);
+
           // members for all similarity functions
           SimilarityType m_type;
+          std::string m_name;
+          // the kernel for the current type, which is selected once in init()
+          KernelFunction m_kernel;
+          // the user-defined function for CUSTOM types
+          Function m_function;
+          // false for user-defined functions that must be evaluated in the calling thread
+          bool m_thread_safe;
 
           // members required by disparity functions
           boost::shared_ptr<Transform> m_gwt;
 
-          // initializes the internal memory to be used for disparity-like Gabor jet similarities
+          // selects the similarity kernel and initializes the internal memory to be used for disparity-like Gabor jet similarities
           void init();
-          // computes confidences from the given Gabor jets
-          void compute_confidences(const Jet& jet1, const Jet& jet2) const;
-          // computes the disparity using the m_confidences and m_phase_differences values
-          void compute_disparity() const;
-
+          // checks that the given Gabor jet can be used with this similarity function
+          void check(const Jet& jet) const;
+          // checks that Gabor jets of the given length can be used with this similarity function
+          void check(int length) const;
+          // computes the similarity of the two Gabor jets, which are stored as (2, length) blocks; the workspace needs to have the given length and is only used by disparity types
+          double compute_similarity(const double* jet1, const double* jet2, int length, Workspace& workspace, blitz::TinyVector<double,2>& disparity) const;
+          // computes the average similarity of the given probe jets to count entries of the contiguous gallery, where each entry contains probe.size() jets; the entries are selected by the given indices, or the first count entries are used if indices is 0
+          void compute_similarities(const std::vector<const double*>& probe, int length, const double* gallery, const int* indices, int count, double* scores, int number_of_threads) const;
+          // checks the probe and gallery and returns the probe data
+          std::vector<const double*> check(const Jet& probe, const blitz::Array<double,3>& gallery) const;
+          std::vector<const double*> check(const std::vector<boost::shared_ptr<Jet>>& probe, const blitz::Array<double,4>& gallery) const;
+          // computes the average similarities between all entries of the contiguous probes and gallery, each of which contains the given number of nodes
+          void compute_similarity_matrix(const double* probes, int probe_size, const double* gallery, int gallery_size, int nodes, int length, double* scores, int number_of_threads) const;
+          // computes confidences and phase differences from the given Gabor jets
+          void compute_confidences(const double* jet1, const double* jet2, int length, double* confidences, double* phase_differences) const;
+          // computes the disparity using the given confidences and phase differences
+          void compute_disparity(const double* confidences, const double* phase_differences, blitz::TinyVector<double,2>& disparity) const;
+          // computes the disparities of a group of at most DISPARITY_GROUP jet pairs at once, and the DISPARITY similarities of the normalized jets, if similarities is given
+          void compute_disparities(const double* const* jets1, const double* const* jets2, int pairs, Workspace& workspace, double* disparities, double* similarities = 0) const;
+          // checks the similarity type and the shapes of the arrays for the batch phase shift
+          void check_shift(const blitz::Array<double,3>& jets, const blitz::Array<double,3>& shifted, const blitz::Array<double,2>& disparities) const;
+          // shifts the phases of count contiguous jets towards the references, which are reference_stride apart (0 for a common reference)
+          void compute_shift_phases(const double* jets, const double* references, int reference_stride, int count, double* shifted, double* disparities, int number_of_threads) const;
+          // checks the similarity type and that the disparity grid fits into images of the given size
+          void check_grid(int height, int width, const blitz::TinyVector<int,2>& first, const blitz::TinyVector<int,2>& step, const blitz::Array<double,3>& disparities, const blitz::Array<double,2>& confidences) const;
+
+          // the wavelet frequencies of m_gwt, stored contiguously for faster access
+          std::vector<double> m_kx, m_ky;
+
+          // the disparity and the workspace used by the functions that are not thread-safe
           mutable blitz::TinyVector<double,2> m_disparity;
-
-          mutable blitz::Array<double,1> m_confidences;
-          mutable blitz::Array<double,1> m_phase_differences;
+          mutable Workspace m_workspace;
 
       }; // class Similarity
     } // namespace gabor
@@ -22,6 +22,18 @@
 #include <bob.ip.gabor/Similarity.h>
 #include <bob.ip.gabor/Graph.h>
 #include <bob.ip.gabor/JetStatistics.h>
+#include <bob.ip.gabor/Cascade.h>
+#include <bob.ip.gabor/GalleryIndex.h>
+#include <bob.ip.gabor/QuantizedIndex.h>
+#include <bob.ip.gabor/FixedPointSimilarity.h>
+#include <bob.ip.gabor/ScoreCache.h>
+#include <bob.ip.gabor/MatchingService.h>
+#include <bob.ip.gabor/JetStatisticsBuilder.h>
+#include <bob.ip.gabor/LandmarkDetector.h>
+#include <bob.ip.gabor/GraphStatisticsTrainer.h>
+#include <bob.ip.gabor/JetList.h>
+#include <bob.ip.gabor/MappedGallery.h>
+#include <bob.ip.gabor/JetStream.h>
 
 #include <boost/shared_ptr.hpp>
 
@@ -50,6 +62,42 @@ enum _PyBobIpGabor_ENUM{
   // Bindings for bob.ip.gabor.JetStatistics
   PyBobIpGaborJetStatistics_Type_NUM,
   PyBobIpGaborJetStatistics_Check_NUM,
+  // Bindings for bob.ip.gabor.Cascade
+  PyBobIpGaborCascade_Type_NUM,
+  PyBobIpGaborCascade_Check_NUM,
+  // Bindings for bob.ip.gabor.GalleryIndex
+  PyBobIpGaborGalleryIndex_Type_NUM,
+  PyBobIpGaborGalleryIndex_Check_NUM,
+  // Bindings for bob.ip.gabor.QuantizedIndex
+  PyBobIpGaborQuantizedIndex_Type_NUM,
+  PyBobIpGaborQuantizedIndex_Check_NUM,
+  // Bindings for bob.ip.gabor.FixedPointSimilarity
+  PyBobIpGaborFixedPointSimilarity_Type_NUM,
+  PyBobIpGaborFixedPointSimilarity_Check_NUM,
+  // Bindings for bob.ip.gabor.ScoreCache
+  PyBobIpGaborScoreCache_Type_NUM,
+  PyBobIpGaborScoreCache_Check_NUM,
+  // Bindings for bob.ip.gabor.MatchingServer
+  PyBobIpGaborMatchingServer_Type_NUM,
+  PyBobIpGaborMatchingServer_Check_NUM,
+  // Bindings for bob.ip.gabor.MatchingClient
+  PyBobIpGaborMatchingClient_Type_NUM,
+  PyBobIpGaborMatchingClient_Check_NUM,
+  // Bindings for bob.ip.gabor.JetStatisticsBuilder
+  PyBobIpGaborJetStatisticsBuilder_Type_NUM,
+  PyBobIpGaborJetStatisticsBuilder_Check_NUM,
+  // Bindings for bob.ip.gabor.LandmarkDetector
+  PyBobIpGaborLandmarkDetector_Type_NUM,
+  PyBobIpGaborLandmarkDetector_Check_NUM,
+  // Bindings for bob.ip.gabor.GraphStatisticsTrainer
+  PyBobIpGaborGraphStatisticsTrainer_Type_NUM,
+  PyBobIpGaborGraphStatisticsTrainer_Check_NUM,
+  // Bindings for bob.ip.gabor.MappedGallery
+  PyBobIpGaborMappedGallery_Type_NUM,
+  PyBobIpGaborMappedGallery_Check_NUM,
+  // Bindings for bob.ip.gabor.JetStream
+  PyBobIpGaborJetStream_Type_NUM,
+  PyBobIpGaborJetStream_Check_NUM,
   // Total number of C API pointers
   PyBobIpGabor_API_pointers
 };
@@ -94,6 +142,80 @@ typedef struct {
   boost::shared_ptr<bob::ip::gabor::JetStatistics> cxx;
 } PyBobIpGaborJetStatisticsObject;
 
+// Cascaded gallery comparison
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::Cascade> cxx;
+} PyBobIpGaborCascadeObject;
+
+// Top-k gallery index
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::GalleryIndex> cxx;
+} PyBobIpGaborGalleryIndexObject;
+
+// Product quantization index
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::QuantizedIndex> cxx;
+} PyBobIpGaborQuantizedIndexObject;
+
+// Fixed-point Gabor jet similarities
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::FixedPointSimilarity> cxx;
+} PyBobIpGaborFixedPointSimilarityObject;
+
+// Cache of similarity scores
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::ScoreCache> cxx;
+} PyBobIpGaborScoreCacheObject;
+
+// Server for search queries on a gallery index
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::MatchingServer> cxx;
+} PyBobIpGaborMatchingServerObject;
+
+// Client that merges the search results of several servers
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::MatchingClient> cxx;
+} PyBobIpGaborMatchingClientObject;
+
+// Incremental computation of Gabor jet statistics
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::JetStatisticsBuilder> cxx;
+} PyBobIpGaborJetStatisticsBuilderObject;
+
+// Localization of several landmarks
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::LandmarkDetector> cxx;
+} PyBobIpGaborLandmarkDetectorObject;
+
+// Parallel training of the statistics of all graph nodes
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::GraphStatisticsTrainer> cxx;
+} PyBobIpGaborGraphStatisticsTrainerObject;
+
+// Memory-mapped binary gallery
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::MappedGallery> cxx;
+} PyBobIpGaborMappedGalleryObject;
+
+// Batch-wise reader of Gabor jet files
+typedef struct {
+  PyObject_HEAD
+  boost::shared_ptr<bob::ip::gabor::JetStream> cxx;
+  // true if any batch was requested since the stream was (re)started
+  bool started;
+} PyBobIpGaborJetStreamObject;
+
 
 #ifdef BOB_IP_GABOR_MODULE
 
@@ -115,6 +237,18 @@ typedef struct {
   extern PyTypeObject PyBobIpGaborSimilarity_Type;
   extern PyTypeObject PyBobIpGaborGraph_Type;
   extern PyTypeObject PyBobIpGaborJetStatistics_Type;
+  extern PyTypeObject PyBobIpGaborCascade_Type;
+  extern PyTypeObject PyBobIpGaborGalleryIndex_Type;
+  extern PyTypeObject PyBobIpGaborQuantizedIndex_Type;
+  extern PyTypeObject PyBobIpGaborFixedPointSimilarity_Type;
+  extern PyTypeObject PyBobIpGaborScoreCache_Type;
+  extern PyTypeObject PyBobIpGaborMatchingServer_Type;
+  extern PyTypeObject PyBobIpGaborMatchingClient_Type;
+  extern PyTypeObject PyBobIpGaborJetStatisticsBuilder_Type;
+  extern PyTypeObject PyBobIpGaborLandmarkDetector_Type;
+  extern PyTypeObject PyBobIpGaborGraphStatisticsTrainer_Type;
+  extern PyTypeObject PyBobIpGaborMappedGallery_Type;
+  extern PyTypeObject PyBobIpGaborJetStream_Type;
 
   /*******************
    * Check functions *
@@ -126,6 +260,18 @@ typedef struct {
   int PyBobIpGaborSimilarity_Check(PyObject* o);
   int PyBobIpGaborGraph_Check(PyObject* o);
   int PyBobIpGaborJetStatistics_Check(PyObject* o);
+  int PyBobIpGaborCascade_Check(PyObject* o);
+  int PyBobIpGaborGalleryIndex_Check(PyObject* o);
+  int PyBobIpGaborQuantizedIndex_Check(PyObject* o);
+  int PyBobIpGaborFixedPointSimilarity_Check(PyObject* o);
+  int PyBobIpGaborScoreCache_Check(PyObject* o);
+  int PyBobIpGaborMatchingServer_Check(PyObject* o);
+  int PyBobIpGaborMatchingClient_Check(PyObject* o);
+  int PyBobIpGaborJetStatisticsBuilder_Check(PyObject* o);
+  int PyBobIpGaborLandmarkDetector_Check(PyObject* o);
+  int PyBobIpGaborGraphStatisticsTrainer_Check(PyObject* o);
+  int PyBobIpGaborMappedGallery_Check(PyObject* o);
+  int PyBobIpGaborJetStream_Check(PyObject* o);
 
 #else
 
@@ -158,6 +304,18 @@ typedef struct {
 #define PyBobIpGaborSimilarity_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborSimilarity_Type_NUM])
 #define PyBobIpGaborTransform_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborTransform_Type_NUM])
 #define PyBobIpGaborJetStatistics_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborJetStatistics_Type_NUM])
+#define PyBobIpGaborCascade_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborCascade_Type_NUM])
+#define PyBobIpGaborGalleryIndex_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborGalleryIndex_Type_NUM])
+#define PyBobIpGaborQuantizedIndex_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborQuantizedIndex_Type_NUM])
+#define PyBobIpGaborFixedPointSimilarity_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborFixedPointSimilarity_Type_NUM])
+#define PyBobIpGaborScoreCache_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborScoreCache_Type_NUM])
+#define PyBobIpGaborMatchingServer_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborMatchingServer_Type_NUM])
+#define PyBobIpGaborMatchingClient_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborMatchingClient_Type_NUM])
+#define PyBobIpGaborJetStatisticsBuilder_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborJetStatisticsBuilder_Type_NUM])
+#define PyBobIpGaborLandmarkDetector_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborLandmarkDetector_Type_NUM])
+#define PyBobIpGaborGraphStatisticsTrainer_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborGraphStatisticsTrainer_Type_NUM])
+#define PyBobIpGaborMappedGallery_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborMappedGallery_Type_NUM])
+#define PyBobIpGaborJetStream_Type (*(PyTypeObject *)PyBobIpGabor_API[PyBobIpGaborJetStream_Type_NUM])
 
 
   /*******************
@@ -169,6 +327,18 @@ typedef struct {
 #define PyBobIpGaPyBobIpGaborSimilarity_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborSimilarity_Check_NUM])
 #define PyBobIpGaborGraph_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborGraph_Check_NUM])
 #define PyBobIpGaborJetStatistics_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborJetStatistics_Check_NUM])
+#define PyBobIpGaborCascade_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborCascade_Check_NUM])
+#define PyBobIpGaborGalleryIndex_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborGalleryIndex_Check_NUM])
+#define PyBobIpGaborQuantizedIndex_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborQuantizedIndex_Check_NUM])
+#define PyBobIpGaborFixedPointSimilarity_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborFixedPointSimilarity_Check_NUM])
+#define PyBobIpGaborScoreCache_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborScoreCache_Check_NUM])
+#define PyBobIpGaborMatchingServer_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborMatchingServer_Check_NUM])
+#define PyBobIpGaborMatchingClient_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborMatchingClient_Check_NUM])
+#define PyBobIpGaborJetStatisticsBuilder_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborJetStatisticsBuilder_Check_NUM])
+#define PyBobIpGaborLandmarkDetector_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborLandmarkDetector_Check_NUM])
+#define PyBobIpGaborGraphStatisticsTrainer_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborGraphStatisticsTrainer_Check_NUM])
+#define PyBobIpGaborMappedGallery_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborMappedGallery_Check_NUM])
+#define PyBobIpGaborJetStream_Check (*(int (*)(PyObject*)) PyBobIpGabor_API[PyBobIpGaborJetStream_Check_NUM])
 
 
 # if !defined(NO_IMPORT_ARRAY)
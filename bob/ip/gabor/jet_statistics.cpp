@@ -328,6 +328,115 @@ BOB_CATCH_MEMBER("log_likelihood", 0)
 }
 
 
+static auto logLikelihoods_doc = bob::extension::FunctionDoc(
+  "log_likelihoods",
+  "Computes the log-likelihoods for a batch of Gabor jets",
+  "This function computes the same scores as :py:meth:`log_likelihood` for all given jets, e.g., the jets extracted at many candidate positions of a landmark. "
+  "The inverse variances and the wavelet frequencies are prepared once for all jets, and the jets are distributed over the given number of threads. "
+  "To compute the log-likelihoods of the jets for several statistics at once, see :py:func:`bob.ip.gabor.log_likelihoods`.",
+  true
+)
+.add_prototype("jets, [estimate_phase], [offset], [scores], [number_of_threads]", "scores")
+.add_parameter("jets", "array_like (3D, float)", "The data of the Gabor jets of shape ``(N, 2, length)``, e.g., created with ``numpy.array([jet.jet for jet in jets])``")
+.add_parameter("estimate_phase", "bool", "[Default: ``True``] Should the phase be included into the estimation?")
+.add_parameter("offset", "(float, float)", "[Default: ``(0,0)``] Sub-pixel location offset, where the Gabor jets should have been extracted")
+.add_parameter("scores", "array_like (1D, float)", "[Default: ``None``] If given, the scores will be written into this array, which must be of shape ``(N,)``")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads to use; ``0`` selects one thread per available core")
+.add_return("scores", "array_like (1D, float)", "The log-likelihood scores of all jets")
+;
+
+static PyObject* PyBobIpGaborJetStatistics_logLikelihoods(PyBobIpGaborJetStatisticsObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = logLikelihoods_doc.kwlist();
+
+  PyBlitzArrayObject* jets,* scores = 0;
+  PyObject* phase = 0;
+  blitz::TinyVector<double,2> offset(0.,0.);
+  int threads = 1;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|O(dd)O&i", kwlist, &PyBlitzArray_Converter, &jets, &phase, &offset[0], &offset[1], &PyBlitzArray_OutputConverter, &scores, &threads)) return 0;
+
+  auto jets_ = make_safe(jets);
+  auto scores_ = make_xsafe(scores);
+
+  if (jets->type_num != NPY_FLOAT64 || jets->ndim != 3) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `jets' to be a 3D array of type float", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  if (scores){
+    if (scores->type_num != NPY_FLOAT64 || scores->ndim != 1) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `scores' to be a 1D array of type float", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[] = {jets->shape[0]};
+    scores = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, osize);
+    scores_ = make_safe(scores);
+  }
+
+  self->cxx->logLikelihoods(*PyBlitzArrayCxx_AsBlitz<double,3>(jets), *PyBlitzArrayCxx_AsBlitz<double,1>(scores), !phase || PyObject_IsTrue(phase), offset, threads);
+  return PyBlitzArray_AsNumpyArray(scores, 0);
+BOB_CATCH_MEMBER("log_likelihoods", 0)
+}
+
+
+static auto logLikelihoodMap_doc = bob::extension::FunctionDoc(
+  "log_likelihood_map",
+  "Computes the log-likelihoods of the Gabor jets at all positions of a region in a Gabor wavelet transformed image",
+  "This function computes the same scores as extracting a :py:class:`Jet` at each position of the region and calling :py:meth:`log_likelihood` with it, e.g., to find the most likely position of a landmark in a search window. "
+  "The Gabor jets are extracted row by row, reading the layers of the ``trafo_image`` sequentially, and the rows are distributed over the given number of threads.",
+  true
+)
+.add_prototype("trafo_image, first, last, [estimate_phase], [normalize], [scores], [number_of_threads]", "scores")
+.add_parameter("trafo_image", "array_like (complex, 3D)", "The Gabor wavelet transformed image, e.g., the result of :py:func:`bob.ip.gabor.Transform.transform`")
+.add_parameter("first", "(int, int)", "The top-left position of the search region")
+.add_parameter("last", "(int, int)", "The bottom-right position of the search region, which is included in the region")
+.add_parameter("estimate_phase", "bool", "[Default: ``True``] Should the disparity corrected phases be included into the estimation?")
+.add_parameter("normalize", "bool", "[Default: ``True``] Should the extracted Gabor jets be normalized to unit Euclidean length, see :py:meth:`Jet.normalize`?")
+.add_parameter("scores", "array_like (2D, float)", "[Default: ``None``] If given, the scores will be written into this array, which must be of shape ``(last[0] - first[0] + 1, last[1] - first[1] + 1)``")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads to use; ``0`` selects one thread per available core")
+.add_return("scores", "array_like (2D, float)", "The log-likelihood scores for all positions in the region")
+;
+
+static PyObject* PyBobIpGaborJetStatistics_logLikelihoodMap(PyBobIpGaborJetStatisticsObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = logLikelihoodMap_doc.kwlist();
+
+  PyBlitzArrayObject* trafo_image,* scores = 0;
+  blitz::TinyVector<int,2> first, last;
+  PyObject* phase = 0,* normalize = 0;
+  int threads = 1;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&(ii)(ii)|OOO&i", kwlist, &PyBlitzArray_Converter, &trafo_image, &first[0], &first[1], &last[0], &last[1], &phase, &normalize, &PyBlitzArray_OutputConverter, &scores, &threads)) return 0;
+
+  auto trafo_image_ = make_safe(trafo_image);
+  auto scores_ = make_xsafe(scores);
+
+  if (trafo_image->ndim != 3 || trafo_image->type_num != NPY_COMPLEX128) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `trafo_image' to be a 3D array of type complex", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  if (scores){
+    if (scores->type_num != NPY_FLOAT64 || scores->ndim != 2) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `scores' to be a 2D array of type float", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  } else {
+    if (last[0] < first[0] || last[1] < first[1]){
+      PyErr_Format(PyExc_ValueError, "`%s' requires the `last' position to be below and right of the `first' position", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    Py_ssize_t osize[] = {last[0] - first[0] + 1, last[1] - first[1] + 1};
+    scores = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, osize);
+    scores_ = make_safe(scores);
+  }
+
+  self->cxx->logLikelihoodMap(*PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(trafo_image), first, last, *PyBlitzArrayCxx_AsBlitz<double,2>(scores), !phase || PyObject_IsTrue(phase), !normalize || PyObject_IsTrue(normalize), threads);
+  return PyBlitzArray_AsNumpyArray(scores, 0);
+BOB_CATCH_MEMBER("log_likelihood_map", 0)
+}
+
+
 static auto save_doc = bob::extension::FunctionDoc(
   "save",
   "Saves the JetStatistics to the given HDF5 file",
@@ -368,6 +477,18 @@ static PyMethodDef PyBobIpGaborJetStatistics_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     logLikelihood_doc.doc()
   },
+  {
+    logLikelihoods_doc.name(),
+    (PyCFunction)PyBobIpGaborJetStatistics_logLikelihoods,
+    METH_VARARGS|METH_KEYWORDS,
+    logLikelihoods_doc.doc()
+  },
+  {
+    logLikelihoodMap_doc.name(),
+    (PyCFunction)PyBobIpGaborJetStatistics_logLikelihoodMap,
+    METH_VARARGS|METH_KEYWORDS,
+    logLikelihoodMap_doc.doc()
+  },
   {
     save_doc.name(),
     (PyCFunction)PyBobIpGaborJetStatistics_save,
@@ -0,0 +1,351 @@
+/**
+ * @date Sat Oct 17 23:46:00 UTC 2026
+ *
+ * @brief Bindings for the incremental computation of Gabor jet statistics
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.io.base/api.h>
+#include <bob.extension/documentation.h>
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto JetStatisticsBuilder_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".JetStatisticsBuilder",
+  "Computes :py:class:`JetStatistics` in a single pass over the training jets",
+  "The :py:class:`JetStatistics` constructor requires all training jets to be in memory at the same time. "
+  "Instead, the ``JetStatisticsBuilder`` accumulates the statistics while the jets are :py:meth:`add`\\ed one at a time or in batches, so that arbitrarily large training sets can be streamed with a memory that does not depend on their size. "
+  "Builders of disjoint parts of the training set, e.g., computed in different processes or on different machines, can be :py:meth:`merge`\\d, and the partial results can be stored with :py:meth:`save`.\n\n"
+  "The mean and the variance of the absolute values are updated with Welford's algorithm. "
+  "The mean phase is the phase of the sum of the complex jet values, which is identical to the phase of the average :py:class:`Jet`. "
+  "The phase variance of the :py:class:`JetStatistics` constructor wraps the difference of each phase to the mean phase, which is only known after the last jet. "
+  "Therefore, the builder accumulates the phase differences to the first added jet together with their range, and shifts them to the mean phase in :py:meth:`finalize`. "
+  "When all phases of a coefficient are less than :math:`\\pi` away from its mean phase, which is the case for any sensible training set, the phase variance is identical to the one of the :py:class:`JetStatistics` constructor. "
+  "Otherwise, it is computed from the first 16 trigonometric moments of the phases, and it differs from the constructor by less than :math:`\\frac{1}{4}\\frac{N}{N-1}` for :math:`N` jets, and by about 1% for phases that are spread over the whole circle; "
+  "in this case, the result can also depend slightly on the order in which the jets are added and merged."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates an empty builder, or reads a partial builder from file",
+    0,
+    true
+  )
+  .add_prototype("", "")
+  .add_prototype("hdf5", "")
+  .add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading, which was written by :py:meth:`save`")
+);
+
+static int PyBobIpGaborJetStatisticsBuilder_init(PyBobIpGaborJetStatisticsBuilderObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = JetStatisticsBuilder_doc.kwlist(1);
+
+  PyBobIoHDF5FileObject* hdf5 = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O&", kwlist, &PyBobIoHDF5File_Converter, &hdf5)) return -1;
+
+  if (hdf5){
+    auto hdf5_ = make_safe(hdf5);
+    self->cxx.reset(new bob::ip::gabor::JetStatisticsBuilder(*hdf5->f));
+  } else {
+    self->cxx.reset(new bob::ip::gabor::JetStatisticsBuilder());
+  }
+  return 0;
+BOB_CATCH_MEMBER("JetStatisticsBuilder constructor", -1)
+}
+
+static void PyBobIpGaborJetStatisticsBuilder_delete(PyBobIpGaborJetStatisticsBuilderObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborJetStatisticsBuilder_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborJetStatisticsBuilder_Type));
+}
+
+static Py_ssize_t PyBobIpGaborJetStatisticsBuilder_len(PyBobIpGaborJetStatisticsBuilderObject* self) {
+  return self->cxx->count();
+}
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto count_doc = bob::extension::VariableDoc(
+  "count",
+  "int",
+  "The number of jets that were added, read only",
+  "This is identical to the ``len`` of the builder."
+);
+PyObject* PyBobIpGaborJetStatisticsBuilder_count(PyBobIpGaborJetStatisticsBuilderObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("l", self->cxx->count());
+BOB_CATCH_MEMBER("count", 0)
+}
+
+static auto length_doc = bob::extension::VariableDoc(
+  "length",
+  "int",
+  "The length of the jets, which is defined by the first added jet; ``0`` if no jet has been added, read only"
+);
+PyObject* PyBobIpGaborJetStatisticsBuilder_length(PyBobIpGaborJetStatisticsBuilderObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->length());
+BOB_CATCH_MEMBER("length", 0)
+}
+
+static PyGetSetDef PyBobIpGaborJetStatisticsBuilder_getseters[] = {
+  {
+    count_doc.name(),
+    (getter)PyBobIpGaborJetStatisticsBuilder_count,
+    0,
+    count_doc.doc(),
+    0
+  },
+  {
+    length_doc.name(),
+    (getter)PyBobIpGaborJetStatisticsBuilder_length,
+    0,
+    length_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto add_doc = bob::extension::FunctionDoc(
+  "add",
+  "Adds the given Gabor jets to the statistics",
+  "The jets can be given as a single :py:class:`Jet`, as a list of :py:class:`Jet`\\s, or as a C-contiguous array of shape ``(N, 2, length)``, e.g., a list of jets that was read with :py:func:`load_jet_block`. "
+  "All jets must have the same length.",
+  true
+)
+.add_prototype("jets")
+.add_parameter("jets", ":py:class:`bob.ip.gabor.Jet` or [:py:class:`bob.ip.gabor.Jet`] or array_like (3D, float)", "The Gabor jets to add")
+;
+
+static PyObject* PyBobIpGaborJetStatisticsBuilder_add(PyBobIpGaborJetStatisticsBuilderObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = add_doc.kwlist();
+
+  PyObject* jets;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &jets)) return 0;
+
+  if (PyBobIpGaborJet_Check(jets)){
+    self->cxx->add(*reinterpret_cast<PyBobIpGaborJetObject*>(jets)->cxx);
+    Py_RETURN_NONE;
+  }
+
+  if (PyBlitzArray_Check(jets) || PyArray_Check(jets)){
+    PyBlitzArrayObject* data;
+    if (!PyBlitzArray_Converter(jets, &data)) return 0;
+    auto data_ = make_safe(data);
+    if (data->type_num != NPY_FLOAT64 || data->ndim != 3) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `jets' to be a 3D array of type float", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    self->cxx->add(*PyBlitzArrayCxx_AsBlitz<double,3>(data));
+    Py_RETURN_NONE;
+  }
+
+  PyObject* iterator = PyObject_GetIter(jets);
+  if (!iterator) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `jets' to be a bob.ip.gabor.Jet, a list of bob.ip.gabor.Jet or a 3D array", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  auto iterator_ = make_safe(iterator);
+  int i = 0;
+  while (PyObject* it = PyIter_Next(iterator)) {
+    auto it_ = make_safe(it);
+    if (!PyBobIpGaborJet_Check(it)){
+      PyErr_Format(PyExc_TypeError, "`%s' requires all elements of the `jets' to be of type bob.ip.gabor.Jet, but element %d isn't", Py_TYPE(self)->tp_name, i);
+      return 0;
+    }
+    self->cxx->add(*reinterpret_cast<PyBobIpGaborJetObject*>(it)->cxx);
+    ++i;
+  }
+  if (PyErr_Occurred()) return 0;
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("add", 0)
+}
+
+static auto merge_doc = bob::extension::FunctionDoc(
+  "merge",
+  "Adds all jets that were added to the other builder",
+  "The result is the same as if all jets of the ``other`` builder were added to this builder.",
+  true
+)
+.add_prototype("other")
+.add_parameter("other", ":py:class:`bob.ip.gabor.JetStatisticsBuilder`", "The builder of another part of the training set")
+;
+
+static PyObject* PyBobIpGaborJetStatisticsBuilder_merge(PyBobIpGaborJetStatisticsBuilderObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = merge_doc.kwlist();
+
+  PyBobIpGaborJetStatisticsBuilderObject* other;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist, &PyBobIpGaborJetStatisticsBuilder_Type, &other)) return 0;
+
+  self->cxx->merge(*other->cxx);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("merge", 0)
+}
+
+static auto finalize_doc = bob::extension::FunctionDoc(
+  "finalize",
+  "Computes the statistics of all added jets",
+  "At least two jets must have been added. "
+  "The builder is not modified, so that more jets can be added afterward.",
+  true
+)
+.add_prototype("[gwt]", "statistics")
+.add_parameter("gwt", ":py:class:`bob.ip.gabor.Transform` or ``None``", "[Default: ``None``] The Gabor wavelet family with which the Gabor jets were extracted")
+.add_return("statistics", ":py:class:`bob.ip.gabor.JetStatistics`", "The statistics of all added jets")
+;
+
+static PyObject* PyBobIpGaborJetStatisticsBuilder_finalize(PyBobIpGaborJetStatisticsBuilderObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = finalize_doc.kwlist();
+
+  PyObject* gwt = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", kwlist, &gwt)) return 0;
+
+  boost::shared_ptr<bob::ip::gabor::Transform> transform;
+  if (gwt && gwt != Py_None){
+    if (!PyBobIpGaborTransform_Check(gwt)){
+      PyErr_Format(PyExc_TypeError, "The given 'gwt' object is not of type bob.ip.gabor.Transform");
+      return 0;
+    }
+    transform = reinterpret_cast<PyBobIpGaborTransformObject*>(gwt)->cxx;
+  }
+
+  PyBobIpGaborJetStatisticsObject* statistics = (PyBobIpGaborJetStatisticsObject*)PyBobIpGaborJetStatistics_Type.tp_alloc(&PyBobIpGaborJetStatistics_Type, 0);
+  auto statistics_ = make_safe(statistics);
+  statistics->cxx = self->cxx->finalize(transform);
+  return Py_BuildValue("O", statistics);
+BOB_CATCH_MEMBER("finalize", 0)
+}
+
+static auto clear_doc = bob::extension::FunctionDoc(
+  "clear",
+  "Removes all jets from the statistics",
+  "Afterward, the jet length is defined by the next added jet.",
+  true
+)
+.add_prototype("")
+;
+
+static PyObject* PyBobIpGaborJetStatisticsBuilder_clear(PyBobIpGaborJetStatisticsBuilderObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = clear_doc.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+
+  self->cxx->clear();
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("clear", 0)
+}
+
+static auto save_doc = bob::extension::FunctionDoc(
+  "save",
+  "Saves the current state of the builder to the given HDF5 file",
+  "The builder can be read with the constructor, e.g., to :py:meth:`merge` it with the builders of other parts of the training set.",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing")
+;
+
+static PyObject* PyBobIpGaborJetStatisticsBuilder_save(PyBobIpGaborJetStatisticsBuilderObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = save_doc.kwlist();
+  PyBobIoHDF5FileObject* file;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &file)) return 0;
+
+  auto file_ = make_safe(file);
+  self->cxx->save(*file->f);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("save", 0)
+}
+
+static PyMethodDef PyBobIpGaborJetStatisticsBuilder_methods[] = {
+  {
+    add_doc.name(),
+    (PyCFunction)PyBobIpGaborJetStatisticsBuilder_add,
+    METH_VARARGS|METH_KEYWORDS,
+    add_doc.doc()
+  },
+  {
+    merge_doc.name(),
+    (PyCFunction)PyBobIpGaborJetStatisticsBuilder_merge,
+    METH_VARARGS|METH_KEYWORDS,
+    merge_doc.doc()
+  },
+  {
+    finalize_doc.name(),
+    (PyCFunction)PyBobIpGaborJetStatisticsBuilder_finalize,
+    METH_VARARGS|METH_KEYWORDS,
+    finalize_doc.doc()
+  },
+  {
+    clear_doc.name(),
+    (PyCFunction)PyBobIpGaborJetStatisticsBuilder_clear,
+    METH_VARARGS|METH_KEYWORDS,
+    clear_doc.doc()
+  },
+  {
+    save_doc.name(),
+    (PyCFunction)PyBobIpGaborJetStatisticsBuilder_save,
+    METH_VARARGS|METH_KEYWORDS,
+    save_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the JetStatisticsBuilder type struct; will be initialized later
+PyTypeObject PyBobIpGaborJetStatisticsBuilder_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+static PySequenceMethods PyBobIpGaborJetStatisticsBuilder_sequence = {
+  (lenfunc)PyBobIpGaborJetStatisticsBuilder_len
+};
+
+bool init_BobIpGaborJetStatisticsBuilder(PyObject* module)
+{
+
+  // initialize the JetStatisticsBuilder type struct
+  PyBobIpGaborJetStatisticsBuilder_Type.tp_name = JetStatisticsBuilder_doc.name();
+  PyBobIpGaborJetStatisticsBuilder_Type.tp_basicsize = sizeof(PyBobIpGaborJetStatisticsBuilderObject);
+  PyBobIpGaborJetStatisticsBuilder_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborJetStatisticsBuilder_Type.tp_doc = JetStatisticsBuilder_doc.doc();
+
+  // set the functions
+  PyBobIpGaborJetStatisticsBuilder_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborJetStatisticsBuilder_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborJetStatisticsBuilder_init);
+  PyBobIpGaborJetStatisticsBuilder_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborJetStatisticsBuilder_delete);
+  PyBobIpGaborJetStatisticsBuilder_Type.tp_methods = PyBobIpGaborJetStatisticsBuilder_methods;
+  PyBobIpGaborJetStatisticsBuilder_Type.tp_getset = PyBobIpGaborJetStatisticsBuilder_getseters;
+  PyBobIpGaborJetStatisticsBuilder_Type.tp_as_sequence = &PyBobIpGaborJetStatisticsBuilder_sequence;
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborJetStatisticsBuilder_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborJetStatisticsBuilder_Type);
+  return PyModule_AddObject(module, "JetStatisticsBuilder", (PyObject*)&PyBobIpGaborJetStatisticsBuilder_Type) >= 0;
+}
@@ -0,0 +1,398 @@
+/**
+ * @date Sun Oct 18 00:28:40 UTC 2026
+ *
+ * @brief Bindings for the batch-wise reading of lists of Gabor jets
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.extension/documentation.h>
+
+#include "gil.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto JetStream_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".JetStream",
+  "Reads the Gabor jets of a file in batches, which are read ahead in a background thread",
+  "Galleries that do not fit into memory cannot be read with :py:func:`load_jet_block`. "
+  "Instead, this class iterates over the jets in batches of ``batch_size`` contiguous jets, each of which is a 3D array of shape ``(n, 2, length)``, where ``n`` is ``batch_size`` for all but the last batch. "
+  "While a batch is processed, the next ``read_ahead`` batches are read by a background thread, so that at most ``(read_ahead + 1) * batch_size`` jets are held in memory at any time.\n\n"
+  "Both the single data set written by :py:func:`save_jet_block` and the directories written by :py:func:`save_jets` can be read. "
+  "Each batch of the single data set is read from the file at once. "
+  "Since other threads might access HDF5 files at the same time, the background thread is only used when the HDF5 library is thread-safe, see :py:attr:`background`; otherwise, each batch is read when it is requested. "
+  "The file must not be modified while it is read. "
+  "The global interpreter lock is released while waiting for a batch.\n\n"
+  "The class is iterable, and a new iteration starts at the first jet, e.g.:\n\n"
+  ".. code-block:: python\n\n"
+  "   for batch in bob.ip.gabor.JetStream(filename):\n"
+  "     scores = similarity.similarities(probe, batch)\n\n"
+  "The scores for several probes are computed with :py:meth:`similarities`."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Opens the given file of Gabor jets and starts reading",
+    0,
+    true
+  )
+  .add_prototype("filename, [batch_size], [read_ahead]", "")
+  .add_parameter("filename", "str", "The name of the HDF5 file that contains the Gabor jets")
+  .add_parameter("batch_size", "int", "[Default: ``1024``] The number of jets per batch")
+  .add_parameter("read_ahead", "int", "[Default: ``2``] The maximum number of batches that are read ahead")
+);
+
+static int PyBobIpGaborJetStream_init(PyBobIpGaborJetStreamObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = JetStream_doc.kwlist(0);
+
+  const char* filename;
+  int batch_size = 1024, read_ahead = 2;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|ii", kwlist, &filename, &batch_size, &read_ahead)) return -1;
+
+  self->cxx.reset(new bob::ip::gabor::JetStream(filename, batch_size, read_ahead));
+  self->started = false;
+  return 0;
+BOB_CATCH_MEMBER("JetStream constructor", -1)
+}
+
+static void PyBobIpGaborJetStream_delete(PyBobIpGaborJetStreamObject* self) {
+  // stopping the background thread might wait for the current read
+  Py_BEGIN_ALLOW_THREADS
+  self->cxx.reset();
+  Py_END_ALLOW_THREADS
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborJetStream_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborJetStream_Type));
+}
+
+static Py_ssize_t PyBobIpGaborJetStream_len(PyBobIpGaborJetStreamObject* self) {
+  return self->cxx->size();
+}
+
+static PyObject* PyBobIpGaborJetStream_iter(PyBobIpGaborJetStreamObject* self) {
+BOB_TRY
+  // each iteration starts at the first jet; the first one uses the batches that are read since construction
+  if (self->started && !without_gil([self](){self->cxx->reset();})) return 0;
+  self->started = true;
+  Py_INCREF(self);
+  return reinterpret_cast<PyObject*>(self);
+BOB_CATCH_MEMBER("__iter__", 0)
+}
+
+static PyObject* PyBobIpGaborJetStream_iternext(PyBobIpGaborJetStreamObject* self) {
+BOB_TRY
+  self->started = true;
+  blitz::Array<double,3> batch;
+  bool found;
+  if (!without_gil([self, &batch, &found](){found = self->cxx->next(batch);})) return 0;
+  // returning 0 without an error stops the iteration
+  if (!found) return 0;
+  return PyBlitzArrayCxx_AsNumpy(batch);
+BOB_CATCH_MEMBER("next", 0)
+}
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto filename_doc = bob::extension::VariableDoc(
+  "filename",
+  "str",
+  "The name of the file that is read, read only"
+);
+PyObject* PyBobIpGaborJetStream_filename(PyBobIpGaborJetStreamObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("s", self->cxx->filename().c_str());
+BOB_CATCH_MEMBER("filename", 0)
+}
+
+static auto size_doc = bob::extension::VariableDoc(
+  "size",
+  "int",
+  "The number of Gabor jets in the file, read only",
+  "This is identical to the ``len`` of the stream."
+);
+PyObject* PyBobIpGaborJetStream_size(PyBobIpGaborJetStreamObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->size());
+BOB_CATCH_MEMBER("size", 0)
+}
+
+static auto length_doc = bob::extension::VariableDoc(
+  "length",
+  "int",
+  "The length of the Gabor jets in the file, read only"
+);
+PyObject* PyBobIpGaborJetStream_length(PyBobIpGaborJetStreamObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->length());
+BOB_CATCH_MEMBER("length", 0)
+}
+
+static auto batchSize_doc = bob::extension::VariableDoc(
+  "batch_size",
+  "int",
+  "The number of Gabor jets per batch, read only"
+);
+PyObject* PyBobIpGaborJetStream_batchSize(PyBobIpGaborJetStreamObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->batchSize());
+BOB_CATCH_MEMBER("batch_size", 0)
+}
+
+static auto readAhead_doc = bob::extension::VariableDoc(
+  "read_ahead",
+  "int",
+  "The maximum number of batches that are read ahead, read only"
+);
+PyObject* PyBobIpGaborJetStream_readAhead(PyBobIpGaborJetStreamObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->readAhead());
+BOB_CATCH_MEMBER("read_ahead", 0)
+}
+
+static auto position_doc = bob::extension::VariableDoc(
+  "position",
+  "int",
+  "The index of the first Gabor jet of the next batch, read only",
+  "Hence, the last returned batch contains the jets with indices ``position - len(batch), ..., position - 1``."
+);
+PyObject* PyBobIpGaborJetStream_position(PyBobIpGaborJetStreamObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->position());
+BOB_CATCH_MEMBER("position", 0)
+}
+
+static auto background_doc = bob::extension::VariableDoc(
+  "background",
+  "bool",
+  "Are the batches read ahead by a background thread?, read only",
+  "This is the case only if the HDF5 library is thread-safe; otherwise, each batch is read when it is requested, and ``read_ahead`` has no effect."
+);
+PyObject* PyBobIpGaborJetStream_background(PyBobIpGaborJetStreamObject* self, void*){
+BOB_TRY
+  if (self->cxx->background()) Py_RETURN_TRUE;
+  Py_RETURN_FALSE;
+BOB_CATCH_MEMBER("background", 0)
+}
+
+static PyGetSetDef PyBobIpGaborJetStream_getseters[] = {
+  {
+    filename_doc.name(),
+    (getter)PyBobIpGaborJetStream_filename,
+    0,
+    filename_doc.doc(),
+    0
+  },
+  {
+    size_doc.name(),
+    (getter)PyBobIpGaborJetStream_size,
+    0,
+    size_doc.doc(),
+    0
+  },
+  {
+    length_doc.name(),
+    (getter)PyBobIpGaborJetStream_length,
+    0,
+    length_doc.doc(),
+    0
+  },
+  {
+    batchSize_doc.name(),
+    (getter)PyBobIpGaborJetStream_batchSize,
+    0,
+    batchSize_doc.doc(),
+    0
+  },
+  {
+    readAhead_doc.name(),
+    (getter)PyBobIpGaborJetStream_readAhead,
+    0,
+    readAhead_doc.doc(),
+    0
+  },
+  {
+    position_doc.name(),
+    (getter)PyBobIpGaborJetStream_position,
+    0,
+    position_doc.doc(),
+    0
+  },
+  {
+    background_doc.name(),
+    (getter)PyBobIpGaborJetStream_background,
+    0,
+    background_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto reset_doc = bob::extension::FunctionDoc(
+  "reset",
+  "Starts reading again at the first Gabor jet",
+  0,
+  true
+)
+.add_prototype("")
+;
+
+static PyObject* PyBobIpGaborJetStream_reset(PyBobIpGaborJetStreamObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = reset_doc.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+
+  if (!without_gil([self](){self->cxx->reset();})) return 0;
+  self->started = false;
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("reset", 0)
+}
+
+static auto similarities_doc = bob::extension::FunctionDoc(
+  "similarities",
+  "Computes the similarities between the given probe(s) and all Gabor jets in the file",
+  "All batches are read from the first jet, and the similarities of each batch are computed with :py:meth:`Similarity.similarities`, while the next batches are read in the background, if :py:attr:`background` is ``True``. "
+  "Several probes should be scored at once, since the file is read only once for all of them. "
+  "Afterwards, iterations over the stream start at the first jet again.",
+  true
+)
+.add_prototype("similarity, probes, [scores], [number_of_threads]", "scores")
+.add_parameter("similarity", ":py:class:`bob.ip.gabor.Similarity`", "The similarity function to use")
+.add_parameter("probes", ":py:class:`bob.ip.gabor.Jet` or [:py:class:`bob.ip.gabor.Jet`]", "The probe jet, or a list of probe jets, which must have the :py:attr:`length` of the jets in the file")
+.add_parameter("scores", "array_like (1D or 2D, float)", "[Default: ``None``] If given, the scores will be written into this array, which must be of shape ``(size,)`` for a single probe, or ``(len(probes), size)`` for a list of probes")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads, over which each batch is distributed; ``0`` selects one thread per available core")
+.add_return("scores", "array_like (1D or 2D, float)", "The similarities between the probe(s) and all jets in the file")
+;
+
+static PyObject* PyBobIpGaborJetStream_similarities(PyBobIpGaborJetStreamObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = similarities_doc.kwlist();
+
+  PyBobIpGaborSimilarityObject* similarity;
+  PyObject* probes;
+  PyBlitzArrayObject* scores = 0;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O|O&i", kwlist, &PyBobIpGaborSimilarity_Type, &similarity, &probes, &PyBlitzArray_OutputConverter, &scores, &threads)) return 0;
+  auto scores_ = make_xsafe(scores);
+
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> jets;
+  const bool single = PyBobIpGaborJet_Check(probes);
+  if (single){
+    jets.push_back(reinterpret_cast<PyBobIpGaborJetObject*>(probes)->cxx);
+  } else {
+    PyObject* iterator = PyObject_GetIter(probes);
+    if (!iterator) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `probes' to be a bob.ip.gabor.Jet or a list of bob.ip.gabor.Jet", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    auto iterator_ = make_safe(iterator);
+    while (PyObject* it = PyIter_Next(iterator)) {
+      auto it_ = make_safe(it);
+      if (!PyBobIpGaborJet_Check(it)){
+        PyErr_Format(PyExc_TypeError, "`%s' requires all elements of the `probes' to be of type bob.ip.gabor.Jet, but element %d isn't", Py_TYPE(self)->tp_name, (int)jets.size());
+        return 0;
+      }
+      jets.push_back(reinterpret_cast<PyBobIpGaborJetObject*>(it)->cxx);
+    }
+    if (PyErr_Occurred()) return 0;
+  }
+
+  const int ndim = single ? 1 : 2;
+  if (scores){
+    if (scores->type_num != NPY_FLOAT64 || scores->ndim != ndim) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `scores' to be a %dD array of type float", Py_TYPE(self)->tp_name, ndim);
+      return 0;
+    }
+    if (single && scores->shape[0] != self->cxx->size()) {
+      PyErr_Format(PyExc_RuntimeError, "`%s' requires the `scores' to have %d elements, but it has %d", Py_TYPE(self)->tp_name, self->cxx->size(), (int)scores->shape[0]);
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[] = {(Py_ssize_t)jets.size(), self->cxx->size()};
+    scores = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, ndim, single ? osize + 1 : osize);
+    scores_ = make_safe(scores);
+  }
+
+  // a single probe is scored as a list with one probe
+  blitz::Array<double,2> matrix;
+  if (single) matrix.resize(1, self->cxx->size());
+  else matrix.reference(*PyBlitzArrayCxx_AsBlitz<double,2>(scores));
+
+  if (!without_gil([&](){self->cxx->similarities(*similarity->cxx, jets, matrix, threads);})) return 0;
+  self->started = true;
+  if (single) *PyBlitzArrayCxx_AsBlitz<double,1>(scores) = matrix(0, blitz::Range::all());
+  return PyBlitzArray_AsNumpyArray(scores, 0);
+BOB_CATCH_MEMBER("similarities", 0)
+}
+
+static PyMethodDef PyBobIpGaborJetStream_methods[] = {
+  {
+    reset_doc.name(),
+    (PyCFunction)PyBobIpGaborJetStream_reset,
+    METH_VARARGS|METH_KEYWORDS,
+    reset_doc.doc()
+  },
+  {
+    similarities_doc.name(),
+    (PyCFunction)PyBobIpGaborJetStream_similarities,
+    METH_VARARGS|METH_KEYWORDS,
+    similarities_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the JetStream type struct; will be initialized later
+PyTypeObject PyBobIpGaborJetStream_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+static PySequenceMethods PyBobIpGaborJetStream_sequence = {
+  (lenfunc)PyBobIpGaborJetStream_len
+};
+
+bool init_BobIpGaborJetStream(PyObject* module)
+{
+
+  // initialize the JetStream type struct
+  PyBobIpGaborJetStream_Type.tp_name = JetStream_doc.name();
+  PyBobIpGaborJetStream_Type.tp_basicsize = sizeof(PyBobIpGaborJetStreamObject);
+  PyBobIpGaborJetStream_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborJetStream_Type.tp_doc = JetStream_doc.doc();
+
+  // set the functions
+  PyBobIpGaborJetStream_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborJetStream_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborJetStream_init);
+  PyBobIpGaborJetStream_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborJetStream_delete);
+  PyBobIpGaborJetStream_Type.tp_methods = PyBobIpGaborJetStream_methods;
+  PyBobIpGaborJetStream_Type.tp_getset = PyBobIpGaborJetStream_getseters;
+  PyBobIpGaborJetStream_Type.tp_as_sequence = &PyBobIpGaborJetStream_sequence;
+  PyBobIpGaborJetStream_Type.tp_iter = reinterpret_cast<getiterfunc>(PyBobIpGaborJetStream_iter);
+  PyBobIpGaborJetStream_Type.tp_iternext = reinterpret_cast<iternextfunc>(PyBobIpGaborJetStream_iternext);
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborJetStream_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborJetStream_Type);
+  return PyModule_AddObject(module, "JetStream", (PyObject*)&PyBobIpGaborJetStream_Type) >= 0;
+}
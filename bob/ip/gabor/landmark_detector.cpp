@@ -0,0 +1,334 @@
+/**
+ * @date Sun Oct 18 00:02:42 UTC 2026
+ *
+ * @brief Bindings for the localization of several landmarks
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.io.base/api.h>
+#include <bob.extension/documentation.h>
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto LandmarkDetector_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".LandmarkDetector",
+  "Localizes several landmarks, each of which is modeled by :py:class:`JetStatistics`",
+  "Each landmark, e.g., a facial landmark, is modeled by the :py:class:`JetStatistics` of the Gabor jets that were extracted at this landmark in training images. "
+  "All statistics share the same :py:class:`Transform`, so that an image is transformed only once. "
+  "In :py:meth:`detect`, the log-likelihood maps of all landmarks are computed in one pass over their search regions, where the Gabor jet of a position that lies in several regions is extracted only once. "
+  "The most likely position of each landmark is refined to sub-pixel precision with the :py:meth:`JetStatistics.disparity` of the Gabor jet at this position.\n\n"
+  "The transform and all statistics are stored as a single model with :py:meth:`save`."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates a detector for the given landmark statistics, or reads it from file",
+    "The statistics are copied, and the :py:attr:`JetStatistics.gwt` of the copies is set to the given ``gwt``, so that the given statistics are not modified.",
+    true
+  )
+  .add_prototype("gwt, statistics", "")
+  .add_prototype("hdf5", "")
+  .add_parameter("gwt", ":py:class:`bob.ip.gabor.Transform`", "The Gabor wavelet family, with which the Gabor jets of all landmarks were extracted")
+  .add_parameter("statistics", "[:py:class:`bob.ip.gabor.JetStatistics`]", "The statistics of all landmarks, which must have the length :py:attr:`Transform.number_of_wavelets`")
+  .add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading, which was written by :py:meth:`save`")
+);
+
+static int PyBobIpGaborLandmarkDetector_init(PyBobIpGaborLandmarkDetectorObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist1 = LandmarkDetector_doc.kwlist(0);
+  char** kwlist2 = LandmarkDetector_doc.kwlist(1);
+
+  // get the number of command line arguments
+  Py_ssize_t nargs = (args?PyTuple_Size(args):0) + (kwargs?PyDict_Size(kwargs):0);
+
+  if (nargs == 1){
+    PyBobIoHDF5FileObject* hdf5;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist2, &PyBobIoHDF5File_Converter, &hdf5)) return -1;
+    auto hdf5_ = make_safe(hdf5);
+    self->cxx.reset(new bob::ip::gabor::LandmarkDetector(*hdf5->f));
+    return 0;
+  }
+
+  PyBobIpGaborTransformObject* gwt;
+  PyObject* list;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O", kwlist1, &PyBobIpGaborTransform_Type, &gwt, &list)) return -1;
+
+  std::vector<boost::shared_ptr<bob::ip::gabor::JetStatistics>> statistics;
+  PyObject* iterator = PyObject_GetIter(list);
+  if (!iterator) return -1;
+  auto iterator_ = make_safe(iterator);
+  while (PyObject* it = PyIter_Next(iterator)) {
+    auto it_ = make_safe(it);
+    if (!PyBobIpGaborJetStatistics_Check(it)){
+      PyErr_Format(PyExc_TypeError, "`%s' requires all elements of the `statistics' to be of type bob.ip.gabor.JetStatistics, but element %d isn't", Py_TYPE(self)->tp_name, (int)statistics.size());
+      return -1;
+    }
+    statistics.push_back(reinterpret_cast<PyBobIpGaborJetStatisticsObject*>(it)->cxx);
+  }
+  if (PyErr_Occurred()) return -1;
+
+  self->cxx.reset(new bob::ip::gabor::LandmarkDetector(gwt->cxx, statistics));
+  return 0;
+BOB_CATCH_MEMBER("LandmarkDetector constructor", -1)
+}
+
+static void PyBobIpGaborLandmarkDetector_delete(PyBobIpGaborLandmarkDetectorObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborLandmarkDetector_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborLandmarkDetector_Type));
+}
+
+static Py_ssize_t PyBobIpGaborLandmarkDetector_len(PyBobIpGaborLandmarkDetectorObject* self) {
+  return self->cxx->numberOfLandmarks();
+}
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto numberOfLandmarks_doc = bob::extension::VariableDoc(
+  "number_of_landmarks",
+  "int",
+  "The number of landmarks, read only",
+  "This is identical to the ``len`` of the detector."
+);
+PyObject* PyBobIpGaborLandmarkDetector_numberOfLandmarks(PyBobIpGaborLandmarkDetectorObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->numberOfLandmarks());
+BOB_CATCH_MEMBER("number_of_landmarks", 0)
+}
+
+static auto gwt_doc = bob::extension::VariableDoc(
+  "gwt",
+  ":py:class:`bob.ip.gabor.Transform`",
+  "The Gabor wavelet family, which is shared by the statistics of all landmarks, read only"
+);
+PyObject* PyBobIpGaborLandmarkDetector_gwt(PyBobIpGaborLandmarkDetectorObject* self, void*){
+BOB_TRY
+  PyBobIpGaborTransformObject* gwt = (PyBobIpGaborTransformObject*)PyBobIpGaborTransform_Type.tp_alloc(&PyBobIpGaborTransform_Type, 0);
+  gwt->cxx = self->cxx->gwt();
+  return Py_BuildValue("N", gwt);
+BOB_CATCH_MEMBER("gwt", 0)
+}
+
+static auto statistics_doc = bob::extension::VariableDoc(
+  "statistics",
+  "[:py:class:`bob.ip.gabor.JetStatistics`]",
+  "The statistics of all landmarks, read only"
+);
+PyObject* PyBobIpGaborLandmarkDetector_statistics(PyBobIpGaborLandmarkDetectorObject* self, void*){
+BOB_TRY
+  const auto& statistics = self->cxx->statistics();
+  PyObject* list = PyList_New(statistics.size());
+  if (!list) return 0;
+  auto list_ = make_safe(list);
+  for (std::size_t i = 0; i < statistics.size(); ++i){
+    PyBobIpGaborJetStatisticsObject* s = (PyBobIpGaborJetStatisticsObject*)PyBobIpGaborJetStatistics_Type.tp_alloc(&PyBobIpGaborJetStatistics_Type, 0);
+    s->cxx = statistics[i];
+    PyList_SET_ITEM(list, i, (PyObject*)s);
+  }
+  return Py_BuildValue("O", list);
+BOB_CATCH_MEMBER("statistics", 0)
+}
+
+static PyGetSetDef PyBobIpGaborLandmarkDetector_getseters[] = {
+  {
+    numberOfLandmarks_doc.name(),
+    (getter)PyBobIpGaborLandmarkDetector_numberOfLandmarks,
+    0,
+    numberOfLandmarks_doc.doc(),
+    0
+  },
+  {
+    gwt_doc.name(),
+    (getter)PyBobIpGaborLandmarkDetector_gwt,
+    0,
+    gwt_doc.doc(),
+    0
+  },
+  {
+    statistics_doc.name(),
+    (getter)PyBobIpGaborLandmarkDetector_statistics,
+    0,
+    statistics_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+// reads a list of positions, one for each landmark
+static bool convert_positions(PyObject* list, const char* name, std::vector<blitz::TinyVector<int,2>>& positions){
+  PyObject* iterator = PyObject_GetIter(list);
+  if (!iterator) return false;
+  auto iterator_ = make_safe(iterator);
+  while (PyObject* it = PyIter_Next(iterator)) {
+    auto it_ = make_safe(it);
+    blitz::TinyVector<int,2> position;
+    if (!PyArg_ParseTuple(it, "ii", &position[0], &position[1])){
+      PyErr_Format(PyExc_TypeError, "all elements of `%s' must be positions (y, x), but element %d isn't", name, (int)positions.size());
+      return false;
+    }
+    positions.push_back(position);
+  }
+  return !PyErr_Occurred();
+}
+
+static auto detect_doc = bob::extension::FunctionDoc(
+  "detect",
+  "Localizes all landmarks in the given image",
+  "Each landmark ``i`` is searched in the region between ``first[i]`` and ``last[i]`` (inclusive), i.e., the position with the highest :py:meth:`JetStatistics.log_likelihood_map` score is selected. "
+  "When the :py:meth:`JetStatistics.disparity` of the Gabor jet at this position is smaller than one pixel in both directions, it is added to the position. "
+  "The returned scores are the log-likelihoods at the selected integral positions.\n\n"
+  "The image can be given either as a gray image, which is transformed with :py:attr:`gwt`, or as a Gabor wavelet transformed image, e.g., when the same image is searched several times. "
+  "The extracted Gabor jets are always normalized to unit Euclidean length.",
+  true
+)
+.add_prototype("image, first, last, [estimate_phase], [number_of_threads]", "positions, scores")
+.add_parameter("image", "array_like (2D) or array_like (complex, 3D)", "The image to search in, either a gray image of type uint8, float or complex, or its Gabor wavelet transform")
+.add_parameter("first", "[(int, int)]", "The top-left positions of the search regions, one for each landmark")
+.add_parameter("last", "[(int, int)]", "The bottom-right positions of the search regions, which are included in the regions")
+.add_parameter("estimate_phase", "bool", "[Default: ``True``] Should the disparity corrected phases be included into the log-likelihoods?")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads, over which the rows of the search regions are distributed; ``0`` selects one thread per available core")
+.add_return("positions", "array_like (2D, float)", "The refined positions (y, x) of all landmarks, of shape ``(number_of_landmarks, 2)``")
+.add_return("scores", "array_like (1D, float)", "The log-likelihoods of all landmarks")
+;
+
+static PyObject* PyBobIpGaborLandmarkDetector_detect(PyBobIpGaborLandmarkDetectorObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = detect_doc.kwlist();
+
+  PyBlitzArrayObject* image;
+  PyObject* first_list,* last_list,* phase = 0;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&OO|Oi", kwlist, &PyBlitzArray_Converter, &image, &first_list, &last_list, &phase, &threads)) return 0;
+  auto image_ = make_safe(image);
+
+  std::vector<blitz::TinyVector<int,2>> first, last;
+  if (!convert_positions(first_list, "first", first) || !convert_positions(last_list, "last", last)) return 0;
+
+  Py_ssize_t psize[] = {self->cxx->numberOfLandmarks(), 2};
+  PyBlitzArrayObject* positions = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, psize);
+  auto positions_ = make_safe(positions);
+  PyBlitzArrayObject* scores = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, psize);
+  auto scores_ = make_safe(scores);
+  auto& p = *PyBlitzArrayCxx_AsBlitz<double,2>(positions);
+  auto& s = *PyBlitzArrayCxx_AsBlitz<double,1>(scores);
+  const bool estimate_phase = !phase || PyObject_IsTrue(phase);
+
+  if (image->ndim == 3 && image->type_num == NPY_COMPLEX128){
+    self->cxx->detect(*PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(image), first, last, p, s, estimate_phase, threads);
+  } else if (image->ndim == 2){
+    switch (image->type_num){
+      case NPY_UINT8:
+        self->cxx->detect(*PyBlitzArrayCxx_AsBlitz<uint8_t,2>(image), first, last, p, s, estimate_phase, threads);
+        break;
+      case NPY_FLOAT64:
+        self->cxx->detect(*PyBlitzArrayCxx_AsBlitz<double,2>(image), first, last, p, s, estimate_phase, threads);
+        break;
+      case NPY_COMPLEX128:
+        self->cxx->detect(*PyBlitzArrayCxx_AsBlitz<std::complex<double>,2>(image), first, last, p, s, estimate_phase, threads);
+        break;
+      default:
+        PyErr_Format(PyExc_TypeError, "`%s' only supports gray images of type uint8, float and complex", Py_TYPE(self)->tp_name);
+        return 0;
+    }
+  } else {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `image' to be a 2D gray image or a 3D complex Gabor wavelet transformed image", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+
+  return Py_BuildValue("NN", PyBlitzArray_AsNumpyArray(positions, 0), PyBlitzArray_AsNumpyArray(scores, 0));
+BOB_CATCH_MEMBER("detect", 0)
+}
+
+static auto save_doc = bob::extension::FunctionDoc(
+  "save",
+  "Saves the detector to the given HDF5 file",
+  "The :py:attr:`gwt` is written only once, and the statistics of the landmarks are written into the sub-directories ``Landmark0``, ``Landmark1``, ...",
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing")
+;
+
+static PyObject* PyBobIpGaborLandmarkDetector_save(PyBobIpGaborLandmarkDetectorObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = save_doc.kwlist();
+  PyBobIoHDF5FileObject* file;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &file)) return 0;
+
+  auto file_ = make_safe(file);
+  self->cxx->save(*file->f);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("save", 0)
+}
+
+static PyMethodDef PyBobIpGaborLandmarkDetector_methods[] = {
+  {
+    detect_doc.name(),
+    (PyCFunction)PyBobIpGaborLandmarkDetector_detect,
+    METH_VARARGS|METH_KEYWORDS,
+    detect_doc.doc()
+  },
+  {
+    save_doc.name(),
+    (PyCFunction)PyBobIpGaborLandmarkDetector_save,
+    METH_VARARGS|METH_KEYWORDS,
+    save_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the LandmarkDetector type struct; will be initialized later
+PyTypeObject PyBobIpGaborLandmarkDetector_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+static PySequenceMethods PyBobIpGaborLandmarkDetector_sequence = {
+  (lenfunc)PyBobIpGaborLandmarkDetector_len
+};
+
+bool init_BobIpGaborLandmarkDetector(PyObject* module)
+{
+
+  // initialize the LandmarkDetector type struct
+  PyBobIpGaborLandmarkDetector_Type.tp_name = LandmarkDetector_doc.name();
+  PyBobIpGaborLandmarkDetector_Type.tp_basicsize = sizeof(PyBobIpGaborLandmarkDetectorObject);
+  PyBobIpGaborLandmarkDetector_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborLandmarkDetector_Type.tp_doc = LandmarkDetector_doc.doc();
+
+  // set the functions
+  PyBobIpGaborLandmarkDetector_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborLandmarkDetector_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborLandmarkDetector_init);
+  PyBobIpGaborLandmarkDetector_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborLandmarkDetector_delete);
+  PyBobIpGaborLandmarkDetector_Type.tp_methods = PyBobIpGaborLandmarkDetector_methods;
+  PyBobIpGaborLandmarkDetector_Type.tp_getset = PyBobIpGaborLandmarkDetector_getseters;
+  PyBobIpGaborLandmarkDetector_Type.tp_as_sequence = &PyBobIpGaborLandmarkDetector_sequence;
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborLandmarkDetector_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborLandmarkDetector_Type);
+  return PyModule_AddObject(module, "LandmarkDetector", (PyObject*)&PyBobIpGaborLandmarkDetector_Type) >= 0;
+}
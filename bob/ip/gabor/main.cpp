@@ -12,10 +12,390 @@
 #undef NO_IMPORT_ARRAY
 #endif
 #include <bob.blitz/capi.h>
+#include <bob.blitz/cppapi.h>
 #include <bob.blitz/cleanup.h>
 #include <bob.core/api.h>
 #include <bob.io.base/api.h>
 #include <bob.sp/api.h>
+#include <bob.extension/documentation.h>
+
+#include <bob.ip.gabor/FastMath.h>
+
+
+static auto get_fast_math_doc = bob::extension::FunctionDoc(
+  "get_fast_math",
+  "Returns whether the fast approximations of the trigonometric functions are enabled",
+  "See :py:func:`set_fast_math` for details."
+)
+.add_prototype("", "enabled")
+.add_return("enabled", "bool", "``True`` if the fast approximations are used, ``False`` if the functions of the standard library are used")
+;
+static PyObject* PyBobIpGabor_get_fast_math(PyObject*, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = get_fast_math_doc.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+  if (bob::ip::gabor::fast_math()) Py_RETURN_TRUE;
+  Py_RETURN_FALSE;
+BOB_CATCH_FUNCTION("get_fast_math", 0)
+}
+
+static auto set_fast_math_doc = bob::extension::FunctionDoc(
+  "set_fast_math",
+  "Enables or disables the fast approximations of the trigonometric functions",
+  "By default, the trigonometric functions of the standard library are used. "
+  "When enabled, vectorizable polynomial approximations of the cosine, sine and arc tangent are used instead, i.e., "
+  "in the creation of :py:class:`Jet`'s and the computation of their complex values, in the phase-based :py:class:`Similarity` functions, "
+  "in the disparity estimation and in the phase shift, as well as in :py:class:`JetStatistics`. "
+  "The approximations have a maximum absolute error of ``1e-13``, so that similarities differ from the exact ones by about ``1e-14``.\n\n"
+  "The mode is global for all objects, and it is read once at the beginning of each computation. "
+  "Computations that are running in other threads while the mode is switched might use either mode."
+)
+.add_prototype("enabled")
+.add_parameter("enabled", "bool", "Use the fast approximations (``True``) or the functions of the standard library (``False``)")
+;
+static PyObject* PyBobIpGabor_set_fast_math(PyObject*, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = set_fast_math_doc.kwlist();
+  PyObject* enabled;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &enabled)) return 0;
+  int value = PyObject_IsTrue(enabled);
+  if (value < 0) return 0;
+  bob::ip::gabor::fast_math(value != 0);
+  Py_RETURN_NONE;
+BOB_CATCH_FUNCTION("set_fast_math", 0)
+}
+
+static auto log_likelihoods_doc = bob::extension::FunctionDoc(
+  "log_likelihoods",
+  "Computes the log-likelihoods of a batch of Gabor jets for several jet statistics",
+  "This function computes the same scores as :py:meth:`JetStatistics.log_likelihood` for all combinations of the given ``statistics`` and ``jets``, e.g., to evaluate the jets extracted at many candidate positions for several landmarks. "
+  "The jets are distributed over the given number of threads, and each jet is scored with all statistics at once."
+)
+.add_prototype("statistics, jets, [estimate_phase], [offset], [scores], [number_of_threads]", "scores")
+.add_parameter("statistics", "[:py:class:`bob.ip.gabor.JetStatistics`]", "The statistics to compute the log-likelihoods for; all must have the same length")
+.add_parameter("jets", "array_like (3D, float)", "The data of the Gabor jets of shape ``(N, 2, length)``")
+.add_parameter("estimate_phase", "bool", "[Default: ``True``] Should the phase be included into the estimation?")
+.add_parameter("offset", "(float, float)", "[Default: ``(0,0)``] Sub-pixel location offset, where the Gabor jets should have been extracted")
+.add_parameter("scores", "array_like (2D, float)", "[Default: ``None``] If given, the scores will be written into this array, which must be of shape ``(len(statistics), N)``")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads to use; ``0`` selects one thread per available core")
+.add_return("scores", "array_like (2D, float)", "The log-likelihood scores, where the rows correspond to the statistics and the columns to the jets")
+;
+static PyObject* PyBobIpGabor_log_likelihoods(PyObject*, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = log_likelihoods_doc.kwlist();
+
+  PyObject* list,* phase = 0;
+  PyBlitzArrayObject* jets,* scores = 0;
+  blitz::TinyVector<double,2> offset(0.,0.);
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO&|O(dd)O&i", kwlist, &list, &PyBlitzArray_Converter, &jets, &phase, &offset[0], &offset[1], &PyBlitzArray_OutputConverter, &scores, &threads)) return 0;
+
+  auto jets_ = make_safe(jets);
+  auto scores_ = make_xsafe(scores);
+
+  std::vector<boost::shared_ptr<bob::ip::gabor::JetStatistics>> statistics;
+  PyObject* iterator = PyObject_GetIter(list);
+  if (!iterator) return 0;
+  auto iterator_ = make_safe(iterator);
+  while (PyObject* it = PyIter_Next(iterator)) {
+    auto it_ = make_safe(it);
+    if (!PyBobIpGaborJetStatistics_Check(it)){
+      PyErr_Format(PyExc_TypeError, "log_likelihoods requires all elements of the `statistics' to be of type bob.ip.gabor.JetStatistics, but element %d isn't", (int)statistics.size());
+      return 0;
+    }
+    statistics.push_back(reinterpret_cast<PyBobIpGaborJetStatisticsObject*>(it)->cxx);
+  }
+  if (PyErr_Occurred()) return 0;
+
+  if (jets->type_num != NPY_FLOAT64 || jets->ndim != 3) {
+    PyErr_Format(PyExc_TypeError, "log_likelihoods requires the `jets' to be a 3D array of type float");
+    return 0;
+  }
+  if (scores){
+    if (scores->type_num != NPY_FLOAT64 || scores->ndim != 2) {
+      PyErr_Format(PyExc_TypeError, "log_likelihoods requires the `scores' to be a 2D array of type float");
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[] = {(Py_ssize_t)statistics.size(), jets->shape[0]};
+    scores = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, osize);
+    scores_ = make_safe(scores);
+  }
+
+  bob::ip::gabor::JetStatistics::logLikelihoods(statistics, *PyBlitzArrayCxx_AsBlitz<double,3>(jets), *PyBlitzArrayCxx_AsBlitz<double,2>(scores), !phase || PyObject_IsTrue(phase), offset, threads);
+  return PyBlitzArray_AsNumpyArray(scores, 0);
+BOB_CATCH_FUNCTION("log_likelihoods", 0)
+}
+
+static auto save_statistics_doc = bob::extension::FunctionDoc(
+  "save_statistics",
+  "Saves several jet statistics, e.g., of all nodes of a graph, to the given HDF5 file",
+  "Instead of one directory per :py:class:`JetStatistics` as in :py:meth:`JetStatistics.save`, the means and variances of all statistics are written into a single data set ``Statistics`` of shape ``(N, 4, length)``, where the second dimension contains the :py:attr:`JetStatistics.mean_abs`, :py:attr:`JetStatistics.var_abs`, :py:attr:`JetStatistics.mean_phase` and :py:attr:`JetStatistics.var_phase`. "
+  "The :py:attr:`JetStatistics.gwt`, which must be identical for all statistics, is written only once. "
+  "The statistics can be read with :py:func:`load_statistics`."
+)
+.add_prototype("statistics, hdf5, [save_gwt]")
+.add_parameter("statistics", "[:py:class:`bob.ip.gabor.JetStatistics`]", "The statistics to write; all must have the same length")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing")
+.add_parameter("save_gwt", "bool", "[Default: ``True``] Should the Gabor wavelet transform class be written to the file as well?")
+;
+static PyObject* PyBobIpGabor_save_statistics(PyObject*, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = save_statistics_doc.kwlist();
+
+  PyObject* list,* gwt = 0;
+  PyBobIoHDF5FileObject* file;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO&|O", kwlist, &list, &PyBobIoHDF5File_Converter, &file, &gwt)) return 0;
+  auto file_ = make_safe(file);
+
+  std::vector<boost::shared_ptr<bob::ip::gabor::JetStatistics>> statistics;
+  PyObject* iterator = PyObject_GetIter(list);
+  if (!iterator) return 0;
+  auto iterator_ = make_safe(iterator);
+  while (PyObject* it = PyIter_Next(iterator)) {
+    auto it_ = make_safe(it);
+    if (!PyBobIpGaborJetStatistics_Check(it)){
+      PyErr_Format(PyExc_TypeError, "save_statistics requires all elements of the `statistics' to be of type bob.ip.gabor.JetStatistics, but element %d isn't", (int)statistics.size());
+      return 0;
+    }
+    statistics.push_back(reinterpret_cast<PyBobIpGaborJetStatisticsObject*>(it)->cxx);
+  }
+  if (PyErr_Occurred()) return 0;
+
+  bob::ip::gabor::JetStatistics::save(statistics, *file->f, !gwt || PyObject_IsTrue(gwt));
+  Py_RETURN_NONE;
+BOB_CATCH_FUNCTION("save_statistics", 0)
+}
+
+static auto load_statistics_doc = bob::extension::FunctionDoc(
+  "load_statistics",
+  "Loads several jet statistics from the given HDF5 file",
+  "The statistics must have been written with :py:func:`save_statistics`."
+)
+.add_prototype("hdf5", "statistics")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading")
+.add_return("statistics", "[:py:class:`bob.ip.gabor.JetStatistics`]", "The statistics read from file, which share the same :py:attr:`JetStatistics.gwt`")
+;
+static PyObject* PyBobIpGabor_load_statistics(PyObject*, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = load_statistics_doc.kwlist();
+
+  PyBobIoHDF5FileObject* file;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, &PyBobIoHDF5File_Converter, &file)) return 0;
+  auto file_ = make_safe(file);
+
+  auto statistics = bob::ip::gabor::JetStatistics::load(*file->f);
+  PyObject* list = PyList_New(statistics.size());
+  if (!list) return 0;
+  auto list_ = make_safe(list);
+  for (std::size_t i = 0; i < statistics.size(); ++i){
+    PyBobIpGaborJetStatisticsObject* s = (PyBobIpGaborJetStatisticsObject*)PyBobIpGaborJetStatistics_Type.tp_alloc(&PyBobIpGaborJetStatistics_Type, 0);
+    s->cxx = statistics[i];
+    PyList_SET_ITEM(list, i, (PyObject*)s);
+  }
+  return Py_BuildValue("O", list);
+BOB_CATCH_FUNCTION("load_statistics", 0)
+}
+
+static auto save_jet_block_doc = bob::extension::FunctionDoc(
+  "save_jet_block",
+  "Saves a list of Gabor jets as a single data set to the given HDF5 file",
+  "In opposition to :py:func:`save_jets`, which writes one directory per :py:class:`Jet`, all jets are written into the single data set ``Jets`` of shape ``(N, 2, length)``, which is written and read with a single HDF5 operation. "
+  "With a ``compression`` level between 1 and 9, the data set is compressed, where :py:class:`bob.io.base.HDF5File` selects the HDF5 chunks.\n\n"
+  "The jets can be read with :py:func:`load_jet_block` or with :py:func:`load_jets`."
+)
+.add_prototype("jets, hdf5, [compression]")
+.add_parameter("jets", "[:py:class:`bob.ip.gabor.Jet`] or array_like (3D, float)", "The Gabor jets to write, either as a list of jets with the same length, or as their data of shape ``(N, 2, length)``")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing")
+.add_parameter("compression", "int", "[Default: ``0``] The compression level between 0 (no compression) and 9 (highest compression)")
+;
+static PyObject* PyBobIpGabor_save_jet_block(PyObject*, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = save_jet_block_doc.kwlist();
+
+  PyObject* jets;
+  PyBobIoHDF5FileObject* file;
+  int compression = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO&|i", kwlist, &jets, &PyBobIoHDF5File_Converter, &file, &compression)) return 0;
+  auto file_ = make_safe(file);
+
+  if (compression < 0 || compression > 9){
+    PyErr_Format(PyExc_ValueError, "save_jet_block requires the `compression' to be between 0 and 9, but it is %d", compression);
+    return 0;
+  }
+
+  if (PyBlitzArray_Check(jets) || PyArray_Check(jets)){
+    PyBlitzArrayObject* data;
+    if (!PyBlitzArray_Converter(jets, &data)) return 0;
+    auto data_ = make_safe(data);
+    if (data->type_num != NPY_FLOAT64 || data->ndim != 3) {
+      PyErr_Format(PyExc_TypeError, "save_jet_block requires the `jets' to be a 3D array of type float");
+      return 0;
+    }
+    bob::ip::gabor::save_jets(*PyBlitzArrayCxx_AsBlitz<double,3>(data), *file->f, compression);
+    Py_RETURN_NONE;
+  }
+
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> list;
+  PyObject* iterator = PyObject_GetIter(jets);
+  if (!iterator) return 0;
+  auto iterator_ = make_safe(iterator);
+  while (PyObject* it = PyIter_Next(iterator)) {
+    auto it_ = make_safe(it);
+    if (!PyBobIpGaborJet_Check(it)){
+      PyErr_Format(PyExc_TypeError, "save_jet_block requires all elements of the `jets' to be of type bob.ip.gabor.Jet, but element %d isn't", (int)list.size());
+      return 0;
+    }
+    list.push_back(reinterpret_cast<PyBobIpGaborJetObject*>(it)->cxx);
+  }
+  if (PyErr_Occurred()) return 0;
+
+  bob::ip::gabor::save_jets(list, *file->f, compression);
+  Py_RETURN_NONE;
+BOB_CATCH_FUNCTION("save_jet_block", 0)
+}
+
+static auto load_jet_block_doc = bob::extension::FunctionDoc(
+  "load_jet_block",
+  "Loads a list of Gabor jets from the given HDF5 file into a single array",
+  "Both the single data set written by :py:func:`save_jet_block` and the directories written by :py:func:`save_jets` can be read. "
+  "The jets are read directly into the returned array, without creating :py:class:`Jet` objects, so that the result can be passed to the batch functions, e.g., :py:meth:`Similarity.similarities` or :py:meth:`JetStatistics.log_likelihoods`."
+)
+.add_prototype("hdf5", "jets")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading")
+.add_return("jets", "array_like (3D, float)", "The data of the Gabor jets, of shape ``(N, 2, length)``")
+;
+static PyObject* PyBobIpGabor_load_jet_block(PyObject*, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = load_jet_block_doc.kwlist();
+
+  PyBobIoHDF5FileObject* file;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, &PyBobIoHDF5File_Converter, &file)) return 0;
+  auto file_ = make_safe(file);
+
+  return PyBlitzArrayCxx_AsNumpy(bob::ip::gabor::load_jets(*file->f));
+BOB_CATCH_FUNCTION("load_jet_block", 0)
+}
+
+// calls a Python similarity function with the two Gabor jets as (2, length) arrays; the function might be called from any thread
+// The function object is never released, since the registered similarity functions live until the process ends
+struct PythonSimilarity{
+  PyObject* function;
+
+  double operator()(const double* jet1, const double* jet2, int length) const{
+    PyGILState_STATE state = PyGILState_Ensure();
+    blitz::Array<double,2> data1(2, length), data2(2, length);
+    std::copy(jet1, jet1 + 2*length, data1.data());
+    std::copy(jet2, jet2 + 2*length, data2.data());
+    PyObject* result = PyObject_CallFunction(function, "NN", PyBlitzArrayCxx_AsNumpy(data1), PyBlitzArrayCxx_AsNumpy(data2));
+    double similarity = result ? PyFloat_AsDouble(result) : 0.;
+    Py_XDECREF(result);
+    std::string error;
+    if (PyErr_Occurred()){
+      PyObject *type, *value, *traceback;
+      PyErr_Fetch(&type, &value, &traceback);
+      PyObject* message = value ? PyObject_Str(value) : 0;
+#if PY_VERSION_HEX >= 0x03000000
+      const char* text = message ? PyUnicode_AsUTF8(message) : 0;
+#else
+      const char* text = message ? PyString_AsString(message) : 0;
+#endif
+      error = std::string("The user-defined similarity function raised an exception: ") + (text ? text : "unknown error");
+      Py_XDECREF(message);
+      Py_XDECREF(type);
+      Py_XDECREF(value);
+      Py_XDECREF(traceback);
+      PyErr_Clear();
+    }
+    PyGILState_Release(state);
+    if (!error.empty())
+      throw std::runtime_error(error);
+    return similarity;
+  }
+};
+
+static auto register_similarity_doc = bob::extension::FunctionDoc(
+  "register_similarity",
+  "Registers a Python function as a user-defined Gabor jet similarity function",
+  "Afterwards, :py:class:`Similarity` objects can be created with the given ``name``, and they can be saved to and loaded from HDF5 files like the built-in similarity functions, as long as the function is registered under the same name before loading. "
+  "The ``function`` is called with the data of two Gabor jets, i.e., two arrays of shape ``(2, length)`` containing absolute values and phases, and must return their similarity as a ``float``. "
+  "Exceptions raised by the ``function`` are reported as a :py:class:`RuntimeError`.\n\n"
+  "Python functions are always evaluated in the calling thread, so the ``number_of_threads`` of the batch computations is ignored for them. "
+  "The names of the built-in similarity functions cannot be used, while registering an existing user-defined name replaces the function for all :py:class:`Similarity` objects that are created afterwards."
+)
+.add_prototype("name, function")
+.add_parameter("name", "str", "The name under which the similarity function is registered")
+.add_parameter("function", "callable", "The similarity function, which is called as ``function(jet1, jet2)`` with the data of two Gabor jets")
+;
+static PyObject* PyBobIpGabor_register_similarity(PyObject*, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = register_similarity_doc.kwlist();
+
+  const char* name;
+  PyObject* function;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sO", kwlist, &name, &function)) return 0;
+  if (!PyCallable_Check(function)){
+    PyErr_Format(PyExc_TypeError, "register_similarity requires the `function' to be callable");
+    return 0;
+  }
+
+  bob::ip::gabor::Similarity::register_function(name, PythonSimilarity{function}, false);
+  Py_INCREF(function);
+  Py_RETURN_NONE;
+BOB_CATCH_FUNCTION("register_similarity", 0)
+}
+
+static PyMethodDef module_methods[] = {
+  {
+    get_fast_math_doc.name(),
+    (PyCFunction)PyBobIpGabor_get_fast_math,
+    METH_VARARGS|METH_KEYWORDS,
+    get_fast_math_doc.doc()
+  },
+  {
+    set_fast_math_doc.name(),
+    (PyCFunction)PyBobIpGabor_set_fast_math,
+    METH_VARARGS|METH_KEYWORDS,
+    set_fast_math_doc.doc()
+  },
+  {
+    log_likelihoods_doc.name(),
+    (PyCFunction)PyBobIpGabor_log_likelihoods,
+    METH_VARARGS|METH_KEYWORDS,
+    log_likelihoods_doc.doc()
+  },
+  {
+    save_statistics_doc.name(),
+    (PyCFunction)PyBobIpGabor_save_statistics,
+    METH_VARARGS|METH_KEYWORDS,
+    save_statistics_doc.doc()
+  },
+  {
+    load_statistics_doc.name(),
+    (PyCFunction)PyBobIpGabor_load_statistics,
+    METH_VARARGS|METH_KEYWORDS,
+    load_statistics_doc.doc()
+  },
+  {
+    save_jet_block_doc.name(),
+    (PyCFunction)PyBobIpGabor_save_jet_block,
+    METH_VARARGS|METH_KEYWORDS,
+    save_jet_block_doc.doc()
+  },
+  {
+    load_jet_block_doc.name(),
+    (PyCFunction)PyBobIpGabor_load_jet_block,
+    METH_VARARGS|METH_KEYWORDS,
+    load_jet_block_doc.doc()
+  },
+  {
+    register_similarity_doc.name(),
+    (PyCFunction)PyBobIpGabor_register_similarity,
+    METH_VARARGS|METH_KEYWORDS,
+    register_similarity_doc.doc()
+  },
+  {0}  /* Sentinel */
+};
 
 
 PyDoc_STRVAR(module_docstr, "Bob's Gabor wavelet support and utilities.");
@@ -26,8 +406,8 @@ static PyModuleDef module_definition = {
   BOB_EXT_MODULE_NAME,
   module_docstr,
   -1,
-  0,
-  0
+  module_methods,
+  0, 0, 0, 0
 };
 #endif
 
@@ -37,6 +417,18 @@ extern bool init_BobIpGaborJet(PyObject* module);
 extern bool init_BobIpGaborSimilarity(PyObject* module);
 extern bool init_BobIpGaborGraph(PyObject* module);
 extern bool init_BobIpGaborJetStatistics(PyObject* module);
+extern bool init_BobIpGaborCascade(PyObject* module);
+extern bool init_BobIpGaborGalleryIndex(PyObject* module);
+extern bool init_BobIpGaborQuantizedIndex(PyObject* module);
+extern bool init_BobIpGaborFixedPointSimilarity(PyObject* module);
+extern bool init_BobIpGaborScoreCache(PyObject* module);
+extern bool init_BobIpGaborMatchingServer(PyObject* module);
+extern bool init_BobIpGaborMatchingClient(PyObject* module);
+extern bool init_BobIpGaborJetStatisticsBuilder(PyObject* module);
+extern bool init_BobIpGaborLandmarkDetector(PyObject* module);
+extern bool init_BobIpGaborGraphStatisticsTrainer(PyObject* module);
+extern bool init_BobIpGaborMappedGallery(PyObject* module);
+extern bool init_BobIpGaborJetStream(PyObject* module);
 
 int PyBobIpGabor_APIVersion = BOB_IP_GABOR_API_VERSION;
 
@@ -47,7 +439,7 @@ static PyObject* create_module (void) {
   auto module_ = make_xsafe(module);
   const char* ret = "O";
 # else
-  PyObject* module = Py_InitModule3(BOB_EXT_MODULE_NAME, 0, module_docstr);
+  PyObject* module = Py_InitModule3(BOB_EXT_MODULE_NAME, module_methods, module_docstr);
   const char* ret = "N";
 # endif
   if (!module) return 0;
@@ -58,6 +450,18 @@ static PyObject* create_module (void) {
   if (!init_BobIpGaborSimilarity(module)) return NULL;
   if (!init_BobIpGaborGraph(module)) return NULL;
   if (!init_BobIpGaborJetStatistics(module)) return NULL;
+  if (!init_BobIpGaborCascade(module)) return NULL;
+  if (!init_BobIpGaborGalleryIndex(module)) return NULL;
+  if (!init_BobIpGaborQuantizedIndex(module)) return NULL;
+  if (!init_BobIpGaborFixedPointSimilarity(module)) return NULL;
+  if (!init_BobIpGaborScoreCache(module)) return NULL;
+  if (!init_BobIpGaborMatchingServer(module)) return NULL;
+  if (!init_BobIpGaborMatchingClient(module)) return NULL;
+  if (!init_BobIpGaborJetStatisticsBuilder(module)) return NULL;
+  if (!init_BobIpGaborLandmarkDetector(module)) return NULL;
+  if (!init_BobIpGaborGraphStatisticsTrainer(module)) return NULL;
+  if (!init_BobIpGaborMappedGallery(module)) return NULL;
+  if (!init_BobIpGaborJetStream(module)) return NULL;
 
   // C-API bindings
 
@@ -79,6 +483,18 @@ static PyObject* create_module (void) {
   PyBobIpGabor_API[PyBobIpGaborSimilarity_Type_NUM] = (void *)&PyBobIpGaborSimilarity_Type;
   PyBobIpGabor_API[PyBobIpGaborTransform_Type_NUM] = (void *)&PyBobIpGaborTransform_Type;
   PyBobIpGabor_API[PyBobIpGaborJetStatistics_Type_NUM] = (void *)&PyBobIpGaborJetStatistics_Type;
+  PyBobIpGabor_API[PyBobIpGaborCascade_Type_NUM] = (void *)&PyBobIpGaborCascade_Type;
+  PyBobIpGabor_API[PyBobIpGaborGalleryIndex_Type_NUM] = (void *)&PyBobIpGaborGalleryIndex_Type;
+  PyBobIpGabor_API[PyBobIpGaborQuantizedIndex_Type_NUM] = (void *)&PyBobIpGaborQuantizedIndex_Type;
+  PyBobIpGabor_API[PyBobIpGaborFixedPointSimilarity_Type_NUM] = (void *)&PyBobIpGaborFixedPointSimilarity_Type;
+  PyBobIpGabor_API[PyBobIpGaborScoreCache_Type_NUM] = (void *)&PyBobIpGaborScoreCache_Type;
+  PyBobIpGabor_API[PyBobIpGaborMatchingServer_Type_NUM] = (void *)&PyBobIpGaborMatchingServer_Type;
+  PyBobIpGabor_API[PyBobIpGaborMatchingClient_Type_NUM] = (void *)&PyBobIpGaborMatchingClient_Type;
+  PyBobIpGabor_API[PyBobIpGaborJetStatisticsBuilder_Type_NUM] = (void *)&PyBobIpGaborJetStatisticsBuilder_Type;
+  PyBobIpGabor_API[PyBobIpGaborLandmarkDetector_Type_NUM] = (void *)&PyBobIpGaborLandmarkDetector_Type;
+  PyBobIpGabor_API[PyBobIpGaborGraphStatisticsTrainer_Type_NUM] = (void *)&PyBobIpGaborGraphStatisticsTrainer_Type;
+  PyBobIpGabor_API[PyBobIpGaborMappedGallery_Type_NUM] = (void *)&PyBobIpGaborMappedGallery_Type;
+  PyBobIpGabor_API[PyBobIpGaborJetStream_Type_NUM] = (void *)&PyBobIpGaborJetStream_Type;
 
   /*******************
    * Check functions *
@@ -90,6 +506,18 @@ static PyObject* create_module (void) {
   PyBobIpGabor_API[PyBobIpGaborSimilarity_Check_NUM] = (void *)&PyBobIpGaborSimilarity_Check;
   PyBobIpGabor_API[PyBobIpGaborTransform_Check_NUM] = (void *)&PyBobIpGaborTransform_Check;
   PyBobIpGabor_API[PyBobIpGaborJetStatistics_Check_NUM] = (void *)&PyBobIpGaborJetStatistics_Check;
+  PyBobIpGabor_API[PyBobIpGaborCascade_Check_NUM] = (void *)&PyBobIpGaborCascade_Check;
+  PyBobIpGabor_API[PyBobIpGaborGalleryIndex_Check_NUM] = (void *)&PyBobIpGaborGalleryIndex_Check;
+  PyBobIpGabor_API[PyBobIpGaborQuantizedIndex_Check_NUM] = (void *)&PyBobIpGaborQuantizedIndex_Check;
+  PyBobIpGabor_API[PyBobIpGaborFixedPointSimilarity_Check_NUM] = (void *)&PyBobIpGaborFixedPointSimilarity_Check;
+  PyBobIpGabor_API[PyBobIpGaborScoreCache_Check_NUM] = (void *)&PyBobIpGaborScoreCache_Check;
+  PyBobIpGabor_API[PyBobIpGaborMatchingServer_Check_NUM] = (void *)&PyBobIpGaborMatchingServer_Check;
+  PyBobIpGabor_API[PyBobIpGaborMatchingClient_Check_NUM] = (void *)&PyBobIpGaborMatchingClient_Check;
+  PyBobIpGabor_API[PyBobIpGaborJetStatisticsBuilder_Check_NUM] = (void *)&PyBobIpGaborJetStatisticsBuilder_Check;
+  PyBobIpGabor_API[PyBobIpGaborLandmarkDetector_Check_NUM] = (void *)&PyBobIpGaborLandmarkDetector_Check;
+  PyBobIpGabor_API[PyBobIpGaborGraphStatisticsTrainer_Check_NUM] = (void *)&PyBobIpGaborGraphStatisticsTrainer_Check;
+  PyBobIpGabor_API[PyBobIpGaborMappedGallery_Check_NUM] = (void *)&PyBobIpGaborMappedGallery_Check;
+  PyBobIpGabor_API[PyBobIpGaborJetStream_Check_NUM] = (void *)&PyBobIpGaborJetStream_Check;
 
 #if PY_VERSION_HEX >= 0x02070000
 
@@ -0,0 +1,470 @@
+/**
+ * @date Sun Oct 18 00:19:09 UTC 2026
+ *
+ * @brief Bindings for the memory-mapped binary gallery
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.extension/documentation.h>
+
+#include "gil.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto MappedGallery_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".MappedGallery",
+  "Provides the enrolled graphs of a binary gallery file, which is mapped into memory",
+  "The gallery file is written with :py:meth:`write`, and it contains the ids, the (optional) node positions, the graphs and (optionally) the graphs quantized by :py:meth:`FixedPointSimilarity.quantize`. "
+  "All blocks are aligned, so that they can be used in place: opening the file neither reads nor converts any data, and the arrays :py:attr:`graphs`, :py:attr:`jets` and :py:attr:`quantized` are read-only views into the mapped file. "
+  "Hence, a gallery of any size is opened instantly, and several processes that open the same file share the memory in the page cache of the operating system.\n\n"
+  "The file is stored in the native byte order; it cannot be opened on machines with a different byte order. "
+  "The file must not be modified while it is mapped."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Maps the given gallery file into memory",
+    "The header of the file is checked, and an exception is raised if the file is not a valid gallery file.",
+    true
+  )
+  .add_prototype("filename", "")
+  .add_parameter("filename", "str", "The name of the gallery file, which was written with :py:meth:`write`")
+);
+
+static int PyBobIpGaborMappedGallery_init(PyBobIpGaborMappedGalleryObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = MappedGallery_doc.kwlist(0);
+
+  const char* filename;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s", kwlist, &filename)) return -1;
+
+  self->cxx.reset(new bob::ip::gabor::MappedGallery(filename));
+  return 0;
+BOB_CATCH_MEMBER("MappedGallery constructor", -1)
+}
+
+static void PyBobIpGaborMappedGallery_delete(PyBobIpGaborMappedGalleryObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborMappedGallery_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborMappedGallery_Type));
+}
+
+static Py_ssize_t PyBobIpGaborMappedGallery_len(PyBobIpGaborMappedGalleryObject* self) {
+  return self->cxx->size();
+}
+
+// creates a read-only numpy array that points into the mapped file, which is kept mapped as long as the array exists
+template <typename T, int N>
+static PyObject* mapped_array(PyBobIpGaborMappedGalleryObject* self, const blitz::Array<T,N>& array){
+  npy_intp shape[N];
+  for (int i = 0; i < N; ++i) shape[i] = array.extent(i);
+  PyObject* result = PyArray_SimpleNewFromData(N, shape, PyBlitzArrayCxx_CToTypenum<T>(), const_cast<T*>(array.data()));
+  if (!result) return 0;
+  PyArray_CLEARFLAGS((PyArrayObject*)result, NPY_ARRAY_WRITEABLE);
+  // the array steals the reference to its base
+  Py_INCREF(self);
+  if (PyArray_SetBaseObject((PyArrayObject*)result, (PyObject*)self) < 0){
+    Py_DECREF(result);
+    return 0;
+  }
+  return result;
+}
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto filename_doc = bob::extension::VariableDoc(
+  "filename",
+  "str",
+  "The name of the mapped gallery file, read only"
+);
+PyObject* PyBobIpGaborMappedGallery_filename(PyBobIpGaborMappedGalleryObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("s", self->cxx->filename().c_str());
+BOB_CATCH_MEMBER("filename", 0)
+}
+
+static auto version_doc = bob::extension::VariableDoc(
+  "version",
+  "int",
+  "The version of the file format of the gallery file, read only"
+);
+PyObject* PyBobIpGaborMappedGallery_version(PyBobIpGaborMappedGalleryObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->version());
+BOB_CATCH_MEMBER("version", 0)
+}
+
+static auto size_doc = bob::extension::VariableDoc(
+  "size",
+  "int",
+  "The number of graphs in the gallery, read only",
+  "This is identical to the ``len`` of the gallery."
+);
+PyObject* PyBobIpGaborMappedGallery_size(PyBobIpGaborMappedGalleryObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->size());
+BOB_CATCH_MEMBER("size", 0)
+}
+
+static auto numberOfNodes_doc = bob::extension::VariableDoc(
+  "number_of_nodes",
+  "int",
+  "The number of nodes of each graph, read only"
+);
+PyObject* PyBobIpGaborMappedGallery_numberOfNodes(PyBobIpGaborMappedGalleryObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->numberOfNodes());
+BOB_CATCH_MEMBER("number_of_nodes", 0)
+}
+
+static auto length_doc = bob::extension::VariableDoc(
+  "length",
+  "int",
+  "The length of the Gabor jets, read only"
+);
+PyObject* PyBobIpGaborMappedGallery_length(PyBobIpGaborMappedGalleryObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->length());
+BOB_CATCH_MEMBER("length", 0)
+}
+
+static auto ids_doc = bob::extension::VariableDoc(
+  "ids",
+  "array_like (1D, int64)",
+  "The ids of the graphs, read only"
+);
+PyObject* PyBobIpGaborMappedGallery_ids(PyBobIpGaborMappedGalleryObject* self, void*){
+BOB_TRY
+  return mapped_array(self, self->cxx->ids());
+BOB_CATCH_MEMBER("ids", 0)
+}
+
+static auto nodes_doc = bob::extension::VariableDoc(
+  "nodes",
+  "[(int, int)] or ``None``",
+  "The node positions of the graphs, if they were written to the file, read only"
+);
+PyObject* PyBobIpGaborMappedGallery_nodes(PyBobIpGaborMappedGalleryObject* self, void*){
+BOB_TRY
+  const auto& nodes = self->cxx->nodes();
+  if (nodes.empty()) Py_RETURN_NONE;
+  PyObject* list = PyList_New(nodes.size());
+  if (!list) return 0;
+  auto list_ = make_safe(list);
+  for (std::size_t i = 0; i < nodes.size(); ++i)
+    PyList_SET_ITEM(list, i, Py_BuildValue("(ii)", nodes[i][0], nodes[i][1]));
+  return Py_BuildValue("O", list);
+BOB_CATCH_MEMBER("nodes", 0)
+}
+
+static auto graphs_doc = bob::extension::VariableDoc(
+  "graphs",
+  "array_like (4D, float)",
+  "The Gabor jets of all graphs, of shape ``(size, number_of_nodes, 2, length)``, read only",
+  "The array points into the mapped file, which stays mapped as long as the array exists. "
+  "It can be passed to :py:meth:`Similarity.similarities` as the ``gallery``."
+);
+PyObject* PyBobIpGaborMappedGallery_graphs(PyBobIpGaborMappedGalleryObject* self, void*){
+BOB_TRY
+  return mapped_array(self, self->cxx->graphs());
+BOB_CATCH_MEMBER("graphs", 0)
+}
+
+static auto jets_doc = bob::extension::VariableDoc(
+  "jets",
+  "array_like (3D, float)",
+  "The Gabor jets of all graphs, of shape ``(size * number_of_nodes, 2, length)``, read only",
+  "This is the same data as in :py:attr:`graphs`, in the shape of a list of Gabor jets."
+);
+PyObject* PyBobIpGaborMappedGallery_jets(PyBobIpGaborMappedGalleryObject* self, void*){
+BOB_TRY
+  return mapped_array(self, self->cxx->jets());
+BOB_CATCH_MEMBER("jets", 0)
+}
+
+static auto quantized_doc = bob::extension::VariableDoc(
+  "quantized",
+  "array_like (3D, uint16) or ``None``",
+  "The quantized Gabor jets of all graphs, of shape ``(size * number_of_nodes, 2, length)``, if they were written to the file, read only",
+  "The array points into the mapped file, and it can be passed to :py:meth:`FixedPointSimilarity.similarities` as the ``gallery``."
+);
+PyObject* PyBobIpGaborMappedGallery_quantized(PyBobIpGaborMappedGalleryObject* self, void*){
+BOB_TRY
+  if (!self->cxx->hasQuantized()) Py_RETURN_NONE;
+  return mapped_array(self, self->cxx->quantized());
+BOB_CATCH_MEMBER("quantized", 0)
+}
+
+static PyGetSetDef PyBobIpGaborMappedGallery_getseters[] = {
+  {
+    filename_doc.name(),
+    (getter)PyBobIpGaborMappedGallery_filename,
+    0,
+    filename_doc.doc(),
+    0
+  },
+  {
+    version_doc.name(),
+    (getter)PyBobIpGaborMappedGallery_version,
+    0,
+    version_doc.doc(),
+    0
+  },
+  {
+    size_doc.name(),
+    (getter)PyBobIpGaborMappedGallery_size,
+    0,
+    size_doc.doc(),
+    0
+  },
+  {
+    numberOfNodes_doc.name(),
+    (getter)PyBobIpGaborMappedGallery_numberOfNodes,
+    0,
+    numberOfNodes_doc.doc(),
+    0
+  },
+  {
+    length_doc.name(),
+    (getter)PyBobIpGaborMappedGallery_length,
+    0,
+    length_doc.doc(),
+    0
+  },
+  {
+    ids_doc.name(),
+    (getter)PyBobIpGaborMappedGallery_ids,
+    0,
+    ids_doc.doc(),
+    0
+  },
+  {
+    nodes_doc.name(),
+    (getter)PyBobIpGaborMappedGallery_nodes,
+    0,
+    nodes_doc.doc(),
+    0
+  },
+  {
+    graphs_doc.name(),
+    (getter)PyBobIpGaborMappedGallery_graphs,
+    0,
+    graphs_doc.doc(),
+    0
+  },
+  {
+    jets_doc.name(),
+    (getter)PyBobIpGaborMappedGallery_jets,
+    0,
+    jets_doc.doc(),
+    0
+  },
+  {
+    quantized_doc.name(),
+    (getter)PyBobIpGaborMappedGallery_quantized,
+    0,
+    quantized_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto write_doc = bob::extension::FunctionDoc(
+  "write",
+  "Writes the given graphs to a gallery file",
+  "This is a static function, which writes the file that can be opened with the :py:class:`MappedGallery` constructor. "
+  "The graphs are given as the data of their Gabor jets; a list of graphs, each of which is a list of :py:class:`Jet`\\s, can be converted with ``numpy.array([[jet.jet for jet in graph] for graph in graphs])``.",
+  true
+)
+.add_prototype("filename, graphs, [ids], [nodes], [quantize]")
+.add_parameter("filename", "str", "The name of the gallery file to write")
+.add_parameter("graphs", "array_like (4D, float)", "The Gabor jets of the graphs, of shape ``(N, number_of_nodes, 2, length)``")
+.add_parameter("ids", "[int] or ``None``", "[Default: ``None``] The ids of the graphs; if not given, the graphs have the ids ``0, ..., N-1``")
+.add_parameter("nodes", "[(int, int)] or ``None``", "[Default: ``None``] The node positions of the graphs, e.g., :py:attr:`Graph.nodes`, which are written to the file, if given")
+.add_parameter("quantize", "bool", "[Default: ``False``] Should the graphs also be written quantized by :py:meth:`FixedPointSimilarity.quantize`?")
+;
+
+static PyObject* PyBobIpGaborMappedGallery_write(PyObject*, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = write_doc.kwlist();
+
+  const char* filename;
+  PyBlitzArrayObject* graphs;
+  PyObject* ids = 0,* nodes = 0,* quantize = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sO&|OOO", kwlist, &filename, &PyBlitzArray_Converter, &graphs, &ids, &nodes, &quantize)) return 0;
+  auto graphs_ = make_safe(graphs);
+
+  if (graphs->type_num != NPY_FLOAT64 || graphs->ndim != 4) {
+    PyErr_Format(PyExc_TypeError, "MappedGallery.write requires the `graphs' to be a 4D array of type float");
+    return 0;
+  }
+
+  std::vector<int64_t> id_list;
+  if (ids && ids != Py_None){
+    PyObject* iterator = PyObject_GetIter(ids);
+    if (!iterator) return 0;
+    auto iterator_ = make_safe(iterator);
+    while (PyObject* it = PyIter_Next(iterator)) {
+      auto it_ = make_safe(it);
+      const long long id = PyLong_AsLongLong(it);
+      if (id == -1 && PyErr_Occurred()) return 0;
+      id_list.push_back(id);
+    }
+    if (PyErr_Occurred()) return 0;
+  }
+
+  std::vector<blitz::TinyVector<int,2>> node_list;
+  if (nodes && nodes != Py_None){
+    PyObject* iterator = PyObject_GetIter(nodes);
+    if (!iterator) return 0;
+    auto iterator_ = make_safe(iterator);
+    while (PyObject* it = PyIter_Next(iterator)) {
+      auto it_ = make_safe(it);
+      blitz::TinyVector<int,2> node;
+      if (!PyArg_ParseTuple(it, "ii", &node[0], &node[1])){
+        PyErr_Format(PyExc_TypeError, "MappedGallery.write requires all elements of the `nodes' to be positions (y, x), but element %d isn't", (int)node_list.size());
+        return 0;
+      }
+      node_list.push_back(node);
+    }
+    if (PyErr_Occurred()) return 0;
+  }
+
+  bob::ip::gabor::MappedGallery::write(filename, *PyBlitzArrayCxx_AsBlitz<double,4>(graphs), id_list, node_list, quantize && PyObject_IsTrue(quantize));
+  Py_RETURN_NONE;
+BOB_CATCH_FUNCTION("MappedGallery.write", 0)
+}
+
+static auto similarities_doc = bob::extension::FunctionDoc(
+  "similarities",
+  "Computes the similarities between the given probe graph and all graphs of the gallery",
+  "This computes the same scores as :py:meth:`Similarity.similarities` with the :py:attr:`graphs`, directly on the mapped file.",
+  true
+)
+.add_prototype("similarity, probe, [scores], [number_of_threads]", "scores")
+.add_parameter("similarity", ":py:class:`bob.ip.gabor.Similarity`", "The similarity function to use")
+.add_parameter("probe", "[:py:class:`bob.ip.gabor.Jet`]", "The probe graph, which must have :py:attr:`number_of_nodes` Gabor jets of length :py:attr:`length`")
+.add_parameter("scores", "array_like (1D, float)", "[Default: ``None``] If given, the scores will be written into this array, which must be of shape ``(size,)``")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads, over which the gallery is distributed; ``0`` selects one thread per available core")
+.add_return("scores", "array_like (1D, float)", "The similarities between the probe and all gallery graphs")
+;
+
+static PyObject* PyBobIpGaborMappedGallery_similarities(PyBobIpGaborMappedGalleryObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = similarities_doc.kwlist();
+
+  PyBobIpGaborSimilarityObject* similarity;
+  PyObject* probe;
+  PyBlitzArrayObject* scores = 0;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O|O&i", kwlist, &PyBobIpGaborSimilarity_Type, &similarity, &probe, &PyBlitzArray_OutputConverter, &scores, &threads)) return 0;
+  auto scores_ = make_xsafe(scores);
+
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> jets;
+  PyObject* iterator = PyObject_GetIter(probe);
+  if (!iterator) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `probe' to be a list of bob.ip.gabor.Jet", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  auto iterator_ = make_safe(iterator);
+  while (PyObject* it = PyIter_Next(iterator)) {
+    auto it_ = make_safe(it);
+    if (!PyBobIpGaborJet_Check(it)){
+      PyErr_Format(PyExc_TypeError, "`%s' requires all elements of the `probe' to be of type bob.ip.gabor.Jet, but element %d isn't", Py_TYPE(self)->tp_name, (int)jets.size());
+      return 0;
+    }
+    jets.push_back(reinterpret_cast<PyBobIpGaborJetObject*>(it)->cxx);
+  }
+  if (PyErr_Occurred()) return 0;
+
+  if (scores){
+    if (scores->type_num != NPY_FLOAT64 || scores->ndim != 1) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `scores' to be a 1D array of type float", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[] = {self->cxx->size()};
+    scores = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, osize);
+    scores_ = make_safe(scores);
+  }
+
+  // the C++ objects stay alive while the global interpreter lock is released
+  auto gallery = self->cxx;
+  auto sim = similarity->cxx;
+  auto& blitz_scores = *PyBlitzArrayCxx_AsBlitz<double,1>(scores);
+  if (!without_gil([&](){gallery->similarities(*sim, jets, blitz_scores, threads);})) return 0;
+  return PyBlitzArray_AsNumpyArray(scores, 0);
+BOB_CATCH_MEMBER("similarities", 0)
+}
+
+static PyMethodDef PyBobIpGaborMappedGallery_methods[] = {
+  {
+    write_doc.name(),
+    (PyCFunction)PyBobIpGaborMappedGallery_write,
+    METH_VARARGS|METH_KEYWORDS|METH_STATIC,
+    write_doc.doc()
+  },
+  {
+    similarities_doc.name(),
+    (PyCFunction)PyBobIpGaborMappedGallery_similarities,
+    METH_VARARGS|METH_KEYWORDS,
+    similarities_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the MappedGallery type struct; will be initialized later
+PyTypeObject PyBobIpGaborMappedGallery_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+static PySequenceMethods PyBobIpGaborMappedGallery_sequence = {
+  (lenfunc)PyBobIpGaborMappedGallery_len
+};
+
+bool init_BobIpGaborMappedGallery(PyObject* module)
+{
+
+  // initialize the MappedGallery type struct
+  PyBobIpGaborMappedGallery_Type.tp_name = MappedGallery_doc.name();
+  PyBobIpGaborMappedGallery_Type.tp_basicsize = sizeof(PyBobIpGaborMappedGalleryObject);
+  PyBobIpGaborMappedGallery_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborMappedGallery_Type.tp_doc = MappedGallery_doc.doc();
+
+  // set the functions
+  PyBobIpGaborMappedGallery_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborMappedGallery_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborMappedGallery_init);
+  PyBobIpGaborMappedGallery_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborMappedGallery_delete);
+  PyBobIpGaborMappedGallery_Type.tp_methods = PyBobIpGaborMappedGallery_methods;
+  PyBobIpGaborMappedGallery_Type.tp_getset = PyBobIpGaborMappedGallery_getseters;
+  PyBobIpGaborMappedGallery_Type.tp_as_sequence = &PyBobIpGaborMappedGallery_sequence;
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborMappedGallery_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborMappedGallery_Type);
+  return PyModule_AddObject(module, "MappedGallery", (PyObject*)&PyBobIpGaborMappedGallery_Type) >= 0;
+}
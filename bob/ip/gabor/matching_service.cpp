@@ -0,0 +1,408 @@
+/**
+ * @date Sat Oct 17 23:41:12 UTC 2026
+ *
+ * @brief Bindings for the matching server and client
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.extension/documentation.h>
+
+#include "gil.h"
+
+// converts the given iterable of Gabor jets into a graph; returns false on error
+static bool get_graph(PyObject* self, PyObject* graph, const char* name, std::vector<boost::shared_ptr<bob::ip::gabor::Jet>>& jets){
+  PyObject* iterator = PyObject_GetIter(graph);
+  if (!iterator) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `%s' to be a list of bob.ip.gabor.Jet", Py_TYPE(self)->tp_name, name);
+    return false;
+  }
+  auto iterator_ = make_safe(iterator);
+  while (PyObject* it = PyIter_Next(iterator)) {
+    auto it_ = make_safe(it);
+    if (!PyBobIpGaborJet_Check(it)){
+      PyErr_Format(PyExc_TypeError, "`%s' requires all elements of the `%s' to be of type bob.ip.gabor.Jet, but element %d isn't", Py_TYPE(self)->tp_name, name, (int)jets.size());
+      return false;
+    }
+    jets.push_back(reinterpret_cast<PyBobIpGaborJetObject*>(it)->cxx);
+  }
+  return !PyErr_Occurred();
+}
+
+
+/******************************************************************/
+/************ MatchingServer **************************************/
+/******************************************************************/
+
+static auto MatchingServer_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".MatchingServer",
+  "Answers search queries on a gallery index over a Unix domain socket",
+  "A single Python process that holds a very large gallery is limited by its memory and by the global interpreter lock. "
+  "Instead, the gallery can be split into shards, i.e., several :py:class:`GalleryIndex` files, and each shard is served by its own process, see the ``bob_ip_gabor_matching_server.py`` script. "
+  "The :py:class:`MatchingClient` sends the queries to all servers and merges their results.\n\n"
+  "The socket is bound when the server is constructed, so that clients can connect immediately; the queries are answered while :py:meth:`serve` is running. "
+  "Each connection is handled in its own thread, and the global interpreter lock is released while serving."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates a server for the given gallery index, listening on the given socket path",
+    "An existing socket at the ``socket_path`` is replaced, while any other existing file raises a :py:class:`RuntimeError`. "
+    "The socket is removed when the server is deleted, unless another server has replaced it meanwhile.",
+    true
+  )
+  .add_prototype("index, socket_path, [number_of_threads]", "")
+  .add_parameter("index", ":py:class:`bob.ip.gabor.GalleryIndex`", "The gallery index to search")
+  .add_parameter("socket_path", "str", "The path of the Unix domain socket")
+  .add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads used in each search; ``0`` selects one thread per available core")
+);
+
+static int PyBobIpGaborMatchingServer_init(PyBobIpGaborMatchingServerObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = MatchingServer_doc.kwlist();
+
+  PyBobIpGaborGalleryIndexObject* index;
+  const char* path;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!s|i", kwlist, &PyBobIpGaborGalleryIndex_Type, &index, &path, &threads)) return -1;
+
+  self->cxx.reset(new bob::ip::gabor::MatchingServer(index->cxx, path, threads));
+  return 0;
+BOB_CATCH_MEMBER("MatchingServer constructor", -1)
+}
+
+static void PyBobIpGaborMatchingServer_delete(PyBobIpGaborMatchingServerObject* self) {
+  // stopping the server might wait for running requests
+  Py_BEGIN_ALLOW_THREADS
+  self->cxx.reset();
+  Py_END_ALLOW_THREADS
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborMatchingServer_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborMatchingServer_Type));
+}
+
+static auto socketPath_doc = bob::extension::VariableDoc(
+  "socket_path",
+  "str",
+  "The path of the Unix domain socket, read only"
+);
+PyObject* PyBobIpGaborMatchingServer_socketPath(PyBobIpGaborMatchingServerObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("s", self->cxx->socket_path().c_str());
+BOB_CATCH_MEMBER("socket_path", 0)
+}
+
+static auto index_doc = bob::extension::VariableDoc(
+  "index",
+  ":py:class:`bob.ip.gabor.GalleryIndex`",
+  "The gallery index that is searched, read only"
+);
+PyObject* PyBobIpGaborMatchingServer_index(PyBobIpGaborMatchingServerObject* self, void*){
+BOB_TRY
+  PyBobIpGaborGalleryIndexObject* index = (PyBobIpGaborGalleryIndexObject*)PyBobIpGaborGalleryIndex_Type.tp_alloc(&PyBobIpGaborGalleryIndex_Type, 0);
+  index->cxx = self->cxx->index();
+  return Py_BuildValue("N", index);
+BOB_CATCH_MEMBER("index", 0)
+}
+
+static PyGetSetDef PyBobIpGaborMatchingServer_getseters[] = {
+  {
+    socketPath_doc.name(),
+    (getter)PyBobIpGaborMatchingServer_socketPath,
+    0,
+    socketPath_doc.doc(),
+    0
+  },
+  {
+    index_doc.name(),
+    (getter)PyBobIpGaborMatchingServer_index,
+    0,
+    index_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+static auto serve_doc = bob::extension::FunctionDoc(
+  "serve",
+  "Answers the queries of all clients until :py:meth:`stop` is called",
+  "This function blocks, but it releases the global interpreter lock, so that it can be run in a separate Python thread.",
+  true
+)
+.add_prototype("")
+;
+
+static PyObject* PyBobIpGaborMatchingServer_serve(PyBobIpGaborMatchingServerObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = serve_doc.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+
+  auto server = self->cxx;
+  if (!without_gil([server](){server->serve();})) return 0;
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("serve", 0)
+}
+
+static auto stop_doc = bob::extension::FunctionDoc(
+  "stop",
+  "Stops :py:meth:`serve` and closes all connections",
+  "This function can be called from any thread, e.g., from a signal handler; it waits until all running requests are finished.",
+  true
+)
+.add_prototype("")
+;
+
+static PyObject* PyBobIpGaborMatchingServer_stop(PyBobIpGaborMatchingServerObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = stop_doc.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+
+  auto server = self->cxx;
+  if (!without_gil([server](){server->stop();})) return 0;
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("stop", 0)
+}
+
+static PyMethodDef PyBobIpGaborMatchingServer_methods[] = {
+  {
+    serve_doc.name(),
+    (PyCFunction)PyBobIpGaborMatchingServer_serve,
+    METH_VARARGS|METH_KEYWORDS,
+    serve_doc.doc()
+  },
+  {
+    stop_doc.name(),
+    (PyCFunction)PyBobIpGaborMatchingServer_stop,
+    METH_VARARGS|METH_KEYWORDS,
+    stop_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ MatchingClient **************************************/
+/******************************************************************/
+
+static auto MatchingClient_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".MatchingClient",
+  "Sends search queries to several matching servers and merges their results",
+  "Each :py:class:`MatchingServer` usually serves one shard of a large gallery. "
+  "The client sends each query to all servers in parallel, without holding the global interpreter lock, and merges the results as :py:meth:`GalleryIndex.search` would do for the complete gallery. "
+  "The client can be used by several Python threads at the same time."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Connects to the matching servers at the given socket paths",
+    0,
+    true
+  )
+  .add_prototype("socket_paths", "")
+  .add_parameter("socket_paths", "[str]", "The paths of the Unix domain sockets of all servers")
+);
+
+static int PyBobIpGaborMatchingClient_init(PyBobIpGaborMatchingClientObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = MatchingClient_doc.kwlist();
+
+  PyObject* paths;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &paths)) return -1;
+
+  std::vector<std::string> socket_paths;
+  PyObject* iterator = PyObject_GetIter(paths);
+  if (!iterator) return -1;
+  auto iterator_ = make_safe(iterator);
+  while (PyObject* it = PyIter_Next(iterator)) {
+    auto it_ = make_safe(it);
+    const char* path;
+    if (!PyArg_Parse(it, "s", &path)){
+      PyErr_Format(PyExc_TypeError, "`%s' requires all elements of the `socket_paths' to be strings, but element %d isn't", Py_TYPE(self)->tp_name, (int)socket_paths.size());
+      return -1;
+    }
+    socket_paths.push_back(path);
+  }
+  if (PyErr_Occurred()) return -1;
+
+  self->cxx.reset(new bob::ip::gabor::MatchingClient(socket_paths));
+  return 0;
+BOB_CATCH_MEMBER("MatchingClient constructor", -1)
+}
+
+static void PyBobIpGaborMatchingClient_delete(PyBobIpGaborMatchingClientObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborMatchingClient_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborMatchingClient_Type));
+}
+
+static Py_ssize_t PyBobIpGaborMatchingClient_len(PyBobIpGaborMatchingClientObject* self) {
+  long size = 0;
+  auto client = self->cxx;
+  if (!without_gil([client, &size](){size = client->size();})) return -1;
+  return size;
+}
+
+static auto numberOfShards_doc = bob::extension::VariableDoc(
+  "number_of_shards",
+  "int",
+  "The number of servers, read only"
+);
+PyObject* PyBobIpGaborMatchingClient_numberOfShards(PyBobIpGaborMatchingClientObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->numberOfShards());
+BOB_CATCH_MEMBER("number_of_shards", 0)
+}
+
+static PyGetSetDef PyBobIpGaborMatchingClient_getseters[] = {
+  {
+    numberOfShards_doc.name(),
+    (getter)PyBobIpGaborMatchingClient_numberOfShards,
+    0,
+    numberOfShards_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+static auto search_doc = bob::extension::FunctionDoc(
+  "search",
+  "Returns the ``k`` graphs of all servers that are most similar to the given probe graph",
+  "The results are sorted by descending score; results with identical scores are sorted by ascending id. "
+  "The ``len`` of the client is the total number of graphs of all servers.\n\n"
+  ".. note::\n\n  The function :py:func:`__call__` is a synonym for this function.",
+  true
+)
+.add_prototype("probe, k, [id_ranges]", "results")
+.add_parameter("probe", "[:py:class:`bob.ip.gabor.Jet`]", "The Gabor jets of the probe graph")
+.add_parameter("k", "int", "The maximum number of results to return")
+.add_parameter("id_ranges", "[(int, int)] or ``None``", "[Default: ``None``] If given, only graphs with ids in these inclusive ranges are considered")
+.add_return("results", "[(int, float)]", "The ids and scores of the (up to) ``k`` most similar graphs")
+;
+
+static PyObject* PyBobIpGaborMatchingClient_search(PyBobIpGaborMatchingClientObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = search_doc.kwlist();
+
+  PyObject* probe,* ranges = 0;
+  int k;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "Oi|O", kwlist, &probe, &k, &ranges)) return 0;
+
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> jets;
+  if (!get_graph((PyObject*)self, probe, "probe", jets)) return 0;
+
+  std::vector<bob::ip::gabor::GalleryIndex::Range> id_ranges;
+  if (ranges && ranges != Py_None){
+    PyObject* iterator = PyObject_GetIter(ranges);
+    if (!iterator) return 0;
+    auto iterator_ = make_safe(iterator);
+    while (PyObject* it = PyIter_Next(iterator)) {
+      auto it_ = make_safe(it);
+      long first, last;
+      if (!PyArg_ParseTuple(it, "ll", &first, &last)){
+        PyErr_Format(PyExc_TypeError, "`%s' requires all elements of the `id_ranges' to be tuples of two integers, but element %d isn't", Py_TYPE(self)->tp_name, (int)id_ranges.size());
+        return 0;
+      }
+      id_ranges.push_back(std::make_pair(first, last));
+    }
+    if (PyErr_Occurred()) return 0;
+  }
+
+  std::vector<bob::ip::gabor::GalleryIndex::Result> results;
+  auto client = self->cxx;
+  if (!without_gil([&](){client->search(jets, k, results, id_ranges);})) return 0;
+
+  PyObject* list = PyList_New(results.size());
+  if (!list) return 0;
+  for (Py_ssize_t i = 0; i < (Py_ssize_t)results.size(); ++i)
+    PyList_SET_ITEM(list, i, Py_BuildValue("(ld)", results[i].second, results[i].first));
+  return list;
+BOB_CATCH_MEMBER("search", 0)
+}
+
+static PyMethodDef PyBobIpGaborMatchingClient_methods[] = {
+  {
+    search_doc.name(),
+    (PyCFunction)PyBobIpGaborMatchingClient_search,
+    METH_VARARGS|METH_KEYWORDS,
+    search_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the MatchingServer and MatchingClient type structs; will be initialized later
+PyTypeObject PyBobIpGaborMatchingServer_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+PyTypeObject PyBobIpGaborMatchingClient_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+static PySequenceMethods PyBobIpGaborMatchingClient_sequence = {
+  (lenfunc)PyBobIpGaborMatchingClient_len
+};
+
+bool init_BobIpGaborMatchingServer(PyObject* module)
+{
+
+  // initialize the MatchingServer type struct
+  PyBobIpGaborMatchingServer_Type.tp_name = MatchingServer_doc.name();
+  PyBobIpGaborMatchingServer_Type.tp_basicsize = sizeof(PyBobIpGaborMatchingServerObject);
+  PyBobIpGaborMatchingServer_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborMatchingServer_Type.tp_doc = MatchingServer_doc.doc();
+
+  // set the functions
+  PyBobIpGaborMatchingServer_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborMatchingServer_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborMatchingServer_init);
+  PyBobIpGaborMatchingServer_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborMatchingServer_delete);
+  PyBobIpGaborMatchingServer_Type.tp_methods = PyBobIpGaborMatchingServer_methods;
+  PyBobIpGaborMatchingServer_Type.tp_getset = PyBobIpGaborMatchingServer_getseters;
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborMatchingServer_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborMatchingServer_Type);
+  return PyModule_AddObject(module, "MatchingServer", (PyObject*)&PyBobIpGaborMatchingServer_Type) >= 0;
+}
+
+bool init_BobIpGaborMatchingClient(PyObject* module)
+{
+
+  // initialize the MatchingClient type struct
+  PyBobIpGaborMatchingClient_Type.tp_name = MatchingClient_doc.name();
+  PyBobIpGaborMatchingClient_Type.tp_basicsize = sizeof(PyBobIpGaborMatchingClientObject);
+  PyBobIpGaborMatchingClient_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborMatchingClient_Type.tp_doc = MatchingClient_doc.doc();
+
+  // set the functions
+  PyBobIpGaborMatchingClient_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborMatchingClient_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborMatchingClient_init);
+  PyBobIpGaborMatchingClient_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborMatchingClient_delete);
+  PyBobIpGaborMatchingClient_Type.tp_methods = PyBobIpGaborMatchingClient_methods;
+  PyBobIpGaborMatchingClient_Type.tp_getset = PyBobIpGaborMatchingClient_getseters;
+  PyBobIpGaborMatchingClient_Type.tp_as_sequence = &PyBobIpGaborMatchingClient_sequence;
+  PyBobIpGaborMatchingClient_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobIpGaborMatchingClient_search);
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborMatchingClient_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborMatchingClient_Type);
+  return PyModule_AddObject(module, "MatchingClient", (PyObject*)&PyBobIpGaborMatchingClient_Type) >= 0;
+}
@@ -0,0 +1,518 @@
+/**
+ * @date Sat Oct 17 23:02:54 UTC 2026
+ *
+ * @brief Bindings for the product quantization index
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.io.base/api.h>
+#include <bob.extension/documentation.h>
+
+#include "gil.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto QuantizedIndex_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".QuantizedIndex",
+  "Approximate nearest neighbor search of Gabor jets using product quantization",
+  "For very large galleries, computing the exact similarity between a probe and all stored Gabor jets is too slow, and storing all jets requires too much memory. "
+  "This index converts each Gabor jet into a vector, which contains either the absolute values (``'Absolute'``) or the real and imaginary parts (``'Cartesian'``) of the jet. "
+  "The vector is split into :py:attr:`number_of_subspaces` sub-vectors of equal length, and each sub-vector is replaced by the index of the closest of :py:attr:`number_of_centroids` centroids, which are trained with k-means. "
+  "Hence, each stored jet requires only :py:attr:`number_of_subspaces` bytes.\n\n"
+  "During :py:meth:`search`, the squared distances between the probe sub-vectors and all centroids are computed once (see :py:meth:`distance_table`), and the approximate distance to each stored jet is the sum of the table entries of its codes. "
+  "The approximate results can be re-ranked with the exact :py:class:`bob.ip.gabor.Similarity` to the original jets, where the number of ``candidates`` controls the trade-off between recall and speed."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates an untrained index, or loads an index from file",
+    0,
+    true
+  )
+  .add_prototype("[number_of_subspaces], [number_of_centroids], [space]", "")
+  .add_prototype("hdf5", "")
+  .add_parameter("number_of_subspaces", "int", "[Default: ``8``] The number of sub-vectors, which must divide the length of the jet vectors")
+  .add_parameter("number_of_centroids", "int", "[Default: ``256``] The number of centroids per sub-vector, at most 256")
+  .add_parameter("space", "str", "[Default: ``'Absolute'``] The space, in which the jets are quantized; possible values are ``'Absolute'`` and ``'Cartesian'``")
+  .add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading to load the index from")
+);
+
+static int PyBobIpGaborQuantizedIndex_init(PyBobIpGaborQuantizedIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist1 = QuantizedIndex_doc.kwlist(1);
+  char** kwlist2 = QuantizedIndex_doc.kwlist(0);
+
+  // two ways to call
+  PyObject* k = Py_BuildValue("s", kwlist1[0]);
+  auto k_ = make_safe(k);
+  if (
+    (kwargs && PyDict_Contains(kwargs, k)) ||
+    (args && PyTuple_Size(args) == 1 && PyBobIoHDF5File_Check(PyTuple_GetItem(args, 0)))
+  ){
+    PyBobIoHDF5FileObject* hdf5;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist1, &PyBobIoHDF5File_Converter, &hdf5)) return -1;
+
+    auto hdf5_ = make_safe(hdf5);
+    self->cxx.reset(new bob::ip::gabor::QuantizedIndex(*hdf5->f));
+  } else {
+    int subspaces = 8, centroids = 256;
+    const char* space = "Absolute";
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|iis", kwlist2, &subspaces, &centroids, &space)) return -1;
+    self->cxx.reset(new bob::ip::gabor::QuantizedIndex(subspaces, centroids, bob::ip::gabor::QuantizedIndex::name_to_space(space)));
+  }
+  return 0;
+BOB_CATCH_MEMBER("QuantizedIndex constructor", -1)
+}
+
+static void PyBobIpGaborQuantizedIndex_delete(PyBobIpGaborQuantizedIndexObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborQuantizedIndex_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborQuantizedIndex_Type));
+}
+
+static Py_ssize_t PyBobIpGaborQuantizedIndex_len(PyBobIpGaborQuantizedIndexObject* self) {
+  return self->cxx->size();
+}
+
+// checks that the given array is a 3D array of type float; returns false on error
+static bool check_jets(PyBobIpGaborQuantizedIndexObject* self, PyBlitzArrayObject* jets, const char* name){
+  if (jets->type_num != NPY_FLOAT64 || jets->ndim != 3) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `%s' to be a 3D array of type float", Py_TYPE(self)->tp_name, name);
+    return false;
+  }
+  return true;
+}
+
+// converts the results into a list of (index, value) tuples
+static PyObject* results_to_list(const std::vector<bob::ip::gabor::QuantizedIndex::Result>& results){
+  PyObject* list = PyList_New(results.size());
+  if (!list) return 0;
+  for (Py_ssize_t i = 0; i < (Py_ssize_t)results.size(); ++i)
+    PyList_SET_ITEM(list, i, Py_BuildValue("(id)", results[i].second, results[i].first));
+  return list;
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto space_doc = bob::extension::VariableDoc(
+  "space",
+  "str",
+  "The space, in which the jets are quantized, i.e., ``'Absolute'`` or ``'Cartesian'``, read only"
+);
+PyObject* PyBobIpGaborQuantizedIndex_space(PyBobIpGaborQuantizedIndexObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("s", bob::ip::gabor::QuantizedIndex::space_to_name(self->cxx->space()).c_str());
+BOB_CATCH_MEMBER("space", 0)
+}
+
+static auto numberOfSubspaces_doc = bob::extension::VariableDoc(
+  "number_of_subspaces",
+  "int",
+  "The number of sub-vectors, i.e., the number of bytes per stored jet, read only"
+);
+PyObject* PyBobIpGaborQuantizedIndex_numberOfSubspaces(PyBobIpGaborQuantizedIndexObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->numberOfSubspaces());
+BOB_CATCH_MEMBER("number_of_subspaces", 0)
+}
+
+static auto numberOfCentroids_doc = bob::extension::VariableDoc(
+  "number_of_centroids",
+  "int",
+  "The number of centroids per sub-vector, read only"
+);
+PyObject* PyBobIpGaborQuantizedIndex_numberOfCentroids(PyBobIpGaborQuantizedIndexObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->numberOfCentroids());
+BOB_CATCH_MEMBER("number_of_centroids", 0)
+}
+
+static auto length_doc = bob::extension::VariableDoc(
+  "length",
+  "int",
+  "The length of the Gabor jets, which is defined during :py:meth:`train`; ``0`` for untrained indices, read only"
+);
+PyObject* PyBobIpGaborQuantizedIndex_length(PyBobIpGaborQuantizedIndexObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("i", self->cxx->length());
+BOB_CATCH_MEMBER("length", 0)
+}
+
+static auto centroids_doc = bob::extension::VariableDoc(
+  "centroids",
+  "array_like (float, 3D)",
+  "The trained centroids of shape ``(number_of_subspaces, number_of_centroids, sub-vector length)``, read only"
+);
+PyObject* PyBobIpGaborQuantizedIndex_centroids(PyBobIpGaborQuantizedIndexObject* self, void*){
+BOB_TRY
+  return PyBlitzArrayCxx_AsConstNumpy(self->cxx->centroids());
+BOB_CATCH_MEMBER("centroids", 0)
+}
+
+static auto codes_doc = bob::extension::VariableDoc(
+  "codes",
+  "array_like (uint8, 2D)",
+  "A copy of the codes of all stored jets, of shape ``(len(self), number_of_subspaces)``, read only"
+);
+PyObject* PyBobIpGaborQuantizedIndex_codes(PyBobIpGaborQuantizedIndexObject* self, void*){
+BOB_TRY
+  return PyBlitzArrayCxx_AsNumpy(self->cxx->codes());
+BOB_CATCH_MEMBER("codes", 0)
+}
+
+static PyGetSetDef PyBobIpGaborQuantizedIndex_getseters[] = {
+  {
+    space_doc.name(),
+    (getter)PyBobIpGaborQuantizedIndex_space,
+    0,
+    space_doc.doc(),
+    0
+  },
+  {
+    numberOfSubspaces_doc.name(),
+    (getter)PyBobIpGaborQuantizedIndex_numberOfSubspaces,
+    0,
+    numberOfSubspaces_doc.doc(),
+    0
+  },
+  {
+    numberOfCentroids_doc.name(),
+    (getter)PyBobIpGaborQuantizedIndex_numberOfCentroids,
+    0,
+    numberOfCentroids_doc.doc(),
+    0
+  },
+  {
+    length_doc.name(),
+    (getter)PyBobIpGaborQuantizedIndex_length,
+    0,
+    length_doc.doc(),
+    0
+  },
+  {
+    centroids_doc.name(),
+    (getter)PyBobIpGaborQuantizedIndex_centroids,
+    0,
+    centroids_doc.doc(),
+    0
+  },
+  {
+    codes_doc.name(),
+    (getter)PyBobIpGaborQuantizedIndex_codes,
+    0,
+    codes_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto train_doc = bob::extension::FunctionDoc(
+  "train",
+  "Trains the codebooks of all sub-vectors with k-means",
+  "The centroids are initialized with randomly selected training jets, where the random selection depends on ``seed`` and the index of the sub-vector only, so that the result does not depend on the ``number_of_threads``. "
+  "All jets that are stored in the index are removed.",
+  true
+)
+.add_prototype("jets, [iterations], [seed], [number_of_threads]")
+.add_parameter("jets", "array_like (float, 3D)", "The training jets, stored contiguously in shape ``(N, 2, length)``, where ``N`` must be at least :py:attr:`number_of_centroids`")
+.add_parameter("iterations", "int", "[Default: ``20``] The maximum number of k-means iterations")
+.add_parameter("seed", "int", "[Default: ``0``] The seed for the random initialization of the centroids")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads, over which the sub-vectors are distributed; ``0`` selects one thread per available core")
+;
+
+static PyObject* PyBobIpGaborQuantizedIndex_train(PyBobIpGaborQuantizedIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = train_doc.kwlist();
+
+  PyBlitzArrayObject* jets;
+  int iterations = 20, threads = 1;
+  unsigned seed = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|iIi", kwlist, &PyBlitzArray_Converter, &jets, &iterations, &seed, &threads)) return 0;
+
+  auto jets_ = make_safe(jets);
+  if (!check_jets(self, jets, "jets")) return 0;
+
+  self->cxx->train(*PyBlitzArrayCxx_AsBlitz<double,3>(jets), iterations, seed, threads);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("train", 0)
+}
+
+static auto add_doc = bob::extension::FunctionDoc(
+  "add",
+  "Encodes the given jets and appends them to the index",
+  "The index of a stored jet is its position in the order in which the jets were added, starting with ``0``. "
+  "For re-ranking with the exact similarity, the same jets need to be kept in a gallery array in the same order.",
+  true
+)
+.add_prototype("jets, [number_of_threads]")
+.add_parameter("jets", "array_like (float, 3D)", "The jets to add, stored contiguously in shape ``(N, 2, length)``")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads to use; ``0`` selects one thread per available core")
+;
+
+static PyObject* PyBobIpGaborQuantizedIndex_add(PyBobIpGaborQuantizedIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = add_doc.kwlist();
+
+  PyBlitzArrayObject* jets;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|i", kwlist, &PyBlitzArray_Converter, &jets, &threads)) return 0;
+
+  auto jets_ = make_safe(jets);
+  if (!check_jets(self, jets, "jets")) return 0;
+
+  // the C++ objects stay alive while the global interpreter lock is released
+  auto index = self->cxx;
+  auto& blitz_jets = *PyBlitzArrayCxx_AsBlitz<double,3>(jets);
+  if (!without_gil([&](){index->add(blitz_jets, threads);})) return 0;
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("add", 0)
+}
+
+static auto clear_doc = bob::extension::FunctionDoc(
+  "clear",
+  "Removes all stored jets, but keeps the trained codebooks",
+  0,
+  true
+)
+.add_prototype("")
+;
+
+static PyObject* PyBobIpGaborQuantizedIndex_clear(PyBobIpGaborQuantizedIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = clear_doc.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+
+  self->cxx->clear();
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("clear", 0)
+}
+
+static auto distanceTable_doc = bob::extension::FunctionDoc(
+  "distance_table",
+  "Computes the squared distances between the sub-vectors of the probe and all centroids",
+  0,
+  true
+)
+.add_prototype("probe", "table")
+.add_parameter("probe", ":py:class:`bob.ip.gabor.Jet`", "The probe Gabor jet")
+.add_return("table", "array_like (float, 2D)", "The distance table of shape ``(number_of_subspaces, number_of_centroids)``")
+;
+
+static PyObject* PyBobIpGaborQuantizedIndex_distanceTable(PyBobIpGaborQuantizedIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = distanceTable_doc.kwlist();
+
+  PyBobIpGaborJetObject* probe;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", kwlist, &PyBobIpGaborJet_Type, &probe)) return 0;
+
+  blitz::Array<double,2> table(self->cxx->numberOfSubspaces(), self->cxx->numberOfCentroids());
+  self->cxx->distance_table(*probe->cxx, table);
+  return PyBlitzArrayCxx_AsNumpy(table);
+BOB_CATCH_MEMBER("distance_table", 0)
+}
+
+static auto search_doc = bob::extension::FunctionDoc(
+  "search",
+  "Finds the stored jets that are closest to the given probe jet",
+  "Without a ``gallery``, the ``k`` stored jets with the smallest approximate squared distances are returned, sorted by ascending distance.\n\n"
+  "When the ``gallery`` (containing the original jets in the order in which they were added) and a ``similarity`` are given, the approximate search selects ``candidates`` jets, which are re-ranked with the exact similarity. "
+  "Then, the ``k`` jets with the highest similarities are returned, sorted by descending similarity. "
+  "More candidates increase the chance that the true best jets are found, but require more exact similarity computations.\n\n"
+  ".. note::\n\n  The function :py:func:`__call__` is a synonym for this function.",
+  true
+)
+.add_prototype("probe, k, [gallery], [similarity], [candidates], [number_of_threads]", "results")
+.add_parameter("probe", ":py:class:`bob.ip.gabor.Jet`", "The probe Gabor jet")
+.add_parameter("k", "int", "The maximum number of results to return")
+.add_parameter("gallery", "array_like (float, 3D) or ``None``", "[Default: ``None``] The original jets of shape ``(len(self), 2, length)`` used for re-ranking")
+.add_parameter("similarity", ":py:class:`bob.ip.gabor.Similarity` or ``None``", "[Default: ``None``] The similarity function used for re-ranking; required when ``gallery`` is given")
+.add_parameter("candidates", "int", "[Default: ``10*k``] The number of approximate results that are re-ranked")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads to use; ``0`` selects one thread per available core")
+.add_return("results", "[(int, float)]", "The indices of the (up to) ``k`` best jets, together with their approximate squared distances or their exact similarities")
+;
+
+static PyObject* PyBobIpGaborQuantizedIndex_search(PyBobIpGaborQuantizedIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = search_doc.kwlist();
+
+  PyBobIpGaborJetObject* probe;
+  int k, candidates = -1, threads = 1;
+  PyBlitzArrayObject* gallery = 0;
+  PyObject* similarity = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!i|O&Oii", kwlist, &PyBobIpGaborJet_Type, &probe, &k, &PyBlitzArray_Converter, &gallery, &similarity, &candidates, &threads)) return 0;
+
+  auto gallery_ = make_xsafe(gallery);
+
+  std::vector<bob::ip::gabor::QuantizedIndex::Result> results;
+  if (gallery){
+    if (!check_jets(self, gallery, "gallery")) return 0;
+    if (!similarity || !PyBobIpGaborSimilarity_Check(similarity)){
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `similarity' to be of type bob.ip.gabor.Similarity when a `gallery' is given", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    if (candidates < 0) candidates = 10 * k;
+    // the C++ objects stay alive while the global interpreter lock is released
+    auto index = self->cxx;
+    auto jet = probe->cxx;
+    auto sim = reinterpret_cast<PyBobIpGaborSimilarityObject*>(similarity)->cxx;
+    auto& blitz_gallery = *PyBlitzArrayCxx_AsBlitz<double,3>(gallery);
+    if (!without_gil([&](){index->search(*jet, blitz_gallery, *sim, k, candidates, results, threads);})) return 0;
+  } else {
+    auto index = self->cxx;
+    auto jet = probe->cxx;
+    if (!without_gil([&](){index->search(*jet, k, results, threads);})) return 0;
+  }
+
+  return results_to_list(results);
+BOB_CATCH_MEMBER("search", 0)
+}
+
+static auto load_doc = bob::extension::FunctionDoc(
+  "load",
+  "Loads the codebooks and the codes of the index from the given HDF5 file",
+  0,
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file opened for reading")
+;
+
+static PyObject* PyBobIpGaborQuantizedIndex_load(PyBobIpGaborQuantizedIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = load_doc.kwlist();
+  PyBobIoHDF5FileObject* file;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &file)) return 0;
+
+  auto file_ = make_safe(file);
+  self->cxx->load(*file->f);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("load", 0)
+}
+
+static auto save_doc = bob::extension::FunctionDoc(
+  "save",
+  "Saves the codebooks and the codes of the index to the given HDF5 file",
+  0,
+  true
+)
+.add_prototype("hdf5")
+.add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for writing")
+;
+
+static PyObject* PyBobIpGaborQuantizedIndex_save(PyBobIpGaborQuantizedIndexObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = save_doc.kwlist();
+  PyBobIoHDF5FileObject* file;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&", kwlist, PyBobIoHDF5File_Converter, &file)) return 0;
+
+  auto file_ = make_safe(file);
+  self->cxx->save(*file->f);
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("save", 0)
+}
+
+
+static PyMethodDef PyBobIpGaborQuantizedIndex_methods[] = {
+  {
+    train_doc.name(),
+    (PyCFunction)PyBobIpGaborQuantizedIndex_train,
+    METH_VARARGS|METH_KEYWORDS,
+    train_doc.doc()
+  },
+  {
+    add_doc.name(),
+    (PyCFunction)PyBobIpGaborQuantizedIndex_add,
+    METH_VARARGS|METH_KEYWORDS,
+    add_doc.doc()
+  },
+  {
+    clear_doc.name(),
+    (PyCFunction)PyBobIpGaborQuantizedIndex_clear,
+    METH_VARARGS|METH_KEYWORDS,
+    clear_doc.doc()
+  },
+  {
+    distanceTable_doc.name(),
+    (PyCFunction)PyBobIpGaborQuantizedIndex_distanceTable,
+    METH_VARARGS|METH_KEYWORDS,
+    distanceTable_doc.doc()
+  },
+  {
+    search_doc.name(),
+    (PyCFunction)PyBobIpGaborQuantizedIndex_search,
+    METH_VARARGS|METH_KEYWORDS,
+    search_doc.doc()
+  },
+  {
+    load_doc.name(),
+    (PyCFunction)PyBobIpGaborQuantizedIndex_load,
+    METH_VARARGS|METH_KEYWORDS,
+    load_doc.doc()
+  },
+  {
+    save_doc.name(),
+    (PyCFunction)PyBobIpGaborQuantizedIndex_save,
+    METH_VARARGS|METH_KEYWORDS,
+    save_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the QuantizedIndex type struct; will be initialized later
+PyTypeObject PyBobIpGaborQuantizedIndex_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+static PySequenceMethods PyBobIpGaborQuantizedIndex_sequence = {
+  (lenfunc)PyBobIpGaborQuantizedIndex_len
+};
+
+bool init_BobIpGaborQuantizedIndex(PyObject* module)
+{
+
+  // initialize the QuantizedIndex type struct
+  PyBobIpGaborQuantizedIndex_Type.tp_name = QuantizedIndex_doc.name();
+  PyBobIpGaborQuantizedIndex_Type.tp_basicsize = sizeof(PyBobIpGaborQuantizedIndexObject);
+  PyBobIpGaborQuantizedIndex_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborQuantizedIndex_Type.tp_doc = QuantizedIndex_doc.doc();
+
+  // set the functions
+  PyBobIpGaborQuantizedIndex_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborQuantizedIndex_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborQuantizedIndex_init);
+  PyBobIpGaborQuantizedIndex_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborQuantizedIndex_delete);
+  PyBobIpGaborQuantizedIndex_Type.tp_methods = PyBobIpGaborQuantizedIndex_methods;
+  PyBobIpGaborQuantizedIndex_Type.tp_getset = PyBobIpGaborQuantizedIndex_getseters;
+  PyBobIpGaborQuantizedIndex_Type.tp_as_sequence = &PyBobIpGaborQuantizedIndex_sequence;
+  PyBobIpGaborQuantizedIndex_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobIpGaborQuantizedIndex_search);
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborQuantizedIndex_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborQuantizedIndex_Type);
+  return PyModule_AddObject(module, "QuantizedIndex", (PyObject*)&PyBobIpGaborQuantizedIndex_Type) >= 0;
+}
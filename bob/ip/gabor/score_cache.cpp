@@ -0,0 +1,398 @@
+/**
+ * @date Sat Oct 17 23:35:10 UTC 2026
+ *
+ * @brief Bindings for the cache of similarity scores
+ *
+ * Copyright (C) 2011-2014 Idiap Research Institute, Martigny, Switzerland
+ */
+
+#define BOB_IP_GABOR_MODULE
+#include <bob.ip.gabor/api.h>
+
+#include <bob.blitz/cppapi.h>
+#include <bob.blitz/cleanup.h>
+#include <bob.extension/documentation.h>
+
+#include "gil.h"
+
+/******************************************************************/
+/************ Constructor Section *********************************/
+/******************************************************************/
+
+static auto ScoreCache_doc = bob::extension::ClassDoc(
+  BOB_EXT_MODULE_PREFIX ".ScoreCache",
+  "Caches the scores of a similarity function for repeatedly compared Gabor jets and graphs",
+  "In verification workflows, the same pairs of probe and gallery graphs are often compared several times, e.g., for repeated claims or in several re-ranking passes. "
+  "This class stores the scores of the given :py:class:`Similarity` function, so that repeated comparisons become lookups.\n\n"
+  "Pairs are identified by 64 bit hashes of the contents of both Gabor jets or graphs, which are seeded with the configuration of the similarity function, i.e., its type, the wavelet frequencies and the mode of :py:func:`bob.ip.gabor.set_fast_math`. "
+  "Hence, the data of the jets can be modified between comparisons. "
+  "When more than :py:attr:`capacity` scores are stored, the least recently used scores are removed.\n\n"
+  "All functions can be called concurrently from several threads, and the cache keeps track of the number of :py:attr:`hits` and :py:attr:`misses`."
+).add_constructor(
+  bob::extension::FunctionDoc(
+    "__init__",
+    "Creates an empty cache for the given similarity function",
+    0,
+    true
+  )
+  .add_prototype("similarity, [capacity]", "")
+  .add_parameter("similarity", ":py:class:`bob.ip.gabor.Similarity`", "The similarity function, of which the scores are cached")
+  .add_parameter("capacity", "int", "[Default: ``100000``] The maximum number of cached scores")
+);
+
+static int PyBobIpGaborScoreCache_init(PyBobIpGaborScoreCacheObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = ScoreCache_doc.kwlist();
+
+  PyBobIpGaborSimilarityObject* similarity;
+  Py_ssize_t capacity = 100000;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|n", kwlist, &PyBobIpGaborSimilarity_Type, &similarity, &capacity)) return -1;
+
+  if (capacity <= 0){
+    PyErr_Format(PyExc_ValueError, "`%s' requires a positive `capacity', not %d", Py_TYPE(self)->tp_name, (int)capacity);
+    return -1;
+  }
+  self->cxx.reset(new bob::ip::gabor::ScoreCache(similarity->cxx, capacity));
+  return 0;
+BOB_CATCH_MEMBER("ScoreCache constructor", -1)
+}
+
+static void PyBobIpGaborScoreCache_delete(PyBobIpGaborScoreCacheObject* self) {
+  self->cxx.reset();
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+int PyBobIpGaborScoreCache_Check(PyObject* o) {
+  return PyObject_IsInstance(o, reinterpret_cast<PyObject*>(&PyBobIpGaborScoreCache_Type));
+}
+
+static Py_ssize_t PyBobIpGaborScoreCache_len(PyBobIpGaborScoreCacheObject* self) {
+  return self->cxx->size();
+}
+
+// converts the given iterable of Gabor jets into a graph; returns false on error
+static bool to_graph(PyBobIpGaborScoreCacheObject* self, PyObject* object, const char* name, std::vector<boost::shared_ptr<bob::ip::gabor::Jet>>& graph){
+  PyObject* iterator = PyObject_GetIter(object);
+  if (!iterator) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `%s' to be a bob.ip.gabor.Jet or a list of those", Py_TYPE(self)->tp_name, name);
+    return false;
+  }
+  auto iterator_ = make_safe(iterator);
+  while (PyObject* it = PyIter_Next(iterator)) {
+    auto it_ = make_safe(it);
+    if (!PyBobIpGaborJet_Check(it)){
+      PyErr_Format(PyExc_TypeError, "`%s' requires all elements of the `%s' to be of type bob.ip.gabor.Jet, but element %d isn't", Py_TYPE(self)->tp_name, name, (int)graph.size());
+      return false;
+    }
+    graph.push_back(reinterpret_cast<PyBobIpGaborJetObject*>(it)->cxx);
+  }
+  return !PyErr_Occurred();
+}
+
+
+/******************************************************************/
+/************ Variables Section ***********************************/
+/******************************************************************/
+
+static auto similarity_doc = bob::extension::VariableDoc(
+  "similarity",
+  ":py:class:`bob.ip.gabor.Similarity`",
+  "The similarity function, of which the scores are cached, read only"
+);
+PyObject* PyBobIpGaborScoreCache_similarity(PyBobIpGaborScoreCacheObject* self, void*){
+BOB_TRY
+  PyBobIpGaborSimilarityObject* similarity = (PyBobIpGaborSimilarityObject*)PyBobIpGaborSimilarity_Type.tp_alloc(&PyBobIpGaborSimilarity_Type, 0);
+  similarity->cxx = self->cxx->similarity();
+  return Py_BuildValue("N", similarity);
+BOB_CATCH_MEMBER("similarity", 0)
+}
+
+static auto capacity_doc = bob::extension::VariableDoc(
+  "capacity",
+  "int",
+  "The maximum number of cached scores, read only"
+);
+PyObject* PyBobIpGaborScoreCache_capacity(PyBobIpGaborScoreCacheObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("n", (Py_ssize_t)self->cxx->capacity());
+BOB_CATCH_MEMBER("capacity", 0)
+}
+
+static auto hits_doc = bob::extension::VariableDoc(
+  "hits",
+  "int",
+  "The number of scores that were found in the cache since the last call to :py:meth:`reset_statistics`, read only"
+);
+PyObject* PyBobIpGaborScoreCache_hits(PyBobIpGaborScoreCacheObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("l", self->cxx->hits());
+BOB_CATCH_MEMBER("hits", 0)
+}
+
+static auto misses_doc = bob::extension::VariableDoc(
+  "misses",
+  "int",
+  "The number of scores that needed to be computed since the last call to :py:meth:`reset_statistics`, read only"
+);
+PyObject* PyBobIpGaborScoreCache_misses(PyBobIpGaborScoreCacheObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("l", self->cxx->misses());
+BOB_CATCH_MEMBER("misses", 0)
+}
+
+static auto hitRate_doc = bob::extension::VariableDoc(
+  "hit_rate",
+  "float",
+  "The rate of scores that were found in the cache since the last call to :py:meth:`reset_statistics`, read only"
+);
+PyObject* PyBobIpGaborScoreCache_hitRate(PyBobIpGaborScoreCacheObject* self, void*){
+BOB_TRY
+  return Py_BuildValue("d", self->cxx->hit_rate());
+BOB_CATCH_MEMBER("hit_rate", 0)
+}
+
+static PyGetSetDef PyBobIpGaborScoreCache_getseters[] = {
+  {
+    similarity_doc.name(),
+    (getter)PyBobIpGaborScoreCache_similarity,
+    0,
+    similarity_doc.doc(),
+    0
+  },
+  {
+    capacity_doc.name(),
+    (getter)PyBobIpGaborScoreCache_capacity,
+    0,
+    capacity_doc.doc(),
+    0
+  },
+  {
+    hits_doc.name(),
+    (getter)PyBobIpGaborScoreCache_hits,
+    0,
+    hits_doc.doc(),
+    0
+  },
+  {
+    misses_doc.name(),
+    (getter)PyBobIpGaborScoreCache_misses,
+    0,
+    misses_doc.doc(),
+    0
+  },
+  {
+    hitRate_doc.name(),
+    (getter)PyBobIpGaborScoreCache_hitRate,
+    0,
+    hitRate_doc.doc(),
+    0
+  },
+  {0}  /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Functions Section ***********************************/
+/******************************************************************/
+
+static auto score_doc = bob::extension::FunctionDoc(
+  "score",
+  "Returns the cached similarity between the given Gabor jets or graphs",
+  "If the score of the pair is not cached, it is computed with the :py:attr:`similarity` function and stored. "
+  "For graphs, the score is the average similarity of the corresponding nodes.\n\n"
+  ".. note::\n\n  The function :py:func:`__call__` is a synonym for this function.",
+  true
+)
+.add_prototype("probe, gallery", "sim")
+.add_parameter("probe", ":py:class:`bob.ip.gabor.Jet` or [:py:class:`bob.ip.gabor.Jet`]", "The probe Gabor jet or the list of Gabor jets of the probe graph")
+.add_parameter("gallery", ":py:class:`bob.ip.gabor.Jet` or [:py:class:`bob.ip.gabor.Jet`]", "The gallery Gabor jet or graph of the same kind")
+.add_return("sim", "float", "The similarity between the probe and the gallery")
+;
+
+static PyObject* PyBobIpGaborScoreCache_score(PyBobIpGaborScoreCacheObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = score_doc.kwlist();
+
+  PyObject* probe,* gallery;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO", kwlist, &probe, &gallery)) return 0;
+
+  if (PyBobIpGaborJet_Check(probe) && PyBobIpGaborJet_Check(gallery))
+    return Py_BuildValue("d", self->cxx->similarity(*reinterpret_cast<PyBobIpGaborJetObject*>(probe)->cxx, *reinterpret_cast<PyBobIpGaborJetObject*>(gallery)->cxx));
+
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> probe_graph, gallery_graph;
+  if (!to_graph(self, probe, "probe", probe_graph) || !to_graph(self, gallery, "gallery", gallery_graph)) return 0;
+  return Py_BuildValue("d", self->cxx->similarity(probe_graph, gallery_graph));
+BOB_CATCH_MEMBER("score", 0)
+}
+
+static auto similarities_doc = bob::extension::FunctionDoc(
+  "similarities",
+  "Computes the cached similarities between the probe and all entries of the given gallery",
+  "The ``probe`` can either be a single Gabor jet, or a list of Gabor jets (i.e., a graph), and the ``gallery`` is a contiguous array of Gabor jet data, see :py:meth:`Similarity.similarities` for details. "
+  "All gallery entries are looked up at once, and only the scores that are not cached are computed, using ``number_of_threads`` threads.",
+  true
+)
+.add_prototype("probe, gallery, [scores], [number_of_threads]", "scores")
+.add_parameter("probe", ":py:class:`bob.ip.gabor.Jet` or [:py:class:`bob.ip.gabor.Jet`]", "The probe Gabor jet or the list of Gabor jets of the probe graph")
+.add_parameter("gallery", "array_like (float, 3D or 4D)", "The Gabor jets of the gallery, stored contiguously")
+.add_parameter("scores", "array_like (float, 1D)", "If given, the scores will be written to this array, which must be of shape ``(N,)``")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads to use; ``0`` selects one thread per available core")
+.add_return("scores", "array_like (float, 1D)", "The scores of all gallery entries; identical to the ``scores`` parameter, if given")
+;
+
+static PyObject* PyBobIpGaborScoreCache_similarities(PyBobIpGaborScoreCacheObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = similarities_doc.kwlist();
+
+  PyObject* probe;
+  PyBlitzArrayObject* gallery = 0,* scores = 0;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO&|O&i", kwlist, &probe, &PyBlitzArray_Converter, &gallery, &PyBlitzArray_OutputConverter, &scores, &threads)) return 0;
+
+  auto gallery_ = make_safe(gallery);
+  auto scores_ = make_xsafe(scores);
+
+  // get the probe jets
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> jets;
+  bool graph = !PyBobIpGaborJet_Check(probe);
+  if (graph && !to_graph(self, probe, "probe", jets)) return 0;
+
+  if (gallery->type_num != NPY_FLOAT64 || gallery->ndim != (graph ? 4 : 3)) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `gallery' to be a %dD array of type float", Py_TYPE(self)->tp_name, graph ? 4 : 3);
+    return 0;
+  }
+
+  if (scores){
+    if (scores->type_num != NPY_FLOAT64 || scores->ndim != 1) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `scores' to be a 1D array of type float", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[] = {gallery->shape[0]};
+    scores = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, osize);
+    scores_ = make_safe(scores);
+  }
+
+  // the C++ objects stay alive while the global interpreter lock is released
+  auto cache = self->cxx;
+  auto& blitz_scores = *PyBlitzArrayCxx_AsBlitz<double,1>(scores);
+  if (graph){
+    auto& blitz_gallery = *PyBlitzArrayCxx_AsBlitz<double,4>(gallery);
+    if (!without_gil([&](){cache->similarities(jets, blitz_gallery, blitz_scores, threads);})) return 0;
+  } else {
+    auto jet = reinterpret_cast<PyBobIpGaborJetObject*>(probe)->cxx;
+    auto& blitz_gallery = *PyBlitzArrayCxx_AsBlitz<double,3>(gallery);
+    if (!without_gil([&](){cache->similarities(*jet, blitz_gallery, blitz_scores, threads);})) return 0;
+  }
+
+  return PyBlitzArray_AsNumpyArray(scores, 0);
+BOB_CATCH_MEMBER("similarities", 0)
+}
+
+static auto clear_doc = bob::extension::FunctionDoc(
+  "clear",
+  "Removes all cached scores, but keeps the statistics",
+  0,
+  true
+)
+.add_prototype("")
+;
+
+static PyObject* PyBobIpGaborScoreCache_clear(PyBobIpGaborScoreCacheObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = clear_doc.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+
+  self->cxx->clear();
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("clear", 0)
+}
+
+static auto resetStatistics_doc = bob::extension::FunctionDoc(
+  "reset_statistics",
+  "Resets the number of hits and misses",
+  0,
+  true
+)
+.add_prototype("")
+;
+
+static PyObject* PyBobIpGaborScoreCache_resetStatistics(PyBobIpGaborScoreCacheObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = resetStatistics_doc.kwlist();
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "", kwlist)) return 0;
+
+  self->cxx->reset_statistics();
+  Py_RETURN_NONE;
+BOB_CATCH_MEMBER("reset_statistics", 0)
+}
+
+
+static PyMethodDef PyBobIpGaborScoreCache_methods[] = {
+  {
+    score_doc.name(),
+    (PyCFunction)PyBobIpGaborScoreCache_score,
+    METH_VARARGS|METH_KEYWORDS,
+    score_doc.doc()
+  },
+  {
+    similarities_doc.name(),
+    (PyCFunction)PyBobIpGaborScoreCache_similarities,
+    METH_VARARGS|METH_KEYWORDS,
+    similarities_doc.doc()
+  },
+  {
+    clear_doc.name(),
+    (PyCFunction)PyBobIpGaborScoreCache_clear,
+    METH_VARARGS|METH_KEYWORDS,
+    clear_doc.doc()
+  },
+  {
+    resetStatistics_doc.name(),
+    (PyCFunction)PyBobIpGaborScoreCache_resetStatistics,
+    METH_VARARGS|METH_KEYWORDS,
+    resetStatistics_doc.doc()
+  },
+  {0} /* Sentinel */
+};
+
+
+/******************************************************************/
+/************ Module Section **************************************/
+/******************************************************************/
+
+// Define the ScoreCache type struct; will be initialized later
+PyTypeObject PyBobIpGaborScoreCache_Type = {
+  PyVarObject_HEAD_INIT(0,0)
+  0
+};
+
+static PySequenceMethods PyBobIpGaborScoreCache_sequence = {
+  (lenfunc)PyBobIpGaborScoreCache_len
+};
+
+bool init_BobIpGaborScoreCache(PyObject* module)
+{
+
+  // initialize the ScoreCache type struct
+  PyBobIpGaborScoreCache_Type.tp_name = ScoreCache_doc.name();
+  PyBobIpGaborScoreCache_Type.tp_basicsize = sizeof(PyBobIpGaborScoreCacheObject);
+  PyBobIpGaborScoreCache_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+  PyBobIpGaborScoreCache_Type.tp_doc = ScoreCache_doc.doc();
+
+  // set the functions
+  PyBobIpGaborScoreCache_Type.tp_new = PyType_GenericNew;
+  PyBobIpGaborScoreCache_Type.tp_init = reinterpret_cast<initproc>(PyBobIpGaborScoreCache_init);
+  PyBobIpGaborScoreCache_Type.tp_dealloc = reinterpret_cast<destructor>(PyBobIpGaborScoreCache_delete);
+  PyBobIpGaborScoreCache_Type.tp_methods = PyBobIpGaborScoreCache_methods;
+  PyBobIpGaborScoreCache_Type.tp_getset = PyBobIpGaborScoreCache_getseters;
+  PyBobIpGaborScoreCache_Type.tp_as_sequence = &PyBobIpGaborScoreCache_sequence;
+  PyBobIpGaborScoreCache_Type.tp_call = reinterpret_cast<ternaryfunc>(PyBobIpGaborScoreCache_score);
+
+  // check that everyting is fine
+  if (PyType_Ready(&PyBobIpGaborScoreCache_Type) < 0) return false;
+
+  // add the type to the module
+  Py_INCREF(&PyBobIpGaborScoreCache_Type);
+  return PyModule_AddObject(module, "ScoreCache", (PyObject*)&PyBobIpGaborScoreCache_Type) >= 0;
+}
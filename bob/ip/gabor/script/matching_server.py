@@ -0,0 +1,54 @@
+#!/usr/bin/env python
+# vim: set fileencoding=utf-8 :
+# Sat Oct 17 23:41:12 UTC 2026
+
+"""Serves search queries on one shard of a large gallery over a Unix domain socket.
+
+The shard is a :py:class:`bob.ip.gabor.GalleryIndex` that was saved to HDF5 file.
+Queries are sent with a :py:class:`bob.ip.gabor.MatchingClient`, which merges the results of all shards.
+The server runs until it receives SIGINT or SIGTERM.
+"""
+
+import argparse
+import signal
+import threading
+
+import bob.io.base
+import bob.ip.gabor
+
+
+def main(command_line_parameters = None):
+  parser = argparse.ArgumentParser(description=__doc__.split('\n')[0], formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+  parser.add_argument('index_file', help = "The HDF5 file containing the gallery index of the shard")
+  parser.add_argument('socket_path', help = "The path of the Unix domain socket to listen on")
+  parser.add_argument('-t', '--threads', type = int, default = 1, help = "The number of threads used in each search; 0 selects one thread per available core")
+  args = parser.parse_args(command_line_parameters)
+
+  index = bob.ip.gabor.GalleryIndex(bob.io.base.HDF5File(args.index_file))
+  server = bob.ip.gabor.MatchingServer(index, args.socket_path, args.threads)
+
+  # serve in a separate thread, so that the main thread can handle the signals
+  errors = []
+  def serve():
+    try:
+      server.serve()
+    except RuntimeError as e:
+      errors.append(e)
+  thread = threading.Thread(target = serve)
+  thread.start()
+
+  stopped = threading.Event()
+  def stop(signal_number, frame):
+    stopped.set()
+  signal.signal(signal.SIGINT, stop)
+  signal.signal(signal.SIGTERM, stop)
+
+  print("Serving %d graphs on '%s'" % (len(index), args.socket_path))
+  while thread.is_alive() and not stopped.wait(1.):
+    pass
+
+  server.stop()
+  thread.join()
+  if errors:
+    raise errors[0]
+  return 0
@@ -15,6 +15,8 @@
 #include <bob.io.base/api.h>
 #include <bob.extension/documentation.h>
 
+#include "gil.h"
+
 
 static inline char* c(const char* o){return const_cast<char*>(o);}
 
@@ -54,7 +56,7 @@ static auto Similarity_doc = bob::extension::ClassDoc(
   )
   .add_prototype("type, [transform]", "")
   .add_prototype("hdf5", "")
-  .add_parameter("type", "str", "The type of the Gabor jet similarity function; might be one of (``'ScalarProduct'``, ``'Canberra'``, ``'AbsPhase'``, ``'Disparity'``, ``'PhaseDiff'``, ``'PhaseDiffPlusCanberra'``)")
+  .add_parameter("type", "str", "The type of the Gabor jet similarity function; might be one of (``'ScalarProduct'``, ``'Canberra'``, ``'AbsPhase'``, ``'Disparity'``, ``'PhaseDiff'``, ``'PhaseDiffPlusCanberra'``), or the name of a similarity function that was registered in C++ or with :py:func:`bob.ip.gabor.register_similarity`")
   .add_parameter("transform", ":py:class:`bob.ip.gabor.Transform`", "The Gabor wavelet transform class that was used to generate the Gabor jets; only required for disparity-based similarity functions ('Disparity', 'PhaseDiff', 'PhaseDiffPlusCanberra')")
   .add_parameter("hdf5", ":py:class:`bob.io.base.HDF5File`", "An HDF5 file open for reading to load the parametrization of the Gabor wavelet similarity from")
 );
@@ -81,9 +83,9 @@ BOB_TRY
     PyBobIpGaborTransformObject* gwt = 0;
     if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|O!", kwlist2, &name, &PyBobIpGaborTransform_Type, &gwt)) return -1;
     if (gwt)
-      self->cxx.reset(new bob::ip::gabor::Similarity(bob::ip::gabor::Similarity::name_to_type(name), gwt->cxx));
+      self->cxx.reset(new bob::ip::gabor::Similarity(std::string(name), gwt->cxx));
     else
-      self->cxx.reset(new bob::ip::gabor::Similarity(bob::ip::gabor::Similarity::name_to_type(name)));
+      self->cxx.reset(new bob::ip::gabor::Similarity(std::string(name)));
   }
   return 0;
 BOB_CATCH_MEMBER("Similarity constructor", -1)
@@ -175,12 +177,17 @@ static auto similarity_doc = bob::extension::FunctionDoc(
   "This function computes the similarity between the two given Gabor jets",
   "Depending on the :py:attr:`type`, different kinds of similarities are computed (see [Guenther2011]_ for details). "
   "Some of them will also compute the disparity from the first to the second Gabor jet, which can be retrieved by :py:attr:`last_disparity`.\n\n"
+  "When ``return_disparity`` is enabled, the disparity is returned together with the similarity, and :py:attr:`last_disparity` is left untouched. "
+  "In this mode, the same :py:class:`Similarity` object can safely be used by several threads at the same time.\n\n"
   ".. note::\n\n  The function :py:func:`__call__` is a synonym for this function.",
   true
 )
-.add_prototype("jet1, jet2", "sim")
+.add_prototype("jet1, jet2, [return_disparity]", "sim")
+.add_prototype("jet1, jet2, return_disparity", "sim, disparity")
 .add_parameter("jet1, jet2", ":py:class:`bob.ip.gabor.Jet`", "The two Gabor jets that should be compared")
+.add_parameter("return_disparity", "bool", "[Default: ``False``] Return the estimated disparity together with the similarity")
 .add_return("sim", "float", "The similarity between the two Gabor jets; more similar Gabor jets will get higher similarity values")
+.add_return("disparity", "(float, float)", "The disparity estimated between the two Gabor jets; ``(nan, nan)`` for similarity types that do not estimate disparities")
 ;
 
 static PyObject* PyBobIpGaborSimilarity_similarity(PyBobIpGaborSimilarityObject* self, PyObject* args, PyObject* kwargs) {
@@ -188,7 +195,15 @@ BOB_TRY
   char** kwlist = similarity_doc.kwlist();
 
   PyBobIpGaborJetObject* jet1,* jet2;
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O!", kwlist, &PyBobIpGaborJet_Type, &jet1, &PyBobIpGaborJet_Type, &jet2)) return 0;
+  PyObject* return_disparity = 0;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O!|O", kwlist, &PyBobIpGaborJet_Type, &jet1, &PyBobIpGaborJet_Type, &jet2, &return_disparity)) return 0;
+
+  if (return_disparity && PyObject_IsTrue(return_disparity)){
+    // use the thread-safe version, which does not modify the object
+    blitz::TinyVector<double,2> disparity;
+    double sim = self->cxx->similarity(*jet1->cxx, *jet2->cxx, disparity);
+    return Py_BuildValue("d(dd)", sim, disparity[0], disparity[1]);
+  }
 
   double sim = self->cxx->similarity(*jet1->cxx, *jet2->cxx);
   return Py_BuildValue("d", sim);
@@ -196,6 +211,164 @@ BOB_CATCH_MEMBER("similarity", 0)
 }
 
 
+static auto similarities_doc = bob::extension::FunctionDoc(
+  "similarities",
+  "This function computes the similarities between the probe and all entries of the given gallery",
+  "The ``probe`` can either be a single Gabor jet, or a list of Gabor jets (i.e., a graph). "
+  "The ``gallery`` needs to be a contiguous array of Gabor jet data, as returned by :py:attr:`bob.ip.gabor.Jet.jet`. "
+  "For a single probe Gabor jet, the ``gallery`` is of shape ``(N, 2, len(probe))``, and ``scores[i] = similarity(probe, gallery[i])``. "
+  "For a probe graph, the ``gallery`` is of shape ``(N, len(probe), 2, len(probe[0]))``, and ``scores[i]`` contains the average similarity of the nodes of the probe and ``gallery[i]``.\n\n"
+  "The gallery can be split into several parts, which are processed in parallel threads; the global interpreter lock is released during the computation. "
+  "This function does not update :py:attr:`last_disparity`.",
+  true
+)
+.add_prototype("probe, gallery, [scores], [number_of_threads]", "scores")
+.add_parameter("probe", ":py:class:`bob.ip.gabor.Jet` or [:py:class:`bob.ip.gabor.Jet`]", "The probe Gabor jet or the list of Gabor jets of the probe graph")
+.add_parameter("gallery", "array_like (float, 3D or 4D)", "The Gabor jets of the gallery, stored contiguously")
+.add_parameter("scores", "array_like (float, 1D)", "If given, the similarities will be written to this array, which must be of shape ``(N,)``")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads to use; ``0`` selects one thread per available core")
+.add_return("scores", "array_like (float, 1D)", "The similarities between the probe and all gallery entries; identical to the ``scores`` parameter, if given")
+;
+
+static PyObject* PyBobIpGaborSimilarity_similarities(PyBobIpGaborSimilarityObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = similarities_doc.kwlist();
+
+  PyObject* probe;
+  PyBlitzArrayObject* gallery = 0,* scores = 0;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO&|O&i", kwlist, &probe, &PyBlitzArray_Converter, &gallery, &PyBlitzArray_OutputConverter, &scores, &threads)) return 0;
+
+  auto gallery_ = make_safe(gallery);
+  auto scores_ = make_xsafe(scores);
+
+  // get the probe jets
+  std::vector<boost::shared_ptr<bob::ip::gabor::Jet>> jets;
+  bool graph = !PyBobIpGaborJet_Check(probe);
+  if (graph){
+    PyObject* iterator = PyObject_GetIter(probe);
+    if (!iterator) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `probe' to be a bob.ip.gabor.Jet or a list of those", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    auto iterator_ = make_safe(iterator);
+    while (PyObject* it = PyIter_Next(iterator)) {
+      auto it_ = make_safe(it);
+      if (!PyBobIpGaborJet_Check(it)){
+        PyErr_Format(PyExc_TypeError, "`%s' requires all elements of the `probe' to be of type bob.ip.gabor.Jet, but element %d isn't", Py_TYPE(self)->tp_name, (int)jets.size());
+        return 0;
+      }
+      jets.push_back(reinterpret_cast<PyBobIpGaborJetObject*>(it)->cxx);
+    }
+  }
+
+  if (gallery->type_num != NPY_FLOAT64 || gallery->ndim != (graph ? 4 : 3)) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `gallery' to be a %dD array of type float", Py_TYPE(self)->tp_name, graph ? 4 : 3);
+    return 0;
+  }
+
+  if (scores){
+    if (scores->type_num != NPY_FLOAT64 || scores->ndim != 1) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `scores' to be a 1D array of type float", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[] = {gallery->shape[0]};
+    scores = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 1, osize);
+    scores_ = make_safe(scores);
+  }
+
+  // the C++ objects stay alive while the global interpreter lock is released
+  auto similarity = self->cxx;
+  if (graph){
+    auto& blitz_gallery = *PyBlitzArrayCxx_AsBlitz<double,4>(gallery);
+    auto& blitz_scores = *PyBlitzArrayCxx_AsBlitz<double,1>(scores);
+    if (!without_gil([&](){similarity->similarities(jets, blitz_gallery, blitz_scores, threads);})) return 0;
+  } else {
+    auto jet = reinterpret_cast<PyBobIpGaborJetObject*>(probe)->cxx;
+    auto& blitz_gallery = *PyBlitzArrayCxx_AsBlitz<double,3>(gallery);
+    auto& blitz_scores = *PyBlitzArrayCxx_AsBlitz<double,1>(scores);
+    if (!without_gil([&](){similarity->similarities(*jet, blitz_gallery, blitz_scores, threads);})) return 0;
+  }
+
+  return PyBlitzArray_AsNumpyArray(scores, 0);
+BOB_CATCH_MEMBER("similarities", 0)
+}
+
+
+static auto similarity_matrix_doc = bob::extension::FunctionDoc(
+  "similarity_matrix",
+  "This function computes the similarities between all probes and all gallery entries",
+  "The ``probes`` and the ``gallery`` need to be contiguous arrays of Gabor jet data, as returned by :py:attr:`bob.ip.gabor.Jet.jet`. "
+  "They can either contain Gabor jets, i.e., have shape ``(N, 2, length)`` and ``(M, 2, length)``, or Gabor graphs, i.e., have shape ``(N, nodes, 2, length)`` and ``(M, nodes, 2, length)``. "
+  "The resulting ``scores[i,j]`` contains the (average) similarity between ``probes[i]`` and ``gallery[j]``.\n\n"
+  "Probes and gallery are split into tiles that fit into the cache, and the tiles are processed in parallel threads; the global interpreter lock is released during the computation. "
+  "When the ``gallery`` is not given, the ``probes`` are compared to themselves, and only half of the similarities are computed. "
+  "This function does not update :py:attr:`last_disparity`.",
+  true
+)
+.add_prototype("probes, [gallery], [scores], [number_of_threads]", "scores")
+.add_parameter("probes", "array_like (float, 3D or 4D)", "The Gabor jets or graphs of the probes, stored contiguously")
+.add_parameter("gallery", "array_like (float, 3D or 4D) or ``None``", "[Default: ``None``] The Gabor jets or graphs of the gallery, stored contiguously; if ``None``, the ``probes`` are used")
+.add_parameter("scores", "array_like (float, 2D)", "If given, the similarities will be written to this array, which must be of shape ``(N, M)``")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads to use; ``0`` selects one thread per available core")
+.add_return("scores", "array_like (float, 2D)", "The similarities between all probes and all gallery entries; identical to the ``scores`` parameter, if given")
+;
+
+static PyObject* PyBobIpGaborSimilarity_similarity_matrix(PyBobIpGaborSimilarityObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = similarity_matrix_doc.kwlist();
+
+  PyBlitzArrayObject* probes = 0,* gallery = 0,* scores = 0;
+  PyObject* gallery_object = 0;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&|OO&i", kwlist, &PyBlitzArray_Converter, &probes, &gallery_object, &PyBlitzArray_OutputConverter, &scores, &threads)) return 0;
+
+  auto probes_ = make_safe(probes);
+  auto scores_ = make_xsafe(scores);
+
+  // when no gallery is given, we compare the probes with themselves
+  if (gallery_object && gallery_object != Py_None){
+    if (!PyBlitzArray_Converter(gallery_object, &gallery)) return 0;
+  } else {
+    gallery = probes;
+    Py_INCREF(gallery);
+  }
+  auto gallery_ = make_safe(gallery);
+
+  if (probes->type_num != NPY_FLOAT64 || gallery->type_num != NPY_FLOAT64 || (probes->ndim != 3 && probes->ndim != 4) || probes->ndim != gallery->ndim) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `probes' and `gallery' to be 3D or 4D arrays of type float", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+
+  if (scores){
+    if (scores->type_num != NPY_FLOAT64 || scores->ndim != 2) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `scores' to be a 2D array of type float", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[] = {probes->shape[0], gallery->shape[0]};
+    scores = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, osize);
+    scores_ = make_safe(scores);
+  }
+
+  auto similarity = self->cxx;
+  auto& blitz_scores = *PyBlitzArrayCxx_AsBlitz<double,2>(scores);
+  if (probes->ndim == 3){
+    auto& blitz_probes = *PyBlitzArrayCxx_AsBlitz<double,3>(probes);
+    auto& blitz_gallery = *PyBlitzArrayCxx_AsBlitz<double,3>(gallery);
+    if (!without_gil([&](){similarity->similarity_matrix(blitz_probes, blitz_gallery, blitz_scores, threads);})) return 0;
+  } else {
+    auto& blitz_probes = *PyBlitzArrayCxx_AsBlitz<double,4>(probes);
+    auto& blitz_gallery = *PyBlitzArrayCxx_AsBlitz<double,4>(gallery);
+    if (!without_gil([&](){similarity->similarity_matrix(blitz_probes, blitz_gallery, blitz_scores, threads);})) return 0;
+  }
+
+  return PyBlitzArray_AsNumpyArray(scores, 0);
+BOB_CATCH_MEMBER("similarity_matrix", 0)
+}
+
+
 static auto disparity_doc = bob::extension::FunctionDoc(
   "disparity",
   "This function computes the disparity vector for the given Gabor jets",
@@ -221,6 +394,145 @@ BOB_CATCH_MEMBER("disparity", 0)
 }
 
 
+static auto disparities_doc = bob::extension::FunctionDoc(
+  "disparities",
+  "This function computes the disparity vectors for many pairs of Gabor jets at once",
+  "The Gabor jets are given as contiguous arrays of Gabor jet data, both of shape ``(N, 2, number_of_wavelets)``, and ``disparities[i] = disparity(jets1[i], jets2[i])``. "
+  "The pairs are processed in small vectorized groups, which can be distributed over several threads; the global interpreter lock is released during the computation. "
+  "This function does not update :py:attr:`last_disparity`.",
+  true
+)
+.add_prototype("jets1, jets2, [disparities], [number_of_threads]", "disparities")
+.add_parameter("jets1, jets2", "array_like (float, 3D)", "The Gabor jets of the pairs to compute the disparities between")
+.add_parameter("disparities", "array_like (float, 2D)", "If given, the disparities will be written to this array, which must be of shape ``(N, 2)``")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads to use; ``0`` selects one thread per available core")
+.add_return("disparities", "array_like (float, 2D)", "The disparity vectors estimated for all pairs; identical to the ``disparities`` parameter, if given")
+;
+
+static PyObject* PyBobIpGaborSimilarity_disparities(PyBobIpGaborSimilarityObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = disparities_doc.kwlist();
+
+  PyBlitzArrayObject* jets1 = 0,* jets2 = 0,* disparities = 0;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|O&i", kwlist, &PyBlitzArray_Converter, &jets1, &PyBlitzArray_Converter, &jets2, &PyBlitzArray_OutputConverter, &disparities, &threads)) return 0;
+
+  auto jets1_ = make_safe(jets1);
+  auto jets2_ = make_safe(jets2);
+  auto disparities_ = make_xsafe(disparities);
+
+  if (jets1->type_num != NPY_FLOAT64 || jets2->type_num != NPY_FLOAT64 || jets1->ndim != 3 || jets2->ndim != 3) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `jets1' and `jets2' to be 3D arrays of type float", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+
+  if (disparities){
+    if (disparities->type_num != NPY_FLOAT64 || disparities->ndim != 2) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `disparities' to be a 2D array of type float", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+  } else {
+    Py_ssize_t osize[] = {jets1->shape[0], 2};
+    disparities = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, osize);
+    disparities_ = make_safe(disparities);
+  }
+
+  auto similarity = self->cxx;
+  auto& blitz_jets1 = *PyBlitzArrayCxx_AsBlitz<double,3>(jets1);
+  auto& blitz_jets2 = *PyBlitzArrayCxx_AsBlitz<double,3>(jets2);
+  auto& blitz_disparities = *PyBlitzArrayCxx_AsBlitz<double,2>(disparities);
+  if (!without_gil([&](){similarity->disparities(blitz_jets1, blitz_jets2, blitz_disparities, threads);})) return 0;
+
+  return PyBlitzArray_AsNumpyArray(disparities, 0);
+BOB_CATCH_MEMBER("disparities", 0)
+}
+
+
+static auto disparity_field_doc = bob::extension::FunctionDoc(
+  "disparity_field",
+  "This function computes the disparity vectors between two images on a regular grid of positions",
+  "The images are either the Gabor wavelet transformed images as returned by :py:meth:`bob.ip.gabor.Transform.transform`, i.e., complex arrays of shape ``(number_of_wavelets, height, width)``, "
+  "or jet images, i.e., float arrays of shape ``(height, width, 2, number_of_wavelets)`` that contain the Gabor jet data of all pixels. "
+  "The disparities are estimated at the grid positions ``(first[0] + y * step[0], first[1] + x * step[1])``, where the grid is as large as the images allow, or as large as the given ``disparities`` and ``confidences``. "
+  "Additionally, a confidence value is computed for each grid position, which is the ``'Disparity'`` similarity between the normalized Gabor jets at the estimated disparity.\n\n"
+  "The grid positions are processed in small vectorized groups, which can be distributed over several threads. "
+  "This function does not update :py:attr:`last_disparity`.",
+  true
+)
+.add_prototype("image1, image2, [step], [first], [disparities], [confidences], [number_of_threads]", "disparities, confidences")
+.add_parameter("image1, image2", "array_like (complex, 3D) or array_like (float, 4D)", "The two trafo images or jet images to compute the disparities between")
+.add_parameter("step", "(int, int)", "[Default: ``(1, 1)``] The distance between two grid positions in vertical and horizontal direction")
+.add_parameter("first", "(int, int)", "[Default: ``(0, 0)``] The first grid position")
+.add_parameter("disparities", "array_like (float, 3D)", "If given, the disparities will be written to this array of shape ``(Y, X, 2)``")
+.add_parameter("confidences", "array_like (float, 2D)", "If given, the confidences will be written to this array of shape ``(Y, X)``")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads to use; ``0`` selects one thread per available core")
+.add_return("disparities", "array_like (float, 3D)", "The disparity vectors estimated at all grid positions")
+.add_return("confidences", "array_like (float, 2D)", "The confidences of the disparities at all grid positions")
+;
+
+static PyObject* PyBobIpGaborSimilarity_disparity_field(PyBobIpGaborSimilarityObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = disparity_field_doc.kwlist();
+
+  PyBlitzArrayObject* image1 = 0,* image2 = 0,* disparities = 0,* confidences = 0;
+  blitz::TinyVector<int,2> step(1,1), first(0,0);
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|(ii)(ii)O&O&i", kwlist, &PyBlitzArray_Converter, &image1, &PyBlitzArray_Converter, &image2, &step[0], &step[1], &first[0], &first[1], &PyBlitzArray_OutputConverter, &disparities, &PyBlitzArray_OutputConverter, &confidences, &threads)) return 0;
+
+  auto image1_ = make_safe(image1);
+  auto image2_ = make_safe(image2);
+  auto disparities_ = make_xsafe(disparities);
+  auto confidences_ = make_xsafe(confidences);
+
+  const bool trafo_images = image1->type_num == NPY_COMPLEX128 && image1->ndim == 3;
+  if (!trafo_images && (image1->type_num != NPY_FLOAT64 || image1->ndim != 4)) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `image1' to be a 3D array of type complex or a 4D array of type float", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  if (image2->type_num != image1->type_num || image2->ndim != image1->ndim) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `image2' to be of the same type as `image1'", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  if ((disparities && (disparities->type_num != NPY_FLOAT64 || disparities->ndim != 3)) || (confidences && (confidences->type_num != NPY_FLOAT64 || confidences->ndim != 2))) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `disparities' and `confidences' to be 3D and 2D arrays of type float", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  if (step[0] < 1 || step[1] < 1) {
+    PyErr_Format(PyExc_ValueError, "`%s' requires a positive `step', but got (%d, %d)", Py_TYPE(self)->tp_name, step[0], step[1]);
+    return 0;
+  }
+
+  // the grid size is defined by the given output arrays, or by the size of the images
+  Py_ssize_t grid[2];
+  if (disparities){
+    grid[0] = disparities->shape[0]; grid[1] = disparities->shape[1];
+  } else if (confidences){
+    grid[0] = confidences->shape[0]; grid[1] = confidences->shape[1];
+  } else {
+    const Py_ssize_t height = trafo_images ? image1->shape[1] : image1->shape[0], width = trafo_images ? image1->shape[2] : image1->shape[1];
+    grid[0] = std::max<Py_ssize_t>((height - first[0] + step[0] - 1) / step[0], 0);
+    grid[1] = std::max<Py_ssize_t>((width - first[1] + step[1] - 1) / step[1], 0);
+  }
+  if (!disparities){
+    Py_ssize_t osize[] = {grid[0], grid[1], 2};
+    disparities = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 3, osize);
+    disparities_ = make_safe(disparities);
+  }
+  if (!confidences){
+    confidences = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, grid);
+    confidences_ = make_safe(confidences);
+  }
+
+  if (trafo_images)
+    self->cxx->disparity_field(*PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(image1), *PyBlitzArrayCxx_AsBlitz<std::complex<double>,3>(image2), first, step, *PyBlitzArrayCxx_AsBlitz<double,3>(disparities), *PyBlitzArrayCxx_AsBlitz<double,2>(confidences), threads);
+  else
+    self->cxx->disparity_field(*PyBlitzArrayCxx_AsBlitz<double,4>(image1), *PyBlitzArrayCxx_AsBlitz<double,4>(image2), first, step, *PyBlitzArrayCxx_AsBlitz<double,3>(disparities), *PyBlitzArrayCxx_AsBlitz<double,2>(confidences), threads);
+
+  return Py_BuildValue("NN", PyBlitzArray_AsNumpyArray(disparities, 0), PyBlitzArray_AsNumpyArray(confidences, 0));
+BOB_CATCH_MEMBER("disparity_field", 0)
+}
+
+
 static auto shift_phase_doc = bob::extension::FunctionDoc(
   "shift_phase",
   "This function returns a copy of the Gabor jet, for which the Gabor phases are shifted towards the reference Gabor jet",
@@ -255,6 +567,75 @@ BOB_CATCH_MEMBER("shift_phase", 0)
 }
 
 
+static auto shift_phases_doc = bob::extension::FunctionDoc(
+  "shift_phases",
+  "This function shifts the Gabor phases of many Gabor jets towards their references at once",
+  "The Gabor jets are given as a contiguous array of Gabor jet data of shape ``(N, 2, number_of_wavelets)``. "
+  "The ``references`` are either an array of the same shape, i.e., ``shifted[i]`` is the ``jets[i]`` shifted towards ``references[i]``, "
+  "or a single :py:class:`bob.ip.gabor.Jet`, towards which all jets are shifted, e.g., when aligning Gabor jets before averaging them. "
+  "The disparities are estimated in small vectorized groups, which can be distributed over several threads. "
+  "To shift the jets in place, ``jets`` can be passed as ``shifted``. "
+  "This function does not update :py:attr:`last_disparity`.",
+  true
+)
+.add_prototype("jets, references, [shifted], [disparities], [number_of_threads]", "shifted")
+.add_parameter("jets", "array_like (float, 3D)", "The Gabor jets, whose phases should be shifted")
+.add_parameter("references", "array_like (float, 3D) or :py:class:`bob.ip.gabor.Jet`", "The reference Gabor jets, or one common reference Gabor jet")
+.add_parameter("shifted", "array_like (float, 3D)", "If given, the shifted Gabor jets will be written to this array, which must be of shape ``(N, 2, number_of_wavelets)``")
+.add_parameter("disparities", "array_like (float, 2D)", "If given, the disparities used to shift the jets will be written to this array, which must be of shape ``(N, 2)``")
+.add_parameter("number_of_threads", "int", "[Default: ``1``] The number of threads to use; ``0`` selects one thread per available core")
+.add_return("shifted", "array_like (float, 3D)", "The Gabor jets with shifted phases; identical to the ``shifted`` parameter, if given")
+;
+
+static PyObject* PyBobIpGaborSimilarity_shift_phases(PyBobIpGaborSimilarityObject* self, PyObject* args, PyObject* kwargs) {
+BOB_TRY
+  char** kwlist = shift_phases_doc.kwlist();
+
+  PyBlitzArrayObject* jets = 0,* shifted = 0,* disparities = 0;
+  PyObject* references;
+  int threads = 1;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O|O&O&i", kwlist, &PyBlitzArray_Converter, &jets, &references, &PyBlitzArray_OutputConverter, &shifted, &PyBlitzArray_OutputConverter, &disparities, &threads)) return 0;
+
+  auto jets_ = make_safe(jets);
+  auto shifted_ = make_xsafe(shifted);
+  auto disparities_ = make_xsafe(disparities);
+
+  if (jets->type_num != NPY_FLOAT64 || jets->ndim != 3) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `jets' to be a 3D array of type float", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+  if ((shifted && (shifted->type_num != NPY_FLOAT64 || shifted->ndim != 3)) || (disparities && (disparities->type_num != NPY_FLOAT64 || disparities->ndim != 2))) {
+    PyErr_Format(PyExc_TypeError, "`%s' requires the `shifted' and `disparities' to be 3D and 2D arrays of type float", Py_TYPE(self)->tp_name);
+    return 0;
+  }
+
+  if (!shifted){
+    shifted = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 3, jets->shape);
+    shifted_ = make_safe(shifted);
+  }
+  if (!disparities){
+    Py_ssize_t osize[] = {jets->shape[0], 2};
+    disparities = (PyBlitzArrayObject*)PyBlitzArray_SimpleNew(NPY_FLOAT64, 2, osize);
+    disparities_ = make_safe(disparities);
+  }
+
+  if (PyBobIpGaborJet_Check(references)){
+    self->cxx->shift_phases(*PyBlitzArrayCxx_AsBlitz<double,3>(jets), *reinterpret_cast<PyBobIpGaborJetObject*>(references)->cxx, *PyBlitzArrayCxx_AsBlitz<double,3>(shifted), *PyBlitzArrayCxx_AsBlitz<double,2>(disparities), threads);
+  } else {
+    PyBlitzArrayObject* reference_array;
+    if (!PyBlitzArray_Converter(references, &reference_array)) return 0;
+    auto reference_array_ = make_safe(reference_array);
+    if (reference_array->type_num != NPY_FLOAT64 || reference_array->ndim != 3) {
+      PyErr_Format(PyExc_TypeError, "`%s' requires the `references' to be a 3D array of type float or a bob.ip.gabor.Jet", Py_TYPE(self)->tp_name);
+      return 0;
+    }
+    self->cxx->shift_phases(*PyBlitzArrayCxx_AsBlitz<double,3>(jets), *PyBlitzArrayCxx_AsBlitz<double,3>(reference_array), *PyBlitzArrayCxx_AsBlitz<double,3>(shifted), *PyBlitzArrayCxx_AsBlitz<double,2>(disparities), threads);
+  }
+
+  return PyBlitzArray_AsNumpyArray(shifted, 0);
+BOB_CATCH_MEMBER("shift_phases", 0)
+}
+
 static auto load_doc = bob::extension::FunctionDoc(
   "load",
   "Loads the parametrization of the Gabor jet similarity from the given HDF5 file",
@@ -310,18 +691,48 @@ static PyMethodDef PyBobIpGaborSimilarity_methods[] = {
     METH_VARARGS|METH_KEYWORDS,
     similarity_doc.doc()
   },
+  {
+    similarities_doc.name(),
+    (PyCFunction)PyBobIpGaborSimilarity_similarities,
+    METH_VARARGS|METH_KEYWORDS,
+    similarities_doc.doc()
+  },
+  {
+    similarity_matrix_doc.name(),
+    (PyCFunction)PyBobIpGaborSimilarity_similarity_matrix,
+    METH_VARARGS|METH_KEYWORDS,
+    similarity_matrix_doc.doc()
+  },
   {
     disparity_doc.name(),
     (PyCFunction)PyBobIpGaborSimilarity_disparity,
     METH_VARARGS|METH_KEYWORDS,
     disparity_doc.doc()
   },
+  {
+    disparities_doc.name(),
+    (PyCFunction)PyBobIpGaborSimilarity_disparities,
+    METH_VARARGS|METH_KEYWORDS,
+    disparities_doc.doc()
+  },
+  {
+    disparity_field_doc.name(),
+    (PyCFunction)PyBobIpGaborSimilarity_disparity_field,
+    METH_VARARGS|METH_KEYWORDS,
+    disparity_field_doc.doc()
+  },
   {
     shift_phase_doc.name(),
     (PyCFunction)PyBobIpGaborSimilarity_shift_phase,
     METH_VARARGS|METH_KEYWORDS,
     shift_phase_doc.doc()
   },
+  {
+    shift_phases_doc.name(),
+    (PyCFunction)PyBobIpGaborSimilarity_shift_phases,
+    METH_VARARGS|METH_KEYWORDS,
+    shift_phases_doc.doc()
+  },
   {
     load_doc.name(),
     (PyCFunction)PyBobIpGaborSimilarity_load,
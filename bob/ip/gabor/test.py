@@ -21,6 +21,25 @@ import bob.io.base.test_utils
 
 regenerate_references = False
 
+def seeded_transform(seed = 10222015, **kwargs):
+  """Seeds the random number generator and returns a Gabor wavelet transform with the given parameters"""
+  numpy.random.seed(seed)
+  return bob.ip.gabor.Transform(**kwargs)
+
+def random_jet(gwt):
+  """Returns a Gabor jet with random complex values for the wavelets of the given transform"""
+  jet_data = numpy.ndarray((gwt.number_of_wavelets,), dtype=numpy.complex)
+  jet_data.real = numpy.random.randn(gwt.number_of_wavelets)
+  jet_data.imag = numpy.random.randn(gwt.number_of_wavelets)
+  return bob.ip.gabor.Jet(complex=jet_data)
+
+def random_graph(gwt, number_of_nodes = 3):
+  """Returns a graph of Gabor jets with random absolute values and phases in [0, 1)"""
+  graph = [bob.ip.gabor.Jet(gwt.number_of_wavelets) for n in range(number_of_nodes)]
+  for jet in graph:
+    jet.jet[:] = numpy.random.rand(2, gwt.number_of_wavelets)
+  return graph
+
 def test_wavelet():
   # check that the wavelet in frequency domain is just a Gaussian moved to
   k = [math.pi/2.] * 2
@@ -250,6 +269,86 @@ def test_graph():
 
 
 
+def test_jet_block():
+  # the jets in the old layout with one directory per jet
+  jets_file = bob.io.base.test_utils.datafile("testjets.hdf5", 'bob.ip.gabor')
+  jets = bob.ip.gabor.load_jets(bob.io.base.HDF5File(jets_file))
+  block = bob.ip.gabor.load_jet_block(bob.io.base.HDF5File(jets_file))
+  assert block.shape == (len(jets), 2, jets[0].length)
+  assert numpy.allclose(block, [jet.jet for jet in jets])
+
+  temp_file = bob.io.base.test_utils.temporary_filename()
+  try:
+    for data, compression in ((jets, 0), (block, 5)):
+      bob.ip.gabor.save_jet_block(data, bob.io.base.HDF5File(temp_file, 'w'), compression)
+      hdf5 = bob.io.base.HDF5File(temp_file)
+      assert hdf5.has_dataset("Jets")
+      assert numpy.allclose(bob.ip.gabor.load_jet_block(hdf5), block)
+      loaded = bob.ip.gabor.load_jets(hdf5)
+      assert len(loaded) == len(jets)
+      assert all(numpy.allclose(a.jet, b.jet) for a, b in zip(loaded, jets))
+
+    hdf5 = bob.io.base.HDF5File(temp_file, 'w')
+    nose.tools.assert_raises(ValueError, bob.ip.gabor.save_jet_block, jets, hdf5, 10)
+    nose.tools.assert_raises(RuntimeError, bob.ip.gabor.save_jet_block, [jets[0], bob.ip.gabor.Jet(10)], hdf5)
+
+    # jets of different lengths are read from the layout with one directory per jet
+    mixed = [jets[0], bob.ip.gabor.Jet(10), jets[1]]
+    bob.ip.gabor.save_jets(mixed, bob.io.base.HDF5File(temp_file, 'w'))
+    loaded = bob.ip.gabor.load_jets(bob.io.base.HDF5File(temp_file))
+    assert [jet.length for jet in loaded] == [jet.length for jet in mixed]
+    assert all(numpy.allclose(a.jet, b.jet) for a, b in zip(loaded, mixed))
+    nose.tools.assert_raises(RuntimeError, bob.ip.gabor.load_jet_block, bob.io.base.HDF5File(temp_file))
+  finally:
+    if os.path.exists(temp_file):
+      os.remove(temp_file)
+
+
+
+def test_jet_stream():
+  numpy.random.seed(10222015)
+  jets = [bob.ip.gabor.Jet(40) for i in range(25)]
+  for jet in jets:
+    jet.jet[:] = numpy.random.rand(2, 40)
+  block = numpy.array([jet.jet for jet in jets])
+
+  temp_file = bob.io.base.test_utils.temporary_filename()
+  try:
+    # both layouts are read in the same way; compressed data sets have an additional dimension in the file
+    for save in (bob.ip.gabor.save_jets, bob.ip.gabor.save_jet_block, lambda jets, hdf5: bob.ip.gabor.save_jet_block(jets, hdf5, compression = 1)):
+      save(jets, bob.io.base.HDF5File(temp_file, 'w'))
+      stream = bob.ip.gabor.JetStream(temp_file, batch_size = 10)
+      assert isinstance(stream.background, bool)
+      assert len(stream) == 25
+      assert stream.length == 40
+      batches = list(stream)
+      assert [len(batch) for batch in batches] == [10, 10, 5]
+      assert stream.position == 25
+      assert numpy.allclose(numpy.concatenate(batches), block)
+      # a new iteration starts at the first jet
+      assert numpy.allclose(next(iter(stream)), block[:10])
+      assert stream.position == 10
+
+      similarity = bob.ip.gabor.Similarity("PhaseDiffPlusCanberra", bob.ip.gabor.Transform())
+      reference = numpy.array([similarity.similarities(jets[i], block) for i in (3, 7)])
+      assert numpy.allclose(stream.similarities(similarity, [jets[3], jets[7]], number_of_threads = 2), reference)
+      scores = numpy.ndarray((25,))
+      stream.similarities(similarity, jets[7], scores)
+      assert numpy.allclose(scores, reference[1])
+      assert len(list(stream)) == 3
+      del stream
+
+    # jets of different lengths cannot be read
+    bob.ip.gabor.save_jets(jets[:5] + [bob.ip.gabor.Jet(20)], bob.io.base.HDF5File(temp_file, 'w'))
+    stream = bob.ip.gabor.JetStream(temp_file, batch_size = 2, read_ahead = 1)
+    nose.tools.assert_raises(RuntimeError, list, stream)
+    del stream
+    nose.tools.assert_raises(RuntimeError, bob.ip.gabor.JetStream, temp_file, 0)
+  finally:
+    if os.path.exists(temp_file):
+      os.remove(temp_file)
+
+
 def test_similarity():
   # here we need the same GWT parameters as used to generate the Gabor jet!
   gwt = bob.ip.gabor.Transform()
@@ -276,6 +375,509 @@ def test_similarity():
   assert reference_sim.transform == gwt
 
 
+def test_similarities():
+  # generate a gallery of Gabor jets and graphs
+  gwt = seeded_transform()
+
+  jets = [random_jet(gwt) for i in range(30)]
+  gallery = numpy.array([jet.jet for jet in jets])
+  graphs = [[random_jet(gwt) for n in range(3)] for i in range(10)]
+  graph_gallery = numpy.array([[jet.jet for jet in graph] for graph in graphs])
+  probe = random_jet(gwt)
+  probe_graph = [random_jet(gwt) for n in range(3)]
+
+  for type in ('ScalarProduct', 'Canberra', 'AbsPhase', 'Disparity', 'PhaseDiff', 'PhaseDiffPlusCanberra'):
+    sim = bob.ip.gabor.Similarity(type, gwt)
+    # 1:N similarities of Gabor jets should be identical to the single similarities
+    reference = [sim(probe, jet) for jet in jets]
+    assert numpy.allclose(sim.similarities(probe, gallery), reference)
+    scores = numpy.ndarray((len(jets),), numpy.float64)
+    sim.similarities(probe, gallery, scores, number_of_threads=4)
+    assert numpy.allclose(scores, reference)
+
+    # 1:N similarities of graphs are the average node similarities
+    reference = [numpy.mean([sim(p, g) for p, g in zip(probe_graph, graph)]) for graph in graphs]
+    assert numpy.allclose(sim.similarities(probe_graph, graph_gallery, number_of_threads=0), reference)
+
+  # check that wrong shapes are detected
+  nose.tools.assert_raises(RuntimeError, sim.similarities, probe, graph_gallery[:,0,:,:20].copy())
+  nose.tools.assert_raises(TypeError, sim.similarities, probe, graph_gallery)
+
+  # N:M similarity matrices should contain the single similarities
+  for type in ('ScalarProduct', 'Canberra', 'AbsPhase', 'Disparity', 'PhaseDiff', 'PhaseDiffPlusCanberra'):
+    sim = bob.ip.gabor.Similarity(type, gwt)
+    reference = numpy.array([[sim(p, g) for g in jets] for p in jets[:7]])
+    assert numpy.allclose(sim.similarity_matrix(gallery[:7], gallery), reference)
+    # symmetric matrix, computed in parallel
+    reference = numpy.array([[sim(p, g) for g in jets] for p in jets])
+    scores = numpy.ndarray((len(jets), len(jets)), numpy.float64)
+    sim.similarity_matrix(gallery, scores=scores, number_of_threads=3)
+    assert numpy.allclose(scores, reference)
+    # graphs
+    reference = numpy.array([sim.similarities(graph, graph_gallery) for graph in graphs])
+    assert numpy.allclose(sim.similarity_matrix(graph_gallery, graph_gallery), reference)
+
+
+def test_custom_similarity():
+  # register a Python function as similarity function, which is the negative L1 distance of the absolute values
+  def l1(jet1, jet2):
+    assert jet1.shape == jet2.shape == (2, 40)
+    return -float(numpy.sum(numpy.abs(jet1[0] - jet2[0])))
+  bob.ip.gabor.register_similarity("L1Test", l1)
+
+  numpy.random.seed(11102026)
+  jets = [bob.ip.gabor.Jet(complex=numpy.random.randn(40) + 1j * numpy.random.randn(40)) for i in range(20)]
+  gallery = numpy.array([jet.jet for jet in jets])
+  probe = jets[0]
+
+  sim = bob.ip.gabor.Similarity("L1Test")
+  assert sim.type == "L1Test"
+  assert sim(probe, probe) == 0.
+  assert abs(sim(probe, jets[1]) - l1(probe.jet, jets[1].jet)) < 1e-12
+
+  # the batch computations use the registered function, also when several threads are requested
+  reference = [l1(probe.jet, jet.jet) for jet in jets]
+  assert numpy.allclose(sim.similarities(probe, gallery, number_of_threads=2), reference)
+  reference = numpy.array([[l1(p.jet, g.jet) for g in jets] for p in jets[:5]])
+  assert numpy.allclose(sim.similarity_matrix(gallery[:5], gallery, number_of_threads=2), reference)
+
+  # the registered name is written to file, and the function is found again when loading
+  temp_file = bob.io.base.test_utils.temporary_filename()
+  try:
+    sim.save(bob.io.base.HDF5File(temp_file, 'w'))
+    loaded = bob.ip.gabor.Similarity(bob.io.base.HDF5File(temp_file))
+    assert loaded.type == "L1Test"
+    assert loaded(probe, jets[1]) == sim(probe, jets[1])
+  finally:
+    if os.path.exists(temp_file):
+      os.remove(temp_file)
+
+  # unknown and reserved names are rejected, and exceptions of the function are reported
+  nose.tools.assert_raises(RuntimeError, bob.ip.gabor.Similarity, "UnknownSimilarity")
+  nose.tools.assert_raises(RuntimeError, bob.ip.gabor.register_similarity, "Canberra", l1)
+  nose.tools.assert_raises(TypeError, bob.ip.gabor.register_similarity, "L1Test", 1)
+  def failing(jet1, jet2):
+    raise ValueError("no similarity")
+  bob.ip.gabor.register_similarity("FailingTest", failing)
+  nose.tools.assert_raises(RuntimeError, bob.ip.gabor.Similarity("FailingTest").similarities, probe, gallery)
+
+
+def test_fast_math():
+  # the fast approximations of the trigonometric functions should give almost the same results as the exact functions
+  gwt = seeded_transform()
+  assert not bob.ip.gabor.get_fast_math()
+
+  complex_data = (numpy.random.randn(10, gwt.number_of_wavelets) + 1j * numpy.random.randn(10, gwt.number_of_wavelets)) * 100.
+  exact_jets = [bob.ip.gabor.Jet(complex=c) for c in complex_data]
+  sims = [bob.ip.gabor.Similarity(type, gwt) for type in ('Canberra', 'AbsPhase', 'Disparity', 'PhaseDiff', 'PhaseDiffPlusCanberra')]
+  exact_scores = [[sim(exact_jets[0], jet) for jet in exact_jets] for sim in sims]
+  exact_disparities = [sims[2].disparity(exact_jets[0], jet) for jet in exact_jets]
+
+  bob.ip.gabor.set_fast_math(True)
+  try:
+    assert bob.ip.gabor.get_fast_math()
+    fast_jets = [bob.ip.gabor.Jet(complex=c) for c in complex_data]
+    for exact, fast in zip(exact_jets, fast_jets):
+      assert numpy.allclose(exact.jet, fast.jet, rtol=0, atol=1e-12)
+      assert numpy.allclose(exact.complex, fast.complex, rtol=0, atol=1e-10)
+    for sim, reference in zip(sims, exact_scores):
+      assert numpy.allclose([sim(fast_jets[0], jet) for jet in fast_jets], reference, rtol=0, atol=1e-12)
+      assert numpy.allclose(sim.similarities(fast_jets[0], numpy.array([jet.jet for jet in fast_jets])), reference, rtol=0, atol=1e-12)
+    assert numpy.allclose([sims[2].disparity(fast_jets[0], jet) for jet in fast_jets], exact_disparities, rtol=0, atol=1e-10)
+  finally:
+    bob.ip.gabor.set_fast_math(False)
+  assert not bob.ip.gabor.get_fast_math()
+
+
+def test_canberra():
+  # the Canberra terms are summed in pairs, which must give the sum of the single quotients for odd lengths and magnitudes close to zero
+  numpy.random.seed(10222015)
+  sim = bob.ip.gabor.Similarity('Canberra')
+  for length in (1, 7, 40, 41):
+    for scale in (1., 1e-160, 1e-200):
+      jet1, jet2 = bob.ip.gabor.Jet(length), bob.ip.gabor.Jet(length)
+      jet1.jet[0] = (numpy.random.rand(length) + 0.1) * scale
+      jet2.jet[0] = (numpy.random.rand(length) + 0.1) * scale
+      expected = numpy.mean(1. - numpy.abs(jet1.jet[0] - jet2.jet[0]) / (jet1.jet[0] + jet2.jet[0]))
+      assert abs(sim(jet1, jet2) - expected) < 1e-14
+      assert abs(sim.similarities(jet1, numpy.array([jet2.jet, jet1.jet]))[0] - expected) < 1e-14
+
+def test_cascade():
+  gwt = seeded_transform()
+
+  probe = random_jet(gwt)
+  gallery = numpy.array([random_jet(gwt).jet for i in range(50)])
+  gallery[17] = probe.jet
+  matching = bob.ip.gabor.Similarity("PhaseDiffPlusCanberra", gwt)
+  expected = matching.similarities(probe, gallery)
+
+  cascade = bob.ip.gabor.Cascade(matching, fraction=0.2)
+  assert cascade.screening.type == "ScalarProduct"
+  scores = cascade(probe, gallery, number_of_threads=2)
+  passed = numpy.isfinite(scores)
+  assert numpy.count_nonzero(passed) == 10
+  assert passed[17]
+  assert numpy.argmax(scores) == 17
+  assert numpy.allclose(scores[passed], expected[passed])
+  assert numpy.all(scores[~passed] == -numpy.inf)
+  assert cascade.evaluated == (50, 10)
+  assert abs(cascade.pass_rate - 0.2) < 1e-12
+
+  # threshold on the screening scores
+  cascade.threshold = 2.
+  scores = cascade.search(probe, gallery)
+  assert numpy.all(numpy.isinf(scores))
+  cascade.reset_statistics()
+  assert cascade.evaluated == (0, 0)
+  assert cascade.pass_rate == 0.
+  nose.tools.assert_raises(RuntimeError, setattr, cascade, "fraction", 0.)
+
+
+def test_gallery_index():
+  gwt = seeded_transform()
+
+  similarity = bob.ip.gabor.Similarity("PhaseDiffPlusCanberra", gwt)
+  index = bob.ip.gabor.GalleryIndex(similarity)
+  graphs = dict((100 + i, random_graph(gwt)) for i in range(40))
+  for id in sorted(graphs):
+    index.add(id, graphs[id])
+  assert len(index) == 40
+  assert 117 in index
+  nose.tools.assert_raises(RuntimeError, index.add, 117, graphs[117])
+
+  probe = random_graph(gwt)
+  def expected(ids, k):
+    scores = [(id, numpy.mean([similarity(p, g) for p, g in zip(probe, graphs[id])])) for id in ids]
+    return sorted(scores, key = lambda x: (-x[1], x[0]))[:k]
+
+  results = index.search(probe, 5, number_of_threads=3)
+  reference = expected(graphs, 5)
+  assert [r[0] for r in results] == [r[0] for r in reference]
+  assert numpy.allclose([r[1] for r in results], [r[1] for r in reference])
+
+  # only some ids
+  results = index(probe, 3, id_ranges = [(105, 109), (130, 131)])
+  assert [r[0] for r in results] == [r[0] for r in expected(list(range(105,110)) + [130, 131], 3)]
+
+  # remove and search again
+  best = results[0][0]
+  assert index.remove(best)
+  assert not index.remove(best)
+  assert len(index) == 39
+  assert best not in [r[0] for r in index.search(probe, 39)]
+
+  # Z-norm and T-norm with a cohort of graphs
+  cohort = [random_graph(gwt) for c in range(8)]
+  cohort_data = numpy.array([[jet.jet for jet in graph] for graph in cohort])
+  def mean_similarity(graph1, graph2):
+    return numpy.mean([similarity(j1, j2) for j1, j2 in zip(graph1, graph2)])
+  index.set_normalization('ZNorm', cohort_data, number_of_threads=2)
+  assert index.normalization == 'ZNorm'
+  assert index.cohort_size == 8
+  index.add(best, graphs[best])
+  for id in (best, 120):
+    cohort_scores = [mean_similarity(c, graphs[id]) for c in cohort]
+    assert numpy.allclose(index.z_statistics(id), (numpy.mean(cohort_scores), numpy.std(cohort_scores)))
+  results = index.search(probe, 5)
+  z_scores = dict((id, (mean_similarity(probe, graphs[id]) - index.z_statistics(id)[0]) / index.z_statistics(id)[1]) for id in graphs)
+  assert [r[0] for r in results] == sorted(graphs, key = lambda id: (-z_scores[id], id))[:5]
+  assert numpy.allclose([r[1] for r in results], [z_scores[r[0]] for r in results])
+
+  index.set_normalization('TNorm', cohort_data)
+  cohort_scores = [mean_similarity(probe, c) for c in cohort]
+  assert numpy.allclose(index.t_statistics(probe), (numpy.mean(cohort_scores), numpy.std(cohort_scores)))
+  nose.tools.assert_raises(RuntimeError, index.z_statistics, best)
+
+  # the cohort statistics are stored with the graphs
+  index.set_normalization('ZTNorm', cohort_data)
+  results = index.search(probe, 5)
+  temp_file = bob.io.base.test_utils.temporary_filename()
+  try:
+    index.save(bob.io.base.HDF5File(temp_file, 'w'))
+    loaded = bob.ip.gabor.GalleryIndex(bob.io.base.HDF5File(temp_file))
+    assert loaded.normalization == 'ZTNorm'
+    assert sorted(loaded.ids) == sorted(index.ids)
+    assert numpy.allclose(loaded.z_statistics(120), index.z_statistics(120))
+    assert loaded.search(probe, 5) == results
+  finally:
+    if os.path.exists(temp_file):
+      os.remove(temp_file)
+
+  index.clear_normalization()
+  assert index.normalization == 'None'
+
+  # a failing computation of the Z-norm statistics leaves the index unchanged
+  failing = [False]
+  def unstable(jet1, jet2):
+    if failing[0]:
+      raise ValueError("unstable similarity")
+    return float(numpy.dot(jet1[0], jet2[0]))
+  bob.ip.gabor.register_similarity("UnstableTest", unstable)
+  unstable_index = bob.ip.gabor.GalleryIndex(bob.ip.gabor.Similarity("UnstableTest"))
+  unstable_index.add(100, graphs[100])
+  unstable_index.set_normalization('ZNorm', cohort_data)
+  failing[0] = True
+  nose.tools.assert_raises(RuntimeError, unstable_index.add, 101, graphs[101])
+  failing[0] = False
+  assert len(unstable_index) == 1
+  assert 101 not in unstable_index
+  unstable_index.add(101, graphs[101])
+  assert sorted(unstable_index.ids) == [100, 101]
+  cohort_scores = [numpy.mean([unstable(c.jet, g.jet) for c, g in zip(graph, graphs[101])]) for graph in cohort]
+  assert numpy.allclose(unstable_index.z_statistics(101), (numpy.mean(cohort_scores), numpy.std(cohort_scores)))
+
+
+def test_score_cache():
+  gwt = seeded_transform()
+
+  jets = [random_jet(gwt) for i in range(20)]
+  gallery = numpy.array([jet.jet for jet in jets])
+  graphs = [[random_jet(gwt) for n in range(3)] for i in range(10)]
+  graph_gallery = numpy.array([[jet.jet for jet in graph] for graph in graphs])
+  probe = random_jet(gwt)
+  probe_graph = [random_jet(gwt) for n in range(3)]
+
+  sim = bob.ip.gabor.Similarity('PhaseDiffPlusCanberra', gwt)
+  cache = bob.ip.gabor.ScoreCache(sim, capacity = 100)
+  assert cache.capacity == 100
+  assert cache.similarity.type == 'PhaseDiffPlusCanberra'
+
+  # the first comparisons are computed, all repeated comparisons are looked up
+  reference = sim.similarities(probe, gallery)
+  assert numpy.allclose(cache.similarities(probe, gallery, number_of_threads = 2), reference)
+  assert (cache.hits, cache.misses) == (0, 20)
+  assert len(cache) == 20
+  assert numpy.allclose([cache(probe, jet) for jet in jets], reference)
+  assert (cache.hits, cache.misses) == (20, 20)
+  assert cache.hit_rate == 0.5
+
+  # modified jets are different pairs
+  modified = bob.ip.gabor.Jet(jets[0])
+  modified.jet[1,0] += 1.
+  assert abs(cache.score(probe, modified) - sim(probe, modified)) < 1e-12
+  assert cache.misses == 21
+
+  # graphs
+  reference = sim.similarities(probe_graph, graph_gallery)
+  assert abs(cache(probe_graph, graphs[3]) - reference[3]) < 1e-12
+  cache.reset_statistics()
+  assert numpy.allclose(cache.similarities(probe_graph, graph_gallery), reference)
+  assert (cache.hits, cache.misses) == (1, 9)
+
+  # the least recently used scores are removed
+  small = bob.ip.gabor.ScoreCache(sim, 5)
+  small.similarities(probe, gallery)
+  assert len(small) == 5
+  small.similarities(probe, gallery[15:])
+  assert small.hits == 5
+  cache.clear()
+  assert len(cache) == 0
+  nose.tools.assert_raises(ValueError, bob.ip.gabor.ScoreCache, sim, 0)
+
+
+def test_matching_service():
+  import threading, tempfile, shutil
+  gwt = seeded_transform()
+
+  # two shards and the complete gallery
+  similarity = bob.ip.gabor.Similarity("PhaseDiffPlusCanberra", gwt)
+  shards = [bob.ip.gabor.GalleryIndex(similarity) for s in range(2)]
+  complete = bob.ip.gabor.GalleryIndex(similarity)
+  for id in range(30):
+    graph = random_graph(gwt)
+    shards[id % 2].add(id, graph)
+    complete.add(id, graph)
+
+  temp_dir = tempfile.mkdtemp(prefix="bobtest_")
+  servers = [bob.ip.gabor.MatchingServer(shard, os.path.join(temp_dir, "shard%d" % s), 2) for s, shard in enumerate(shards)]
+  threads = [threading.Thread(target = server.serve) for server in servers]
+  try:
+    for thread in threads:
+      thread.start()
+    client = bob.ip.gabor.MatchingClient([server.socket_path for server in servers])
+    assert client.number_of_shards == 2
+    assert len(client) == 30
+
+    probe = random_graph(gwt)
+    assert client.search(probe, 5) == complete.search(probe, 5)
+    assert client(probe, 4, id_ranges = [(3, 8), (20, 21)]) == complete(probe, 4, id_ranges = [(3, 8), (20, 21)])
+
+    # errors of the servers are raised, and the connections stay usable
+    nose.tools.assert_raises(RuntimeError, client.search, probe[:2], 5)
+    assert client.search(probe, 30) == complete.search(probe, 30)
+
+    # only sockets are replaced, and a replaced socket is not removed by the previous server
+    not_a_socket = os.path.join(temp_dir, "file")
+    open(not_a_socket, 'w').close()
+    nose.tools.assert_raises(RuntimeError, bob.ip.gabor.MatchingServer, shards[0], not_a_socket)
+    assert os.path.isfile(not_a_socket)
+    first = bob.ip.gabor.MatchingServer(shards[0], os.path.join(temp_dir, "replaced"))
+    second = bob.ip.gabor.MatchingServer(shards[0], first.socket_path)
+    del first
+    assert os.path.exists(second.socket_path)
+    del second
+    assert not os.path.exists(os.path.join(temp_dir, "replaced"))
+
+    # the connections to the reachable servers are closed when a later server is not reachable
+    if os.path.isdir("/proc/self/fd"):
+      idle = bob.ip.gabor.MatchingServer(shards[0], os.path.join(temp_dir, "idle"))
+      open_files = len(os.listdir("/proc/self/fd"))
+      nose.tools.assert_raises(RuntimeError, bob.ip.gabor.MatchingClient, [idle.socket_path, not_a_socket])
+      assert len(os.listdir("/proc/self/fd")) == open_files
+  finally:
+    for server in servers:
+      server.stop()
+    for thread in threads:
+      thread.join()
+    shutil.rmtree(temp_dir)
+  nose.tools.assert_raises(RuntimeError, bob.ip.gabor.MatchingClient, [servers[0].socket_path])
+
+
+def test_quantized_index():
+  gwt = seeded_transform()
+  # clustered jets, so that the quantization is meaningful
+  prototypes = numpy.random.rand(20, 2, gwt.number_of_wavelets)
+  gallery = numpy.array([prototypes[i % 20] + 0.05 * numpy.random.randn(2, gwt.number_of_wavelets) for i in range(500)])
+  gallery[:,0] = numpy.abs(gallery[:,0])
+
+  index = bob.ip.gabor.QuantizedIndex(number_of_subspaces = 4, number_of_centroids = 32)
+  nose.tools.assert_raises(RuntimeError, index.add, gallery)
+  index.train(gallery, number_of_threads = 2)
+  index.add(gallery)
+  assert len(index) == 500
+  assert index.codes.shape == (500, 4)
+  assert index.centroids.shape == (4, 32, gwt.number_of_wavelets // 4)
+
+  probe = bob.ip.gabor.Jet(gwt.number_of_wavelets)
+  probe.jet[:] = gallery[42]
+  results = index.search(probe, 5)
+  assert len(results) == 5
+  assert all(results[i][1] <= results[i+1][1] for i in range(4))
+  table = index.distance_table(probe)
+  assert numpy.allclose(results[0][1], sum(table[m, index.codes[results[0][0], m]] for m in range(4)))
+
+  # re-ranking with all candidates gives the exact result
+  similarity = bob.ip.gabor.Similarity("ScalarProduct")
+  results = index(probe, 3, gallery, similarity, candidates = 500)
+  expected = similarity.similarities(probe, gallery)
+  assert [r[0] for r in results] == list(numpy.argsort(-expected, kind='mergesort')[:3])
+  assert numpy.allclose([r[1] for r in results], numpy.sort(expected)[::-1][:3])
+
+  # check IO
+  temp_file = bob.io.base.test_utils.temporary_filename()
+  try:
+    index.save(bob.io.base.HDF5File(temp_file, 'w'))
+    loaded = bob.ip.gabor.QuantizedIndex(bob.io.base.HDF5File(temp_file))
+    assert loaded.space == 'Absolute'
+    assert len(loaded) == 500
+    assert numpy.all(loaded.codes == index.codes)
+    assert numpy.allclose(loaded.centroids, index.centroids)
+    # centroids that do not fit to the stored configuration are rejected
+    hdf5 = bob.io.base.HDF5File(temp_file, 'a')
+    hdf5.set("NumberOfCentroids", 8)
+    del hdf5
+    nose.tools.assert_raises(RuntimeError, bob.ip.gabor.QuantizedIndex, bob.io.base.HDF5File(temp_file))
+  finally:
+    if os.path.exists(temp_file):
+      os.remove(temp_file)
+
+
+def test_fixed_point_similarity():
+  # compare the fixed-point similarities with the floating point similarities with the stored configuration
+  numpy.random.seed(10222015)
+  reference_sim = bob.ip.gabor.Similarity(bob.io.base.HDF5File(bob.io.base.test_utils.datafile("testsim.hdf5", 'bob.ip.gabor')))
+  gwt = reference_sim.transform
+  jet = bob.ip.gabor.Jet(bob.io.base.HDF5File(bob.io.base.test_utils.datafile("testjet.hdf5", 'bob.ip.gabor')))
+  jet.normalize()
+
+  # distorted copies of the test jet
+  jets = []
+  for i in range(20):
+    distorted = bob.ip.gabor.Jet(jet)
+    distorted.jet[0] *= 1. + 0.2 * numpy.abs(numpy.random.randn(gwt.number_of_wavelets))
+    distorted.jet[1] += 0.3 * numpy.random.randn(gwt.number_of_wavelets)
+    distorted.normalize()
+    jets.append(distorted)
+  gallery = numpy.array([j.jet for j in jets])
+
+  for type in ('ScalarProduct', 'Canberra', 'AbsPhase'):
+    sim = bob.ip.gabor.Similarity(type, gwt)
+    fixed = bob.ip.gabor.FixedPointSimilarity(type)
+    assert fixed.type == type
+    probe = fixed.quantize(jet)
+    assert probe.dtype == numpy.uint16
+    assert probe.shape == (2, gwt.number_of_wavelets)
+    quantized = fixed.quantize(gallery)
+    assert quantized.shape == gallery.shape
+    assert numpy.all(quantized[3] == fixed.quantize(jets[3]))
+
+    assert abs(fixed(probe, probe) - sim(jet, jet)) < 1e-3
+    reference = [sim(jet, j) for j in jets]
+    assert numpy.allclose([fixed(probe, q) for q in quantized], reference, atol=1e-3)
+    scores = numpy.ndarray((len(jets),), numpy.float64)
+    fixed.similarities(probe, quantized, scores, number_of_threads=3)
+    assert numpy.all(scores == fixed.similarities(probe, quantized))
+    assert numpy.allclose(scores, reference, atol=1e-3)
+
+  # disparity based similarities cannot be computed in fixed-point arithmetic
+  nose.tools.assert_raises(RuntimeError, bob.ip.gabor.FixedPointSimilarity, 'Disparity')
+  nose.tools.assert_raises(TypeError, fixed.similarity, gallery[0], gallery[1])
+
+
+def test_mapped_gallery():
+  gwt = seeded_transform()
+  graphs = numpy.random.rand(12, 3, 2, gwt.number_of_wavelets)
+  ids = [100 + 3 * i for i in range(12)]
+  nodes = [(10, 20), (10, 40), (30, 30)]
+
+  temp_file = bob.io.base.test_utils.temporary_filename()
+  try:
+    bob.ip.gabor.MappedGallery.write(temp_file, graphs, ids, nodes, quantize = True)
+    gallery = bob.ip.gabor.MappedGallery(temp_file)
+    assert gallery.filename == temp_file
+    assert len(gallery) == 12
+    assert gallery.number_of_nodes == 3
+    assert gallery.length == gwt.number_of_wavelets
+    assert list(gallery.ids) == ids
+    assert gallery.nodes == nodes
+    assert numpy.all(gallery.graphs == graphs)
+    assert numpy.all(gallery.jets == graphs.reshape(36, 2, gwt.number_of_wavelets))
+    assert not gallery.graphs.flags.writeable
+    fixed = bob.ip.gabor.FixedPointSimilarity('ScalarProduct')
+    assert numpy.all(gallery.quantized == fixed.quantize(gallery.jets))
+
+    # the scores are computed on the mapped data
+    similarity = bob.ip.gabor.Similarity("PhaseDiffPlusCanberra", gwt)
+    probe = [bob.ip.gabor.Jet(gwt.number_of_wavelets) for n in range(3)]
+    for jet in probe:
+      jet.jet[:] = numpy.random.rand(2, gwt.number_of_wavelets)
+    reference = similarity.similarities(probe, graphs)
+    assert numpy.allclose(gallery.similarities(similarity, probe, number_of_threads = 2), reference)
+    assert numpy.allclose(similarity.similarities(probe, gallery.graphs), reference)
+
+    # the array keeps the mapping alive
+    jets = gallery.jets
+    del gallery
+    assert numpy.all(jets[4] == graphs[1,1])
+    del jets
+
+    # default ids, no nodes and no quantized jets
+    bob.ip.gabor.MappedGallery.write(temp_file, graphs[:5])
+    gallery = bob.ip.gabor.MappedGallery(temp_file)
+    assert list(gallery.ids) == list(range(5))
+    assert gallery.nodes is None
+    assert gallery.quantized is None
+    del gallery
+
+    nose.tools.assert_raises(RuntimeError, bob.ip.gabor.MappedGallery.write, temp_file, graphs, ids[:3])
+    with open(temp_file, 'wb') as f:
+      f.write(b"not a gallery")
+    nose.tools.assert_raises(RuntimeError, bob.ip.gabor.MappedGallery, temp_file)
+  finally:
+    if os.path.exists(temp_file):
+      os.remove(temp_file)
+
+
 def test_disparity():
   # generate Gabor jet
   gwt = bob.ip.gabor.Transform()
@@ -310,6 +912,71 @@ def test_disparity():
   assert abs(new_disp[0]) < 1e-8
   assert abs(new_disp[1]) < 1e-8
 
+  # the reentrant version returns the disparity, but does not update the last disparity
+  score, disp = sim(shifted_jet, jet, return_disparity=True)
+  assert abs(score - sim(shifted_jet, jet)) < 1e-8
+  assert numpy.allclose(disp, sim.last_disparity)
+  sim(normalized_jet, jet)
+  sim.similarity(shifted_jet, jet, return_disparity=True)
+  assert abs(sim.last_disparity[1]) < 1e-8
+
+  # batch disparity estimation
+  numpy.random.seed(10222015)
+  jets1 = numpy.array([normalized_jet.jet, shifted_jet.jet, jet.jet] * 5)
+  jets2 = numpy.array([jet.jet] * 15)
+  jets2[::2,1] += numpy.random.random((8, gwt.number_of_wavelets)) * 0.1
+  disps = sim.disparities(jets1, jets2)
+  assert disps.shape == (15, 2)
+  jet1, jet2 = bob.ip.gabor.Jet(gwt.number_of_wavelets), bob.ip.gabor.Jet(gwt.number_of_wavelets)
+  for i in range(15):
+    jet1.jet[:] = jets1[i]
+    jet2.jet[:] = jets2[i]
+    assert numpy.allclose(disps[i], sim.disparity(jet1, jet2))
+  assert numpy.allclose(sim.disparities(jets1, jets2, number_of_threads=3), disps)
+  nose.tools.assert_raises(RuntimeError, sim.disparities, jets1, jets2[:-1])
+
+  # batch phase shift, towards individual references and towards a common reference
+  shifted = sim.shift_phases(jets1, jets2)
+  disparities = numpy.ndarray((15, 2))
+  common = sim.shift_phases(jets1, jet, disparities=disparities, number_of_threads=2)
+  for i in range(15):
+    jet1.jet[:] = jets1[i]
+    jet2.jet[:] = jets2[i]
+    assert numpy.allclose(shifted[i], sim.shift_phase(jet1, jet2).jet)
+    assert numpy.allclose(common[i], sim.shift_phase(jet1, jet).jet)
+    assert numpy.allclose(disparities[i], sim.last_disparity)
+  in_place = jets1.copy()
+  sim.shift_phases(in_place, jets2, in_place)
+  assert numpy.allclose(in_place, shifted)
+
+  # dense disparity fields between two trafo images
+  image = numpy.random.random((32, 36)) * 255.
+  shifted_image = numpy.roll(image, 2, axis=1)
+  trafo1, trafo2 = gwt(image), gwt(shifted_image)
+  disps, confidences = sim.disparity_field(trafo1, trafo2, step=(3, 4), first=(2, 1))
+  assert disps.shape == (10, 9, 2)
+  assert confidences.shape == (10, 9)
+  for y in range(10):
+    for x in range(9):
+      position = (2 + 3 * y, 1 + 4 * x)
+      jet1, jet2 = bob.ip.gabor.Jet(trafo1, position, True), bob.ip.gabor.Jet(trafo2, position, True)
+      assert numpy.allclose(disps[y,x], sim.disparity(jet1, jet2))
+      assert abs(confidences[y,x] - sim(jet1, jet2)) < 1e-8
+  # jet images give the same results, also with several threads
+  jet_image1 = numpy.array([[bob.ip.gabor.Jet(trafo1, (y, x)).jet for x in range(36)] for y in range(32)])
+  jet_image2 = numpy.array([[bob.ip.gabor.Jet(trafo2, (y, x)).jet for x in range(36)] for y in range(32)])
+  jet_disps, jet_confidences = sim.disparity_field(jet_image1, jet_image2, (3, 4), (2, 1), number_of_threads=4)
+  assert numpy.allclose(jet_disps, disps)
+  assert numpy.allclose(jet_confidences, confidences)
+  # the full field has one disparity per pixel
+  disps, confidences = sim.disparity_field(trafo1, trafo2)
+  assert disps.shape == (32, 36, 2)
+  nose.tools.assert_raises(RuntimeError, sim.disparity_field, trafo1, trafo2, (3, 4), (2, 1), numpy.ndarray((11, 9, 2)), numpy.ndarray((11, 9)))
+
+  # types without disparity estimation return nan
+  score, disp = bob.ip.gabor.Similarity("ScalarProduct", gwt).similarity(shifted_jet, jet, True)
+  assert all(math.isnan(d) for d in disp)
+
 
 def test_statistics():
   numpy.random.seed(10222015)
@@ -357,3 +1024,241 @@ def test_statistics():
   finally:
     if os.path.exists(temp_file):
       os.remove(temp_file)
+
+  # batched log likelihoods
+  stats.gwt = gwt
+  data = numpy.array([jet.jet for jet in jets[:10]])
+  for estimate_phase in (True, False):
+    reference = [stats.log_likelihood(jet, estimate_phase, (1.5, 0.25)) for jet in jets[:10]]
+    assert numpy.allclose(stats.log_likelihoods(data, estimate_phase, (1.5, 0.25), number_of_threads = 2), reference)
+  other = bob.ip.gabor.JetStatistics(jets[50:], gwt)
+  scores = bob.ip.gabor.log_likelihoods([stats, other], data, number_of_threads = 3)
+  assert scores.shape == (2, 10)
+  assert numpy.allclose(scores, [[s.log_likelihood(jet) for jet in jets[:10]] for s in (stats, other)])
+  nose.tools.assert_raises(RuntimeError, stats.log_likelihoods, data[:,:,:5])
+
+  # likelihood maps in a transformed image
+  image = numpy.random.rand(20, 30) * 255.
+  trafo_image = gwt.transform(image)
+  for estimate_phase in (True, False):
+    scores = stats.log_likelihood_map(trafo_image, (2, 5), (10, 20), estimate_phase, number_of_threads = 2)
+    assert scores.shape == (9, 16)
+    for y, x in ((2, 5), (7, 11), (10, 20)):
+      jet = bob.ip.gabor.Jet(trafo_image=trafo_image, position=(y, x))
+      assert abs(scores[y-2, x-5] - stats.log_likelihood(jet, estimate_phase)) < 1e-8
+  nose.tools.assert_raises(RuntimeError, stats.log_likelihood_map, trafo_image, (10, 10), (20, 20))
+
+
+def test_statistics_builder():
+  gwt = seeded_transform(number_of_scales=4, number_of_directions = 5)
+  # generate Gabor jets, whose phases scatter around a common mean
+  mean_phase = numpy.random.uniform(-math.pi, math.pi, gwt.number_of_wavelets)
+  jets = []
+  for i in range(100):
+    jet = bob.ip.gabor.Jet(gwt.number_of_wavelets)
+    jet.jet[0] = numpy.random.rand(gwt.number_of_wavelets)
+    jet.jet[1] = mean_phase + numpy.random.randn(gwt.number_of_wavelets) * 0.5
+    jets.append(jet)
+  stats = bob.ip.gabor.JetStatistics(jets, gwt)
+
+  def check(builder, phase_tolerance = 1e-8):
+    built = builder.finalize(gwt)
+    assert built.gwt == gwt
+    assert numpy.allclose(built.mean_abs, stats.mean_abs)
+    assert numpy.allclose(built.var_abs, stats.var_abs)
+    assert numpy.allclose(numpy.angle(numpy.exp(1j * (built.mean_phase - stats.mean_phase))), 0.)
+    assert numpy.allclose(built.var_phase, stats.var_phase, rtol = phase_tolerance)
+
+  # add the jets one by one
+  builder = bob.ip.gabor.JetStatisticsBuilder()
+  assert len(builder) == 0
+  for jet in jets:
+    builder.add(jet)
+  assert builder.count == 100
+  assert builder.length == gwt.number_of_wavelets
+  check(builder)
+
+  # merge builders of parts, which are given as lists and arrays
+  parts = [bob.ip.gabor.JetStatisticsBuilder() for i in range(3)]
+  parts[0].add(jets[:30])
+  parts[1].add(numpy.array([jet.jet for jet in jets[30:70]]))
+  parts[2].add(jets[70:])
+  merged = bob.ip.gabor.JetStatisticsBuilder()
+  for part in parts:
+    merged.merge(part)
+  assert len(merged) == 100
+  check(merged)
+
+  # partial builders can be written and read
+  temp_file = bob.io.base.test_utils.temporary_filename()
+  try:
+    parts[2].save(bob.io.base.HDF5File(temp_file, 'w'))
+    parts[0].merge(parts[1])
+    parts[0].merge(bob.ip.gabor.JetStatisticsBuilder(bob.io.base.HDF5File(temp_file)))
+    check(parts[0])
+  finally:
+    if os.path.exists(temp_file):
+      os.remove(temp_file)
+
+  # for uniformly spread phases, the phase variances are approximated from the trigonometric moments of the phases, in any order of adding and merging the jets
+  for jet in jets:
+    jet.jet[1] = numpy.random.uniform(-math.pi, math.pi, gwt.number_of_wavelets)
+  stats = bob.ip.gabor.JetStatistics(jets, gwt)
+  builder.clear()
+  for i in numpy.random.permutation(len(jets)):
+    builder.add(jets[i])
+  check(builder, 0.05)
+  parts = [bob.ip.gabor.JetStatisticsBuilder() for i in range(3)]
+  parts[0].add(jets[60:])
+  parts[1].add(jets[:25])
+  parts[2].add(numpy.array([jet.jet for jet in jets[25:60]]))
+  parts[2].merge(parts[0])
+  parts[1].merge(parts[2])
+  check(parts[1], 0.05)
+
+  builder.clear()
+  builder.add(jets[0])
+  nose.tools.assert_raises(RuntimeError, builder.finalize)
+  nose.tools.assert_raises(RuntimeError, builder.add, bob.ip.gabor.Jet(10))
+  # jets that are not stored contiguously are rejected
+  nose.tools.assert_raises(RuntimeError, bob.ip.gabor.JetStatisticsBuilder().add, numpy.array([jet.jet for jet in jets])[:,:,::2])
+
+
+def test_graph_statistics_trainer():
+  gwt = seeded_transform(10182015, number_of_scales=4, number_of_directions = 5)
+  graph = bob.ip.gabor.Graph(first=(10,10), last=(30,30), step=(10,10))
+  # extract the graphs from several images
+  graphs = []
+  for i in range(10):
+    trafo_image = gwt.transform(numpy.random.rand(40, 40) * 255.)
+    graphs.append(graph.extract(trafo_image))
+  data = numpy.array([[jet.jet for jet in jets] for jets in graphs])
+  assert data.shape == (10, graph.number_of_nodes, 2, gwt.number_of_wavelets)
+
+  # the jets of each node are accumulated by their own JetStatisticsBuilder
+  def builders(graphs):
+    result = [bob.ip.gabor.JetStatisticsBuilder() for n in range(graph.number_of_nodes)]
+    for jets in graphs:
+      for builder, jet in zip(result, jets):
+        builder.add(jet)
+    return result
+  reference = [builder.finalize(gwt) for builder in builders(graphs)]
+  # the absolute values and the mean phases are the ones of the JetStatistics constructor;
+  # the phases of the noise images are spread over the whole circle, so that the phase variances are approximated
+  for n in range(graph.number_of_nodes):
+    batch = bob.ip.gabor.JetStatistics([jets[n] for jets in graphs], gwt)
+    assert numpy.allclose(reference[n].mean_abs, batch.mean_abs)
+    assert numpy.allclose(reference[n].var_abs, batch.var_abs)
+    assert numpy.allclose(numpy.angle(numpy.exp(1j * (reference[n].mean_phase - batch.mean_phase))), 0.)
+    assert numpy.allclose(reference[n].var_phase, batch.var_phase, rtol = 0.05)
+
+  # add the graphs in batches
+  trainer = bob.ip.gabor.GraphStatisticsTrainer()
+  assert len(trainer) == 0
+  trainer.add(data[:4], number_of_threads = 2)
+  trainer.add(data[4:], number_of_threads = 3)
+  assert trainer.count == 10
+  assert trainer.number_of_nodes == graph.number_of_nodes
+  assert trainer.length == gwt.number_of_wavelets
+  statistics = trainer.finalize(gwt, number_of_threads = 2)
+  assert len(statistics) == graph.number_of_nodes
+  assert all(s == r for s, r in zip(statistics, reference))
+
+  # add single graphs and merge the trainers of parts
+  parts = [bob.ip.gabor.GraphStatisticsTrainer() for i in range(2)]
+  for jets in graphs[:3]:
+    parts[0].add(jets)
+  for i in range(3, 10):
+    parts[1].add(data[i])
+  parts[0].merge(parts[1])
+  merged = builders(graphs[:3])
+  for builder, other in zip(merged, builders(graphs[3:])):
+    builder.merge(other)
+  assert all(s == m.finalize(gwt) for s, m in zip(parts[0].finalize(gwt), merged))
+
+  # the statistics of all nodes are written into one data set
+  temp_file = bob.io.base.test_utils.temporary_filename()
+  try:
+    bob.ip.gabor.save_statistics(statistics, bob.io.base.HDF5File(temp_file, 'w'))
+    hdf5 = bob.io.base.HDF5File(temp_file)
+    assert hdf5.get('Statistics').shape == (graph.number_of_nodes, 4, gwt.number_of_wavelets)
+    loaded = bob.ip.gabor.load_statistics(hdf5)
+    assert all(s == r for s, r in zip(loaded, statistics))
+    assert loaded[0].gwt == gwt
+  finally:
+    if os.path.exists(temp_file):
+      os.remove(temp_file)
+
+  trainer.clear()
+  trainer.add(data[0])
+  nose.tools.assert_raises(RuntimeError, trainer.finalize)
+  nose.tools.assert_raises(RuntimeError, trainer.add, data[0,:5])
+
+
+def test_landmark_detector():
+  gwt = seeded_transform(10182015, number_of_scales=4, number_of_directions = 5)
+  image = numpy.random.rand(40, 50) * 255.
+  trafo_image = gwt.transform(image)
+
+  # train the statistics of three landmarks with the jets around their positions
+  landmarks = ((10, 12), (25, 30), (18, 40))
+  statistics = []
+  for y, x in landmarks:
+    jets = [bob.ip.gabor.Jet(trafo_image=trafo_image, position=(y+dy, x+dx)) for dy in (-1, 0, 1) for dx in (-1, 0, 1)]
+    statistics.append(bob.ip.gabor.JetStatistics(jets))
+  detector = bob.ip.gabor.LandmarkDetector(gwt, statistics)
+  assert len(detector) == 3
+  assert detector.number_of_landmarks == 3
+  assert detector.gwt == gwt
+  assert all(s.gwt == gwt for s in detector.statistics)
+  # the given statistics are not modified
+  assert statistics[0].gwt is None
+
+  first = [(y-6, x-6) for y, x in landmarks]
+  last = [(y+6, x+8) for y, x in landmarks]
+  for estimate_phase in (True, False):
+    positions, scores = detector.detect(trafo_image, first, last, estimate_phase, number_of_threads = 2)
+    assert positions.shape == (3, 2)
+    assert scores.shape == (3,)
+    for i, s in enumerate(detector.statistics):
+      scores_map = s.log_likelihood_map(trafo_image, first[i], last[i], estimate_phase)
+      best = numpy.unravel_index(numpy.argmax(scores_map), scores_map.shape)
+      assert abs(scores[i] - scores_map[best]) < 1e-8
+      assert numpy.all(numpy.abs(positions[i] - numpy.array(best) - first[i]) < 1.)
+    # the image is transformed by the detector
+    image_positions, image_scores = detector.detect(image, first, last, estimate_phase)
+    assert numpy.allclose(image_positions, positions)
+    assert numpy.allclose(image_scores, scores)
+
+  # the detector is stored as a single model
+  temp_file = bob.io.base.test_utils.temporary_filename()
+  try:
+    detector.save(bob.io.base.HDF5File(temp_file, 'w'))
+    new_detector = bob.ip.gabor.LandmarkDetector(bob.io.base.HDF5File(temp_file))
+    assert new_detector.gwt == gwt
+    assert all(a == b for a, b in zip(new_detector.statistics, detector.statistics))
+    assert numpy.allclose(new_detector.detect(trafo_image, first, last)[0], detector.detect(trafo_image, first, last)[0])
+  finally:
+    if os.path.exists(temp_file):
+      os.remove(temp_file)
+
+  # train with the jets at the landmarks in noisy versions of the image, and detect them in the image shifted by a sub-pixel offset
+  statistics = [bob.ip.gabor.JetStatistics([bob.ip.gabor.Jet(trafo_image=gwt.transform(image + numpy.random.randn(*image.shape) * 5.), position=landmark) for i in range(5)]) for landmark in landmarks]
+  shift = (0.3, -0.4)
+  frequencies = numpy.fft.fftfreq(image.shape[0])[:,numpy.newaxis] * shift[0] + numpy.fft.fftfreq(image.shape[1])[numpy.newaxis,:] * shift[1]
+  shifted = numpy.real(numpy.fft.ifft2(numpy.fft.fft2(image) * numpy.exp(-2j * math.pi * frequencies)))
+  first = [(y-3, x-3) for y, x in landmarks]
+  last = [(y+3, x+3) for y, x in landmarks]
+  detector = bob.ip.gabor.LandmarkDetector(gwt, statistics)
+  positions, scores = detector.detect(shifted, first, last)
+  trafo_shifted = gwt.transform(shifted)
+  for i, landmark in enumerate(landmarks):
+    truth = numpy.array(landmark) + shift
+    scores_map = detector.statistics[i].log_likelihood_map(trafo_shifted, first[i], last[i])
+    best = numpy.array(numpy.unravel_index(numpy.argmax(scores_map), scores_map.shape)) + first[i]
+    # the refined position is closer to the true position than the best integral position
+    assert numpy.linalg.norm(positions[i] - truth) < numpy.linalg.norm(best - truth)
+    assert numpy.linalg.norm(positions[i] - truth) < 0.2
+
+  nose.tools.assert_raises(RuntimeError, detector.detect, trafo_image, first[:2], last[:2])
+  nose.tools.assert_raises(RuntimeError, bob.ip.gabor.LandmarkDetector, bob.ip.gabor.Transform(), statistics)
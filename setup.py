@@ -15,9 +15,14 @@ build_requires = load_requirements()
 # Define package version
 version = open("version.txt").read().rstrip()
 
-packages = ['boost']
+# the JetStream reads the jets through the HDF5 C API
+packages = ['boost', 'hdf5']
 boost_modules = ['system']
 
+# batch computations are distributed over threads and use OpenMP SIMD directives (but not the OpenMP runtime)
+extra_compile_args = ['-pthread', '-fopenmp-simd']
+extra_link_args = ['-pthread']
+
 setup(
 
     name='bob.ip.gabor',
@@ -58,11 +63,26 @@ setup(
           "bob/ip/gabor/cpp/Graph.cpp",
           "bob/ip/gabor/cpp/Similarity.cpp",
           "bob/ip/gabor/cpp/JetStatistics.cpp",
+          "bob/ip/gabor/cpp/Cascade.cpp",
+          "bob/ip/gabor/cpp/GalleryIndex.cpp",
+          "bob/ip/gabor/cpp/QuantizedIndex.cpp",
+          "bob/ip/gabor/cpp/FastMath.cpp",
+          "bob/ip/gabor/cpp/FixedPointSimilarity.cpp",
+          "bob/ip/gabor/cpp/ScoreCache.cpp",
+          "bob/ip/gabor/cpp/MatchingService.cpp",
+          "bob/ip/gabor/cpp/JetStatisticsBuilder.cpp",
+          "bob/ip/gabor/cpp/LandmarkDetector.cpp",
+          "bob/ip/gabor/cpp/GraphStatisticsTrainer.cpp",
+          "bob/ip/gabor/cpp/JetList.cpp",
+          "bob/ip/gabor/cpp/MappedGallery.cpp",
+          "bob/ip/gabor/cpp/JetStream.cpp",
         ],
         version = version,
         bob_packages = bob_packages,
         packages = packages,
         boost_modules = boost_modules,
+        extra_compile_args = extra_compile_args,
+        extra_link_args = extra_link_args,
       ),
 
       Extension("bob.ip.gabor._library",
@@ -73,12 +93,25 @@ setup(
           "bob/ip/gabor/graph.cpp",
           "bob/ip/gabor/similarity.cpp",
           "bob/ip/gabor/jet_statistics.cpp",
+          "bob/ip/gabor/cascade.cpp",
+          "bob/ip/gabor/gallery_index.cpp",
+          "bob/ip/gabor/quantized_index.cpp",
+          "bob/ip/gabor/fixed_point_similarity.cpp",
+          "bob/ip/gabor/score_cache.cpp",
+          "bob/ip/gabor/matching_service.cpp",
+          "bob/ip/gabor/jet_statistics_builder.cpp",
+          "bob/ip/gabor/landmark_detector.cpp",
+          "bob/ip/gabor/graph_statistics_trainer.cpp",
+          "bob/ip/gabor/mapped_gallery.cpp",
+          "bob/ip/gabor/jet_stream.cpp",
           "bob/ip/gabor/main.cpp",
         ],
         bob_packages = bob_packages,
         version = version,
         packages = packages,
         boost_modules = boost_modules,
+        extra_compile_args = extra_compile_args,
+        extra_link_args = extra_link_args,
       ),
     ],
 
@@ -86,6 +119,12 @@ setup(
       'build_ext': build_ext
     },
 
+    entry_points = {
+      'console_scripts': [
+        'bob_ip_gabor_matching_server.py = bob.ip.gabor.script.matching_server:main',
+      ],
+    },
+
     classifiers = [
       'Framework :: Bob',
       'Development Status :: 4 - Beta',